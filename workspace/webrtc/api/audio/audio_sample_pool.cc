@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/audio/audio_sample_pool.h"
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+constexpr size_t AudioSamplePool::kMinBufferSamples;
+constexpr size_t AudioSamplePool::kNumSizeClasses;
+constexpr size_t AudioSamplePool::kSlotsPerClass;
+constexpr size_t AudioSamplePool::kMaxBufferSamples;
+
+// static
+AudioSamplePool* AudioSamplePool::Get() {
+  static AudioSamplePool* const pool = new AudioSamplePool();
+  return pool;
+}
+
+AudioSamplePool::AudioSamplePool() {
+  for (auto& size_class : slots_) {
+    for (auto& slot : size_class) {
+      slot.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+}
+
+AudioSamplePool::~AudioSamplePool() {
+  for (auto& size_class : slots_) {
+    for (auto& slot : size_class) {
+      delete[] slot.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+// static
+size_t AudioSamplePool::SizeClass(size_t num_samples) {
+  RTC_DCHECK_LE(num_samples, kMaxBufferSamples);
+  size_t size_class = 0;
+  while ((kMinBufferSamples << size_class) < num_samples) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+// static
+size_t AudioSamplePool::CapacityFor(size_t num_samples) {
+  RTC_DCHECK_LE(num_samples, AudioFrame::kMaxDataSizeSamples);
+  return kMinBufferSamples << SizeClass(num_samples);
+}
+
+int16_t* AudioSamplePool::Acquire(size_t num_samples) {
+  RTC_DCHECK_LE(num_samples, AudioFrame::kMaxDataSizeSamples);
+  const size_t size_class = SizeClass(num_samples);
+  for (auto& slot : slots_[size_class]) {
+    // Cheap check first, to avoid writing to slots that are already empty.
+    if (slot.load(std::memory_order_relaxed) != nullptr) {
+      int16_t* buffer = slot.exchange(nullptr, std::memory_order_acquire);
+      if (buffer != nullptr) {
+        return buffer;
+      }
+    }
+  }
+  return new int16_t[kMinBufferSamples << size_class];
+}
+
+void AudioSamplePool::Release(int16_t* buffer, size_t capacity) {
+  RTC_DCHECK(buffer);
+  for (auto& slot : slots_[SizeClass(capacity)]) {
+    int16_t* expected = nullptr;
+    if (slot.load(std::memory_order_relaxed) == nullptr &&
+        slot.compare_exchange_strong(expected, buffer,
+                                     std::memory_order_release,
+                                     std::memory_order_relaxed)) {
+      return;
+    }
+  }
+  delete[] buffer;
+}
+
+size_t AudioSamplePool::NumFreeBuffers() const {
+  size_t num_free = 0;
+  for (const auto& size_class : slots_) {
+    for (const auto& slot : size_class) {
+      if (slot.load(std::memory_order_relaxed) != nullptr) {
+        ++num_free;
+      }
+    }
+  }
+  return num_free;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_AUDIO_AUDIO_SAMPLE_POOL_H_
+#define API_AUDIO_AUDIO_SAMPLE_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "api/audio/audio_frame.h"
+
+namespace webrtc {
+
+// Lock-free pool of int16_t sample buffers, used by PooledAudioFrame.
+//
+// Buffers come in power of two size classes from kMinBufferSamples up to the
+// first one holding AudioFrame::kMaxDataSizeSamples. Each class keeps up to
+// kSlotsPerClass free buffers in a fixed array of atomic slots; Acquire() and
+// Release() claim a slot with a single exchange or compare-and-swap, so they
+// never block and are not subject to ABA. When a class is empty a new buffer
+// is allocated, and when it is full the released buffer is freed.
+class AudioSamplePool {
+ public:
+  static constexpr size_t kMinBufferSamples = 128;
+  static constexpr size_t kNumSizeClasses = 7;
+  static constexpr size_t kSlotsPerClass = 16;
+  static_assert((kMinBufferSamples << (kNumSizeClasses - 1)) >=
+                    AudioFrame::kMaxDataSizeSamples,
+                "The largest size class must hold a full AudioFrame");
+
+  // The pool shared by all PooledAudioFrames. It is never destroyed.
+  static AudioSamplePool* Get();
+
+  AudioSamplePool();
+  ~AudioSamplePool();
+  AudioSamplePool(const AudioSamplePool&) = delete;
+  AudioSamplePool& operator=(const AudioSamplePool&) = delete;
+
+  // Returns the number of samples in the buffers that Acquire() returns for
+  // |num_samples|, which must be at most AudioFrame::kMaxDataSizeSamples.
+  static size_t CapacityFor(size_t num_samples);
+
+  // Returns an uninitialized buffer of CapacityFor(|num_samples|) samples.
+  int16_t* Acquire(size_t num_samples);
+  // Returns |buffer|, obtained from Acquire() on this pool, to the pool.
+  // |capacity| is either the number of samples it was acquired for or
+  // CapacityFor() them.
+  void Release(int16_t* buffer, size_t capacity);
+
+  // Number of buffers currently held by the pool, for tests.
+  size_t NumFreeBuffers() const;
+
+ private:
+  static constexpr size_t kMaxBufferSamples = kMinBufferSamples
+                                              << (kNumSizeClasses - 1);
+
+  // The size class of buffers of at least |num_samples| samples, which may
+  // be up to kMaxBufferSamples.
+  static size_t SizeClass(size_t num_samples);
+
+  std::atomic<int16_t*> slots_[kNumSizeClasses][kSlotsPerClass];
+};
+
+}  // namespace webrtc
+
+#endif  // API_AUDIO_AUDIO_SAMPLE_POOL_H_
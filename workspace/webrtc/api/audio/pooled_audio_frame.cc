@@ -0,0 +1,230 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/audio/pooled_audio_frame.h"
+
+#include <string.h>
+
+#include <utility>
+
+#include "api/audio/audio_sample_pool.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/time_utils.h"
+
+namespace webrtc {
+
+PooledAudioFrame::PooledAudioFrame() = default;
+
+PooledAudioFrame::~PooledAudioFrame() {
+  if (data_) {
+    AudioSamplePool::Get()->Release(data_, capacity_);
+  }
+}
+
+PooledAudioFrame::PooledAudioFrame(PooledAudioFrame&& other) {
+  swap(*this, other);
+}
+
+PooledAudioFrame& PooledAudioFrame::operator=(PooledAudioFrame&& other) {
+  swap(*this, other);
+  return *this;
+}
+
+void swap(PooledAudioFrame& a, PooledAudioFrame& b) {
+  using std::swap;
+  swap(a.timestamp_, b.timestamp_);
+  swap(a.elapsed_time_ms_, b.elapsed_time_ms_);
+  swap(a.ntp_time_ms_, b.ntp_time_ms_);
+  swap(a.samples_per_channel_, b.samples_per_channel_);
+  swap(a.sample_rate_hz_, b.sample_rate_hz_);
+  swap(a.num_channels_, b.num_channels_);
+  swap(a.channel_layout_, b.channel_layout_);
+  swap(a.speech_type_, b.speech_type_);
+  swap(a.vad_activity_, b.vad_activity_);
+  swap(a.profile_timestamp_ms_, b.profile_timestamp_ms_);
+  swap(a.packet_infos_, b.packet_infos_);
+  swap(a.data_, b.data_);
+  swap(a.capacity_, b.capacity_);
+  swap(a.muted_, b.muted_);
+  swap(a.absolute_capture_timestamp_ms_, b.absolute_capture_timestamp_ms_);
+}
+
+void PooledAudioFrame::Reset() {
+  ResetWithoutMuting();
+  muted_ = true;
+}
+
+void PooledAudioFrame::ResetWithoutMuting() {
+  timestamp_ = 0;
+  elapsed_time_ms_ = -1;
+  ntp_time_ms_ = -1;
+  samples_per_channel_ = 0;
+  sample_rate_hz_ = 0;
+  num_channels_ = 0;
+  channel_layout_ = CHANNEL_LAYOUT_NONE;
+  speech_type_ = AudioFrame::kUndefined;
+  vad_activity_ = AudioFrame::kVadUnknown;
+  profile_timestamp_ms_ = 0;
+  packet_infos_ = RtpPacketInfos();
+  absolute_capture_timestamp_ms_ = absl::nullopt;
+}
+
+void PooledAudioFrame::UpdateFrame(uint32_t timestamp,
+                                   const int16_t* data,
+                                   size_t samples_per_channel,
+                                   int sample_rate_hz,
+                                   SpeechType speech_type,
+                                   VADActivity vad_activity,
+                                   size_t num_channels) {
+  timestamp_ = timestamp;
+  samples_per_channel_ = samples_per_channel;
+  sample_rate_hz_ = sample_rate_hz;
+  speech_type_ = speech_type;
+  vad_activity_ = vad_activity;
+  num_channels_ = num_channels;
+  channel_layout_ = GuessChannelLayout(num_channels);
+  if (channel_layout_ != CHANNEL_LAYOUT_UNSUPPORTED) {
+    RTC_DCHECK_EQ(num_channels, ChannelLayoutToChannelCount(channel_layout_));
+  }
+
+  const size_t length = samples_per_channel * num_channels;
+  RTC_CHECK_LE(length, AudioFrame::kMaxDataSizeSamples);
+  if (data != nullptr) {
+    // The old samples are overwritten, so don't preserve them on growth.
+    muted_ = true;
+    EnsureCapacity(length);
+    memcpy(data_, data, sizeof(int16_t) * length);
+    muted_ = false;
+  } else {
+    muted_ = true;
+  }
+}
+
+void PooledAudioFrame::CopyFrom(const PooledAudioFrame& src) {
+  if (this == &src)
+    return;
+
+  timestamp_ = src.timestamp_;
+  elapsed_time_ms_ = src.elapsed_time_ms_;
+  ntp_time_ms_ = src.ntp_time_ms_;
+  packet_infos_ = src.packet_infos_;
+  samples_per_channel_ = src.samples_per_channel_;
+  sample_rate_hz_ = src.sample_rate_hz_;
+  speech_type_ = src.speech_type_;
+  vad_activity_ = src.vad_activity_;
+  num_channels_ = src.num_channels_;
+  channel_layout_ = src.channel_layout_;
+  absolute_capture_timestamp_ms_ = src.absolute_capture_timestamp_ms();
+
+  const size_t length = samples_per_channel_ * num_channels_;
+  RTC_CHECK_LE(length, AudioFrame::kMaxDataSizeSamples);
+  muted_ = true;
+  if (!src.muted()) {
+    EnsureCapacity(length);
+    memcpy(data_, src.data(), sizeof(int16_t) * length);
+    muted_ = false;
+  }
+}
+
+void PooledAudioFrame::CopyFrom(const AudioFrame& src) {
+  timestamp_ = src.timestamp_;
+  elapsed_time_ms_ = src.elapsed_time_ms_;
+  ntp_time_ms_ = src.ntp_time_ms_;
+  packet_infos_ = src.packet_infos_;
+  samples_per_channel_ = src.samples_per_channel_;
+  sample_rate_hz_ = src.sample_rate_hz_;
+  speech_type_ = src.speech_type_;
+  vad_activity_ = src.vad_activity_;
+  num_channels_ = src.num_channels_;
+  channel_layout_ = src.channel_layout_;
+  absolute_capture_timestamp_ms_ = src.absolute_capture_timestamp_ms();
+
+  const size_t length = samples_per_channel_ * num_channels_;
+  RTC_CHECK_LE(length, AudioFrame::kMaxDataSizeSamples);
+  muted_ = true;
+  if (!src.muted()) {
+    EnsureCapacity(length);
+    memcpy(data_, src.data(), sizeof(int16_t) * length);
+    muted_ = false;
+  }
+}
+
+void PooledAudioFrame::CopyTo(AudioFrame* dst) const {
+  RTC_DCHECK(dst);
+  dst->UpdateFrame(timestamp_, muted_ ? nullptr : data_, samples_per_channel_,
+                   sample_rate_hz_, speech_type_, vad_activity_,
+                   num_channels_);
+  dst->elapsed_time_ms_ = elapsed_time_ms_;
+  dst->ntp_time_ms_ = ntp_time_ms_;
+  dst->packet_infos_ = packet_infos_;
+  dst->channel_layout_ = channel_layout_;
+  if (absolute_capture_timestamp_ms_) {
+    dst->set_absolute_capture_timestamp_ms(*absolute_capture_timestamp_ms_);
+  }
+}
+
+void PooledAudioFrame::UpdateProfileTimeStamp() {
+  profile_timestamp_ms_ = rtc::TimeMillis();
+}
+
+int64_t PooledAudioFrame::ElapsedProfileTimeMs() const {
+  if (profile_timestamp_ms_ == 0) {
+    // Profiling has not been activated.
+    return -1;
+  }
+  return rtc::TimeSince(profile_timestamp_ms_);
+}
+
+const int16_t* PooledAudioFrame::data() const {
+  return muted_ ? empty_data() : data_;
+}
+
+int16_t* PooledAudioFrame::mutable_data() {
+  const size_t length = samples_per_channel_ * num_channels_;
+  RTC_CHECK_LE(length, AudioFrame::kMaxDataSizeSamples);
+  EnsureCapacity(length);
+  if (muted_) {
+    memset(data_, 0, sizeof(int16_t) * length);
+    muted_ = false;
+  }
+  return data_;
+}
+
+void PooledAudioFrame::Mute() {
+  muted_ = true;
+}
+
+bool PooledAudioFrame::muted() const {
+  return muted_;
+}
+
+void PooledAudioFrame::EnsureCapacity(size_t num_samples) {
+  if (data_ && num_samples <= capacity_) {
+    return;
+  }
+  AudioSamplePool* pool = AudioSamplePool::Get();
+  int16_t* data = pool->Acquire(num_samples);
+  if (data_) {
+    if (!muted_) {
+      memcpy(data, data_, sizeof(int16_t) * capacity_);
+    }
+    pool->Release(data_, capacity_);
+  }
+  data_ = data;
+  capacity_ = AudioSamplePool::CapacityFor(num_samples);
+}
+
+// static
+const int16_t* PooledAudioFrame::empty_data() {
+  static int16_t* null_data = new int16_t[AudioFrame::kMaxDataSizeSamples]();
+  return &null_data[0];
+}
+
+}  // namespace webrtc
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_AUDIO_POOLED_AUDIO_FRAME_H_
+#define API_AUDIO_POOLED_AUDIO_FRAME_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "absl/types/optional.h"
+#include "api/audio/audio_frame.h"
+#include "api/audio/channel_layout.h"
+#include "api/rtp_packet_infos.h"
+
+namespace webrtc {
+
+/* A variant of AudioFrame whose samples live in a right-sized buffer drawn
+ * from AudioSamplePool, instead of an embedded kMaxDataSizeSamples array.
+ *
+ * A 10 ms 16 kHz mono frame thus holds a 256 sample buffer rather than 7680,
+ * copies and mute zeroing only touch the samples in use, and moves swap a
+ * pointer.
+ *
+ * The accessors match AudioFrame, with one difference: the buffer returned by
+ * mutable_data() holds max_16bit_samples() samples, which is only guaranteed
+ * to cover samples_per_channel_ * num_channels_ as set when mutable_data() was
+ * called. Set the frame size, or use UpdateFrame(), before writing samples.
+ */
+class PooledAudioFrame {
+ public:
+  using VADActivity = AudioFrame::VADActivity;
+  using SpeechType = AudioFrame::SpeechType;
+
+  PooledAudioFrame();
+  ~PooledAudioFrame();
+  PooledAudioFrame(PooledAudioFrame&& other);
+  PooledAudioFrame& operator=(PooledAudioFrame&& other);
+  PooledAudioFrame(const PooledAudioFrame&) = delete;
+  PooledAudioFrame& operator=(const PooledAudioFrame&) = delete;
+
+  friend void swap(PooledAudioFrame& a, PooledAudioFrame& b);
+
+  // Resets all members to their default state. The sample buffer is kept for
+  // reuse.
+  void Reset();
+  // Same as Reset(), but leaves mute state unchanged.
+  void ResetWithoutMuting();
+
+  void UpdateFrame(uint32_t timestamp,
+                   const int16_t* data,
+                   size_t samples_per_channel,
+                   int sample_rate_hz,
+                   SpeechType speech_type,
+                   VADActivity vad_activity,
+                   size_t num_channels = 1);
+
+  void CopyFrom(const PooledAudioFrame& src);
+  // Conversions to and from AudioFrame, copying only the samples in use.
+  void CopyFrom(const AudioFrame& src);
+  void CopyTo(AudioFrame* dst) const;
+
+  void UpdateProfileTimeStamp();
+  int64_t ElapsedProfileTimeMs() const;
+
+  // data() returns a zeroed static buffer if the frame is muted.
+  // mutable_data() always returns a non-static buffer large enough for the
+  // current frame size; the first call after muting zeros the samples in use
+  // and marks the frame unmuted.
+  const int16_t* data() const;
+  int16_t* mutable_data();
+
+  void Mute();
+  // Frame is muted by default.
+  bool muted() const;
+
+  size_t max_16bit_samples() const { return capacity_; }
+  size_t samples_per_channel() const { return samples_per_channel_; }
+  size_t num_channels() const { return num_channels_; }
+  ChannelLayout channel_layout() const { return channel_layout_; }
+  int sample_rate_hz() const { return sample_rate_hz_; }
+
+  void set_absolute_capture_timestamp_ms(
+      int64_t absolute_capture_time_stamp_ms) {
+    absolute_capture_timestamp_ms_ = absolute_capture_time_stamp_ms;
+  }
+
+  absl::optional<int64_t> absolute_capture_timestamp_ms() const {
+    return absolute_capture_timestamp_ms_;
+  }
+
+  // See AudioFrame for the meaning of these members.
+  uint32_t timestamp_ = 0;
+  int64_t elapsed_time_ms_ = -1;
+  int64_t ntp_time_ms_ = -1;
+  size_t samples_per_channel_ = 0;
+  int sample_rate_hz_ = 0;
+  size_t num_channels_ = 0;
+  ChannelLayout channel_layout_ = CHANNEL_LAYOUT_NONE;
+  SpeechType speech_type_ = AudioFrame::kUndefined;
+  VADActivity vad_activity_ = AudioFrame::kVadUnknown;
+  int64_t profile_timestamp_ms_ = 0;
+  RtpPacketInfos packet_infos_;
+
+ private:
+  static const int16_t* empty_data();
+
+  // Makes |data_| hold at least |num_samples|, keeping its contents.
+  void EnsureCapacity(size_t num_samples);
+
+  int16_t* data_ = nullptr;
+  size_t capacity_ = 0;
+  bool muted_ = true;
+  absl::optional<int64_t> absolute_capture_timestamp_ms_;
+};
+
+}  // namespace webrtc
+
+#endif  // API_AUDIO_POOLED_AUDIO_FRAME_H_
@@ -0,0 +1,130 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "api/audio/audio_frame.h"
+#include "api/audio/pooled_audio_frame.h"
+#include "benchmark/benchmark.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+namespace {
+
+// Arguments: samples per channel, number of channels. The cases are 10 ms
+// frames as seen by APM (16 and 48 kHz mono) and by the mixer (48 kHz
+// stereo).
+void FrameSizes(benchmark::internal::Benchmark* b) {
+  b->Args({160, 1})->Args({480, 1})->Args({480, 2});
+}
+
+std::vector<int16_t> CreateSamples(const benchmark::State& state) {
+  return std::vector<int16_t>(state.range(0) * state.range(1), 1000);
+}
+
+template <typename Frame>
+void FillFrame(const benchmark::State& state,
+               const std::vector<int16_t>& samples,
+               Frame* frame) {
+  frame->UpdateFrame(0, samples.data(), state.range(0), 48000,
+                     AudioFrame::kNormalSpeech, AudioFrame::kVadActive,
+                     state.range(1));
+}
+
+template <typename Frame>
+void BM_CopyFrom(benchmark::State& state) {
+  Frame src;
+  FillFrame(state, CreateSamples(state), &src);
+  Frame dst;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    dst.CopyFrom(src);
+    benchmark::DoNotOptimize(dst.data());
+  }
+}
+
+// AudioFrame has no move; swap() is the cheapest way to hand it over.
+void BM_AudioFrameSwap(benchmark::State& state) {
+  AudioFrame a;
+  AudioFrame b;
+  FillFrame(state, CreateSamples(state), &a);
+  FillFrame(state, CreateSamples(state), &b);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    swap(a, b);
+    benchmark::DoNotOptimize(a.data());
+  }
+}
+
+void BM_PooledAudioFrameMove(benchmark::State& state) {
+  PooledAudioFrame a;
+  FillFrame(state, CreateSamples(state), &a);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    PooledAudioFrame b(std::move(a));
+    a = std::move(b);
+    benchmark::DoNotOptimize(a.data());
+  }
+}
+
+// Muting and then writing a frame zeroes its buffer.
+template <typename Frame>
+void BM_MuteAndWrite(benchmark::State& state) {
+  Frame frame;
+  FillFrame(state, CreateSamples(state), &frame);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    frame.Mute();
+    frame.mutable_data()[0] = 1;
+    benchmark::DoNotOptimize(frame.data());
+  }
+}
+
+// Allocating, filling and freeing a frame, as done for queued frames.
+template <typename Frame>
+void BM_Allocate(benchmark::State& state) {
+  const std::vector<int16_t> samples = CreateSamples(state);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    auto frame = std::make_unique<Frame>();
+    FillFrame(state, samples, frame.get());
+    benchmark::DoNotOptimize(frame->data());
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_CopyFrom, AudioFrame)->Apply(FrameSizes);
+BENCHMARK_TEMPLATE(BM_CopyFrom, PooledAudioFrame)->Apply(FrameSizes);
+BENCHMARK(BM_AudioFrameSwap)->Apply(FrameSizes);
+BENCHMARK(BM_PooledAudioFrameMove)->Apply(FrameSizes);
+BENCHMARK_TEMPLATE(BM_MuteAndWrite, AudioFrame)->Apply(FrameSizes);
+BENCHMARK_TEMPLATE(BM_MuteAndWrite, PooledAudioFrame)->Apply(FrameSizes);
+BENCHMARK_TEMPLATE(BM_Allocate, AudioFrame)->Apply(FrameSizes);
+BENCHMARK_TEMPLATE(BM_Allocate, PooledAudioFrame)->Apply(FrameSizes);
+
+}  // namespace
+}  // namespace webrtc
+
+/* Results, x86-64, times in ns:
+
+sizeof(AudioFrame) is 15464 bytes. sizeof(PooledAudioFrame) is 120 bytes
+plus a 256, 512 or 1024 sample buffer for the three cases, i.e. 632, 1144
+and 2168 bytes in total.
+
+                                  160/1   480/1   480/2
+BM_CopyFrom<AudioFrame>            12.0    17.7    28.7
+BM_CopyFrom<PooledAudioFrame>      14.6    17.4    26.3
+BM_AudioFrameSwap                   157     470     820
+BM_PooledAudioFrameMove (x2)       39.6    29.9    47.0
+BM_MuteAndWrite<AudioFrame>         127     146     119
+BM_MuteAndWrite<PooledAudioFrame>  10.1    15.4    23.8
+BM_Allocate<AudioFrame>            55.1    54.3    51.9
+BM_Allocate<PooledAudioFrame>      61.9    59.4    88.2
+*/
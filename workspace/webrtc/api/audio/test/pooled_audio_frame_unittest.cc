@@ -0,0 +1,236 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/audio/pooled_audio_frame.h"
+
+#include <stdint.h>
+#include <string.h>  // memcmp
+
+#include <utility>
+#include <vector>
+
+#include "api/audio/audio_sample_pool.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+bool AllSamplesAre(int16_t sample, const PooledAudioFrame& frame) {
+  const int16_t* frame_data = frame.data();
+  for (size_t i = 0; i < frame.samples_per_channel() * frame.num_channels();
+       i++) {
+    if (frame_data[i] != sample) {
+      return false;
+    }
+  }
+  return true;
+}
+
+constexpr uint32_t kTimestamp = 27;
+constexpr int kSampleRateHz = 16000;
+constexpr size_t kNumChannelsMono = 1;
+constexpr size_t kNumChannelsStereo = 2;
+constexpr size_t kSamplesPerChannel = kSampleRateHz / 100;
+
+}  // namespace
+
+TEST(AudioSamplePoolTest, CapacityIsNextSizeClass) {
+  EXPECT_EQ(128u, AudioSamplePool::CapacityFor(0));
+  EXPECT_EQ(128u, AudioSamplePool::CapacityFor(128));
+  EXPECT_EQ(256u, AudioSamplePool::CapacityFor(129));
+  EXPECT_EQ(512u, AudioSamplePool::CapacityFor(480));
+  EXPECT_EQ(8192u,
+            AudioSamplePool::CapacityFor(AudioFrame::kMaxDataSizeSamples));
+}
+
+TEST(AudioSamplePoolTest, ReusesReleasedBuffers) {
+  AudioSamplePool pool;
+  int16_t* buffer = pool.Acquire(160);
+  EXPECT_EQ(0u, pool.NumFreeBuffers());
+  pool.Release(buffer, 160);
+  EXPECT_EQ(1u, pool.NumFreeBuffers());
+  // Any size in the same class gets the buffer back.
+  EXPECT_EQ(buffer, pool.Acquire(256));
+  EXPECT_EQ(0u, pool.NumFreeBuffers());
+  pool.Release(buffer, 256);
+}
+
+TEST(AudioSamplePoolTest, FreesBuffersBeyondSlots) {
+  AudioSamplePool pool;
+  std::vector<int16_t*> buffers;
+  for (size_t i = 0; i < AudioSamplePool::kSlotsPerClass + 3; ++i) {
+    buffers.push_back(pool.Acquire(480));
+  }
+  for (int16_t* buffer : buffers) {
+    pool.Release(buffer, 480);
+  }
+  EXPECT_EQ(AudioSamplePool::kSlotsPerClass, pool.NumFreeBuffers());
+}
+
+TEST(PooledAudioFrameTest, FrameStartsMutedAndEmpty) {
+  PooledAudioFrame frame;
+  EXPECT_TRUE(frame.muted());
+  EXPECT_EQ(0u, frame.max_16bit_samples());
+}
+
+TEST(PooledAudioFrameTest, UnmutedFrameIsInitiallyZeroed) {
+  PooledAudioFrame frame;
+  frame.UpdateFrame(kTimestamp, nullptr /* data */, kSamplesPerChannel,
+                    kSampleRateHz, AudioFrame::kPLC, AudioFrame::kVadActive,
+                    kNumChannelsStereo);
+  frame.mutable_data();
+  EXPECT_FALSE(frame.muted());
+  EXPECT_TRUE(AllSamplesAre(0, frame));
+}
+
+TEST(PooledAudioFrameTest, StorageIsRightSized) {
+  PooledAudioFrame frame;
+  int16_t samples[kNumChannelsMono * kSamplesPerChannel] = {17};
+  frame.UpdateFrame(kTimestamp, samples, kSamplesPerChannel, kSampleRateHz,
+                    AudioFrame::kPLC, AudioFrame::kVadActive, kNumChannelsMono);
+  EXPECT_EQ(256u, frame.max_16bit_samples());
+  EXPECT_FALSE(frame.muted());
+  EXPECT_EQ(0, memcmp(samples, frame.data(), sizeof(samples)));
+}
+
+TEST(PooledAudioFrameTest, MutedFrameBufferIsZeroed) {
+  PooledAudioFrame frame;
+  frame.UpdateFrame(kTimestamp, nullptr /* data */, kSamplesPerChannel,
+                    kSampleRateHz, AudioFrame::kPLC, AudioFrame::kVadActive,
+                    kNumChannelsMono);
+  int16_t* frame_data = frame.mutable_data();
+  for (size_t i = 0; i < frame.max_16bit_samples(); i++) {
+    frame_data[i] = 17;
+  }
+  ASSERT_TRUE(AllSamplesAre(17, frame));
+  frame.Mute();
+  EXPECT_TRUE(frame.muted());
+  EXPECT_TRUE(AllSamplesAre(0, frame));
+  frame.mutable_data();
+  EXPECT_TRUE(AllSamplesAre(0, frame));
+}
+
+TEST(PooledAudioFrameTest, GrowingKeepsSamples) {
+  PooledAudioFrame frame;
+  int16_t samples[kNumChannelsMono * kSamplesPerChannel];
+  for (size_t i = 0; i < kSamplesPerChannel; ++i) {
+    samples[i] = i;
+  }
+  frame.UpdateFrame(kTimestamp, samples, kSamplesPerChannel, kSampleRateHz,
+                    AudioFrame::kPLC, AudioFrame::kVadActive, kNumChannelsMono);
+  frame.samples_per_channel_ = 4 * kSamplesPerChannel;
+  const int16_t* frame_data = frame.mutable_data();
+  EXPECT_EQ(1024u, frame.max_16bit_samples());
+  EXPECT_EQ(0, memcmp(samples, frame_data, sizeof(samples)));
+}
+
+TEST(PooledAudioFrameTest, FullFrameReturnsBufferToPool) {
+  const size_t free_buffers = AudioSamplePool::Get()->NumFreeBuffers();
+  {
+    PooledAudioFrame frame;
+    frame.UpdateFrame(kTimestamp, nullptr /* data */,
+                      AudioFrame::kMaxDataSizeSamples / kNumChannelsStereo,
+                      kSampleRateHz, AudioFrame::kPLC, AudioFrame::kVadActive,
+                      kNumChannelsStereo);
+    int16_t* frame_data = frame.mutable_data();
+    for (size_t i = 0; i < AudioFrame::kMaxDataSizeSamples; i++) {
+      frame_data[i] = 17;
+    }
+    EXPECT_EQ(8192u, frame.max_16bit_samples());
+    EXPECT_TRUE(AllSamplesAre(17, frame));
+  }
+  EXPECT_EQ(free_buffers + 1, AudioSamplePool::Get()->NumFreeBuffers());
+}
+
+TEST(PooledAudioFrameTest, CopyFrom) {
+  PooledAudioFrame frame1;
+  PooledAudioFrame frame2;
+
+  int16_t samples[kNumChannelsMono * kSamplesPerChannel] = {17};
+  frame2.UpdateFrame(kTimestamp, samples, kSamplesPerChannel, kSampleRateHz,
+                     AudioFrame::kPLC, AudioFrame::kVadActive,
+                     kNumChannelsMono);
+  frame1.CopyFrom(frame2);
+
+  EXPECT_EQ(frame2.timestamp_, frame1.timestamp_);
+  EXPECT_EQ(frame2.samples_per_channel_, frame1.samples_per_channel_);
+  EXPECT_EQ(frame2.sample_rate_hz_, frame1.sample_rate_hz_);
+  EXPECT_EQ(frame2.speech_type_, frame1.speech_type_);
+  EXPECT_EQ(frame2.vad_activity_, frame1.vad_activity_);
+  EXPECT_EQ(frame2.num_channels_, frame1.num_channels_);
+
+  EXPECT_EQ(frame2.muted(), frame1.muted());
+  EXPECT_EQ(0, memcmp(frame2.data(), frame1.data(), sizeof(samples)));
+
+  frame2.UpdateFrame(kTimestamp, nullptr /* data */, kSamplesPerChannel,
+                     kSampleRateHz, AudioFrame::kPLC, AudioFrame::kVadActive,
+                     kNumChannelsMono);
+  frame1.CopyFrom(frame2);
+
+  EXPECT_EQ(frame2.muted(), frame1.muted());
+  EXPECT_EQ(0, memcmp(frame2.data(), frame1.data(), sizeof(samples)));
+}
+
+TEST(PooledAudioFrameTest, MoveTakesBuffer) {
+  PooledAudioFrame frame1;
+  int16_t samples[kNumChannelsStereo * kSamplesPerChannel] = {17, 18};
+  frame1.UpdateFrame(kTimestamp, samples, kSamplesPerChannel, kSampleRateHz,
+                     AudioFrame::kPLC, AudioFrame::kVadActive,
+                     kNumChannelsStereo);
+  const int16_t* buffer = frame1.data();
+
+  PooledAudioFrame frame2(std::move(frame1));
+  EXPECT_EQ(buffer, frame2.data());
+  EXPECT_EQ(kTimestamp, frame2.timestamp_);
+  EXPECT_EQ(kNumChannelsStereo, frame2.num_channels());
+
+  PooledAudioFrame frame3;
+  frame3 = std::move(frame2);
+  EXPECT_EQ(buffer, frame3.data());
+  EXPECT_EQ(0, memcmp(samples, frame3.data(), sizeof(samples)));
+}
+
+TEST(PooledAudioFrameTest, ConvertsToAndFromAudioFrame) {
+  AudioFrame audio_frame;
+  int16_t samples[kNumChannelsStereo * kSamplesPerChannel];
+  for (size_t i = 0; i < kNumChannelsStereo * kSamplesPerChannel; ++i) {
+    samples[i] = 1000 + i;
+  }
+  audio_frame.UpdateFrame(kTimestamp, samples, kSamplesPerChannel,
+                          kSampleRateHz, AudioFrame::kNormalSpeech,
+                          AudioFrame::kVadPassive, kNumChannelsStereo);
+  audio_frame.set_absolute_capture_timestamp_ms(12345678);
+
+  PooledAudioFrame frame;
+  frame.CopyFrom(audio_frame);
+  EXPECT_EQ(512u, frame.max_16bit_samples());
+  EXPECT_EQ(kSampleRateHz, frame.sample_rate_hz());
+  EXPECT_EQ(CHANNEL_LAYOUT_STEREO, frame.channel_layout());
+  EXPECT_EQ(12345678, frame.absolute_capture_timestamp_ms());
+  EXPECT_EQ(0, memcmp(samples, frame.data(), sizeof(samples)));
+
+  AudioFrame copy;
+  frame.CopyTo(&copy);
+  EXPECT_EQ(kTimestamp, copy.timestamp_);
+  EXPECT_EQ(kSamplesPerChannel, copy.samples_per_channel());
+  EXPECT_EQ(kNumChannelsStereo, copy.num_channels());
+  EXPECT_EQ(AudioFrame::kNormalSpeech, copy.speech_type_);
+  EXPECT_EQ(AudioFrame::kVadPassive, copy.vad_activity_);
+  EXPECT_EQ(12345678, copy.absolute_capture_timestamp_ms());
+  EXPECT_FALSE(copy.muted());
+  EXPECT_EQ(0, memcmp(samples, copy.data(), sizeof(samples)));
+
+  frame.Mute();
+  frame.CopyTo(&copy);
+  EXPECT_TRUE(copy.muted());
+}
+
+}  // namespace webrtc
@@ -13,12 +13,13 @@
 #include <string.h>
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <utility>
 
+#include "audio/utility/audio_frame_operations_kernels.h"
 #include "common_audio/include/audio_util.h"
 #include "rtc_base/checks.h"
-#include "rtc_base/numerics/safe_conversions.h"
 
 namespace webrtc {
 namespace {
@@ -27,6 +28,22 @@ namespace {
 const size_t kMuteFadeFrames = 128;
 const float kMuteFadeInc = 1.0f / kMuteFadeFrames;
 
+void DownmixToMono(const int16_t* src_audio,
+                   size_t src_channels,
+                   size_t samples_per_channel,
+                   int16_t* dst_audio) {
+  if (src_channels == 2) {
+    GetAudioFrameOperationsKernels().stereo_to_mono(
+        src_audio, samples_per_channel, dst_audio);
+  } else if (src_channels == 4) {
+    GetAudioFrameOperationsKernels().quad_to_mono(
+        src_audio, samples_per_channel, dst_audio);
+  } else {
+    DownmixInterleavedToMono(src_audio, samples_per_channel, src_channels,
+                             dst_audio);
+  }
+}
+
 }  // namespace
 
 void AudioFrameOperations::Add(const AudioFrame& frame_to_add,
@@ -63,11 +80,7 @@ void AudioFrameOperations::Add(const AudioFrame& frame_to_add,
     if (no_previous_data) {
       std::copy(in_data, in_data + length, out_data);
     } else {
-      for (size_t i = 0; i < length; i++) {
-        const int32_t wrap_guard = static_cast<int32_t>(out_data[i]) +
-                                   static_cast<int32_t>(in_data[i]);
-        out_data[i] = rtc::saturated_cast<int16_t>(wrap_guard);
-      }
+      GetAudioFrameOperationsKernels().add(in_data, length, out_data);
     }
   }
 }
@@ -91,13 +104,8 @@ int AudioFrameOperations::StereoToMono(AudioFrame* frame) {
 void AudioFrameOperations::QuadToStereo(const int16_t* src_audio,
                                         size_t samples_per_channel,
                                         int16_t* dst_audio) {
-  for (size_t i = 0; i < samples_per_channel; i++) {
-    dst_audio[i * 2] =
-        (static_cast<int32_t>(src_audio[4 * i]) + src_audio[4 * i + 1]) >> 1;
-    dst_audio[i * 2 + 1] =
-        (static_cast<int32_t>(src_audio[4 * i + 2]) + src_audio[4 * i + 3]) >>
-        1;
-  }
+  GetAudioFrameOperationsKernels().quad_to_stereo(
+      src_audio, samples_per_channel, dst_audio);
 }
 
 int AudioFrameOperations::QuadToStereo(AudioFrame* frame) {
@@ -123,8 +131,7 @@ void AudioFrameOperations::DownmixChannels(const int16_t* src_audio,
                                            size_t dst_channels,
                                            int16_t* dst_audio) {
   if (src_channels > 1 && dst_channels == 1) {
-    DownmixInterleavedToMono(src_audio, samples_per_channel, src_channels,
-                             dst_audio);
+    DownmixToMono(src_audio, src_channels, samples_per_channel, dst_audio);
     return;
   } else if (src_channels == 4 && dst_channels == 2) {
     QuadToStereo(src_audio, samples_per_channel, dst_audio);
@@ -141,8 +148,8 @@ void AudioFrameOperations::DownmixChannels(size_t dst_channels,
                 AudioFrame::kMaxDataSizeSamples);
   if (frame->num_channels_ > 1 && dst_channels == 1) {
     if (!frame->muted()) {
-      DownmixInterleavedToMono(frame->data(), frame->samples_per_channel_,
-                               frame->num_channels_, frame->mutable_data());
+      DownmixToMono(frame->data(), frame->num_channels_,
+                    frame->samples_per_channel_, frame->mutable_data());
     }
     frame->num_channels_ = 1;
   } else if (frame->num_channels_ == 4 && dst_channels == 2) {
@@ -166,14 +173,17 @@ void AudioFrameOperations::UpmixChannels(size_t target_number_of_channels,
     return;
   }
 
-  if (!frame->muted()) {
+  if (!frame->muted() && target_number_of_channels == 2) {
+    GetAudioFrameOperationsKernels().mono_to_stereo(
+        frame->data(), frame->samples_per_channel_, frame->mutable_data());
+  } else if (!frame->muted()) {
     // Up-mixing done in place. Going backwards through the frame ensure nothing
     // is irrevocably overwritten.
+    int16_t* frame_data = frame->mutable_data();
     for (int i = frame->samples_per_channel_ - 1; i >= 0; i--) {
-      for (size_t j = 0; j < target_number_of_channels; ++j) {
-        frame->mutable_data()[target_number_of_channels * i + j] =
-            frame->data()[i];
-      }
+      const int16_t sample = frame_data[i];
+      std::fill_n(&frame_data[target_number_of_channels * i],
+                  target_number_of_channels, sample);
     }
   }
   frame->num_channels_ = target_number_of_channels;
@@ -234,15 +244,16 @@ void AudioFrameOperations::Mute(AudioFrame* frame,
     }
 
     // Perform fade.
-    int16_t* frame_data = frame->mutable_data();
-    size_t channels = frame->num_channels_;
-    for (size_t j = 0; j < channels; ++j) {
-      float g = start_g;
-      for (size_t i = start * channels; i < end * channels; i += channels) {
-        g += inc;
-        frame_data[i + j] *= g;
-      }
+    std::array<float, kMuteFadeFrames> gains;
+    float g = start_g;
+    for (size_t i = 0; i < end - start; ++i) {
+      g += inc;
+      gains[i] = g;
     }
+    const size_t channels = frame->num_channels_;
+    GetAudioFrameOperationsKernels().apply_gains(
+        gains.data(), end - start, channels,
+        &frame->mutable_data()[start * channels]);
   }
 }
 
@@ -284,11 +295,9 @@ int AudioFrameOperations::ScaleWithSat(float scale, AudioFrame* frame) {
     return 0;
   }
 
-  int16_t* frame_data = frame->mutable_data();
-  for (size_t i = 0; i < frame->samples_per_channel_ * frame->num_channels_;
-       i++) {
-    frame_data[i] = rtc::saturated_cast<int16_t>(scale * frame_data[i]);
-  }
+  GetAudioFrameOperationsKernels().scale_with_sat(
+      scale, frame->samples_per_channel_ * frame->num_channels_,
+      frame->mutable_data());
   return 0;
 }
 }  // namespace webrtc
@@ -0,0 +1,204 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "audio/utility/audio_frame_operations_kernels.h"
+#include "rtc_base/numerics/safe_conversions.h"
+
+namespace webrtc {
+namespace {
+
+__m256i Load(const int16_t* src) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+}
+
+void Store(__m256i x, int16_t* dst) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), x);
+}
+
+// Sums of adjacent pairs of samples.
+__m256i SumPairs(__m256i x) {
+  return _mm256_madd_epi16(x, _mm256_set1_epi16(1));
+}
+
+// Divides by 2^kShift, rounding toward zero like integer division.
+template <int kShift>
+__m256i DivideByPowerOfTwo(__m256i x) {
+  const __m256i bias =
+      _mm256_srli_epi32(_mm256_srai_epi32(x, 31), 32 - kShift);
+  return _mm256_srai_epi32(_mm256_add_epi32(x, bias), kShift);
+}
+
+// Packs with saturation, keeping the order of the values across the lanes.
+__m256i Pack(__m256i low, __m256i high) {
+  return _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high),
+                                  _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+// Truncates and saturates like rtc::saturated_cast<int16_t>().
+__m256i ToS16(__m256 low, __m256 high) {
+  const __m256 max = _mm256_set1_ps(32767.f);
+  const __m256 min = _mm256_set1_ps(-32768.f);
+  return Pack(_mm256_cvttps_epi32(_mm256_max_ps(_mm256_min_ps(low, max), min)),
+              _mm256_cvttps_epi32(
+                  _mm256_max_ps(_mm256_min_ps(high, max), min)));
+}
+
+__m256 LowToFloat(__m256i x) {
+  return _mm256_cvtepi32_ps(
+      _mm256_cvtepi16_epi32(_mm256_castsi256_si128(x)));
+}
+
+__m256 HighToFloat(__m256i x) {
+  return _mm256_cvtepi32_ps(
+      _mm256_cvtepi16_epi32(_mm256_extracti128_si256(x, 1)));
+}
+
+void AddAvx2(const int16_t* src, size_t size, int16_t* dst) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    Store(_mm256_adds_epi16(Load(&dst[i]), Load(&src[i])), &dst[i]);
+  }
+  for (; i < size; ++i) {
+    dst[i] = rtc::saturated_cast<int16_t>(static_cast<int32_t>(dst[i]) +
+                                          static_cast<int32_t>(src[i]));
+  }
+}
+
+void StereoToMonoAvx2(const int16_t* src,
+                      size_t samples_per_channel,
+                      int16_t* dst) {
+  size_t i = 0;
+  for (; i + 16 <= samples_per_channel; i += 16) {
+    const __m256i low = DivideByPowerOfTwo<1>(SumPairs(Load(&src[2 * i])));
+    const __m256i high =
+        DivideByPowerOfTwo<1>(SumPairs(Load(&src[2 * i + 16])));
+    Store(Pack(low, high), &dst[i]);
+  }
+  for (; i < samples_per_channel; ++i) {
+    dst[i] = (static_cast<int32_t>(src[2 * i]) + src[2 * i + 1]) / 2;
+  }
+}
+
+void QuadToMonoAvx2(const int16_t* src,
+                    size_t samples_per_channel,
+                    int16_t* dst) {
+  size_t i = 0;
+  for (; i + 16 <= samples_per_channel; i += 16) {
+    __m256i sums[2];
+    for (int k = 0; k < 2; ++k) {
+      // The horizontal add gives the sums of samples 0, 1, 4, 5, 2, 3, 6, 7.
+      const __m256i sum =
+          _mm256_hadd_epi32(SumPairs(Load(&src[4 * i + 32 * k])),
+                            SumPairs(Load(&src[4 * i + 32 * k + 16])));
+      sums[k] = DivideByPowerOfTwo<2>(
+          _mm256_permute4x64_epi64(sum, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    Store(Pack(sums[0], sums[1]), &dst[i]);
+  }
+  for (; i < samples_per_channel; ++i) {
+    dst[i] = (static_cast<int32_t>(src[4 * i]) + src[4 * i + 1] +
+              src[4 * i + 2] + src[4 * i + 3]) /
+             4;
+  }
+}
+
+void QuadToStereoAvx2(const int16_t* src,
+                      size_t samples_per_channel,
+                      int16_t* dst) {
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    const __m256i low = _mm256_srai_epi32(SumPairs(Load(&src[4 * i])), 1);
+    const __m256i high =
+        _mm256_srai_epi32(SumPairs(Load(&src[4 * i + 16])), 1);
+    Store(Pack(low, high), &dst[2 * i]);
+  }
+  for (; i < samples_per_channel; i++) {
+    dst[i * 2] = (static_cast<int32_t>(src[4 * i]) + src[4 * i + 1]) >> 1;
+    dst[i * 2 + 1] =
+        (static_cast<int32_t>(src[4 * i + 2]) + src[4 * i + 3]) >> 1;
+  }
+}
+
+void MonoToStereoAvx2(const int16_t* src,
+                      size_t samples_per_channel,
+                      int16_t* dst) {
+  // Going backwards through the frame allows |dst| to be |src|.
+  size_t i = samples_per_channel;
+  for (; i % 16 != 0; --i) {
+    const int16_t sample = src[i - 1];
+    dst[2 * (i - 1)] = sample;
+    dst[2 * (i - 1) + 1] = sample;
+  }
+  for (; i > 0; i -= 16) {
+    const __m256i x = Load(&src[i - 16]);
+    // Samples 0-3 and 8-11, and 4-7 and 12-15, duplicated.
+    const __m256i low = _mm256_unpacklo_epi16(x, x);
+    const __m256i high = _mm256_unpackhi_epi16(x, x);
+    Store(_mm256_permute2x128_si256(low, high, 0x20), &dst[2 * (i - 16)]);
+    Store(_mm256_permute2x128_si256(low, high, 0x31), &dst[2 * (i - 16) + 16]);
+  }
+}
+
+void ScaleWithSatAvx2(float scale, size_t size, int16_t* data) {
+  const __m256 scale8 = _mm256_set1_ps(scale);
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m256i x = Load(&data[i]);
+    Store(ToS16(_mm256_mul_ps(scale8, LowToFloat(x)),
+                _mm256_mul_ps(scale8, HighToFloat(x))),
+          &data[i]);
+  }
+  for (; i < size; ++i) {
+    data[i] = rtc::saturated_cast<int16_t>(scale * data[i]);
+  }
+}
+
+void ApplyGainsAvx2(const float* gains,
+                    size_t samples_per_channel,
+                    size_t num_channels,
+                    int16_t* data) {
+  size_t i = 0;
+  if (num_channels == 1) {
+    for (; i + 16 <= samples_per_channel; i += 16) {
+      const __m256i x = Load(&data[i]);
+      Store(ToS16(_mm256_mul_ps(LowToFloat(x), _mm256_loadu_ps(&gains[i])),
+                  _mm256_mul_ps(HighToFloat(x),
+                                _mm256_loadu_ps(&gains[i + 8]))),
+            &data[i]);
+    }
+  } else if (num_channels == 2) {
+    const __m256i low_index = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i high_index = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+    for (; i + 8 <= samples_per_channel; i += 8) {
+      const __m256i x = Load(&data[2 * i]);
+      const __m256 g = _mm256_loadu_ps(&gains[i]);
+      Store(ToS16(_mm256_mul_ps(LowToFloat(x),
+                                _mm256_permutevar8x32_ps(g, low_index)),
+                  _mm256_mul_ps(HighToFloat(x),
+                                _mm256_permutevar8x32_ps(g, high_index))),
+            &data[2 * i]);
+    }
+  }
+  for (; i < samples_per_channel; ++i) {
+    for (size_t ch = 0; ch < num_channels; ++ch) {
+      data[i * num_channels + ch] *= gains[i];
+    }
+  }
+}
+
+}  // namespace
+
+const AudioFrameOperationsKernels kAudioFrameOperationsKernelsAvx2 = {
+    AddAvx2,          StereoToMonoAvx2, QuadToMonoAvx2, QuadToStereoAvx2,
+    MonoToStereoAvx2, ScaleWithSatAvx2, ApplyGainsAvx2};
+
+}  // namespace webrtc
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio/utility/audio_frame_operations_kernels.h"
+
+#include "rtc_base/numerics/safe_conversions.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "system_wrappers/include/cpu_features_wrapper.h"  // kSSE2, WebRtc_G...
+#endif
+
+namespace webrtc {
+namespace {
+
+void AddC(const int16_t* src, size_t size, int16_t* dst) {
+  for (size_t i = 0; i < size; ++i) {
+    dst[i] = rtc::saturated_cast<int16_t>(static_cast<int32_t>(dst[i]) +
+                                          static_cast<int32_t>(src[i]));
+  }
+}
+
+void StereoToMonoC(const int16_t* src,
+                   size_t samples_per_channel,
+                   int16_t* dst) {
+  for (size_t i = 0; i < samples_per_channel; ++i) {
+    dst[i] = (static_cast<int32_t>(src[2 * i]) + src[2 * i + 1]) / 2;
+  }
+}
+
+void QuadToMonoC(const int16_t* src, size_t samples_per_channel, int16_t* dst) {
+  for (size_t i = 0; i < samples_per_channel; ++i) {
+    dst[i] = (static_cast<int32_t>(src[4 * i]) + src[4 * i + 1] +
+              src[4 * i + 2] + src[4 * i + 3]) /
+             4;
+  }
+}
+
+void QuadToStereoC(const int16_t* src,
+                   size_t samples_per_channel,
+                   int16_t* dst) {
+  for (size_t i = 0; i < samples_per_channel; i++) {
+    dst[i * 2] = (static_cast<int32_t>(src[4 * i]) + src[4 * i + 1]) >> 1;
+    dst[i * 2 + 1] =
+        (static_cast<int32_t>(src[4 * i + 2]) + src[4 * i + 3]) >> 1;
+  }
+}
+
+void MonoToStereoC(const int16_t* src,
+                   size_t samples_per_channel,
+                   int16_t* dst) {
+  // Going backwards through the frame allows |dst| to be |src|.
+  for (size_t i = samples_per_channel; i > 0; --i) {
+    const int16_t sample = src[i - 1];
+    dst[2 * (i - 1)] = sample;
+    dst[2 * (i - 1) + 1] = sample;
+  }
+}
+
+void ScaleWithSatC(float scale, size_t size, int16_t* data) {
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = rtc::saturated_cast<int16_t>(scale * data[i]);
+  }
+}
+
+void ApplyGainsC(const float* gains,
+                 size_t samples_per_channel,
+                 size_t num_channels,
+                 int16_t* data) {
+  for (size_t i = 0; i < samples_per_channel; ++i) {
+    for (size_t ch = 0; ch < num_channels; ++ch) {
+      data[i * num_channels + ch] *= gains[i];
+    }
+  }
+}
+
+const AudioFrameOperationsKernels& SelectKernels() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (GetCPUInfo(kAVX2)) {
+    return kAudioFrameOperationsKernelsAvx2;
+  } else if (GetCPUInfo(kSSE2)) {
+    return kAudioFrameOperationsKernelsSse2;
+  }
+  return kAudioFrameOperationsKernelsC;
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  return kAudioFrameOperationsKernelsNeon;
+#else
+  return kAudioFrameOperationsKernelsC;
+#endif
+}
+
+}  // namespace
+
+const AudioFrameOperationsKernels kAudioFrameOperationsKernelsC = {
+    AddC,          StereoToMonoC, QuadToMonoC, QuadToStereoC,
+    MonoToStereoC, ScaleWithSatC, ApplyGainsC};
+
+const AudioFrameOperationsKernels& GetAudioFrameOperationsKernels() {
+  static const AudioFrameOperationsKernels& kernels = SelectKernels();
+  return kernels;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef AUDIO_UTILITY_AUDIO_FRAME_OPERATIONS_KERNELS_H_
+#define AUDIO_UTILITY_AUDIO_FRAME_OPERATIONS_KERNELS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtc_base/system/arch.h"
+
+namespace webrtc {
+
+// The sample loops of AudioFrameOperations, in versions for the instruction
+// sets of the CPU. All versions give exactly the same results. Where |src|
+// and |dst| are both given, they may point to the same buffer.
+struct AudioFrameOperationsKernels {
+  // Adds |src| to |dst|, saturating.
+  void (*add)(const int16_t* src, size_t size, int16_t* dst);
+  // Averages the channels of stereo or 4 channel |src| into mono |dst|,
+  // rounding toward zero.
+  void (*stereo_to_mono)(const int16_t* src,
+                         size_t samples_per_channel,
+                         int16_t* dst);
+  void (*quad_to_mono)(const int16_t* src,
+                       size_t samples_per_channel,
+                       int16_t* dst);
+  // Averages channels 0 and 1, and 2 and 3, of |src| into stereo |dst|,
+  // rounding toward negative infinity.
+  void (*quad_to_stereo)(const int16_t* src,
+                         size_t samples_per_channel,
+                         int16_t* dst);
+  // Duplicates mono |src| into stereo |dst|.
+  void (*mono_to_stereo)(const int16_t* src,
+                         size_t samples_per_channel,
+                         int16_t* dst);
+  // Multiplies |data| by |scale|, truncating and saturating.
+  void (*scale_with_sat)(float scale, size_t size, int16_t* data);
+  // Multiplies every channel of sample |i| of |data| by |gains[i]|,
+  // truncating. The gains must be in [0, 1].
+  void (*apply_gains)(const float* gains,
+                      size_t samples_per_channel,
+                      size_t num_channels,
+                      int16_t* data);
+};
+
+// Returns the fastest kernels the CPU supports, detected on the first call.
+const AudioFrameOperationsKernels& GetAudioFrameOperationsKernels();
+
+extern const AudioFrameOperationsKernels kAudioFrameOperationsKernelsC;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+extern const AudioFrameOperationsKernels kAudioFrameOperationsKernelsSse2;
+extern const AudioFrameOperationsKernels kAudioFrameOperationsKernelsAvx2;
+#endif
+#if defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+extern const AudioFrameOperationsKernels kAudioFrameOperationsKernelsNeon;
+#endif
+
+}  // namespace webrtc
+
+#endif  // AUDIO_UTILITY_AUDIO_FRAME_OPERATIONS_KERNELS_H_
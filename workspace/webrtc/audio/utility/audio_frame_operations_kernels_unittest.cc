@@ -0,0 +1,192 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio/utility/audio_frame_operations_kernels.h"
+
+#include <string>
+#include <vector>
+
+#include "rtc_base/numerics/safe_conversions.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#endif
+
+namespace webrtc {
+namespace {
+
+// Sizes around the vector widths, and common frame sizes.
+constexpr size_t kSamplesPerChannel[] = {0, 1, 7, 8, 9, 15, 16, 17, 160, 480};
+
+struct KernelsParam {
+  const char* name;
+  const AudioFrameOperationsKernels* kernels;
+};
+
+// Returns the kernels the CPU supports.
+std::vector<KernelsParam> SupportedKernels() {
+  std::vector<KernelsParam> kernels = {{"C", &kAudioFrameOperationsKernelsC}};
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (GetCPUInfo(kSSE2) != 0) {
+    kernels.push_back({"Sse2", &kAudioFrameOperationsKernelsSse2});
+  }
+  if (GetCPUInfo(kAVX2) != 0) {
+    kernels.push_back({"Avx2", &kAudioFrameOperationsKernelsAvx2});
+  }
+#endif
+#if defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  kernels.push_back({"Neon", &kAudioFrameOperationsKernelsNeon});
+#endif
+  return kernels;
+}
+
+std::vector<int16_t> RandomSamples(Random* random, size_t size) {
+  std::vector<int16_t> x(size);
+  for (auto& v : x) {
+    v = random->Rand(-32768, 32767);
+  }
+  // Include the extremes, which are where the rounding and saturation differ.
+  if (size >= 2) {
+    x[0] = -32768;
+    x[1] = 32767;
+  }
+  return x;
+}
+
+class AudioFrameOperationsKernelsTest
+    : public ::testing::TestWithParam<KernelsParam> {
+ protected:
+  const AudioFrameOperationsKernels& kernels() const {
+    return *GetParam().kernels;
+  }
+
+  Random random_{42};
+};
+
+TEST_P(AudioFrameOperationsKernelsTest, Add) {
+  for (size_t size : kSamplesPerChannel) {
+    const std::vector<int16_t> src = RandomSamples(&random_, size);
+    std::vector<int16_t> dst = RandomSamples(&random_, size);
+    std::vector<int16_t> expected(size);
+    for (size_t i = 0; i < size; ++i) {
+      expected[i] = rtc::saturated_cast<int16_t>(static_cast<int32_t>(dst[i]) +
+                                                 src[i]);
+    }
+    kernels().add(src.data(), size, dst.data());
+    EXPECT_EQ(expected, dst) << size;
+  }
+}
+
+TEST_P(AudioFrameOperationsKernelsTest, DownmixInPlace) {
+  for (size_t samples_per_channel : kSamplesPerChannel) {
+    const std::vector<int16_t> stereo =
+        RandomSamples(&random_, 2 * samples_per_channel);
+    const std::vector<int16_t> quad =
+        RandomSamples(&random_, 4 * samples_per_channel);
+    std::vector<int16_t> expected_mono_from_stereo(samples_per_channel);
+    std::vector<int16_t> expected_mono_from_quad(samples_per_channel);
+    std::vector<int16_t> expected_stereo_from_quad(2 * samples_per_channel);
+    for (size_t i = 0; i < samples_per_channel; ++i) {
+      expected_mono_from_stereo[i] =
+          (static_cast<int32_t>(stereo[2 * i]) + stereo[2 * i + 1]) / 2;
+      expected_mono_from_quad[i] =
+          (static_cast<int32_t>(quad[4 * i]) + quad[4 * i + 1] +
+           quad[4 * i + 2] + quad[4 * i + 3]) /
+          4;
+      expected_stereo_from_quad[2 * i] =
+          (static_cast<int32_t>(quad[4 * i]) + quad[4 * i + 1]) >> 1;
+      expected_stereo_from_quad[2 * i + 1] =
+          (static_cast<int32_t>(quad[4 * i + 2]) + quad[4 * i + 3]) >> 1;
+    }
+
+    std::vector<int16_t> data = stereo;
+    kernels().stereo_to_mono(data.data(), samples_per_channel, data.data());
+    data.resize(samples_per_channel);
+    EXPECT_EQ(expected_mono_from_stereo, data) << samples_per_channel;
+
+    data = quad;
+    kernels().quad_to_mono(data.data(), samples_per_channel, data.data());
+    data.resize(samples_per_channel);
+    EXPECT_EQ(expected_mono_from_quad, data) << samples_per_channel;
+
+    data = quad;
+    kernels().quad_to_stereo(data.data(), samples_per_channel, data.data());
+    data.resize(2 * samples_per_channel);
+    EXPECT_EQ(expected_stereo_from_quad, data) << samples_per_channel;
+  }
+}
+
+TEST_P(AudioFrameOperationsKernelsTest, MonoToStereoInPlace) {
+  for (size_t samples_per_channel : kSamplesPerChannel) {
+    const std::vector<int16_t> mono =
+        RandomSamples(&random_, samples_per_channel);
+    std::vector<int16_t> expected(2 * samples_per_channel);
+    for (size_t i = 0; i < samples_per_channel; ++i) {
+      expected[2 * i] = mono[i];
+      expected[2 * i + 1] = mono[i];
+    }
+    std::vector<int16_t> data = mono;
+    data.resize(2 * samples_per_channel);
+    kernels().mono_to_stereo(data.data(), samples_per_channel, data.data());
+    EXPECT_EQ(expected, data) << samples_per_channel;
+  }
+}
+
+TEST_P(AudioFrameOperationsKernelsTest, ScaleWithSat) {
+  for (float scale : {0.f, 0.3f, 1.f, 1.7f, -2.5f, 100.f}) {
+    for (size_t size : kSamplesPerChannel) {
+      std::vector<int16_t> data = RandomSamples(&random_, size);
+      std::vector<int16_t> expected(size);
+      for (size_t i = 0; i < size; ++i) {
+        expected[i] = rtc::saturated_cast<int16_t>(scale * data[i]);
+      }
+      kernels().scale_with_sat(scale, size, data.data());
+      EXPECT_EQ(expected, data) << scale << ", " << size;
+    }
+  }
+}
+
+TEST_P(AudioFrameOperationsKernelsTest, ApplyGains) {
+  for (size_t num_channels : {1, 2, 3, 8}) {
+    for (size_t samples_per_channel : kSamplesPerChannel) {
+      // A fade-in, like AudioFrameOperations::Mute() computes it.
+      std::vector<float> gains(samples_per_channel);
+      float g = 0.f;
+      for (float& gain : gains) {
+        g += 1.f / samples_per_channel;
+        gain = g;
+      }
+      std::vector<int16_t> data =
+          RandomSamples(&random_, samples_per_channel * num_channels);
+      std::vector<int16_t> expected = data;
+      for (size_t i = 0; i < samples_per_channel; ++i) {
+        for (size_t ch = 0; ch < num_channels; ++ch) {
+          expected[i * num_channels + ch] *= gains[i];
+        }
+      }
+      kernels().apply_gains(gains.data(), samples_per_channel, num_channels,
+                            data.data());
+      EXPECT_EQ(expected, data) << num_channels << ", " << samples_per_channel;
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AudioFrameOperations,
+    AudioFrameOperationsKernelsTest,
+    ::testing::ValuesIn(SupportedKernels()),
+    [](const ::testing::TestParamInfo<KernelsParam>& info) {
+      return std::string(info.param.name);
+    });
+
+}  // namespace
+}  // namespace webrtc
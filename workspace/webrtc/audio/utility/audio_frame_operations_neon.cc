@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio/utility/audio_frame_operations_kernels.h"
+
+#if defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+
+#include <arm_neon.h>
+
+#include "rtc_base/numerics/safe_conversions.h"
+
+namespace webrtc {
+namespace {
+
+// Divides by 2^kShift, rounding toward zero like integer division.
+template <int kShift>
+int32x4_t DivideByPowerOfTwo(int32x4_t x) {
+  const int32x4_t bias = vreinterpretq_s32_u32(
+      vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(x, 31)), 32 - kShift));
+  return vshrq_n_s32(vaddq_s32(x, bias), kShift);
+}
+
+// Truncates and saturates like rtc::saturated_cast<int16_t>().
+int16x8_t ToS16(float32x4_t low, float32x4_t high) {
+  const float32x4_t max = vdupq_n_f32(32767.f);
+  const float32x4_t min = vdupq_n_f32(-32768.f);
+  return vcombine_s16(
+      vqmovn_s32(vcvtq_s32_f32(vmaxq_f32(vminq_f32(low, max), min))),
+      vqmovn_s32(vcvtq_s32_f32(vmaxq_f32(vminq_f32(high, max), min))));
+}
+
+float32x4_t LowToFloat(int16x8_t x) {
+  return vcvtq_f32_s32(vmovl_s16(vget_low_s16(x)));
+}
+
+float32x4_t HighToFloat(int16x8_t x) {
+  return vcvtq_f32_s32(vmovl_s16(vget_high_s16(x)));
+}
+
+void AddNeon(const int16_t* src, size_t size, int16_t* dst) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    vst1q_s16(&dst[i], vqaddq_s16(vld1q_s16(&dst[i]), vld1q_s16(&src[i])));
+  }
+  for (; i < size; ++i) {
+    dst[i] = rtc::saturated_cast<int16_t>(static_cast<int32_t>(dst[i]) +
+                                          static_cast<int32_t>(src[i]));
+  }
+}
+
+void StereoToMonoNeon(const int16_t* src,
+                      size_t samples_per_channel,
+                      int16_t* dst) {
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    const int32x4_t low =
+        DivideByPowerOfTwo<1>(vpaddlq_s16(vld1q_s16(&src[2 * i])));
+    const int32x4_t high =
+        DivideByPowerOfTwo<1>(vpaddlq_s16(vld1q_s16(&src[2 * i + 8])));
+    vst1q_s16(&dst[i], vcombine_s16(vqmovn_s32(low), vqmovn_s32(high)));
+  }
+  for (; i < samples_per_channel; ++i) {
+    dst[i] = (static_cast<int32_t>(src[2 * i]) + src[2 * i + 1]) / 2;
+  }
+}
+
+void QuadToMonoNeon(const int16_t* src,
+                    size_t samples_per_channel,
+                    int16_t* dst) {
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    int32x4_t sums[2];
+    for (int k = 0; k < 2; ++k) {
+      const int32x4_t p0 = vpaddlq_s16(vld1q_s16(&src[4 * i + 16 * k]));
+      const int32x4_t p1 = vpaddlq_s16(vld1q_s16(&src[4 * i + 16 * k + 8]));
+      sums[k] = DivideByPowerOfTwo<2>(vpaddq_s32(p0, p1));
+    }
+    vst1q_s16(&dst[i], vcombine_s16(vqmovn_s32(sums[0]), vqmovn_s32(sums[1])));
+  }
+  for (; i < samples_per_channel; ++i) {
+    dst[i] = (static_cast<int32_t>(src[4 * i]) + src[4 * i + 1] +
+              src[4 * i + 2] + src[4 * i + 3]) /
+             4;
+  }
+}
+
+void QuadToStereoNeon(const int16_t* src,
+                      size_t samples_per_channel,
+                      int16_t* dst) {
+  size_t i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4) {
+    const int32x4_t low = vshrq_n_s32(vpaddlq_s16(vld1q_s16(&src[4 * i])), 1);
+    const int32x4_t high =
+        vshrq_n_s32(vpaddlq_s16(vld1q_s16(&src[4 * i + 8])), 1);
+    vst1q_s16(&dst[2 * i], vcombine_s16(vqmovn_s32(low), vqmovn_s32(high)));
+  }
+  for (; i < samples_per_channel; i++) {
+    dst[i * 2] = (static_cast<int32_t>(src[4 * i]) + src[4 * i + 1]) >> 1;
+    dst[i * 2 + 1] =
+        (static_cast<int32_t>(src[4 * i + 2]) + src[4 * i + 3]) >> 1;
+  }
+}
+
+void MonoToStereoNeon(const int16_t* src,
+                      size_t samples_per_channel,
+                      int16_t* dst) {
+  // Going backwards through the frame allows |dst| to be |src|.
+  size_t i = samples_per_channel;
+  for (; i % 8 != 0; --i) {
+    const int16_t sample = src[i - 1];
+    dst[2 * (i - 1)] = sample;
+    dst[2 * (i - 1) + 1] = sample;
+  }
+  for (; i > 0; i -= 8) {
+    const int16x8_t x = vld1q_s16(&src[i - 8]);
+    vst1q_s16(&dst[2 * (i - 8)], vzip1q_s16(x, x));
+    vst1q_s16(&dst[2 * (i - 8) + 8], vzip2q_s16(x, x));
+  }
+}
+
+void ScaleWithSatNeon(float scale, size_t size, int16_t* data) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const int16x8_t x = vld1q_s16(&data[i]);
+    vst1q_s16(&data[i], ToS16(vmulq_n_f32(LowToFloat(x), scale),
+                              vmulq_n_f32(HighToFloat(x), scale)));
+  }
+  for (; i < size; ++i) {
+    data[i] = rtc::saturated_cast<int16_t>(scale * data[i]);
+  }
+}
+
+void ApplyGainsNeon(const float* gains,
+                    size_t samples_per_channel,
+                    size_t num_channels,
+                    int16_t* data) {
+  size_t i = 0;
+  if (num_channels == 1) {
+    for (; i + 8 <= samples_per_channel; i += 8) {
+      const int16x8_t x = vld1q_s16(&data[i]);
+      vst1q_s16(&data[i],
+                ToS16(vmulq_f32(LowToFloat(x), vld1q_f32(&gains[i])),
+                      vmulq_f32(HighToFloat(x), vld1q_f32(&gains[i + 4]))));
+    }
+  } else if (num_channels == 2) {
+    for (; i + 4 <= samples_per_channel; i += 4) {
+      const int16x8_t x = vld1q_s16(&data[2 * i]);
+      const float32x4_t g = vld1q_f32(&gains[i]);
+      vst1q_s16(&data[2 * i],
+                ToS16(vmulq_f32(LowToFloat(x), vzip1q_f32(g, g)),
+                      vmulq_f32(HighToFloat(x), vzip2q_f32(g, g))));
+    }
+  }
+  for (; i < samples_per_channel; ++i) {
+    for (size_t ch = 0; ch < num_channels; ++ch) {
+      data[i * num_channels + ch] *= gains[i];
+    }
+  }
+}
+
+}  // namespace
+
+const AudioFrameOperationsKernels kAudioFrameOperationsKernelsNeon = {
+    AddNeon,          StereoToMonoNeon, QuadToMonoNeon, QuadToStereoNeon,
+    MonoToStereoNeon, ScaleWithSatNeon, ApplyGainsNeon};
+
+}  // namespace webrtc
+
+#endif  // defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
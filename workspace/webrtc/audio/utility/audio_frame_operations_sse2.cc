@@ -0,0 +1,190 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "audio/utility/audio_frame_operations_kernels.h"
+#include "rtc_base/numerics/safe_conversions.h"
+
+namespace webrtc {
+namespace {
+
+__m128i Load(const int16_t* src) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+void Store(__m128i x, int16_t* dst) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), x);
+}
+
+// Sums of adjacent pairs of samples.
+__m128i SumPairs(__m128i x) {
+  return _mm_madd_epi16(x, _mm_set1_epi16(1));
+}
+
+// Divides by 2^kShift, rounding toward zero like integer division.
+template <int kShift>
+__m128i DivideByPowerOfTwo(__m128i x) {
+  const __m128i bias = _mm_srli_epi32(_mm_srai_epi32(x, 31), 32 - kShift);
+  return _mm_srai_epi32(_mm_add_epi32(x, bias), kShift);
+}
+
+// Truncates and saturates like rtc::saturated_cast<int16_t>().
+__m128i ToS16(__m128 low, __m128 high) {
+  const __m128 max = _mm_set1_ps(32767.f);
+  const __m128 min = _mm_set1_ps(-32768.f);
+  return _mm_packs_epi32(
+      _mm_cvttps_epi32(_mm_max_ps(_mm_min_ps(low, max), min)),
+      _mm_cvttps_epi32(_mm_max_ps(_mm_min_ps(high, max), min)));
+}
+
+__m128 LowToFloat(__m128i x) {
+  return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+}
+
+__m128 HighToFloat(__m128i x) {
+  return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+}
+
+void AddSse2(const int16_t* src, size_t size, int16_t* dst) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    Store(_mm_adds_epi16(Load(&dst[i]), Load(&src[i])), &dst[i]);
+  }
+  for (; i < size; ++i) {
+    dst[i] = rtc::saturated_cast<int16_t>(static_cast<int32_t>(dst[i]) +
+                                          static_cast<int32_t>(src[i]));
+  }
+}
+
+void StereoToMonoSse2(const int16_t* src,
+                      size_t samples_per_channel,
+                      int16_t* dst) {
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    const __m128i low = DivideByPowerOfTwo<1>(SumPairs(Load(&src[2 * i])));
+    const __m128i high =
+        DivideByPowerOfTwo<1>(SumPairs(Load(&src[2 * i + 8])));
+    Store(_mm_packs_epi32(low, high), &dst[i]);
+  }
+  for (; i < samples_per_channel; ++i) {
+    dst[i] = (static_cast<int32_t>(src[2 * i]) + src[2 * i + 1]) / 2;
+  }
+}
+
+void QuadToMonoSse2(const int16_t* src,
+                    size_t samples_per_channel,
+                    int16_t* dst) {
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    __m128i sums[2];
+    for (int k = 0; k < 2; ++k) {
+      // Pair sums of 4 samples, two per sample.
+      const __m128 p0 =
+          _mm_castsi128_ps(SumPairs(Load(&src[4 * i + 16 * k])));
+      const __m128 p1 =
+          _mm_castsi128_ps(SumPairs(Load(&src[4 * i + 16 * k + 8])));
+      const __m128i even =
+          _mm_castps_si128(_mm_shuffle_ps(p0, p1, _MM_SHUFFLE(2, 0, 2, 0)));
+      const __m128i odd =
+          _mm_castps_si128(_mm_shuffle_ps(p0, p1, _MM_SHUFFLE(3, 1, 3, 1)));
+      sums[k] = DivideByPowerOfTwo<2>(_mm_add_epi32(even, odd));
+    }
+    Store(_mm_packs_epi32(sums[0], sums[1]), &dst[i]);
+  }
+  for (; i < samples_per_channel; ++i) {
+    dst[i] = (static_cast<int32_t>(src[4 * i]) + src[4 * i + 1] +
+              src[4 * i + 2] + src[4 * i + 3]) /
+             4;
+  }
+}
+
+void QuadToStereoSse2(const int16_t* src,
+                      size_t samples_per_channel,
+                      int16_t* dst) {
+  size_t i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4) {
+    const __m128i low = _mm_srai_epi32(SumPairs(Load(&src[4 * i])), 1);
+    const __m128i high = _mm_srai_epi32(SumPairs(Load(&src[4 * i + 8])), 1);
+    Store(_mm_packs_epi32(low, high), &dst[2 * i]);
+  }
+  for (; i < samples_per_channel; i++) {
+    dst[i * 2] = (static_cast<int32_t>(src[4 * i]) + src[4 * i + 1]) >> 1;
+    dst[i * 2 + 1] =
+        (static_cast<int32_t>(src[4 * i + 2]) + src[4 * i + 3]) >> 1;
+  }
+}
+
+void MonoToStereoSse2(const int16_t* src,
+                      size_t samples_per_channel,
+                      int16_t* dst) {
+  // Going backwards through the frame allows |dst| to be |src|.
+  size_t i = samples_per_channel;
+  for (; i % 8 != 0; --i) {
+    const int16_t sample = src[i - 1];
+    dst[2 * (i - 1)] = sample;
+    dst[2 * (i - 1) + 1] = sample;
+  }
+  for (; i > 0; i -= 8) {
+    const __m128i x = Load(&src[i - 8]);
+    Store(_mm_unpacklo_epi16(x, x), &dst[2 * (i - 8)]);
+    Store(_mm_unpackhi_epi16(x, x), &dst[2 * (i - 8) + 8]);
+  }
+}
+
+void ScaleWithSatSse2(float scale, size_t size, int16_t* data) {
+  const __m128 scale4 = _mm_set1_ps(scale);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m128i x = Load(&data[i]);
+    Store(ToS16(_mm_mul_ps(scale4, LowToFloat(x)),
+                _mm_mul_ps(scale4, HighToFloat(x))),
+          &data[i]);
+  }
+  for (; i < size; ++i) {
+    data[i] = rtc::saturated_cast<int16_t>(scale * data[i]);
+  }
+}
+
+void ApplyGainsSse2(const float* gains,
+                    size_t samples_per_channel,
+                    size_t num_channels,
+                    int16_t* data) {
+  size_t i = 0;
+  if (num_channels == 1) {
+    for (; i + 8 <= samples_per_channel; i += 8) {
+      const __m128i x = Load(&data[i]);
+      Store(ToS16(_mm_mul_ps(LowToFloat(x), _mm_loadu_ps(&gains[i])),
+                  _mm_mul_ps(HighToFloat(x), _mm_loadu_ps(&gains[i + 4]))),
+            &data[i]);
+    }
+  } else if (num_channels == 2) {
+    for (; i + 4 <= samples_per_channel; i += 4) {
+      const __m128i x = Load(&data[2 * i]);
+      const __m128 g = _mm_loadu_ps(&gains[i]);
+      Store(ToS16(_mm_mul_ps(LowToFloat(x), _mm_unpacklo_ps(g, g)),
+                  _mm_mul_ps(HighToFloat(x), _mm_unpackhi_ps(g, g))),
+            &data[2 * i]);
+    }
+  }
+  for (; i < samples_per_channel; ++i) {
+    for (size_t ch = 0; ch < num_channels; ++ch) {
+      data[i * num_channels + ch] *= gains[i];
+    }
+  }
+}
+
+}  // namespace
+
+const AudioFrameOperationsKernels kAudioFrameOperationsKernelsSse2 = {
+    AddSse2,          StereoToMonoSse2, QuadToMonoSse2, QuadToStereoSse2,
+    MonoToStereoSse2, ScaleWithSatSse2, ApplyGainsSse2};
+
+}  // namespace webrtc
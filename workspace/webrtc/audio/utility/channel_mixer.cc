@@ -10,12 +10,115 @@
 
 #include "audio/utility/channel_mixer.h"
 
+#include <algorithm>
+
 #include "audio/utility/channel_mixing_matrix.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_conversions.h"
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 
 namespace webrtc {
+namespace {
+
+// Number of samples per channel mixed at a time.
+constexpr size_t kBlockSize = 64;
+
+// Sets |y| to |scale| * |x|.
+void Scale(const float* x, float scale, size_t size, float* y) {
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128 scale4 = _mm_set1_ps(scale);
+  for (; i + 4 <= size; i += 4) {
+    _mm_storeu_ps(&y[i], _mm_mul_ps(scale4, _mm_loadu_ps(&x[i])));
+  }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  for (; i + 4 <= size; i += 4) {
+    vst1q_f32(&y[i], vmulq_n_f32(vld1q_f32(&x[i]), scale));
+  }
+#endif
+  for (; i < size; ++i) {
+    y[i] = scale * x[i];
+  }
+}
+
+// Adds |scale| * |x| to |y|, rounding the product before the sum.
+void ScaleAndAdd(const float* x, float scale, size_t size, float* y) {
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128 scale4 = _mm_set1_ps(scale);
+  for (; i + 4 <= size; i += 4) {
+    _mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]),
+                                    _mm_mul_ps(scale4, _mm_loadu_ps(&x[i]))));
+  }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  for (; i + 4 <= size; i += 4) {
+    vst1q_f32(&y[i], vaddq_f32(vld1q_f32(&y[i]),
+                               vmulq_n_f32(vld1q_f32(&x[i]), scale)));
+  }
+#endif
+  for (; i < size; ++i) {
+    y[i] += scale * x[i];
+  }
+}
+
+// Writes |x| to every |stride|-th element of |y|, truncated and saturated like
+// rtc::saturated_cast<int16_t>().
+void ConvertToS16(const float* x, size_t size, size_t stride, int16_t* y) {
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128 max = _mm_set1_ps(32767.f);
+  const __m128 min = _mm_set1_ps(-32768.f);
+  for (; i + 8 <= size; i += 8) {
+    const __m128i low = _mm_cvttps_epi32(
+        _mm_max_ps(_mm_min_ps(_mm_loadu_ps(&x[i]), max), min));
+    const __m128i high = _mm_cvttps_epi32(
+        _mm_max_ps(_mm_min_ps(_mm_loadu_ps(&x[i + 4]), max), min));
+    const __m128i packed = _mm_packs_epi32(low, high);
+    if (stride == 1) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(&y[i]), packed);
+    } else {
+      alignas(16) int16_t values[8];
+      _mm_store_si128(reinterpret_cast<__m128i*>(values), packed);
+      for (size_t k = 0; k < 8; ++k) {
+        y[(i + k) * stride] = values[k];
+      }
+    }
+  }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  const float32x4_t max = vdupq_n_f32(32767.f);
+  const float32x4_t min = vdupq_n_f32(-32768.f);
+  for (; i + 8 <= size; i += 8) {
+    const int32x4_t low =
+        vcvtq_s32_f32(vmaxq_f32(vminq_f32(vld1q_f32(&x[i]), max), min));
+    const int32x4_t high =
+        vcvtq_s32_f32(vmaxq_f32(vminq_f32(vld1q_f32(&x[i + 4]), max), min));
+    const int16x8_t packed = vcombine_s16(vqmovn_s32(low), vqmovn_s32(high));
+    if (stride == 1) {
+      vst1q_s16(&y[i], packed);
+    } else {
+      int16_t values[8];
+      vst1q_s16(values, packed);
+      for (size_t k = 0; k < 8; ++k) {
+        y[(i + k) * stride] = values[k];
+      }
+    }
+  }
+#endif
+  for (; i < size; ++i) {
+    y[i * stride] = rtc::saturated_cast<int16_t>(x[i]);
+  }
+}
+
+}  // namespace
 
 ChannelMixer::ChannelMixer(ChannelLayout input_layout,
                            ChannelLayout output_layout)
@@ -23,18 +126,34 @@ ChannelMixer::ChannelMixer(ChannelLayout input_layout,
       output_layout_(output_layout),
       input_channels_(ChannelLayoutToChannelCount(input_layout)),
       output_channels_(ChannelLayoutToChannelCount(output_layout)) {
-  // Create the transformation matrix.
+  // Create the transformation matrix and keep only its non-zero entries.
+  std::vector<std::vector<float>> matrix;
   ChannelMixingMatrix matrix_builder(input_layout_, input_channels_,
                                      output_layout_, output_channels_);
-  remapping_ = matrix_builder.CreateTransformationMatrix(&matrix_);
+  matrix_builder.CreateTransformationMatrix(&matrix);
+  RTC_DCHECK_EQ(matrix.size(), output_channels_);
+  coefficient_offsets_.push_back(0);
+  for (const std::vector<float>& row : matrix) {
+    RTC_DCHECK_EQ(row.size(), input_channels_);
+    for (size_t input_ch = 0; input_ch < row.size(); ++input_ch) {
+      // Scale should always be positive.
+      RTC_DCHECK_GE(row[input_ch], 0);
+      if (row[input_ch] != 0.f) {
+        coefficients_.push_back({input_ch, row[input_ch]});
+      }
+    }
+    coefficient_offsets_.push_back(coefficients_.size());
+  }
+
+  input_block_.resize(input_channels_ * kBlockSize);
+  output_block_.resize(kBlockSize);
 }
 
 ChannelMixer::~ChannelMixer() = default;
 
 void ChannelMixer::Transform(AudioFrame* frame) {
   RTC_DCHECK(frame);
-  RTC_DCHECK_EQ(matrix_[0].size(), static_cast<size_t>(input_channels_));
-  RTC_DCHECK_EQ(matrix_.size(), static_cast<size_t>(output_channels_));
+  RTC_DCHECK_EQ(coefficient_offsets_.size(), output_channels_ + 1);
 
   // Leave the audio frame intact if the channel layouts for in and out are
   // identical.
@@ -54,46 +173,57 @@ void ChannelMixer::Transform(AudioFrame* frame) {
     return;
   }
 
-  const int16_t* in_audio = frame->data();
-
-  // Only allocate fresh memory at first access or if the required size has
-  // increased.
-  // TODO(henrika): we might be able to do downmixing in-place and thereby avoid
-  // extra memory allocation and a memcpy.
-  const size_t num_elements = frame->samples_per_channel() * output_channels_;
-  if (audio_vector_ == nullptr || num_elements > audio_vector_size_) {
-    audio_vector_.reset(new int16_t[num_elements]);
-    audio_vector_size_ = num_elements;
-  }
-  int16_t* out_audio = audio_vector_.get();
-
-  // Modify the number of channels by creating a weighted sum of input samples
-  // where the weights (scale factors) for each output sample are given by the
-  // transformation matrix.
-  for (size_t i = 0; i < frame->samples_per_channel(); i++) {
-    for (size_t output_ch = 0; output_ch < output_channels_; ++output_ch) {
-      float acc_value = 0.0f;
-      for (size_t input_ch = 0; input_ch < input_channels_; ++input_ch) {
-        const float scale = matrix_[output_ch][input_ch];
-        // Scale should always be positive.
-        RTC_DCHECK_GE(scale, 0);
-        // Each output sample is a weighted sum of input samples.
-        acc_value += scale * in_audio[i * input_channels_ + input_ch];
-      }
-      const size_t index = output_channels_ * i + output_ch;
-      RTC_CHECK_LE(index, audio_vector_size_);
-      out_audio[index] = rtc::saturated_cast<int16_t>(acc_value);
-    }
+  // The frame is transformed in place, one block at a time. Every block is
+  // read before it is written, so downmixing front to back and upmixing back
+  // to front never overwrites samples that have not been read yet.
+  int16_t* const audio = frame->mutable_data();
+  const size_t samples_per_channel = frame->samples_per_channel();
+  const size_t num_blocks = (samples_per_channel + kBlockSize - 1) / kBlockSize;
+  for (size_t n = 0; n < num_blocks; ++n) {
+    const size_t block = IsUpMixing() ? num_blocks - 1 - n : n;
+    const size_t first_sample = block * kBlockSize;
+    const size_t block_size =
+        std::min(kBlockSize, samples_per_channel - first_sample);
+    MixBlock(&audio[first_sample * input_channels_], block_size,
+             &audio[first_sample * output_channels_]);
   }
 
   // Update channel information.
   frame->num_channels_ = output_channels_;
   frame->channel_layout_ = output_layout_;
+}
+
+void ChannelMixer::MixBlock(const int16_t* input,
+                            size_t block_size,
+                            int16_t* output) {
+  // Deinterleave and convert to float.
+  for (size_t input_ch = 0; input_ch < input_channels_; ++input_ch) {
+    float* const channel = &input_block_[input_ch * kBlockSize];
+    for (size_t i = 0; i < block_size; ++i) {
+      channel[i] = input[i * input_channels_ + input_ch];
+    }
+  }
 
-  // Copy the output result to the audio frame in |frame|.
-  memcpy(
-      frame->mutable_data(), out_audio,
-      sizeof(int16_t) * frame->samples_per_channel() * frame->num_channels());
+  // Each output sample is a weighted sum of input samples, where the weights
+  // are given by the transformation matrix.
+  float* const mix = output_block_.data();
+  for (size_t output_ch = 0; output_ch < output_channels_; ++output_ch) {
+    const size_t begin = coefficient_offsets_[output_ch];
+    const size_t end = coefficient_offsets_[output_ch + 1];
+    if (begin == end) {
+      std::fill(mix, mix + block_size, 0.f);
+    }
+    for (size_t k = begin; k < end; ++k) {
+      const Coefficient& c = coefficients_[k];
+      const float* const channel = &input_block_[c.input_channel * kBlockSize];
+      if (k == begin) {
+        Scale(channel, c.scale, block_size, mix);
+      } else {
+        ScaleAndAdd(channel, c.scale, block_size, mix);
+      }
+    }
+    ConvertToS16(mix, block_size, output_channels_, &output[output_ch]);
+  }
 }
 
 }  // namespace webrtc
@@ -27,7 +27,8 @@ namespace webrtc {
 // algorithm works by generating a conversion matrix mapping each output channel
 // to list of input channels.  The transform renders all of the output channels,
 // with each output channel rendered according to a weighted sum of the relevant
-// input channels as defined in the matrix.
+// input channels as defined in the matrix. Only the non-zero weights are kept,
+// and the frame is mixed in place in blocks, without allocating memory.
 // This file is derived from Chromium's media/base/channel_mixer.h.
 class ChannelMixer {
  public:
@@ -55,6 +56,10 @@ class ChannelMixer {
  private:
   bool IsUpMixing() const { return output_channels_ > input_channels_; }
 
+  // Mixes |block_size| interleaved samples per channel from |input| into
+  // |output|, which may be the same memory.
+  void MixBlock(const int16_t* input, size_t block_size, int16_t* output);
+
   // Selected channel layouts.
   const ChannelLayout input_layout_;
   const ChannelLayout output_layout_;
@@ -63,18 +68,21 @@ class ChannelMixer {
   const size_t input_channels_;
   const size_t output_channels_;
 
-  // 2D matrix of output channels to input channels.
-  std::vector<std::vector<float> > matrix_;
-
-  // 1D array used as temporary storage during the transformation.
-  std::unique_ptr<int16_t[]> audio_vector_;
-
-  // Number of elements allocated for |audio_vector_|.
-  size_t audio_vector_size_ = 0;
-
-  // Optimization case for when we can simply remap the input channels to output
-  // channels, i.e., when all scaling factors in |matrix_| equals 1.0.
-  bool remapping_;
+  // Non-zero entries of the transformation matrix as (input channel, scale)
+  // pairs, ordered by output channel and then by input channel. The entries
+  // of output channel |ch| are those in
+  // [coefficient_offsets_[ch], coefficient_offsets_[ch + 1]).
+  struct Coefficient {
+    size_t input_channel;
+    float scale;
+  };
+  std::vector<Coefficient> coefficients_;
+  std::vector<size_t> coefficient_offsets_;
+
+  // Planar float copy of a block of input samples, and the mix of one output
+  // channel for the block. Allocated once, at construction.
+  std::vector<float> input_block_;
+  std::vector<float> output_block_;
 
   // Delete the copy constructor and assignment operator.
   ChannelMixer(const ChannelMixer& other) = delete;
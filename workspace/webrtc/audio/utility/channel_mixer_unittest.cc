@@ -11,11 +11,14 @@
 #include "audio/utility/channel_mixer.h"
 
 #include <memory>
+#include <vector>
 
 #include "api/audio/audio_frame.h"
 #include "api/audio/channel_layout.h"
 #include "audio/utility/channel_mixing_matrix.h"
 #include "rtc_base/arraysize.h"
+#include "rtc_base/numerics/safe_conversions.h"
+#include "rtc_base/random.h"
 #include "rtc_base/strings/string_builder.h"
 #include "test/gtest.h"
 
@@ -390,4 +393,72 @@ TEST_F(ChannelMixerTest, StereoToFiveOne) {
   VerifyFramesAreEqual(five_one_frame, frame_);
 }
 
+
+// Compares the transform with a direct evaluation of the transformation
+// matrix, for all layout pairs and for frame sizes that are not multiples of
+// the block size.
+TEST_F(ChannelMixerTest, MatchesTransformationMatrix) {
+  Random random(42);
+  for (ChannelLayout input_layout = CHANNEL_LAYOUT_MONO;
+       input_layout <= CHANNEL_LAYOUT_MAX;
+       input_layout = static_cast<ChannelLayout>(input_layout + 1)) {
+    for (ChannelLayout output_layout = CHANNEL_LAYOUT_MONO;
+         output_layout <= CHANNEL_LAYOUT_MAX;
+         output_layout = static_cast<ChannelLayout>(output_layout + 1)) {
+      if (input_layout == CHANNEL_LAYOUT_BITSTREAM ||
+          input_layout == CHANNEL_LAYOUT_DISCRETE ||
+          input_layout == CHANNEL_LAYOUT_STEREO_AND_KEYBOARD_MIC ||
+          output_layout == CHANNEL_LAYOUT_BITSTREAM ||
+          output_layout == CHANNEL_LAYOUT_DISCRETE ||
+          output_layout == CHANNEL_LAYOUT_STEREO_AND_KEYBOARD_MIC ||
+          output_layout == CHANNEL_LAYOUT_STEREO_DOWNMIX ||
+          input_layout == output_layout) {
+        continue;
+      }
+      rtc::StringBuilder ss;
+      ss << "Input Layout: " << input_layout
+         << ", Output Layout: " << output_layout;
+      SCOPED_TRACE(ss.str());
+
+      const size_t input_channels = ChannelLayoutToChannelCount(input_layout);
+      const size_t output_channels =
+          ChannelLayoutToChannelCount(output_layout);
+      std::vector<std::vector<float>> matrix;
+      ChannelMixingMatrix(input_layout, input_channels, output_layout,
+                          output_channels)
+          .CreateTransformationMatrix(&matrix);
+      ChannelMixer mixer(input_layout, output_layout);
+
+      for (size_t samples_per_channel : {1, 63, 160, 441, 480}) {
+        frame_.UpdateFrame(kTimestamp, nullptr, samples_per_channel,
+                           kSampleRateHz, AudioFrame::kNormalSpeech,
+                           AudioFrame::kVadActive, input_channels);
+        int16_t* data = frame_.mutable_data();
+        for (size_t i = 0; i < samples_per_channel * input_channels; ++i) {
+          data[i] = random.Rand(-32768, 32767);
+        }
+        std::vector<int16_t> expected(samples_per_channel * output_channels);
+        for (size_t i = 0; i < samples_per_channel; ++i) {
+          for (size_t output_ch = 0; output_ch < output_channels;
+               ++output_ch) {
+            float acc = 0.f;
+            for (size_t input_ch = 0; input_ch < input_channels; ++input_ch) {
+              acc += matrix[output_ch][input_ch] *
+                     data[i * input_channels + input_ch];
+            }
+            expected[i * output_channels + output_ch] =
+                rtc::saturated_cast<int16_t>(acc);
+          }
+        }
+
+        mixer.Transform(&frame_);
+        ASSERT_EQ(output_channels, frame_.num_channels());
+        for (size_t i = 0; i < expected.size(); ++i) {
+          ASSERT_EQ(expected[i], frame_.data()[i]) << i;
+        }
+      }
+    }
+  }
+}
+
 }  // namespace webrtc
@@ -5,9 +5,11 @@ namespace webrtc {
 
   //-------------    RingBufferWrapper   ---------------//
 const size_t RingBufferWrapper::kMaxBufferSize = 50 * 1024 * 1024;
-RingBufferWrapper::RingBufferWrapper(size_t capacity, bool auto_adjust_capacity)
-  : buff_handle_(WebRtc_CreateBuffer(capacity, 1)),
-  auto_adjust_capacity_(auto_adjust_capacity) {
+RingBufferWrapper::RingBufferWrapper(size_t capacity, bool auto_adjust_capacity,
+    bool contiguous_read)
+  : auto_adjust_capacity_(auto_adjust_capacity),
+  contiguous_read_(contiguous_read) {
+    buff_handle_ = CreateBuffer(capacity);
   }
 
   RingBufferWrapper::~RingBufferWrapper() {
@@ -65,7 +67,7 @@ void RingBufferWrapper::AdjustCapacity(size_t capacity) {
   if (capacity < BufferCurrentSize() || capacity == BufferCapacity()) {
     return;
   }
-  RingBuffer* new_buff_handle = WebRtc_CreateBuffer(capacity, 1);
+  RingBuffer* new_buff_handle = CreateBuffer(capacity);
   size_t read_size = BufferCurrentSize();
   if (read_size > 0) {
     size_t read_size1 = buff_handle_->write_pos - buff_handle_->read_pos;
@@ -88,6 +90,11 @@ size_t RingBufferWrapper::CalculatedExpansionCapacity(size_t write_size) {
   RTC_DCHECK(write_size <= kMaxBufferSize);
   return new_size > kMaxBufferSize ?  kMaxBufferSize : new_size;
 }
+
+RingBuffer* RingBufferWrapper::CreateBuffer(size_t capacity) const {
+  return contiguous_read_ ? WebRtc_CreateMirroredBuffer(capacity, 1)
+                          : WebRtc_CreateBuffer(capacity, 1);
+}
 //-------------    RingBufferWrapper   ---------------//
 
 } // webrtc
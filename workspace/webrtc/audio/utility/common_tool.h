@@ -17,8 +17,13 @@ public:
   RingBufferWrapper(const RingBufferWrapper&) = delete;
   RingBufferWrapper(RingBufferWrapper&&) = delete;
   // If expandable_ is true, the buffer will automatically expand when it is full,
-  // otherwise, the buffer will overwrite the past data when it is full
-  RingBufferWrapper(size_t capacity, bool auto_expand_capacity = false);
+  // otherwise, the buffer will overwrite the past data when it is full.
+  // If contiguous_read is true, the buffer is mirrored in virtual memory where
+  // supported, so BufferRead never has to copy wrapped data into |data|; the
+  // capacity is then rounded up to a multiple of the page size.
+  RingBufferWrapper(size_t capacity,
+                    bool auto_expand_capacity = false,
+                    bool contiguous_read = false);
   virtual ~RingBufferWrapper();
   const void* BufferRead(void* data, size_t in_size, size_t* out_size);
   size_t BufferRead(void* data, size_t size);
@@ -31,12 +36,14 @@ public:
 
 private:
   size_t CalculatedExpansionCapacity(size_t write_size);
+  RingBuffer* CreateBuffer(size_t capacity) const;
 private:
   // If buffer is in expandable mode, exceeding this capacity will automatically turn into non-expandable mode
   static const size_t kMaxBufferSize;
 
   RingBuffer* buff_handle_ = nullptr;
   bool auto_adjust_capacity_; // Automatically adjusts buffer capacity
+  const bool contiguous_read_; // Buffer is created with WebRtc_CreateMirroredBuffer
 };
 //----------------------  CacheBuffer ----------------------------------//
 
@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/async_wav_writer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common_audio/include/audio_util.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+AsyncWavWriter::AsyncWavWriter(const std::string& filename,
+                               int sample_rate,
+                               size_t num_channels,
+                               SampleFormat sample_format,
+                               size_t buffer_size,
+                               OverflowPolicy overflow_policy)
+    : writer_(filename, sample_rate, num_channels, sample_format),
+      int16_format_(sample_format == SampleFormat::kInt16),
+      buffer_size_(std::max(buffer_size + num_channels - 1, num_channels) /
+                   num_channels * num_channels),
+      overflow_policy_(overflow_policy),
+      thread_(&AsyncWavWriter::WriterThread,
+              this,
+              "AsyncWavWriter",
+              rtc::kLowPriority) {
+  for (Buffer* buffer : {&front_, &back_}) {
+    if (int16_format_) {
+      buffer->int16_samples.resize(buffer_size_);
+    } else {
+      buffer->float_samples.resize(buffer_size_);
+    }
+  }
+  thread_.Start();
+}
+
+AsyncWavWriter::~AsyncWavWriter() {
+  if (front_.size > 0) {
+    SubmitFront(/*wait=*/true);
+  }
+  {
+    MutexLock lock(&mutex_);
+    stopping_ = true;
+  }
+  work_event_.Set();
+  thread_.Stop();
+  // |writer_| writes the header when destroyed.
+}
+
+void AsyncWavWriter::WriteSamples(const float* samples, size_t num_samples) {
+  WriteSamplesInternal(samples, num_samples);
+}
+
+void AsyncWavWriter::WriteSamples(const int16_t* samples, size_t num_samples) {
+  WriteSamplesInternal(samples, num_samples);
+}
+
+template <typename T>
+void AsyncWavWriter::WriteSamplesInternal(const T* samples,
+                                          size_t num_samples) {
+  while (num_samples > 0) {
+    if (front_.size == buffer_size_ &&
+        !SubmitFront(overflow_policy_ == OverflowPolicy::kBlock)) {
+      num_samples_dropped_ += num_samples;
+      return;
+    }
+    const size_t count = std::min(num_samples, buffer_size_ - front_.size);
+    Append(samples, count);
+    num_samples_accepted_ += count;
+    samples += count;
+    num_samples -= count;
+  }
+}
+
+void AsyncWavWriter::Append(const float* samples, size_t num_samples) {
+  if (int16_format_) {
+    int16_t* dst = &front_.int16_samples[front_.size];
+    for (size_t i = 0; i < num_samples; ++i) {
+      dst[i] = FloatS16ToS16(samples[i]);
+    }
+  } else {
+    std::copy(samples, samples + num_samples,
+              &front_.float_samples[front_.size]);
+  }
+  front_.size += num_samples;
+}
+
+void AsyncWavWriter::Append(const int16_t* samples, size_t num_samples) {
+  if (int16_format_) {
+    std::copy(samples, samples + num_samples,
+              &front_.int16_samples[front_.size]);
+  } else {
+    // Written as S16 range floats, which WavWriter scales to [-1, 1] exactly
+    // like it does for int16 input.
+    float* dst = &front_.float_samples[front_.size];
+    for (size_t i = 0; i < num_samples; ++i) {
+      dst[i] = static_cast<float>(samples[i]);
+    }
+  }
+  front_.size += num_samples;
+}
+
+bool AsyncWavWriter::SubmitFront(bool wait) {
+  while (true) {
+    {
+      MutexLock lock(&mutex_);
+      if (!back_pending_) {
+        std::swap(front_, back_);
+        front_.size = 0;
+        back_pending_ = true;
+        break;
+      }
+    }
+    if (!wait) {
+      return false;
+    }
+    space_event_.Wait(rtc::Event::kForever);
+  }
+  work_event_.Set();
+  return true;
+}
+
+void AsyncWavWriter::WriterThread(void* obj) {
+  static_cast<AsyncWavWriter*>(obj)->Run();
+}
+
+void AsyncWavWriter::Run() {
+  while (true) {
+    work_event_.Wait(rtc::Event::kForever);
+    while (true) {
+      {
+        MutexLock lock(&mutex_);
+        if (!back_pending_) {
+          if (stopping_) {
+            return;
+          }
+          break;
+        }
+      }
+      if (int16_format_) {
+        writer_.WriteSamples(back_.int16_samples.data(), back_.size);
+      } else {
+        writer_.WriteSamples(back_.float_samples.data(), back_.size);
+      }
+      {
+        MutexLock lock(&mutex_);
+        back_pending_ = false;
+      }
+      space_event_.Set();
+    }
+  }
+}
+
+}  // namespace webrtc
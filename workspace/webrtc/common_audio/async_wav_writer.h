@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_AUDIO_ASYNC_WAV_WRITER_H_
+#define COMMON_AUDIO_ASYNC_WAV_WRITER_H_
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "common_audio/wav_file.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Writes WAV files like WavWriter, but hands the samples to a background thread
+// that does the file I/O. Samples are collected in one of two buffers; when it
+// is full it is swapped with the other one, which the background thread is
+// then writing to disk. The output is identical to that of WavWriter given the
+// same input.
+//
+// WriteSamples() must always be called from the same thread. It does not wait
+// for file I/O unless both buffers are full, in which case the behavior is
+// given by the OverflowPolicy.
+class AsyncWavWriter final : public WavFile {
+ public:
+  enum class OverflowPolicy {
+    // Drop the samples that do not fit, and count them. Never waits.
+    kDrop,
+    // Wait for the background thread to finish writing the other buffer.
+    kBlock,
+  };
+
+  // 1 s of stereo audio at 48 kHz.
+  static constexpr size_t kDefaultBufferSize = 96000;
+
+  // Opens a new WAV file for writing. |buffer_size| is the size of each of the
+  // two buffers, in samples. It is rounded up to a whole number of frames.
+  AsyncWavWriter(const std::string& filename,
+                 int sample_rate,
+                 size_t num_channels,
+                 SampleFormat sample_format = SampleFormat::kInt16,
+                 size_t buffer_size = kDefaultBufferSize,
+                 OverflowPolicy overflow_policy = OverflowPolicy::kDrop);
+
+  // Writes the remaining samples and closes the file, after writing its header.
+  ~AsyncWavWriter() override;
+
+  AsyncWavWriter(const AsyncWavWriter&) = delete;
+  AsyncWavWriter& operator=(const AsyncWavWriter&) = delete;
+
+  // Same as WavWriter::WriteSamples().
+  void WriteSamples(const float* samples, size_t num_samples);
+  void WriteSamples(const int16_t* samples, size_t num_samples);
+
+  int sample_rate() const override { return writer_.sample_rate(); }
+  size_t num_channels() const override { return writer_.num_channels(); }
+  // Number of samples accepted by WriteSamples(), including those not yet
+  // written to the file.
+  size_t num_samples() const override { return num_samples_accepted_; }
+  // Number of samples dropped because both buffers were full.
+  size_t num_dropped_samples() const { return num_samples_dropped_; }
+
+ private:
+  // Samples are stored in the format of the file, so that the background
+  // thread does not have to convert them.
+  struct Buffer {
+    std::vector<int16_t> int16_samples;
+    std::vector<float> float_samples;
+    size_t size = 0;
+  };
+
+  static void WriterThread(void* obj);
+  void Run();
+
+  template <typename T>
+  void WriteSamplesInternal(const T* samples, size_t num_samples);
+  // Appends samples to |front_|, converted to the file format.
+  void Append(const float* samples, size_t num_samples);
+  void Append(const int16_t* samples, size_t num_samples);
+  // Passes |front_| to the background thread. Returns false if the other
+  // buffer is still being written and |wait| is false.
+  bool SubmitFront(bool wait);
+
+  WavWriter writer_;
+  const bool int16_format_;
+  const size_t buffer_size_;
+  const OverflowPolicy overflow_policy_;
+
+  // Only accessed by the thread calling WriteSamples().
+  Buffer front_;
+  size_t num_samples_accepted_ = 0;
+  size_t num_samples_dropped_ = 0;
+
+  Mutex mutex_;
+  // Only accessed by the background thread while |back_pending_| is set.
+  Buffer back_;
+  bool back_pending_ RTC_GUARDED_BY(mutex_) = false;
+  bool stopping_ RTC_GUARDED_BY(mutex_) = false;
+  // Signaled when |back_| is handed to the background thread, or on stop.
+  rtc::Event work_event_;
+  // Signaled when the background thread is done writing |back_|.
+  rtc::Event space_event_;
+
+  rtc::PlatformThread thread_;
+};
+
+}  // namespace webrtc
+
+#endif  // COMMON_AUDIO_ASYNC_WAV_WRITER_H_
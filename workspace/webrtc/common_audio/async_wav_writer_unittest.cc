@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/async_wav_writer.h"
+
+#include <vector>
+
+#include "common_audio/wav_file.h"
+#include "test/gtest.h"
+#include "test/testsupport/file_utils.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSampleRate = 48000;
+constexpr size_t kNumChannels = 2;
+constexpr size_t kFrameSize = kSampleRate / 100 * kNumChannels;
+constexpr size_t kNumFrames = 250;
+
+std::vector<uint8_t> ReadFile(const std::string& filename) {
+  std::vector<uint8_t> contents(test::GetFileSize(filename));
+  FILE* f = fopen(filename.c_str(), "rb");
+  EXPECT_TRUE(f);
+  if (f) {
+    EXPECT_EQ(contents.size(), fread(contents.data(), 1, contents.size(), f));
+    fclose(f);
+  }
+  return contents;
+}
+
+}  // namespace
+
+// The asynchronous writer must produce the same file as WavWriter, for all
+// combinations of input and file formats.
+TEST(AsyncWavWriterTest, OutputMatchesWavWriter) {
+  const std::string sync_file = test::OutputPath() + "async_wavtest1.wav";
+  const std::string async_file = test::OutputPath() + "async_wavtest2.wav";
+  std::vector<float> float_frame(kFrameSize);
+  std::vector<int16_t> int16_frame(kFrameSize);
+  for (WavFile::SampleFormat format :
+       {WavFile::SampleFormat::kInt16, WavFile::SampleFormat::kFloat}) {
+    for (bool float_input : {false, true}) {
+      {
+        WavWriter sync_writer(sync_file, kSampleRate, kNumChannels, format);
+        // Small buffers, so that they are swapped many times.
+        AsyncWavWriter async_writer(
+            async_file, kSampleRate, kNumChannels, format, 3 * kFrameSize + 1,
+            AsyncWavWriter::OverflowPolicy::kBlock);
+        EXPECT_EQ(kSampleRate, async_writer.sample_rate());
+        EXPECT_EQ(kNumChannels, async_writer.num_channels());
+        for (size_t i = 0; i < kNumFrames; ++i) {
+          for (size_t j = 0; j < kFrameSize; ++j) {
+            float_frame[j] = (i * kFrameSize + j) * 13.1f - 40000.f;
+            int16_frame[j] = static_cast<int16_t>((i * kFrameSize + j) * 13);
+          }
+          if (float_input) {
+            sync_writer.WriteSamples(float_frame.data(), kFrameSize);
+            async_writer.WriteSamples(float_frame.data(), kFrameSize);
+          } else {
+            sync_writer.WriteSamples(int16_frame.data(), kFrameSize);
+            async_writer.WriteSamples(int16_frame.data(), kFrameSize);
+          }
+        }
+        EXPECT_EQ(kNumFrames * kFrameSize, async_writer.num_samples());
+        EXPECT_EQ(0u, async_writer.num_dropped_samples());
+      }
+      EXPECT_EQ(ReadFile(sync_file), ReadFile(async_file));
+    }
+  }
+}
+
+TEST(AsyncWavWriterTest, DropPolicyKeepsCountsConsistent) {
+  const std::string outfile = test::OutputPath() + "async_wavtest3.wav";
+  const std::vector<int16_t> frame(kFrameSize, 1000);
+  size_t num_accepted;
+  {
+    AsyncWavWriter writer(outfile, kSampleRate, kNumChannels,
+                          WavFile::SampleFormat::kInt16, kFrameSize,
+                          AsyncWavWriter::OverflowPolicy::kDrop);
+    for (size_t i = 0; i < kNumFrames; ++i) {
+      writer.WriteSamples(frame.data(), frame.size());
+    }
+    num_accepted = writer.num_samples();
+    EXPECT_EQ(kNumFrames * kFrameSize,
+              num_accepted + writer.num_dropped_samples());
+    EXPECT_EQ(0u, num_accepted % kNumChannels);
+  }
+  WavReader reader(outfile);
+  EXPECT_EQ(num_accepted, reader.num_samples());
+}
+
+}  // namespace webrtc
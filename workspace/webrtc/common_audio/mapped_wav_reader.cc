@@ -0,0 +1,175 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/mapped_wav_reader.h"
+
+#if defined(WEBRTC_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/system/file_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+// Reads the WAV header from memory.
+class WavHeaderMemoryReader : public WavHeaderReader {
+ public:
+  WavHeaderMemoryReader(const uint8_t* data, size_t size)
+      : data_(data), size_(size) {}
+
+  WavHeaderMemoryReader(const WavHeaderMemoryReader&) = delete;
+  WavHeaderMemoryReader& operator=(const WavHeaderMemoryReader&) = delete;
+
+  size_t Read(void* buf, size_t num_bytes) override {
+    const size_t count = std::min(num_bytes, size_ - pos_);
+    memcpy(buf, data_ + pos_, count);
+    pos_ += count;
+    return count;
+  }
+  bool SeekForward(uint32_t num_bytes) override {
+    if (num_bytes > size_ - pos_) {
+      return false;
+    }
+    pos_ += num_bytes;
+    return true;
+  }
+  int64_t GetPosition() override { return static_cast<int64_t>(pos_); }
+
+ private:
+  const uint8_t* const data_;
+  const size_t size_;
+  size_t pos_ = 0;
+};
+
+}  // namespace
+
+MappedWavReader::MappedWavReader(const std::string& filename) {
+#ifndef WEBRTC_ARCH_LITTLE_ENDIAN
+#error "Need to convert samples to big-endian when reading from WAV file"
+#endif
+
+  LoadFile(filename);
+
+  WavHeaderMemoryReader readable(file_data_, file_size_);
+  size_t bytes_per_sample;
+  int64_t data_start_pos;
+  RTC_CHECK(ReadWavHeader(&readable, &num_channels_, &sample_rate_, &format_,
+                          &bytes_per_sample, &num_samples_in_file_,
+                          &data_start_pos));
+  RTC_CHECK(format_ == WavFormat::kWavFormatPcm ||
+            format_ == WavFormat::kWavFormatIeeeFloat)
+      << "Non-implemented wav-format";
+
+  // Like WavReader, accept files that end before the size given in the header.
+  const size_t data_start = static_cast<size_t>(data_start_pos);
+  RTC_CHECK_LE(data_start, file_size_);
+  num_samples_in_file_ = std::min(num_samples_in_file_,
+                                  (file_size_ - data_start) / bytes_per_sample);
+
+  samples_ = file_data_ + data_start;
+  if (format_ == WavFormat::kWavFormatPcm &&
+      reinterpret_cast<uintptr_t>(samples_) % alignof(int16_t) != 0) {
+    aligned_int16_samples_.resize(num_samples_in_file_);
+    memcpy(aligned_int16_samples_.data(), samples_,
+           num_samples_in_file_ * sizeof(int16_t));
+    samples_ = aligned_int16_samples_.data();
+  } else if (format_ == WavFormat::kWavFormatIeeeFloat &&
+             reinterpret_cast<uintptr_t>(samples_) % alignof(float) != 0) {
+    aligned_float_samples_.resize(num_samples_in_file_);
+    memcpy(aligned_float_samples_.data(), samples_,
+           num_samples_in_file_ * sizeof(float));
+    samples_ = aligned_float_samples_.data();
+  }
+}
+
+MappedWavReader::~MappedWavReader() {
+#if defined(WEBRTC_POSIX)
+  if (mapped_) {
+    munmap(const_cast<uint8_t*>(file_data_), file_size_);
+  }
+#endif
+}
+
+rtc::ArrayView<const int16_t> MappedWavReader::int16_samples() const {
+  RTC_CHECK_EQ(format_, WavFormat::kWavFormatPcm);
+  return rtc::ArrayView<const int16_t>(static_cast<const int16_t*>(samples_),
+                                       num_samples_in_file_);
+}
+
+rtc::ArrayView<const float> MappedWavReader::float_samples() const {
+  RTC_CHECK_EQ(format_, WavFormat::kWavFormatIeeeFloat);
+  return rtc::ArrayView<const float>(static_cast<const float*>(samples_),
+                                     num_samples_in_file_);
+}
+
+rtc::ArrayView<const int16_t> MappedWavReader::ReadInt16Samples(
+    size_t num_samples) {
+  const size_t count = std::min(num_samples, num_unread_samples());
+  rtc::ArrayView<const int16_t> view =
+      int16_samples().subview(num_read_samples_, count);
+  num_read_samples_ += count;
+  return view;
+}
+
+rtc::ArrayView<const float> MappedWavReader::ReadFloatSamples(
+    size_t num_samples) {
+  const size_t count = std::min(num_samples, num_unread_samples());
+  rtc::ArrayView<const float> view =
+      float_samples().subview(num_read_samples_, count);
+  num_read_samples_ += count;
+  return view;
+}
+
+void MappedWavReader::LoadFile(const std::string& filename) {
+#if defined(WEBRTC_POSIX)
+  const int fd = open(filename.c_str(), O_RDONLY);
+  RTC_CHECK_GE(fd, 0)
+      << "Invalid file. Could not create file handle for wav file.";
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+    void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size),
+                      PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      // Samples are normally consumed front to back.
+      madvise(data, static_cast<size_t>(file_stat.st_size), MADV_SEQUENTIAL);
+      file_data_ = static_cast<const uint8_t*>(data);
+      file_size_ = static_cast<size_t>(file_stat.st_size);
+      mapped_ = true;
+    }
+  }
+  close(fd);
+  if (mapped_) {
+    return;
+  }
+#endif
+
+  // Fall back to reading the whole file.
+  FileWrapper file = FileWrapper::OpenReadOnly(filename);
+  RTC_CHECK(file.is_open())
+      << "Invalid file. Could not create file handle for wav file.";
+  const long file_size = file.FileSize();
+  RTC_CHECK_GE(file_size, 0) << "Could not determine the wav file size.";
+  file_contents_.resize(static_cast<size_t>(file_size));
+  RTC_CHECK_EQ(file.Read(file_contents_.data(), file_contents_.size()),
+               file_contents_.size());
+  file_data_ = file_contents_.data();
+  file_size_ = file_contents_.size();
+}
+
+}  // namespace webrtc
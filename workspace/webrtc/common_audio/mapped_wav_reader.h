@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_AUDIO_MAPPED_WAV_READER_H_
+#define COMMON_AUDIO_MAPPED_WAV_READER_H_
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "api/array_view.h"
+#include "common_audio/wav_file.h"
+#include "common_audio/wav_header.h"
+
+namespace webrtc {
+
+// Reads 16-bit integer and 32-bit floating point PCM WAV files by mapping them
+// into memory, and hands out views of the samples instead of copying them. On
+// platforms without mmap, the file is read into memory once at construction.
+// Intended for offline processing of long recordings. Follows the error
+// handling conventions of WavReader.
+class MappedWavReader final : public WavFile {
+ public:
+  // Opens an existing WAV file for reading.
+  explicit MappedWavReader(const std::string& filename);
+  ~MappedWavReader() override;
+
+  MappedWavReader(const MappedWavReader&) = delete;
+  MappedWavReader& operator=(const MappedWavReader&) = delete;
+
+  SampleFormat sample_format() const {
+    return format_ == WavFormat::kWavFormatPcm ? SampleFormat::kInt16
+                                               : SampleFormat::kFloat;
+  }
+
+  // All interleaved samples of the file. The view stays valid for the lifetime
+  // of the reader. Only available when sample_format() is kInt16. If the
+  // header size leaves the samples misaligned, they are copied once to aligned
+  // memory at construction.
+  rtc::ArrayView<const int16_t> int16_samples() const;
+
+  // As int16_samples(), for kFloat files. Samples are returned as stored in the
+  // file, i.e. in the range [-1, 1], and not scaled to the S16 range like
+  // WavReader::ReadSamples() does. If the header size leaves the samples
+  // misaligned, they are copied once to aligned memory at construction.
+  rtc::ArrayView<const float> float_samples() const;
+
+  // Returns a view of the next |num_samples| samples, or fewer at the end of
+  // the file, and advances the read position.
+  rtc::ArrayView<const int16_t> ReadInt16Samples(size_t num_samples);
+  rtc::ArrayView<const float> ReadFloatSamples(size_t num_samples);
+
+  // Resets the read position to the beginning of the samples.
+  void Reset() { num_read_samples_ = 0; }
+
+  int sample_rate() const override { return sample_rate_; }
+  size_t num_channels() const override { return num_channels_; }
+  size_t num_samples() const override { return num_samples_in_file_; }
+  size_t num_unread_samples() const {
+    return num_samples_in_file_ - num_read_samples_;
+  }
+
+ private:
+  // Maps or reads the file into memory and sets |file_data_|/|file_size_|.
+  void LoadFile(const std::string& filename);
+
+  int sample_rate_;
+  size_t num_channels_;
+  WavFormat format_;
+  size_t num_samples_in_file_;
+  size_t num_read_samples_ = 0;
+
+  const uint8_t* file_data_ = nullptr;
+  size_t file_size_ = 0;
+  bool mapped_ = false;
+  // Backing storage when the file could not be mapped.
+  std::vector<uint8_t> file_contents_;
+  // Aligned copies of samples that are misaligned in the file.
+  std::vector<int16_t> aligned_int16_samples_;
+  std::vector<float> aligned_float_samples_;
+  const void* samples_ = nullptr;
+};
+
+}  // namespace webrtc
+
+#endif  // COMMON_AUDIO_MAPPED_WAV_READER_H_
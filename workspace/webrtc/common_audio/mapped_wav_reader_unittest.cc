@@ -0,0 +1,150 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/mapped_wav_reader.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "common_audio/include/audio_util.h"
+#include "common_audio/wav_file.h"
+#include "rtc_base/system/file_wrapper.h"
+#include "test/gtest.h"
+#include "test/testsupport/file_utils.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSampleRate = 16000;
+constexpr size_t kNumChannels = 2;
+// Not a whole number of 10 ms chunks.
+constexpr size_t kNumSamples = 3 * kSampleRate * kNumChannels + kNumChannels;
+
+std::vector<float> CreateSamples() {
+  std::vector<float> samples(kNumSamples);
+  for (size_t i = 0; i < kNumSamples; ++i) {
+    samples[i] = static_cast<float>(static_cast<int>(i * 37 % 65536) - 32768);
+  }
+  return samples;
+}
+
+}  // namespace
+
+TEST(MappedWavReaderTest, Int16SamplesMatchWavReader) {
+  const std::string outfile = test::OutputPath() + "mapped_wavtest1.wav";
+  const std::vector<float> samples = CreateSamples();
+  {
+    WavWriter w(outfile, kSampleRate, kNumChannels);
+    w.WriteSamples(samples.data(), samples.size());
+  }
+
+  MappedWavReader mapped(outfile);
+  EXPECT_EQ(kSampleRate, mapped.sample_rate());
+  EXPECT_EQ(kNumChannels, mapped.num_channels());
+  EXPECT_EQ(kNumSamples, mapped.num_samples());
+  EXPECT_EQ(WavFile::SampleFormat::kInt16, mapped.sample_format());
+
+  WavReader reader(outfile);
+  std::vector<int16_t> expected(kNumSamples);
+  ASSERT_EQ(kNumSamples, reader.ReadSamples(kNumSamples, expected.data()));
+  rtc::ArrayView<const int16_t> all = mapped.int16_samples();
+  ASSERT_EQ(kNumSamples, all.size());
+  EXPECT_TRUE(std::equal(all.begin(), all.end(), expected.begin()));
+
+  // Read in 10 ms chunks, with a short chunk at the end.
+  const size_t kChunkSize = kSampleRate / 100 * kNumChannels;
+  size_t num_read = 0;
+  while (mapped.num_unread_samples() > 0) {
+    rtc::ArrayView<const int16_t> chunk = mapped.ReadInt16Samples(kChunkSize);
+    ASSERT_LE(chunk.size(), kChunkSize);
+    EXPECT_EQ(all.data() + num_read, chunk.data());
+    num_read += chunk.size();
+  }
+  EXPECT_EQ(kNumSamples, num_read);
+  EXPECT_TRUE(mapped.ReadInt16Samples(kChunkSize).empty());
+
+  mapped.Reset();
+  EXPECT_EQ(kNumSamples, mapped.num_unread_samples());
+  EXPECT_EQ(all.data(), mapped.ReadInt16Samples(kChunkSize).data());
+}
+
+// A chunk of odd size before the data chunk puts the samples at an odd offset
+// in the file.
+TEST(MappedWavReaderTest, Int16SamplesAtOddOffsetMatchWavReader) {
+  const std::string outfile = test::OutputPath() + "mapped_wavtest3.wav";
+  const std::vector<float> samples = CreateSamples();
+  {
+    WavWriter w(outfile, kSampleRate, kNumChannels);
+    w.WriteSamples(samples.data(), samples.size());
+  }
+  std::vector<uint8_t> contents;
+  {
+    FileWrapper file = FileWrapper::OpenReadOnly(outfile);
+    ASSERT_TRUE(file.is_open());
+    contents.resize(file.FileSize());
+    ASSERT_EQ(contents.size(), file.Read(contents.data(), contents.size()));
+  }
+  // After the RIFF header and the "fmt " chunk.
+  constexpr size_t kDataChunkPos = 36;
+  const uint8_t kListChunk[] = {'L', 'I', 'S', 'T', 3, 0, 0, 0, 'a', 'b', 'c'};
+  ASSERT_EQ(0, memcmp(&contents[kDataChunkPos], "data", 4));
+  contents.insert(contents.begin() + kDataChunkPos, std::begin(kListChunk),
+                  std::end(kListChunk));
+  // The RIFF chunk size.
+  contents[4] += sizeof(kListChunk);
+  const std::string oddfile = test::OutputPath() + "mapped_wavtest4.wav";
+  {
+    FileWrapper file = FileWrapper::OpenWriteOnly(oddfile);
+    ASSERT_TRUE(file.is_open());
+    ASSERT_TRUE(file.Write(contents.data(), contents.size()));
+  }
+
+  MappedWavReader mapped(oddfile);
+  EXPECT_EQ(kNumSamples, mapped.num_samples());
+  WavReader reader(outfile);
+  std::vector<int16_t> expected(kNumSamples);
+  ASSERT_EQ(kNumSamples, reader.ReadSamples(kNumSamples, expected.data()));
+  rtc::ArrayView<const int16_t> all = mapped.int16_samples();
+  ASSERT_EQ(kNumSamples, all.size());
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(all.data()) % alignof(int16_t));
+  EXPECT_TRUE(std::equal(all.begin(), all.end(), expected.begin()));
+}
+
+TEST(MappedWavReaderTest, FloatSamplesMatchFile) {
+  const std::string outfile = test::OutputPath() + "mapped_wavtest2.wav";
+  const std::vector<float> samples = CreateSamples();
+  {
+    WavWriter w(outfile, kSampleRate, kNumChannels,
+                WavFile::SampleFormat::kFloat);
+    w.WriteSamples(samples.data(), samples.size());
+  }
+
+  MappedWavReader mapped(outfile);
+  EXPECT_EQ(kNumSamples, mapped.num_samples());
+  EXPECT_EQ(WavFile::SampleFormat::kFloat, mapped.sample_format());
+
+  // The mapped reader returns the stored [-1, 1] samples, WavReader scales them
+  // to the S16 range.
+  WavReader reader(outfile);
+  std::vector<float> expected(kNumSamples);
+  ASSERT_EQ(kNumSamples, reader.ReadSamples(kNumSamples, expected.data()));
+  rtc::ArrayView<const float> all = mapped.float_samples();
+  ASSERT_EQ(kNumSamples, all.size());
+  for (size_t i = 0; i < kNumSamples; ++i) {
+    EXPECT_EQ(expected[i], FloatToFloatS16(all[i]));
+  }
+  EXPECT_EQ(all.data(), mapped.ReadFloatSamples(10).data());
+  EXPECT_EQ(all.data() + 10, mapped.ReadFloatSamples(10).data());
+}
+
+}  // namespace webrtc
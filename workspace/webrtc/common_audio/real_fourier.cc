@@ -11,6 +11,7 @@
 #include "common_audio/real_fourier.h"
 
 #include "common_audio/real_fourier_ooura.h"
+#include "common_audio/real_fourier_pffft.h"
 #include "common_audio/signal_processing/include/signal_processing_library.h"
 #include "rtc_base/checks.h"
 
@@ -21,6 +22,10 @@ using std::complex;
 const size_t RealFourier::kFftBufferAlignment = 32;
 
 std::unique_ptr<RealFourier> RealFourier::Create(int fft_order) {
+  // PFFFT does not support the smallest orders.
+  if (fft_order >= RealFourierPffft::kMinFftOrder) {
+    return std::unique_ptr<RealFourier>(new RealFourierPffft(fft_order));
+  }
   return std::unique_ptr<RealFourier>(new RealFourierOoura(fft_order));
 }
 
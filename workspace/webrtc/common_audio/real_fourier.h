@@ -35,7 +35,8 @@ class RealFourier {
   static const size_t kFftBufferAlignment;
 
   // Construct a wrapper instance for the given input order, which must be
-  // between 1 and kMaxFftOrder, inclusively.
+  // between 1 and kMaxFftOrder, inclusively. Uses PFFFT for orders it
+  // supports, and Ooura otherwise.
   static std::unique_ptr<RealFourier> Create(int fft_order);
   virtual ~RealFourier() {}
 
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "common_audio/real_fourier.h"
+#include "common_audio/real_fourier_ooura.h"
+#include "common_audio/real_fourier_pffft.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+namespace {
+
+template <typename Fft>
+void BM_RealFourierForwardInverse(benchmark::State& state) {
+  const int order = state.range(0);
+  const Fft fft(order);
+  const size_t length = RealFourier::FftLength(order);
+  RealFourier::fft_real_scoper real = RealFourier::AllocRealBuffer(length);
+  RealFourier::fft_cplx_scoper cplx =
+      RealFourier::AllocCplxBuffer(RealFourier::ComplexLength(order));
+  for (size_t i = 0; i < length; ++i) {
+    real[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    fft.Forward(real.get(), cplx.get());
+    fft.Inverse(cplx.get(), real.get());
+    benchmark::DoNotOptimize(real.get());
+  }
+}
+
+// Creation followed by a first transform, which is when Ooura computes its
+// tables.
+template <typename Fft>
+void BM_RealFourierCreate(benchmark::State& state) {
+  const int order = state.range(0);
+  const size_t length = RealFourier::FftLength(order);
+  RealFourier::fft_real_scoper real = RealFourier::AllocRealBuffer(length);
+  RealFourier::fft_cplx_scoper cplx =
+      RealFourier::AllocCplxBuffer(RealFourier::ComplexLength(order));
+  std::fill(real.get(), real.get() + length, 1.0f);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    auto fft = std::make_unique<Fft>(order);
+    fft->Forward(real.get(), cplx.get());
+    benchmark::DoNotOptimize(cplx.get());
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_RealFourierForwardInverse, RealFourierOoura)
+    ->DenseRange(7, 10);
+BENCHMARK_TEMPLATE(BM_RealFourierForwardInverse, RealFourierPffft)
+    ->DenseRange(7, 10);
+BENCHMARK_TEMPLATE(BM_RealFourierCreate, RealFourierOoura)->DenseRange(7, 10);
+BENCHMARK_TEMPLATE(BM_RealFourierCreate, RealFourierPffft)->DenseRange(7, 10);
+
+}  // namespace
+}  // namespace webrtc
+
+/*
+
+Results (Linux, x86-64, SSE):
+
+-------------------------------------------------------------------------
+Benchmark                                              Time          CPU
+-------------------------------------------------------------------------
+BM_RealFourierForwardInverse<RealFourierOoura>/7     677 ns       673 ns
+BM_RealFourierForwardInverse<RealFourierOoura>/8    1545 ns      1520 ns
+BM_RealFourierForwardInverse<RealFourierOoura>/9    3125 ns      3112 ns
+BM_RealFourierForwardInverse<RealFourierOoura>/10   7397 ns      7339 ns
+BM_RealFourierForwardInverse<RealFourierPffft>/7     530 ns       525 ns
+BM_RealFourierForwardInverse<RealFourierPffft>/8     698 ns       688 ns
+BM_RealFourierForwardInverse<RealFourierPffft>/9    1304 ns      1293 ns
+BM_RealFourierForwardInverse<RealFourierPffft>/10   3138 ns      3106 ns
+BM_RealFourierCreate<RealFourierOoura>/7             480 ns       474 ns
+BM_RealFourierCreate<RealFourierOoura>/8            1066 ns      1055 ns
+BM_RealFourierCreate<RealFourierOoura>/9            2030 ns      2013 ns
+BM_RealFourierCreate<RealFourierOoura>/10           4495 ns      4456 ns
+BM_RealFourierCreate<RealFourierPffft>/7             167 ns       166 ns
+BM_RealFourierCreate<RealFourierPffft>/8             296 ns       292 ns
+BM_RealFourierCreate<RealFourierPffft>/9             566 ns       561 ns
+BM_RealFourierCreate<RealFourierPffft>/10           1072 ns      1068 ns
+
+Creating a RealFourierPffft only allocates its work buffer; the twiddle
+factors are shared by all instances of the same order.
+
+*/
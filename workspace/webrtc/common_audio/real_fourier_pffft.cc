@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/real_fourier_pffft.h"
+
+#include <algorithm>
+#include <array>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+#include "third_party/pffft/src/pffft.h"
+
+namespace webrtc {
+
+using std::complex;
+
+namespace {
+
+// PFFFT setups are read-only once created and can be shared by any number of
+// threads. They are created on first use and kept for the lifetime of the
+// process; there is at most one per order.
+class PffftSetupCache {
+ public:
+  static PffftSetupCache* Get() {
+    static PffftSetupCache* const cache = new PffftSetupCache();
+    return cache;
+  }
+
+  PFFFT_Setup* GetSetup(int order) {
+    RTC_CHECK_GE(order, RealFourierPffft::kMinFftOrder);
+    RTC_CHECK_LE(order, RealFourierPffft::kMaxFftOrder);
+    MutexLock lock(&mutex_);
+    PFFFT_Setup*& setup = setups_[order];
+    if (!setup) {
+      setup = pffft_new_setup(1 << order, PFFFT_REAL);
+      RTC_CHECK(setup);
+    }
+    return setup;
+  }
+
+ private:
+  PffftSetupCache() = default;
+
+  Mutex mutex_;
+  std::array<PFFFT_Setup*, RealFourierPffft::kMaxFftOrder + 1> setups_
+      RTC_GUARDED_BY(mutex_) = {};
+};
+
+}  // namespace
+
+RealFourierPffft::RealFourierPffft(int fft_order)
+    : order_(fft_order),
+      length_(FftLength(order_)),
+      complex_length_(ComplexLength(order_)),
+      setup_(PffftSetupCache::Get()->GetSetup(order_)),
+      work_(AllocRealBuffer(static_cast<int>(length_))) {}
+
+RealFourierPffft::~RealFourierPffft() = default;
+
+void RealFourierPffft::Forward(const float* src, complex<float>* dest) const {
+  // This cast is well-defined since C++11. See "Non-static data members" at:
+  // http://en.cppreference.com/w/cpp/numeric/complex
+  auto* dest_float = reinterpret_cast<float*>(dest);
+  pffft_transform_ordered(setup_, src, dest_float, work_.get(), PFFFT_FORWARD);
+
+  // PFFFT places real[n/2] in imag[0].
+  dest[complex_length_ - 1] = complex<float>(dest[0].imag(), 0.0f);
+  dest[0] = complex<float>(dest[0].real(), 0.0f);
+}
+
+void RealFourierPffft::Inverse(const complex<float>* src, float* dest) const {
+  {
+    auto* dest_complex = reinterpret_cast<complex<float>*>(dest);
+    // The real output array is shorter than the input complex array by one
+    // complex element.
+    const size_t dest_complex_length = complex_length_ - 1;
+    std::copy(src, src + dest_complex_length, dest_complex);
+    // Restore real[n/2] to imag[0].
+    dest_complex[0] =
+        complex<float>(dest_complex[0].real(), src[complex_length_ - 1].real());
+  }
+
+  // Transforms in place.
+  pffft_transform_ordered(setup_, dest, dest, work_.get(), PFFFT_BACKWARD);
+
+  // PFFFT returns a scaled version.
+  const float scale = 1.0f / length_;
+  std::for_each(dest, dest + length_, [scale](float& v) { v *= scale; });
+}
+
+int RealFourierPffft::order() const {
+  return order_;
+}
+
+}  // namespace webrtc
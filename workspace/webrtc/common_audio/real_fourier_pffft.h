@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_AUDIO_REAL_FOURIER_PFFFT_H_
+#define COMMON_AUDIO_REAL_FOURIER_PFFFT_H_
+
+#include <stddef.h>
+
+#include <complex>
+#include <memory>
+
+#include "common_audio/real_fourier.h"
+
+// Forward declaration.
+struct PFFFT_Setup;
+
+namespace webrtc {
+
+// RealFourier implementation using PFFFT, which is SIMD optimized. The PFFFT
+// setup (the twiddle factors) for each order is created once per process and
+// shared by all instances of that order, which makes creating an instance
+// cheap. Each instance has its own work buffer, so different instances can be
+// used concurrently.
+class RealFourierPffft : public RealFourier {
+ public:
+  // The smallest order supported by PFFFT for real transforms.
+  static constexpr int kMinFftOrder = 5;
+  static constexpr int kMaxFftOrder = 30;
+
+  explicit RealFourierPffft(int fft_order);
+  ~RealFourierPffft() override;
+
+  void Forward(const float* src, std::complex<float>* dest) const override;
+  void Inverse(const std::complex<float>* src, float* dest) const override;
+
+  int order() const override;
+
+ private:
+  const int order_;
+  const size_t length_;
+  const size_t complex_length_;
+  // Owned by the process-wide setup cache.
+  PFFFT_Setup* const setup_;
+  const fft_real_scoper work_;
+};
+
+}  // namespace webrtc
+
+#endif  // COMMON_AUDIO_REAL_FOURIER_PFFFT_H_
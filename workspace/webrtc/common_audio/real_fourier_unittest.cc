@@ -12,7 +12,13 @@
 
 #include <stdlib.h>
 
+#include <memory>
+#include <vector>
+
 #include "common_audio/real_fourier_ooura.h"
+#include "common_audio/real_fourier_pffft.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/random.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -99,4 +105,114 @@ TYPED_TEST(RealFourierTest, SimpleBackwardTransform) {
   EXPECT_NEAR(this->real_buffer_[3], 4.0f, 1e-8f);
 }
 
+class RealFourierPffftTest : public ::testing::TestWithParam<int> {
+ protected:
+  RealFourierPffftTest()
+      : order_(GetParam()),
+        length_(RealFourier::FftLength(order_)),
+        complex_length_(RealFourier::ComplexLength(order_)),
+        real_buffer_(RealFourier::AllocRealBuffer(length_)),
+        cplx_buffer_(RealFourier::AllocCplxBuffer(complex_length_)),
+        expected_cplx_buffer_(RealFourier::AllocCplxBuffer(complex_length_)) {
+    Random random(42);
+    for (size_t i = 0; i < length_; ++i) {
+      real_buffer_[i] = 2.0f * random.Rand<float>() - 1.0f;
+    }
+  }
+
+  const int order_;
+  const size_t length_;
+  const size_t complex_length_;
+  const RealFourier::fft_real_scoper real_buffer_;
+  const RealFourier::fft_cplx_scoper cplx_buffer_;
+  const RealFourier::fft_cplx_scoper expected_cplx_buffer_;
+};
+
+INSTANTIATE_TEST_SUITE_P(RealFourierTest,
+                         RealFourierPffftTest,
+                         ::testing::Values(5, 6, 7, 8, 9, 10, 12));
+
+TEST_P(RealFourierPffftTest, ForwardMatchesOoura) {
+  RealFourierOoura ooura(order_);
+  RealFourierPffft pffft(order_);
+  ooura.Forward(real_buffer_.get(), expected_cplx_buffer_.get());
+  pffft.Forward(real_buffer_.get(), cplx_buffer_.get());
+  const float tolerance = 1e-5f * length_;
+  for (size_t i = 0; i < complex_length_; ++i) {
+    EXPECT_NEAR(expected_cplx_buffer_[i].real(), cplx_buffer_[i].real(),
+                tolerance);
+    EXPECT_NEAR(expected_cplx_buffer_[i].imag(), cplx_buffer_[i].imag(),
+                tolerance);
+  }
+}
+
+TEST_P(RealFourierPffftTest, InverseRestoresInput) {
+  RealFourierPffft pffft(order_);
+  auto output = RealFourier::AllocRealBuffer(length_);
+  pffft.Forward(real_buffer_.get(), cplx_buffer_.get());
+  pffft.Inverse(cplx_buffer_.get(), output.get());
+  for (size_t i = 0; i < length_; ++i) {
+    EXPECT_NEAR(real_buffer_[i], output[i], 1e-5f);
+  }
+}
+
+TEST(RealFourierStaticsTest, CreateSupportsAllOrders) {
+  for (int order = 1; order <= 12; ++order) {
+    std::unique_ptr<RealFourier> fft = RealFourier::Create(order);
+    EXPECT_EQ(order, fft->order());
+
+    const size_t length = RealFourier::FftLength(order);
+    auto input = RealFourier::AllocRealBuffer(length);
+    auto output = RealFourier::AllocRealBuffer(length);
+    auto spectrum =
+        RealFourier::AllocCplxBuffer(RealFourier::ComplexLength(order));
+    for (size_t i = 0; i < length; ++i) {
+      input[i] = (i % 3) - 1.0f;
+    }
+    fft->Forward(input.get(), spectrum.get());
+    fft->Inverse(spectrum.get(), output.get());
+    for (size_t i = 0; i < length; ++i) {
+      EXPECT_NEAR(input[i], output[i], 1e-5f);
+    }
+  }
+}
+
+// Creates instances of the same orders on several threads at once, which all
+// use the shared setups.
+TEST(RealFourierStaticsTest, ConcurrentCreationAndUse) {
+  constexpr int kNumThreads = 4;
+  struct ThreadState {
+    bool success = true;
+  };
+  auto run = [](void* obj) {
+    ThreadState* state = static_cast<ThreadState*>(obj);
+    for (int iteration = 0; iteration < 50; ++iteration) {
+      for (int order = RealFourierPffft::kMinFftOrder; order <= 10; ++order) {
+        RealFourierPffft fft(order);
+        const size_t length = RealFourier::FftLength(order);
+        auto input = RealFourier::AllocRealBuffer(length);
+        auto spectrum =
+            RealFourier::AllocCplxBuffer(RealFourier::ComplexLength(order));
+        std::fill(input.get(), input.get() + length, 1.0f);
+        fft.Forward(input.get(), spectrum.get());
+        // The spectrum of a constant is a single peak at DC.
+        state->success &= spectrum[0].real() == static_cast<float>(length);
+      }
+    }
+  };
+  std::vector<ThreadState> states(kNumThreads);
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (ThreadState& state : states) {
+    threads.push_back(std::make_unique<rtc::PlatformThread>(
+        run, &state, "RealFourierTest"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Stop();
+  }
+  for (const ThreadState& state : states) {
+    EXPECT_TRUE(state.success);
+  }
+}
+
 }  // namespace webrtc
@@ -17,6 +17,22 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(WEBRTC_LINUX)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#endif
+
+#if defined(WEBRTC_LINUX) && defined(__NR_memfd_create)
+#define WEBRTC_RING_BUFFER_MIRRORING_SUPPORTED 1
+#else
+#define WEBRTC_RING_BUFFER_MIRRORING_SUPPORTED 0
+#endif
+
 // Get address of region(s) from which we can read data.
 // If the region is contiguous, |data_ptr_bytes_2| will be zero.
 // If non-contiguous, |data_ptr_bytes_2| will be the size in bytes of the second
@@ -34,8 +50,9 @@ static size_t GetBufferReadRegions(RingBuffer* buf,
       readable_elements : element_count);
   const size_t margin = buf->element_count - buf->read_pos;
 
-  // Check to see if read is not contiguous.
-  if (read_elements > margin) {
+  // Check to see if read is not contiguous. A mirrored buffer continues into
+  // its second mapping, so reads never need to be split.
+  if (read_elements > margin && !buf->mirrored) {
     // Write data in two blocks that wrap the buffer.
     *data_ptr_1 = buf->data + buf->read_pos * buf->element_size;
     *data_ptr_bytes_1 = margin * buf->element_size;
@@ -71,9 +88,103 @@ RingBuffer* WebRtc_CreateBuffer(size_t element_count, size_t element_size) {
 
   self->element_count = element_count;
   self->element_size = element_size;
+  self->mirrored = 0;
+  WebRtc_InitBuffer(self);
+
+  return self;
+}
+
+#if WEBRTC_RING_BUFFER_MIRRORING_SUPPORTED
+static size_t GreatestCommonDivisor(size_t a, size_t b) {
+  while (b != 0) {
+    const size_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// Maps |bytes| of anonymous shared memory twice, back-to-back, and returns the
+// start of the first mapping, or NULL on failure. |bytes| must be a multiple of
+// the page size.
+static char* MapMirroredMemory(size_t bytes) {
+  char* address = NULL;
+  void* mapping = NULL;
+  const int fd =
+      (int)syscall(__NR_memfd_create, "webrtc_ring_buffer", MFD_CLOEXEC);
+  if (fd < 0) {
+    return NULL;
+  }
+  if (ftruncate(fd, (off_t)bytes) != 0) {
+    close(fd);
+    return NULL;
+  }
+
+  // Reserve the address range for both halves, then map the file into it.
+  mapping = mmap(NULL, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED) {
+    close(fd);
+    return NULL;
+  }
+  address = (char*)mapping;
+  if (mmap(address, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd,
+           0) == MAP_FAILED ||
+      mmap(address + bytes, bytes, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+    munmap(address, 2 * bytes);
+    close(fd);
+    return NULL;
+  }
+
+  // The mappings keep the memory alive.
+  close(fd);
+  return address;
+}
+#endif  // WEBRTC_RING_BUFFER_MIRRORING_SUPPORTED
+
+RingBuffer* WebRtc_CreateMirroredBuffer(size_t element_count,
+                                        size_t element_size) {
+#if WEBRTC_RING_BUFFER_MIRRORING_SUPPORTED
+  RingBuffer* self = NULL;
+  size_t granularity = 0;
+  size_t bytes = 0;
+  const long page_size = sysconf(_SC_PAGESIZE);
+  if (element_count == 0 || element_size == 0 || page_size <= 0) {
+    return NULL;
+  }
+
+  // The buffer size has to be a multiple of both the page size and the element
+  // size, so that the wrap point of the ring coincides with the mirror.
+  granularity = ((size_t)page_size / GreatestCommonDivisor((size_t)page_size,
+                                                           element_size)) *
+                element_size;
+  if (granularity > ((size_t)-1) / 2 ||
+      element_count > (((size_t)-1) / 2 - granularity) / element_size) {
+    return NULL;
+  }
+  bytes = element_count * element_size;
+  bytes = ((bytes + granularity - 1) / granularity) * granularity;
+
+  self = malloc(sizeof(RingBuffer));
+  if (!self) {
+    return NULL;
+  }
+
+  self->data = MapMirroredMemory(bytes);
+  if (!self->data) {
+    free(self);
+    return WebRtc_CreateBuffer(element_count, element_size);
+  }
+
+  self->element_count = bytes / element_size;
+  self->element_size = element_size;
+  self->mirrored = 1;
   WebRtc_InitBuffer(self);
 
   return self;
+#else
+  return WebRtc_CreateBuffer(element_count, element_size);
+#endif
 }
 
 void WebRtc_InitBuffer(RingBuffer* self) {
@@ -91,6 +202,14 @@ void WebRtc_FreeBuffer(void* handle) {
     return;
   }
 
+#if WEBRTC_RING_BUFFER_MIRRORING_SUPPORTED
+  if (self->mirrored) {
+    munmap(self->data, 2 * self->element_count * self->element_size);
+    free(self);
+    return;
+  }
+#endif
+
   free(self->data);
   free(self);
 }
@@ -157,6 +276,20 @@ size_t WebRtc_WriteBuffer(RingBuffer* self,
     size_t n = write_elements;
     const size_t margin = self->element_count - self->write_pos;
 
+    if (self->mirrored) {
+      // The second mapping aliases the start of the buffer, so the write can be
+      // done in one block even when it wraps.
+      memcpy(self->data + self->write_pos * self->element_size, data,
+             write_elements * self->element_size);
+      if (write_elements > margin) {
+        self->write_pos = write_elements - margin;
+        self->rw_wrap = DIFF_WRAP;
+      } else {
+        self->write_pos += write_elements;
+      }
+      return write_elements;
+    }
+
     if (write_elements > margin) {
       // Buffer wrap around when writing.
       memcpy(self->data + self->write_pos * self->element_size,
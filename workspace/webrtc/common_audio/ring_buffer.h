@@ -31,10 +31,23 @@ typedef struct RingBuffer {
   size_t element_size;
   enum Wrap rw_wrap;
   char* data;
+  // Non-zero if |data| is mapped twice back-to-back in virtual memory, see
+  // WebRtc_CreateMirroredBuffer().
+  int mirrored;
 } RingBuffer;
 
 // Creates and initializes the buffer. Returns null on failure.
 RingBuffer* WebRtc_CreateBuffer(size_t element_count, size_t element_size);
+
+// Creates and initializes a buffer whose storage is mapped twice, back-to-back,
+// in virtual memory. Every readable region is then contiguous, so
+// WebRtc_ReadBuffer() always returns a pointer into the buffer and never copies
+// to |data|. |element_count| is rounded up so that the size of the buffer is a
+// multiple of the page size; the actual capacity is found in |element_count| of
+// the returned handle. Only available on Linux and Android; elsewhere, or if
+// the mapping fails, this behaves like WebRtc_CreateBuffer().
+RingBuffer* WebRtc_CreateMirroredBuffer(size_t element_count,
+                                        size_t element_size);
 void WebRtc_InitBuffer(RingBuffer* handle);
 void WebRtc_FreeBuffer(void* handle);
 
@@ -49,7 +49,7 @@ static int CheckIncrementingData(int* data,
 
 // We use ASSERTs in this test to avoid obscuring the seed in the case of a
 // failure.
-static void RandomStressTest(int** data_ptr) {
+static void RandomStressTest(int** data_ptr, bool mirrored) {
   const int kNumTests = 10;
   const int kNumOps = 1000;
   const int kMaxBufferSize = 1000;
@@ -59,12 +59,17 @@ static void RandomStressTest(int** data_ptr) {
   srand(seed);
   for (int i = 0; i < kNumTests; i++) {
     // rand_r is not supported on many platforms, so rand is used.
-    const int buffer_size = std::max(rand() % kMaxBufferSize, 1);  // NOLINT
-    std::unique_ptr<int[]> write_data(new int[buffer_size]);
-    std::unique_ptr<int[]> read_data(new int[buffer_size]);
-    scoped_ring_buffer buffer(WebRtc_CreateBuffer(buffer_size, sizeof(int)));
+    const int requested_size = std::max(rand() % kMaxBufferSize, 1);  // NOLINT
+    scoped_ring_buffer buffer(
+        mirrored ? WebRtc_CreateMirroredBuffer(requested_size, sizeof(int))
+                 : WebRtc_CreateBuffer(requested_size, sizeof(int)));
     ASSERT_TRUE(buffer.get() != nullptr);
     WebRtc_InitBuffer(buffer.get());
+    // A mirrored buffer may be larger than requested.
+    const int buffer_size = static_cast<int>(buffer->element_count);
+    ASSERT_GE(buffer_size, requested_size);
+    std::unique_ptr<int[]> write_data(new int[buffer_size]);
+    std::unique_ptr<int[]> read_data(new int[buffer_size]);
     int buffer_consumed = 0;
     int write_element = 0;
     int read_element = 0;
@@ -105,11 +110,20 @@ static void RandomStressTest(int** data_ptr) {
 
 TEST(RingBufferTest, RandomStressTest) {
   int* data_ptr = nullptr;
-  RandomStressTest(&data_ptr);
+  RandomStressTest(&data_ptr, /*mirrored=*/false);
 }
 
 TEST(RingBufferTest, RandomStressTestWithNullPtr) {
-  RandomStressTest(nullptr);
+  RandomStressTest(nullptr, /*mirrored=*/false);
+}
+
+TEST(RingBufferTest, RandomStressTestMirrored) {
+  int* data_ptr = nullptr;
+  RandomStressTest(&data_ptr, /*mirrored=*/true);
+}
+
+TEST(RingBufferTest, RandomStressTestMirroredWithNullPtr) {
+  RandomStressTest(nullptr, /*mirrored=*/true);
 }
 
 TEST(RingBufferTest, PassingNulltoReadBufferForcesMemcpy) {
@@ -139,6 +153,50 @@ TEST(RingBufferTest, PassingNulltoReadBufferForcesMemcpy) {
   CheckIncrementingData(read_data, kDataSize, 0);
 }
 
+TEST(RingBufferTest, MirroredBufferReadsWithoutCopyWhenWrapping) {
+  scoped_ring_buffer buffer(WebRtc_CreateMirroredBuffer(1, sizeof(int)));
+  ASSERT_TRUE(buffer.get() != nullptr);
+  if (!buffer->mirrored) {
+    // Mirroring is not supported on this platform.
+    return;
+  }
+  const size_t kCapacity = buffer->element_count;
+  const size_t kChunkSize = kCapacity / 2 + 1;
+  std::unique_ptr<int[]> write_data(new int[kChunkSize]);
+  std::unique_ptr<int[]> read_data(new int[kChunkSize]);
+  int* data_ptr = nullptr;
+
+  // Move the read and write positions past the middle of the buffer, so that
+  // the next chunk wraps around the end.
+  SetIncrementingData(write_data.get(), kChunkSize, 0);
+  EXPECT_EQ(kChunkSize,
+            WebRtc_WriteBuffer(buffer.get(), write_data.get(), kChunkSize));
+  EXPECT_EQ(kChunkSize, WebRtc_ReadBuffer(buffer.get(), nullptr,
+                                          read_data.get(), kChunkSize));
+
+  const int next = SetIncrementingData(write_data.get(), kChunkSize, 100);
+  EXPECT_EQ(kChunkSize,
+            WebRtc_WriteBuffer(buffer.get(), write_data.get(), kChunkSize));
+  SetIncrementingData(read_data.get(), kChunkSize, next);
+  EXPECT_EQ(kChunkSize,
+            WebRtc_ReadBuffer(buffer.get(), reinterpret_cast<void**>(&data_ptr),
+                              read_data.get(), kChunkSize));
+  // The data wrapped, but is still returned in place.
+  EXPECT_NE(read_data.get(), data_ptr);
+  CheckIncrementingData(data_ptr, kChunkSize, 100);
+  CheckIncrementingData(read_data.get(), kChunkSize, next);
+}
+
+TEST(RingBufferTest, CreateMirroredRoundsUpToPageSize) {
+  EXPECT_TRUE(WebRtc_CreateMirroredBuffer(0, 1) == nullptr);
+  EXPECT_TRUE(WebRtc_CreateMirroredBuffer(1, 0) == nullptr);
+  scoped_ring_buffer buffer(WebRtc_CreateMirroredBuffer(480, 3));
+  ASSERT_TRUE(buffer.get() != nullptr);
+  EXPECT_GE(buffer->element_count, 480u);
+  EXPECT_EQ(buffer->element_count, WebRtc_available_write(buffer.get()));
+  EXPECT_EQ(0u, WebRtc_available_read(buffer.get()));
+}
+
 TEST(RingBufferTest, CreateHandlesErrors) {
   EXPECT_TRUE(WebRtc_CreateBuffer(0, 1) == nullptr);
   EXPECT_TRUE(WebRtc_CreateBuffer(1, 0) == nullptr);
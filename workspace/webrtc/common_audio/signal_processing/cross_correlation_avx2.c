@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+// Bit-exact with the C version, see cross_correlation_sse2.c.
+static inline int32_t DotProductWithScaleAVX2(const int16_t* vector1,
+                                              const int16_t* vector2,
+                                              size_t length,
+                                              int scaling) {
+  const __m128i shift = _mm_cvtsi32_si128(scaling);
+  __m256i sum = _mm256_setzero_si256();
+  __m128i sum128;
+  size_t i = 0;
+  int32_t corr = 0;
+
+  if (scaling == 0) {
+    for (; i + 16 <= length; i += 16) {
+      const __m256i v1 = _mm256_loadu_si256((const __m256i*)&vector1[i]);
+      const __m256i v2 = _mm256_loadu_si256((const __m256i*)&vector2[i]);
+      sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v1, v2));
+    }
+  } else {
+    for (; i + 16 <= length; i += 16) {
+      const __m256i v1 = _mm256_loadu_si256((const __m256i*)&vector1[i]);
+      const __m256i v2 = _mm256_loadu_si256((const __m256i*)&vector2[i]);
+      const __m256i lo = _mm256_mullo_epi16(v1, v2);
+      const __m256i hi = _mm256_mulhi_epi16(v1, v2);
+      const __m256i prod0 = _mm256_unpacklo_epi16(lo, hi);
+      const __m256i prod1 = _mm256_unpackhi_epi16(lo, hi);
+      sum = _mm256_add_epi32(sum, _mm256_sra_epi32(prod0, shift));
+      sum = _mm256_add_epi32(sum, _mm256_sra_epi32(prod1, shift));
+    }
+  }
+  sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                         _mm256_extracti128_si256(sum, 1));
+  sum128 = _mm_add_epi32(sum128,
+                         _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum128 = _mm_add_epi32(sum128,
+                         _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+  corr = _mm_cvtsi128_si32(sum128);
+
+  // Calculate the rest of the samples.
+  for (; i < length; i++) {
+    corr += (vector1[i] * vector2[i]) >> scaling;
+  }
+  return corr;
+}
+
+// AVX2 version of WebRtcSpl_CrossCorrelation() for x86 platforms.
+void WebRtcSpl_CrossCorrelationAVX2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2) {
+  size_t i = 0;
+
+  for (i = 0; i < dim_cross_correlation; i++) {
+    *cross_correlation++ =
+        DotProductWithScaleAVX2(seq1, seq2, dim_seq, right_shifts);
+    seq2 += step_seq2;
+  }
+}
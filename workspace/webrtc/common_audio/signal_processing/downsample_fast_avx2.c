@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+#include <stddef.h>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+// Loads data_in[0], data_in[factor], ..., data_in[15 * factor].
+static inline __m256i LoadStrided(const int16_t* data_in, int factor) {
+  if (factor == 1) {
+    return _mm256_loadu_si256((const __m256i*)data_in);
+  }
+  if (factor == 2) {
+    // Take the even samples of data_in[0..15] and the odd samples of
+    // data_in[15..30], so that nothing beyond the last used sample is read.
+    // The pack works per 128-bit lane, hence the final permutation.
+    const __m256i v0 = _mm256_loadu_si256((const __m256i*)data_in);
+    const __m256i v1 = _mm256_loadu_si256((const __m256i*)&data_in[15]);
+    const __m256i packed =
+        _mm256_packs_epi32(_mm256_srai_epi32(_mm256_slli_epi32(v0, 16), 16),
+                           _mm256_srai_epi32(v1, 16));
+    return _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+  }
+  return _mm256_setr_epi16(
+      data_in[0], data_in[factor], data_in[2 * factor], data_in[3 * factor],
+      data_in[4 * factor], data_in[5 * factor], data_in[6 * factor],
+      data_in[7 * factor], data_in[8 * factor], data_in[9 * factor],
+      data_in[10 * factor], data_in[11 * factor], data_in[12 * factor],
+      data_in[13 * factor], data_in[14 * factor], data_in[15 * factor]);
+}
+
+// AVX2 version of WebRtcSpl_DownsampleFast() for x86 platforms. Same scheme as
+// the SSE2 version, with sixteen outputs at a time.
+int WebRtcSpl_DownsampleFastAVX2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t k = 0;
+  int32_t out_s32 = 0;
+  size_t endpos = delay + factor * (data_out_length - 1) + 1;
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length == 0 || coefficients_length == 0
+                           || data_in_length < endpos) {
+    return -1;
+  }
+
+  i = delay;
+  for (; k + 16 <= data_out_length; k += 16, i += 16 * factor) {
+    const __m256i round = _mm256_set1_epi32(2048);  // 0.5 in Q12.
+    // The unpacks work per 128-bit lane: |acc_lo| holds outputs 0-3 and 8-11,
+    // |acc_hi| outputs 4-7 and 12-15, which the final pack puts back in order.
+    __m256i acc_lo = round;
+    __m256i acc_hi = round;
+
+    // Negative indices are permitted, see the C version.
+    for (j = 0; j + 1 < coefficients_length; j += 2) {
+      const __m256i x0 = LoadStrided(&data_in[(ptrdiff_t)i - (ptrdiff_t)j],
+                                     factor);
+      const __m256i x1 = LoadStrided(
+          &data_in[(ptrdiff_t)i - (ptrdiff_t)j - 1], factor);
+      const __m256i c = _mm256_set1_epi32(
+          (int32_t)((uint16_t)coefficients[j] |
+                    ((uint32_t)(uint16_t)coefficients[j + 1] << 16)));
+      acc_lo = _mm256_add_epi32(
+          acc_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(x0, x1), c));
+      acc_hi = _mm256_add_epi32(
+          acc_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(x0, x1), c));
+    }
+    if (j < coefficients_length) {
+      const __m256i x0 = LoadStrided(&data_in[(ptrdiff_t)i - (ptrdiff_t)j],
+                                     factor);
+      const __m256i c = _mm256_set1_epi32((uint16_t)coefficients[j]);
+      acc_lo = _mm256_add_epi32(
+          acc_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(x0, x0), c));
+      acc_hi = _mm256_add_epi32(
+          acc_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(x0, x0), c));
+    }
+
+    // Shift to Q0, saturate and store the outputs.
+    _mm256_storeu_si256((__m256i*)&data_out[k],
+                        _mm256_packs_epi32(_mm256_srai_epi32(acc_lo, 12),
+                                           _mm256_srai_epi32(acc_hi, 12)));
+  }
+
+  // Calculate the rest of the samples.
+  for (; k < data_out_length; k++, i += factor) {
+    out_s32 = 2048;  // Round value, 0.5 in Q12.
+    for (j = 0; j < coefficients_length; j++) {
+      out_s32 += coefficients[j] * data_in[(ptrdiff_t)i - (ptrdiff_t)j];
+    }
+    out_s32 >>= 12;  // Q0.
+    data_out[k] = WebRtcSpl_SatW32ToW16(out_s32);
+  }
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+#include <stddef.h>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+// Loads data_in[0], data_in[factor], ..., data_in[7 * factor].
+static inline __m128i LoadStrided(const int16_t* data_in, int factor) {
+  if (factor == 1) {
+    return _mm_loadu_si128((const __m128i*)data_in);
+  }
+  if (factor == 2) {
+    // Take the even samples of data_in[0..7] and the odd samples of
+    // data_in[7..14], so that nothing beyond the last used sample is read.
+    const __m128i v0 = _mm_loadu_si128((const __m128i*)data_in);
+    const __m128i v1 = _mm_loadu_si128((const __m128i*)&data_in[7]);
+    return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(v0, 16), 16),
+                           _mm_srai_epi32(v1, 16));
+  }
+  return _mm_setr_epi16(data_in[0], data_in[factor], data_in[2 * factor],
+                        data_in[3 * factor], data_in[4 * factor],
+                        data_in[5 * factor], data_in[6 * factor],
+                        data_in[7 * factor]);
+}
+
+// SSE2 version of WebRtcSpl_DownsampleFast() for x86 platforms. Computes eight
+// outputs at a time, two filter taps per multiply-add, and is bit-exact with
+// the C version.
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t k = 0;
+  int32_t out_s32 = 0;
+  size_t endpos = delay + factor * (data_out_length - 1) + 1;
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length == 0 || coefficients_length == 0
+                           || data_in_length < endpos) {
+    return -1;
+  }
+
+  i = delay;
+  for (; k + 8 <= data_out_length; k += 8, i += 8 * factor) {
+    const __m128i round = _mm_set1_epi32(2048);  // 0.5 in Q12.
+    __m128i acc_lo = round;
+    __m128i acc_hi = round;
+
+    // Negative indices are permitted, see the C version.
+    for (j = 0; j + 1 < coefficients_length; j += 2) {
+      const __m128i x0 = LoadStrided(&data_in[(ptrdiff_t)i - (ptrdiff_t)j],
+                                     factor);
+      const __m128i x1 = LoadStrided(
+          &data_in[(ptrdiff_t)i - (ptrdiff_t)j - 1], factor);
+      const __m128i c = _mm_set1_epi32(
+          (int32_t)((uint16_t)coefficients[j] |
+                    ((uint32_t)(uint16_t)coefficients[j + 1] << 16)));
+      acc_lo = _mm_add_epi32(acc_lo,
+                             _mm_madd_epi16(_mm_unpacklo_epi16(x0, x1), c));
+      acc_hi = _mm_add_epi32(acc_hi,
+                             _mm_madd_epi16(_mm_unpackhi_epi16(x0, x1), c));
+    }
+    if (j < coefficients_length) {
+      const __m128i x0 = LoadStrided(&data_in[(ptrdiff_t)i - (ptrdiff_t)j],
+                                     factor);
+      const __m128i c = _mm_set1_epi32((uint16_t)coefficients[j]);
+      acc_lo = _mm_add_epi32(acc_lo,
+                             _mm_madd_epi16(_mm_unpacklo_epi16(x0, x0), c));
+      acc_hi = _mm_add_epi32(acc_hi,
+                             _mm_madd_epi16(_mm_unpackhi_epi16(x0, x0), c));
+    }
+
+    // Shift to Q0, saturate and store the outputs.
+    _mm_storeu_si128((__m128i*)&data_out[k],
+                     _mm_packs_epi32(_mm_srai_epi32(acc_lo, 12),
+                                     _mm_srai_epi32(acc_hi, 12)));
+  }
+
+  // Calculate the rest of the samples.
+  for (; k < data_out_length; k++, i += factor) {
+    out_s32 = 2048;  // Round value, 0.5 in Q12.
+    for (j = 0; j < coefficients_length; j++) {
+      out_s32 += coefficients[j] * data_in[(ptrdiff_t)i - (ptrdiff_t)j];
+    }
+    out_s32 >>= 12;  // Q0.
+    data_out[k] = WebRtcSpl_SatW32ToW16(out_s32);
+  }
+
+  return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+#include <stdlib.h>
+
+#include "rtc_base/checks.h"
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+static inline int16_t HorizontalMaxEpi16(__m256i v) {
+  __m128i w = _mm_max_epi16(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  w = _mm_max_epi16(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(1, 0, 3, 2)));
+  w = _mm_max_epi16(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  w = _mm_max_epi16(w, _mm_shufflelo_epi16(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(w);
+}
+
+static inline int16_t HorizontalMinEpi16(__m256i v) {
+  __m128i w = _mm_min_epi16(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  w = _mm_min_epi16(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(1, 0, 3, 2)));
+  w = _mm_min_epi16(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  w = _mm_min_epi16(w, _mm_shufflelo_epi16(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(w);
+}
+
+static inline uint32_t HorizontalMaxEpu32(__m256i v) {
+  __m128i w = _mm_max_epu32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  w = _mm_max_epu32(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(1, 0, 3, 2)));
+  w = _mm_max_epu32(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (uint32_t)_mm_cvtsi128_si32(w);
+}
+
+static inline int32_t HorizontalMaxEpi32(__m256i v) {
+  __m128i w = _mm_max_epi32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  w = _mm_max_epi32(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(1, 0, 3, 2)));
+  w = _mm_max_epi32(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(w);
+}
+
+static inline int32_t HorizontalMinEpi32(__m256i v) {
+  __m128i w = _mm_min_epi32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  w = _mm_min_epi32(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(1, 0, 3, 2)));
+  w = _mm_min_epi32(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(w);
+}
+
+// AVX2 version of WebRtcSpl_MaxAbsValueW16C() for x86 platforms.
+int16_t WebRtcSpl_MaxAbsValueW16AVX2(const int16_t* vector, size_t length) {
+  size_t i = 0;
+  int absolute = 0, maximum = 0;
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i max_v = zero;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 16 <= length; i += 16) {
+    const __m256i v = _mm256_loadu_si256((const __m256i*)&vector[i]);
+    // The saturating negation maps -32768 to 32767, like the final guard of
+    // the C version.
+    max_v = _mm256_max_epi16(max_v,
+                             _mm256_max_epi16(v, _mm256_subs_epi16(zero, v)));
+  }
+  maximum = HorizontalMaxEpi16(max_v);
+
+  for (; i < length; i++) {
+    absolute = abs((int)vector[i]);
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  // Guard the case for abs(-32768).
+  if (maximum > WEBRTC_SPL_WORD16_MAX) {
+    maximum = WEBRTC_SPL_WORD16_MAX;
+  }
+
+  return (int16_t)maximum;
+}
+
+// AVX2 version of WebRtcSpl_MaxAbsValueW32C() for x86 platforms.
+int32_t WebRtcSpl_MaxAbsValueW32AVX2(const int32_t* vector, size_t length) {
+  // Use uint32_t for the local variables, to accommodate the return value
+  // of abs(0x80000000), which is 0x80000000.
+  uint32_t absolute = 0, maximum = 0;
+  size_t i = 0;
+  __m256i max_v = _mm256_setzero_si256();
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    const __m256i v = _mm256_loadu_si256((const __m256i*)&vector[i]);
+    max_v = _mm256_max_epu32(max_v, _mm256_abs_epi32(v));
+  }
+  maximum = HorizontalMaxEpu32(max_v);
+
+  for (; i < length; i++) {
+    // Computed in unsigned arithmetic, since abs(0x80000000) is undefined.
+    absolute = vector[i] < 0 ? 0u - (uint32_t)vector[i] : (uint32_t)vector[i];
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  maximum = WEBRTC_SPL_MIN(maximum, WEBRTC_SPL_WORD32_MAX);
+
+  return (int32_t)maximum;
+}
+
+// AVX2 version of WebRtcSpl_MaxValueW16C() for x86 platforms.
+int16_t WebRtcSpl_MaxValueW16AVX2(const int16_t* vector, size_t length) {
+  int16_t maximum = WEBRTC_SPL_WORD16_MIN;
+  size_t i = 0;
+  __m256i max_v = _mm256_set1_epi16(WEBRTC_SPL_WORD16_MIN);
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 16 <= length; i += 16) {
+    max_v = _mm256_max_epi16(max_v,
+                             _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  maximum = HorizontalMaxEpi16(max_v);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// AVX2 version of WebRtcSpl_MaxValueW32C() for x86 platforms.
+int32_t WebRtcSpl_MaxValueW32AVX2(const int32_t* vector, size_t length) {
+  int32_t maximum = WEBRTC_SPL_WORD32_MIN;
+  size_t i = 0;
+  __m256i max_v = _mm256_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    max_v = _mm256_max_epi32(max_v,
+                             _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  maximum = HorizontalMaxEpi32(max_v);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// AVX2 version of WebRtcSpl_MinValueW16C() for x86 platforms.
+int16_t WebRtcSpl_MinValueW16AVX2(const int16_t* vector, size_t length) {
+  int16_t minimum = WEBRTC_SPL_WORD16_MAX;
+  size_t i = 0;
+  __m256i min_v = _mm256_set1_epi16(WEBRTC_SPL_WORD16_MAX);
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 16 <= length; i += 16) {
+    min_v = _mm256_min_epi16(min_v,
+                             _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  minimum = HorizontalMinEpi16(min_v);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
+
+// AVX2 version of WebRtcSpl_MinValueW32C() for x86 platforms.
+int32_t WebRtcSpl_MinValueW32AVX2(const int32_t* vector, size_t length) {
+  int32_t minimum = WEBRTC_SPL_WORD32_MAX;
+  size_t i = 0;
+  __m256i min_v = _mm256_set1_epi32(WEBRTC_SPL_WORD32_MAX);
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    min_v = _mm256_min_epi32(min_v,
+                             _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  minimum = HorizontalMinEpi32(min_v);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
@@ -0,0 +1,202 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+#include <stdlib.h>
+
+#include "rtc_base/checks.h"
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+// SSE2 has no 32-bit min/max, so they are done with a compare and a select.
+static inline __m128i MaxEpi32(__m128i a, __m128i b) {
+  const __m128i a_greater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(a_greater, a),
+                      _mm_andnot_si128(a_greater, b));
+}
+
+static inline __m128i MinEpi32(__m128i a, __m128i b) {
+  const __m128i a_greater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(a_greater, b),
+                      _mm_andnot_si128(a_greater, a));
+}
+
+static inline int16_t HorizontalMaxEpi16(__m128i v) {
+  v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  v = _mm_max_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+static inline int16_t HorizontalMinEpi16(__m128i v) {
+  v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  v = _mm_min_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+static inline int32_t HorizontalMaxEpi32(__m128i v) {
+  v = MaxEpi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = MaxEpi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(v);
+}
+
+static inline int32_t HorizontalMinEpi32(__m128i v) {
+  v = MinEpi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = MinEpi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(v);
+}
+
+// SSE2 version of WebRtcSpl_MaxAbsValueW16C() for x86 platforms.
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, size_t length) {
+  size_t i = 0;
+  int absolute = 0, maximum = 0;
+  const __m128i zero = _mm_setzero_si128();
+  __m128i max_v = zero;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)&vector[i]);
+    // The saturating negation maps -32768 to 32767, like the final guard of
+    // the C version.
+    max_v = _mm_max_epi16(max_v, _mm_max_epi16(v, _mm_subs_epi16(zero, v)));
+  }
+  maximum = HorizontalMaxEpi16(max_v);
+
+  for (; i < length; i++) {
+    absolute = abs((int)vector[i]);
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  // Guard the case for abs(-32768).
+  if (maximum > WEBRTC_SPL_WORD16_MAX) {
+    maximum = WEBRTC_SPL_WORD16_MAX;
+  }
+
+  return (int16_t)maximum;
+}
+
+// SSE2 version of WebRtcSpl_MaxAbsValueW32C() for x86 platforms.
+int32_t WebRtcSpl_MaxAbsValueW32SSE2(const int32_t* vector, size_t length) {
+  // Use uint32_t for the local variables, to accommodate the return value
+  // of abs(0x80000000), which is 0x80000000.
+  uint32_t absolute = 0, maximum = 0;
+  size_t i = 0;
+  __m128i max_v = _mm_setzero_si128();
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 4 <= length; i += 4) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)&vector[i]);
+    const __m128i sign = _mm_srai_epi32(v, 31);
+    __m128i abs_v = _mm_sub_epi32(_mm_xor_si128(v, sign), sign);
+    // abs(0x80000000) is 0x80000000; saturate it to 0x7fffffff already here
+    // so that a signed max can be used.
+    abs_v = _mm_sub_epi32(abs_v, _mm_srli_epi32(abs_v, 31));
+    max_v = MaxEpi32(max_v, abs_v);
+  }
+  maximum = (uint32_t)HorizontalMaxEpi32(max_v);
+
+  for (; i < length; i++) {
+    // Computed in unsigned arithmetic, since abs(0x80000000) is undefined.
+    absolute = vector[i] < 0 ? 0u - (uint32_t)vector[i] : (uint32_t)vector[i];
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  maximum = WEBRTC_SPL_MIN(maximum, WEBRTC_SPL_WORD32_MAX);
+
+  return (int32_t)maximum;
+}
+
+// SSE2 version of WebRtcSpl_MaxValueW16C() for x86 platforms.
+int16_t WebRtcSpl_MaxValueW16SSE2(const int16_t* vector, size_t length) {
+  int16_t maximum = WEBRTC_SPL_WORD16_MIN;
+  size_t i = 0;
+  __m128i max_v = _mm_set1_epi16(WEBRTC_SPL_WORD16_MIN);
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    max_v = _mm_max_epi16(max_v,
+                          _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  maximum = HorizontalMaxEpi16(max_v);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// SSE2 version of WebRtcSpl_MaxValueW32C() for x86 platforms.
+int32_t WebRtcSpl_MaxValueW32SSE2(const int32_t* vector, size_t length) {
+  int32_t maximum = WEBRTC_SPL_WORD32_MIN;
+  size_t i = 0;
+  __m128i max_v = _mm_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 4 <= length; i += 4) {
+    max_v = MaxEpi32(max_v, _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  maximum = HorizontalMaxEpi32(max_v);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// SSE2 version of WebRtcSpl_MinValueW16C() for x86 platforms.
+int16_t WebRtcSpl_MinValueW16SSE2(const int16_t* vector, size_t length) {
+  int16_t minimum = WEBRTC_SPL_WORD16_MAX;
+  size_t i = 0;
+  __m128i min_v = _mm_set1_epi16(WEBRTC_SPL_WORD16_MAX);
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    min_v = _mm_min_epi16(min_v,
+                          _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  minimum = HorizontalMinEpi16(min_v);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
+
+// SSE2 version of WebRtcSpl_MinValueW32C() for x86 platforms.
+int32_t WebRtcSpl_MinValueW32SSE2(const int32_t* vector, size_t length) {
+  int32_t minimum = WEBRTC_SPL_WORD32_MAX;
+  size_t i = 0;
+  __m128i min_v = _mm_set1_epi32(WEBRTC_SPL_WORD32_MAX);
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 4 <= length; i += 4) {
+    min_v = MinEpi32(min_v, _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  minimum = HorizontalMinEpi32(min_v);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/system/unused.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+// The lengths are those used by the VAD (80, 160 and 240 samples per frame),
+// AECM (128) and the iSAC pitch analysis (480).
+
+std::vector<int16_t> RandomSamples(size_t length) {
+  Random random(42);
+  std::vector<int16_t> samples(length);
+  for (int16_t& x : samples) {
+    x = random.Rand<int16_t>();
+  }
+  return samples;
+}
+
+bool SkipIfUnsupported(benchmark::State& state, bool supported) {
+  if (!supported) {
+    state.SkipWithError("Not supported by this CPU");
+  }
+  return !supported;
+}
+
+void BM_MaxAbsValueW16(benchmark::State& state,
+                       MaxAbsValueW16 function,
+                       bool supported) {
+  if (SkipIfUnsupported(state, supported)) {
+    return;
+  }
+  const std::vector<int16_t> samples = RandomSamples(state.range(0));
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    benchmark::DoNotOptimize(function(samples.data(), samples.size()));
+  }
+}
+
+void BM_CrossCorrelation(benchmark::State& state,
+                         CrossCorrelation function,
+                         bool supported) {
+  if (SkipIfUnsupported(state, supported)) {
+    return;
+  }
+  // As in the iSAC pitch analysis: correlate against a range of lags.
+  const size_t kNumLags = 20;
+  const std::vector<int16_t> seq1 = RandomSamples(state.range(0));
+  const std::vector<int16_t> seq2 = RandomSamples(state.range(0) + kNumLags);
+  std::vector<int32_t> cross_correlation(kNumLags);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    function(cross_correlation.data(), seq1.data(), seq2.data(), seq1.size(),
+              kNumLags, /*right_shifts=*/2, /*step_seq2=*/1);
+    benchmark::DoNotOptimize(cross_correlation.data());
+  }
+}
+
+void BM_DownsampleFast(benchmark::State& state,
+                       DownsampleFast function,
+                       bool supported) {
+  if (SkipIfUnsupported(state, supported)) {
+    return;
+  }
+  // Downsampling by two with a 12-tap filter, as in the iSAC decimator.
+  const int kFactor = 2;
+  const size_t kNumCoefficients = 12;
+  const size_t data_out_length = state.range(0) / kFactor;
+  const std::vector<int16_t> coefficients = RandomSamples(kNumCoefficients);
+  const std::vector<int16_t> data_in =
+      RandomSamples(kNumCoefficients + state.range(0));
+  std::vector<int16_t> data_out(data_out_length);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    function(data_in.data(), data_in.size(), data_out.data(),
+              data_out_length, coefficients.data(), kNumCoefficients, kFactor,
+              kNumCoefficients - 1);
+    benchmark::DoNotOptimize(data_out.data());
+  }
+}
+
+void Lengths(benchmark::internal::Benchmark* b) {
+  for (int length : {80, 128, 160, 240, 480}) {
+    b->Arg(length);
+  }
+}
+
+BENCHMARK_CAPTURE(BM_MaxAbsValueW16, C, WebRtcSpl_MaxAbsValueW16C, true)
+    ->Apply(Lengths);
+BENCHMARK_CAPTURE(BM_CrossCorrelation, C, WebRtcSpl_CrossCorrelationC, true)
+    ->Apply(Lengths);
+BENCHMARK_CAPTURE(BM_DownsampleFast, C, WebRtcSpl_DownsampleFastC, true)
+    ->Apply(Lengths);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+BENCHMARK_CAPTURE(BM_MaxAbsValueW16, SSE2, WebRtcSpl_MaxAbsValueW16SSE2, true)
+    ->Apply(Lengths);
+BENCHMARK_CAPTURE(BM_MaxAbsValueW16,
+                  AVX2,
+                  WebRtcSpl_MaxAbsValueW16AVX2,
+                  GetCPUInfo(kAVX2) != 0)
+    ->Apply(Lengths);
+BENCHMARK_CAPTURE(BM_CrossCorrelation,
+                  SSE2,
+                  WebRtcSpl_CrossCorrelationSSE2,
+                  true)
+    ->Apply(Lengths);
+BENCHMARK_CAPTURE(BM_CrossCorrelation,
+                  AVX2,
+                  WebRtcSpl_CrossCorrelationAVX2,
+                  GetCPUInfo(kAVX2) != 0)
+    ->Apply(Lengths);
+BENCHMARK_CAPTURE(BM_DownsampleFast, SSE2, WebRtcSpl_DownsampleFastSSE2, true)
+    ->Apply(Lengths);
+BENCHMARK_CAPTURE(BM_DownsampleFast,
+                  AVX2,
+                  WebRtcSpl_DownsampleFastAVX2,
+                  GetCPUInfo(kAVX2) != 0)
+    ->Apply(Lengths);
+#endif
+
+}  // namespace
+}  // namespace webrtc
+
+/*
+
+Results (Linux, x86-64 with AVX2, everything built with -mavx2 -mfma):
+
+----------------------------------------------------------------
+Benchmark                              Time             CPU
+----------------------------------------------------------------
+BM_MaxAbsValueW16/C/160              148 ns          147 ns
+BM_MaxAbsValueW16/SSE2/160          12.4 ns         12.4 ns
+BM_MaxAbsValueW16/AVX2/160          9.24 ns         9.18 ns
+BM_CrossCorrelation/C/160           2047 ns         2030 ns
+BM_CrossCorrelation/SSE2/160         516 ns          513 ns
+BM_CrossCorrelation/AVX2/160         341 ns          337 ns
+BM_CrossCorrelation/C/480           7664 ns         7611 ns
+BM_CrossCorrelation/SSE2/480        1494 ns         1493 ns
+BM_CrossCorrelation/AVX2/480         894 ns          893 ns
+BM_DownsampleFast/C/160              615 ns          610 ns
+BM_DownsampleFast/SSE2/160           181 ns          181 ns
+BM_DownsampleFast/AVX2/160           115 ns          115 ns
+BM_DownsampleFast/C/480             2119 ns         2110 ns
+BM_DownsampleFast/SSE2/480           524 ns          522 ns
+BM_DownsampleFast/AVX2/480           317 ns          317 ns
+
+*/
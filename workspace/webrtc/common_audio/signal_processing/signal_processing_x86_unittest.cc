@@ -0,0 +1,224 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "rtc_base/random.h"
+#include "rtc_base/strings/string_builder.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+// Lengths around the SSE2 and AVX2 vector sizes, and typical frame sizes.
+const size_t kLengths[] = {1, 7, 8, 9, 15, 16, 17, 31, 33, 80, 160, 479};
+
+struct Implementation {
+  const char* name;
+  MaxAbsValueW16 max_abs_value_w16;
+  MaxAbsValueW32 max_abs_value_w32;
+  MaxValueW16 max_value_w16;
+  MaxValueW32 max_value_w32;
+  MinValueW16 min_value_w16;
+  MinValueW32 min_value_w32;
+  CrossCorrelation cross_correlation;
+  DownsampleFast downsample_fast;
+};
+
+std::vector<Implementation> Implementations() {
+  std::vector<Implementation> implementations = {
+      {"SSE2", WebRtcSpl_MaxAbsValueW16SSE2, WebRtcSpl_MaxAbsValueW32SSE2,
+       WebRtcSpl_MaxValueW16SSE2, WebRtcSpl_MaxValueW32SSE2,
+       WebRtcSpl_MinValueW16SSE2, WebRtcSpl_MinValueW32SSE2,
+       WebRtcSpl_CrossCorrelationSSE2, WebRtcSpl_DownsampleFastSSE2}};
+  if (GetCPUInfo(kAVX2) != 0) {
+    implementations.push_back(
+        {"AVX2", WebRtcSpl_MaxAbsValueW16AVX2, WebRtcSpl_MaxAbsValueW32AVX2,
+         WebRtcSpl_MaxValueW16AVX2, WebRtcSpl_MaxValueW32AVX2,
+         WebRtcSpl_MinValueW16AVX2, WebRtcSpl_MinValueW32AVX2,
+         WebRtcSpl_CrossCorrelationAVX2, WebRtcSpl_DownsampleFastAVX2});
+  }
+  return implementations;
+}
+
+std::string ProduceDebugText(const char* name, size_t length) {
+  rtc::StringBuilder ss;
+  ss << name << ", length: " << length;
+  return ss.Release();
+}
+
+template <typename T>
+std::vector<T> RandomVector(Random* random, size_t length) {
+  std::vector<T> v(length);
+  for (T& x : v) {
+    x = random->Rand<T>();
+  }
+  return v;
+}
+
+TEST(SplX86Test, MinMaxOperationsAreBitExact) {
+  Random random(42);
+  for (const Implementation& impl : Implementations()) {
+    for (size_t length : kLengths) {
+      SCOPED_TRACE(ProduceDebugText(impl.name, length));
+      for (int trial = 0; trial < 10; ++trial) {
+        std::vector<int16_t> v16 = RandomVector<int16_t>(&random, length);
+        std::vector<int32_t> v32 = RandomVector<int32_t>(&random, length);
+        // Place the extreme values at varying positions.
+        if (trial % 2 == 1) {
+          v16[trial % length] = WEBRTC_SPL_WORD16_MIN;
+          v32[trial % length] = WEBRTC_SPL_WORD32_MIN;
+        }
+        if (trial % 3 == 2) {
+          v16[(trial * 7) % length] = WEBRTC_SPL_WORD16_MAX;
+          v32[(trial * 7) % length] = WEBRTC_SPL_WORD32_MAX;
+        }
+
+        EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(v16.data(), length),
+                  impl.max_abs_value_w16(v16.data(), length));
+        // The C version calls abs(0x80000000), which is undefined, so the
+        // result for WEBRTC_SPL_WORD32_MIN is checked against the documented
+        // value instead.
+        if (trial % 2 == 1) {
+          EXPECT_EQ(WEBRTC_SPL_WORD32_MAX,
+                    impl.max_abs_value_w32(v32.data(), length));
+        } else {
+          EXPECT_EQ(WebRtcSpl_MaxAbsValueW32C(v32.data(), length),
+                    impl.max_abs_value_w32(v32.data(), length));
+        }
+        EXPECT_EQ(WebRtcSpl_MaxValueW16C(v16.data(), length),
+                  impl.max_value_w16(v16.data(), length));
+        EXPECT_EQ(WebRtcSpl_MaxValueW32C(v32.data(), length),
+                  impl.max_value_w32(v32.data(), length));
+        EXPECT_EQ(WebRtcSpl_MinValueW16C(v16.data(), length),
+                  impl.min_value_w16(v16.data(), length));
+        EXPECT_EQ(WebRtcSpl_MinValueW32C(v32.data(), length),
+                  impl.min_value_w32(v32.data(), length));
+      }
+    }
+  }
+}
+
+TEST(SplX86Test, MaxAbsValueOfMinimumValues) {
+  for (const Implementation& impl : Implementations()) {
+    for (size_t length : kLengths) {
+      SCOPED_TRACE(ProduceDebugText(impl.name, length));
+      const std::vector<int16_t> v16(length, WEBRTC_SPL_WORD16_MIN);
+      const std::vector<int32_t> v32(length, WEBRTC_SPL_WORD32_MIN);
+      EXPECT_EQ(WEBRTC_SPL_WORD16_MAX,
+                impl.max_abs_value_w16(v16.data(), length));
+      EXPECT_EQ(WEBRTC_SPL_WORD32_MAX,
+                impl.max_abs_value_w32(v32.data(), length));
+    }
+  }
+}
+
+TEST(SplX86Test, CrossCorrelationIsBitExact) {
+  const size_t kDimCrossCorrelation = 5;
+  Random random(42);
+  for (const Implementation& impl : Implementations()) {
+    for (size_t length : kLengths) {
+      for (int right_shifts : {0, 1, 6}) {
+        for (int step_seq2 : {-1, 1}) {
+          SCOPED_TRACE(ProduceDebugText(impl.name, length));
+          const std::vector<int16_t> seq1 =
+              RandomVector<int16_t>(&random, length);
+          const std::vector<int16_t> seq2 =
+              RandomVector<int16_t>(&random, length + kDimCrossCorrelation);
+          // A negative step starts at the end, like in the pitch estimators.
+          const int16_t* seq2_start =
+              step_seq2 > 0 ? seq2.data()
+                            : seq2.data() + kDimCrossCorrelation - 1;
+          int32_t expected[kDimCrossCorrelation];
+          int32_t actual[kDimCrossCorrelation];
+          WebRtcSpl_CrossCorrelationC(expected, seq1.data(), seq2_start,
+                                      length, kDimCrossCorrelation,
+                                      right_shifts, step_seq2);
+          impl.cross_correlation(actual, seq1.data(), seq2_start, length,
+                                 kDimCrossCorrelation, right_shifts,
+                                 step_seq2);
+          for (size_t i = 0; i < kDimCrossCorrelation; ++i) {
+            EXPECT_EQ(expected[i], actual[i]);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(SplX86Test, CrossCorrelationOfMinimumValues) {
+  // The products overflow when added pairwise without shifting.
+  const std::vector<int16_t> seq(40, WEBRTC_SPL_WORD16_MIN);
+  for (const Implementation& impl : Implementations()) {
+    for (int right_shifts : {0, 1}) {
+      SCOPED_TRACE(ProduceDebugText(impl.name, seq.size()));
+      int32_t expected = 0;
+      int32_t actual = 0;
+      WebRtcSpl_CrossCorrelationC(&expected, seq.data(), seq.data(),
+                                  seq.size(), 1, right_shifts, 1);
+      impl.cross_correlation(&actual, seq.data(), seq.data(), seq.size(), 1,
+                             right_shifts, 1);
+      EXPECT_EQ(expected, actual);
+    }
+  }
+}
+
+TEST(SplX86Test, DownsampleFastIsBitExact) {
+  Random random(42);
+  for (const Implementation& impl : Implementations()) {
+    for (size_t data_out_length : kLengths) {
+      for (int factor : {1, 2, 3, 4}) {
+        for (size_t coefficients_length : {1, 2, 5, 8}) {
+          SCOPED_TRACE(ProduceDebugText(impl.name, data_out_length));
+          const size_t delay = coefficients_length - 1;
+          const size_t data_in_length =
+              delay + factor * (data_out_length - 1) + 1;
+          const std::vector<int16_t> data_in =
+              RandomVector<int16_t>(&random, data_in_length);
+          // Large coefficients make the outputs saturate now and then.
+          const std::vector<int16_t> coefficients =
+              RandomVector<int16_t>(&random, coefficients_length);
+          std::vector<int16_t> expected(data_out_length);
+          std::vector<int16_t> actual(data_out_length);
+          EXPECT_EQ(0, WebRtcSpl_DownsampleFastC(
+                           data_in.data(), data_in_length, expected.data(),
+                           data_out_length, coefficients.data(),
+                           coefficients_length, factor, delay));
+          EXPECT_EQ(0, impl.downsample_fast(
+                           data_in.data(), data_in_length, actual.data(),
+                           data_out_length, coefficients.data(),
+                           coefficients_length, factor, delay));
+          EXPECT_EQ(expected, actual);
+        }
+      }
+    }
+  }
+}
+
+TEST(SplX86Test, DownsampleFastRejectsShortInput) {
+  const int16_t kCoefficients[] = {1, 2, 3};
+  int16_t data_in[20] = {0};
+  int16_t data_out[10];
+  for (const Implementation& impl : Implementations()) {
+    SCOPED_TRACE(impl.name);
+    EXPECT_EQ(-1, impl.downsample_fast(data_in, 20, data_out, 10,
+                                       kCoefficients, 3, 2, 2));
+    EXPECT_EQ(-1, impl.downsample_fast(data_in, 20, data_out, 0,
+                                       kCoefficients, 3, 1, 2));
+    EXPECT_EQ(0, impl.downsample_fast(data_in, 20, data_out, 9,
+                                      kCoefficients, 3, 2, 2));
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
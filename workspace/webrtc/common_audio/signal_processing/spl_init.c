@@ -11,6 +11,7 @@
 // Some code came from common/rtcd.c in the WebM project.
 
 #include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "rtc_base/system/arch.h"
 
 // TODO(bugs.webrtc.org/9553): These function pointers are useless. Refactor
 // things so that we simply have a bunch of regular functions with different
@@ -53,6 +54,37 @@ const ScaleAndAddVectorsWithRound WebRtcSpl_ScaleAndAddVectorsWithRound =
     WebRtcSpl_ScaleAndAddVectorsWithRoundC;
 #endif
 
+#elif defined(WEBRTC_ARCH_X86_FAMILY) && defined(__AVX2__)
+
+// AVX2 is only used when the whole build targets it, since the function
+// pointers are constant and cannot be set by a run-time CPU check.
+const MaxAbsValueW16 WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16AVX2;
+const MaxAbsValueW32 WebRtcSpl_MaxAbsValueW32 = WebRtcSpl_MaxAbsValueW32AVX2;
+const MaxValueW16 WebRtcSpl_MaxValueW16 = WebRtcSpl_MaxValueW16AVX2;
+const MaxValueW32 WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32AVX2;
+const MinValueW16 WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16AVX2;
+const MinValueW32 WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32AVX2;
+const CrossCorrelation WebRtcSpl_CrossCorrelation =
+    WebRtcSpl_CrossCorrelationAVX2;
+const DownsampleFast WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastAVX2;
+const ScaleAndAddVectorsWithRound WebRtcSpl_ScaleAndAddVectorsWithRound =
+    WebRtcSpl_ScaleAndAddVectorsWithRoundC;
+
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+
+// SSE2 is part of the x86-64 baseline and required on 32-bit x86 as well.
+const MaxAbsValueW16 WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16SSE2;
+const MaxAbsValueW32 WebRtcSpl_MaxAbsValueW32 = WebRtcSpl_MaxAbsValueW32SSE2;
+const MaxValueW16 WebRtcSpl_MaxValueW16 = WebRtcSpl_MaxValueW16SSE2;
+const MaxValueW32 WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32SSE2;
+const MinValueW16 WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16SSE2;
+const MinValueW32 WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32SSE2;
+const CrossCorrelation WebRtcSpl_CrossCorrelation =
+    WebRtcSpl_CrossCorrelationSSE2;
+const DownsampleFast WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastSSE2;
+const ScaleAndAddVectorsWithRound WebRtcSpl_ScaleAndAddVectorsWithRound =
+    WebRtcSpl_ScaleAndAddVectorsWithRoundC;
+
 #else
 
 const MaxAbsValueW16 WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16C;
@@ -20,6 +20,7 @@
 #define MODULES_AUDIO_CODING_CODECS_ISAC_FIX_SOURCE_CODEC_H_
 
 #include "modules/audio_coding/codecs/isac/fix/source/structs.h"
+#include "rtc_base/system/arch.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -143,7 +144,7 @@ void WebRtcIsacfix_NormLatticeFilterAr(size_t orderCoef,
 
 /* TODO(kma): Remove the following functions into individual header files. */
 
-/* Internal functions in both C and ARM Neon versions */
+/* Internal functions in C, ARM Neon, MIPS and x86 versions */
 
 int WebRtcIsacfix_AutocorrC(int32_t* __restrict r,
                             const int16_t* __restrict x,
@@ -188,6 +189,34 @@ void WebRtcIsacfix_FilterMaLoopMIPS(int16_t input0,
                                     int32_t* ptr2);
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int WebRtcIsacfix_AutocorrSSE2(int32_t* __restrict r,
+                               const int16_t* __restrict x,
+                               int16_t N,
+                               int16_t order,
+                               int16_t* __restrict scale);
+
+void WebRtcIsacfix_FilterMaLoopSSE2(int16_t input0,
+                                    int16_t input1,
+                                    int32_t input2,
+                                    int32_t* ptr0,
+                                    int32_t* ptr1,
+                                    int32_t* ptr2);
+
+int WebRtcIsacfix_AutocorrAVX2(int32_t* __restrict r,
+                               const int16_t* __restrict x,
+                               int16_t N,
+                               int16_t order,
+                               int16_t* __restrict scale);
+
+void WebRtcIsacfix_FilterMaLoopAVX2(int16_t input0,
+                                    int16_t input1,
+                                    int32_t input2,
+                                    int32_t* ptr0,
+                                    int32_t* ptr1,
+                                    int32_t* ptr2);
+#endif
+
 /* Function pointers associated with the above functions. */
 
 typedef int (*AutocorrFix)(int32_t* __restrict r,
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+#include <limits.h>
+
+#include "modules/audio_coding/codecs/isac/fix/source/codec.h"
+#include "rtc_base/checks.h"
+
+// Returns the exact sum of x[i] * y[i] for 0 <= i < length. See
+// filters_sse2.c for how the sums of two products are sign extended.
+static int64_t DotProductAVX2(const int16_t* x, const int16_t* y, int length) {
+  const __m256i kMin32 = _mm256_set1_epi32(INT_MIN);
+  __m256i sum = _mm256_setzero_si256();
+  __m128i sum128;
+  int64_t sums[2];
+  int64_t prod = 0;
+  int i = 0;
+
+  for (; i + 16 <= length; i += 16) {
+    const __m256i x_v = _mm256_loadu_si256((const __m256i*)&x[i]);
+    const __m256i y_v = _mm256_loadu_si256((const __m256i*)&y[i]);
+    const __m256i pairs = _mm256_madd_epi16(x_v, y_v);
+    const __m256i sign = _mm256_andnot_si256(
+        _mm256_cmpeq_epi32(pairs, kMin32), _mm256_srai_epi32(pairs, 31));
+    sum = _mm256_add_epi64(sum, _mm256_unpacklo_epi32(pairs, sign));
+    sum = _mm256_add_epi64(sum, _mm256_unpackhi_epi32(pairs, sign));
+  }
+  sum128 = _mm_add_epi64(_mm256_castsi256_si128(sum),
+                         _mm256_extracti128_si256(sum, 1));
+  if (i + 8 <= length) {
+    const __m128i x_v = _mm_loadu_si128((const __m128i*)&x[i]);
+    const __m128i y_v = _mm_loadu_si128((const __m128i*)&y[i]);
+    const __m128i pairs = _mm_madd_epi16(x_v, y_v);
+    const __m128i sign =
+        _mm_andnot_si128(_mm_cmpeq_epi32(pairs, _mm_set1_epi32(INT_MIN)),
+                         _mm_srai_epi32(pairs, 31));
+    sum128 = _mm_add_epi64(sum128, _mm_unpacklo_epi32(pairs, sign));
+    sum128 = _mm_add_epi64(sum128, _mm_unpackhi_epi32(pairs, sign));
+    i += 8;
+  }
+  _mm_storeu_si128((__m128i*)sums, sum128);
+  prod = sums[0] + sums[1];
+
+  for (; i < length; i++) {
+    prod += x[i] * y[i];
+  }
+  return prod;
+}
+
+// Autocorrelation function in fixed point, bit-exact with
+// WebRtcIsacfix_AutocorrC().
+int WebRtcIsacfix_AutocorrAVX2(int32_t* __restrict r,
+                               const int16_t* __restrict x,
+                               int16_t N,
+                               int16_t order,
+                               int16_t* __restrict scale) {
+  int i = 0;
+  int16_t scaling = 0;
+  uint32_t temp = 0;
+  int64_t prod = 0;
+
+  RTC_DCHECK_EQ(0, N % 4);
+  RTC_DCHECK_GE(N, 8);
+
+  // Calculate r[0].
+  prod = DotProductAVX2(x, x, N);
+
+  // Calculate scaling (the value of shifting).
+  temp = (uint32_t)(prod >> 31);
+  scaling = temp ? 32 - WebRtcSpl_NormU32(temp) : 0;
+  r[0] = (int32_t)(prod >> scaling);
+
+  // Perform the actual correlation calculation.
+  for (i = 1; i < order + 1; i++) {
+    prod = DotProductAVX2(x, x + i, N - i);
+    r[i] = (int32_t)(prod >> scaling);
+  }
+
+  *scale = scaling;
+
+  return order + 1;
+}
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+#include <limits.h>
+
+#include "modules/audio_coding/codecs/isac/fix/source/codec.h"
+#include "rtc_base/checks.h"
+
+// Returns the exact sum of x[i] * y[i] for 0 <= i < length.
+static int64_t DotProductSSE2(const int16_t* x, const int16_t* y, int length) {
+  const __m128i kMin32 = _mm_set1_epi32(INT_MIN);
+  __m128i sum = _mm_setzero_si128();
+  int64_t sums[2];
+  int64_t prod = 0;
+  int i = 0;
+
+  for (; i + 8 <= length; i += 8) {
+    const __m128i x_v = _mm_loadu_si128((const __m128i*)&x[i]);
+    const __m128i y_v = _mm_loadu_si128((const __m128i*)&y[i]);
+    const __m128i pairs = _mm_madd_epi16(x_v, y_v);
+    // A sum of two products lies in [-2^31 + 2^16, 2^31]. Only 2^31 does not
+    // fit, and it wraps to INT_MIN, so INT_MIN is sign extended as positive.
+    const __m128i sign = _mm_andnot_si128(_mm_cmpeq_epi32(pairs, kMin32),
+                                          _mm_srai_epi32(pairs, 31));
+    sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(pairs, sign));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(pairs, sign));
+  }
+  _mm_storeu_si128((__m128i*)sums, sum);
+  prod = sums[0] + sums[1];
+
+  for (; i < length; i++) {
+    prod += x[i] * y[i];
+  }
+  return prod;
+}
+
+// Autocorrelation function in fixed point, bit-exact with
+// WebRtcIsacfix_AutocorrC().
+int WebRtcIsacfix_AutocorrSSE2(int32_t* __restrict r,
+                               const int16_t* __restrict x,
+                               int16_t N,
+                               int16_t order,
+                               int16_t* __restrict scale) {
+  int i = 0;
+  int16_t scaling = 0;
+  uint32_t temp = 0;
+  int64_t prod = 0;
+
+  RTC_DCHECK_EQ(0, N % 4);
+  RTC_DCHECK_GE(N, 8);
+
+  // Calculate r[0].
+  prod = DotProductSSE2(x, x, N);
+
+  // Calculate scaling (the value of shifting).
+  temp = (uint32_t)(prod >> 31);
+  scaling = temp ? 32 - WebRtcSpl_NormU32(temp) : 0;
+  r[0] = (int32_t)(prod >> scaling);
+
+  // Perform the actual correlation calculation.
+  for (i = 1; i < order + 1; i++) {
+    prod = DotProductSSE2(x, x + i, N - i);
+    r[i] = (int32_t)(prod >> scaling);
+  }
+
+  *scale = scaling;
+
+  return order + 1;
+}
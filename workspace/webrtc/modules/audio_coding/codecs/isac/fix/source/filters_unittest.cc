@@ -65,4 +65,10 @@ TEST_F(FiltersTest, AutocorrFixTest) {
 #if defined(WEBRTC_HAS_NEON)
   FiltersTester(WebRtcIsacfix_AutocorrNeon);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  FiltersTester(WebRtcIsacfix_AutocorrSSE2);
+  if (webrtc::GetCPUInfo(webrtc::kAVX2) != 0) {
+    FiltersTester(WebRtcIsacfix_AutocorrAVX2);
+  }
+#endif
 }
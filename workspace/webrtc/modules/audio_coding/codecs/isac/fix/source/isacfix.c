@@ -196,6 +196,29 @@ static void WebRtcIsacfix_InitMIPS(void) {
 }
 #endif
 
+/****************************************************************************
+ * WebRtcIsacfix_InitSSE2(...)
+ * WebRtcIsacfix_InitAVX2(...)
+ *
+ * These functions initialize function pointers for x86 platforms. SSE2 is
+ * always available there, while AVX2 is only used when the build targets it,
+ * like in the signal processing library.
+ */
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+static void WebRtcIsacfix_InitSSE2(void) {
+  WebRtcIsacfix_AutocorrFix = WebRtcIsacfix_AutocorrSSE2;
+  WebRtcIsacfix_FilterMaLoopFix = WebRtcIsacfix_FilterMaLoopSSE2;
+}
+#endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__AVX2__)
+static void WebRtcIsacfix_InitAVX2(void) {
+  WebRtcIsacfix_AutocorrFix = WebRtcIsacfix_AutocorrAVX2;
+  WebRtcIsacfix_FilterMaLoopFix = WebRtcIsacfix_FilterMaLoopAVX2;
+}
+#endif
+
 static void InitFunctionPointers(void) {
   WebRtcIsacfix_AutocorrFix = WebRtcIsacfix_AutocorrC;
   WebRtcIsacfix_FilterMaLoopFix = WebRtcIsacfix_FilterMaLoopC;
@@ -215,6 +238,14 @@ static void InitFunctionPointers(void) {
 #if defined(MIPS32_LE)
   WebRtcIsacfix_InitMIPS();
 #endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  WebRtcIsacfix_InitSSE2();
+#endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__AVX2__)
+  WebRtcIsacfix_InitAVX2();
+#endif
 }
 
 /****************************************************************************
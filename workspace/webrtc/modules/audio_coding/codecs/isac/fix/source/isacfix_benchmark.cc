@@ -0,0 +1,228 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "modules/audio_coding/codecs/isac/fix/include/isacfix.h"
+#include "modules/audio_coding/codecs/isac/fix/source/codec.h"
+#include "modules/audio_coding/codecs/isac/fix/source/settings.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/system/unused.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kSamplesPer10Ms = 160;
+constexpr int16_t kRateBps = 32000;
+constexpr int kFrameSizeMs = 30;
+
+struct Implementation {
+  AutocorrFix autocorr;
+  FilterMaLoopFix filter_ma_loop;
+};
+
+const Implementation kCImplementation = {WebRtcIsacfix_AutocorrC,
+                                         WebRtcIsacfix_FilterMaLoopC};
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+const Implementation kSSE2Implementation = {
+    WebRtcIsacfix_AutocorrSSE2, WebRtcIsacfix_FilterMaLoopSSE2};
+const Implementation kAVX2Implementation = {
+    WebRtcIsacfix_AutocorrAVX2, WebRtcIsacfix_FilterMaLoopAVX2};
+#endif
+
+bool SkipIfUnsupported(benchmark::State& state, bool supported) {
+  if (!supported) {
+    state.SkipWithError("Not supported by this CPU");
+  }
+  return !supported;
+}
+
+// One second of a voiced-speech-like signal: a few harmonics of a slowly
+// varying pitch, amplitude modulated at a syllable rate, plus some noise.
+std::vector<int16_t> SyntheticSpeech() {
+  Random random(42);
+  std::vector<int16_t> speech(100 * kSamplesPer10Ms);
+  double phase = 0.0;
+  for (size_t i = 0; i < speech.size(); ++i) {
+    const double t = i / 16000.0;
+    phase += 2 * M_PI * (140.0 + 30.0 * sin(2 * M_PI * 3.0 * t)) / 16000.0;
+    double sample = 0.0;
+    for (int harmonic = 1; harmonic <= 8; ++harmonic) {
+      sample += sin(harmonic * phase) / harmonic;
+    }
+    const double envelope = 0.55 + 0.45 * sin(2 * M_PI * 4.0 * t);
+    speech[i] = static_cast<int16_t>(5000.0 * envelope * sample +
+                                     random.Gaussian(0.0, 100.0));
+  }
+  return speech;
+}
+
+ISACFIX_MainStruct* CreateEncoder(const Implementation& implementation) {
+  ISACFIX_MainStruct* encoder = nullptr;
+  RTC_CHECK_EQ(0, WebRtcIsacfix_Create(&encoder));
+  RTC_CHECK_EQ(0, WebRtcIsacfix_EncoderInit(encoder, /*CodingMode=*/1));
+  RTC_CHECK_EQ(0, WebRtcIsacfix_Control(encoder, kRateBps, kFrameSizeMs));
+  // The function pointers are set by the init functions above.
+  WebRtcIsacfix_AutocorrFix = implementation.autocorr;
+  WebRtcIsacfix_FilterMaLoopFix = implementation.filter_ma_loop;
+  return encoder;
+}
+
+// Time to encode 10 ms; every third call completes a 30 ms packet.
+void BM_IsacFixEncode(benchmark::State& state,
+                      const Implementation& implementation,
+                      bool supported) {
+  if (SkipIfUnsupported(state, supported)) {
+    return;
+  }
+  const std::vector<int16_t> speech = SyntheticSpeech();
+  ISACFIX_MainStruct* encoder = CreateEncoder(implementation);
+  uint8_t payload[STREAM_MAXW16_60MS * 2];
+  size_t i = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    benchmark::DoNotOptimize(
+        WebRtcIsacfix_Encode(encoder, &speech[i], payload));
+    i = (i + kSamplesPer10Ms) % speech.size();
+  }
+  WebRtcIsacfix_Free(encoder);
+}
+
+// Time to decode one 30 ms packet. The decoder does not use the vectorized
+// kernels, so this is the reference for how much of a call is decoding.
+void BM_IsacFixDecode(benchmark::State& state) {
+  const std::vector<int16_t> speech = SyntheticSpeech();
+  ISACFIX_MainStruct* encoder = CreateEncoder(kCImplementation);
+  std::vector<std::vector<uint8_t>> packets;
+  uint8_t payload[STREAM_MAXW16_60MS * 2];
+  for (size_t i = 0; i < speech.size(); i += kSamplesPer10Ms) {
+    const int payload_size =
+        WebRtcIsacfix_Encode(encoder, &speech[i], payload);
+    RTC_CHECK_GE(payload_size, 0);
+    if (payload_size > 0) {
+      packets.emplace_back(payload, payload + payload_size);
+    }
+  }
+  WebRtcIsacfix_Free(encoder);
+
+  ISACFIX_MainStruct* decoder = nullptr;
+  RTC_CHECK_EQ(0, WebRtcIsacfix_Create(&decoder));
+  WebRtcIsacfix_DecoderInit(decoder);
+  int16_t decoded[FRAMESAMPLES * 2];
+  int16_t speech_type;
+  size_t packet = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    benchmark::DoNotOptimize(WebRtcIsacfix_Decode(
+        decoder, packets[packet].data(), packets[packet].size(), decoded,
+        &speech_type));
+    packet = (packet + 1) % packets.size();
+  }
+  WebRtcIsacfix_Free(decoder);
+}
+
+void BM_IsacFixAutocorr(benchmark::State& state,
+                        AutocorrFix function,
+                        bool supported) {
+  if (SkipIfUnsupported(state, supported)) {
+    return;
+  }
+  // As in the LPC analysis of the lower band.
+  constexpr int16_t kWindowLength = WINLEN;
+  constexpr int16_t kOrder = ORDERLO + 1;
+  const std::vector<int16_t> speech = SyntheticSpeech();
+  int32_t r[kOrder + 1];
+  int16_t scale;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    function(r, speech.data(), kWindowLength, kOrder, &scale);
+    benchmark::DoNotOptimize(r);
+  }
+}
+
+void BM_IsacFixFilterMaLoop(benchmark::State& state,
+                            FilterMaLoopFix function,
+                            bool supported) {
+  if (SkipIfUnsupported(state, supported)) {
+    return;
+  }
+  constexpr size_t kLength = HALF_SUBFRAMELEN - 1;
+  Random random(42);
+  std::vector<int32_t> ptr0(kLength);
+  std::vector<int32_t> ptr1(kLength);
+  std::vector<int32_t> ptr2(kLength);
+  for (size_t n = 0; n < kLength; ++n) {
+    ptr0[n] = random.Rand<int32_t>() >> 8;
+    ptr2[n] = random.Rand<int32_t>() >> 8;
+  }
+  const int16_t input0 = random.Rand<int16_t>();
+  const int16_t input1 = random.Rand<int16_t>();
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    // An inverse coefficient just below one in Q16 keeps |ptr2| bounded.
+    function(input0, input1, 65000, ptr0.data(), ptr1.data(), ptr2.data());
+    benchmark::DoNotOptimize(ptr2.data());
+  }
+}
+
+BENCHMARK_CAPTURE(BM_IsacFixEncode, C, kCImplementation, true);
+BENCHMARK(BM_IsacFixDecode);
+BENCHMARK_CAPTURE(BM_IsacFixAutocorr, C, WebRtcIsacfix_AutocorrC, true);
+BENCHMARK_CAPTURE(BM_IsacFixFilterMaLoop, C, WebRtcIsacfix_FilterMaLoopC, true);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+BENCHMARK_CAPTURE(BM_IsacFixEncode, SSE2, kSSE2Implementation, true);
+BENCHMARK_CAPTURE(BM_IsacFixEncode,
+                  AVX2,
+                  kAVX2Implementation,
+                  GetCPUInfo(kAVX2) != 0);
+BENCHMARK_CAPTURE(BM_IsacFixAutocorr, SSE2, WebRtcIsacfix_AutocorrSSE2, true);
+BENCHMARK_CAPTURE(BM_IsacFixAutocorr,
+                  AVX2,
+                  WebRtcIsacfix_AutocorrAVX2,
+                  GetCPUInfo(kAVX2) != 0);
+BENCHMARK_CAPTURE(BM_IsacFixFilterMaLoop,
+                  SSE2,
+                  WebRtcIsacfix_FilterMaLoopSSE2,
+                  true);
+BENCHMARK_CAPTURE(BM_IsacFixFilterMaLoop,
+                  AVX2,
+                  WebRtcIsacfix_FilterMaLoopAVX2,
+                  GetCPUInfo(kAVX2) != 0);
+#endif
+
+}  // namespace
+}  // namespace webrtc
+
+/*
+
+Results (Linux, x86-64 with AVX2, the codec built with -msse2 only):
+
+----------------------------------------------------------------
+Benchmark                            Time             CPU
+----------------------------------------------------------------
+BM_IsacFixEncode/C               50593 ns        49970 ns
+BM_IsacFixDecode                 86813 ns        85159 ns
+BM_IsacFixAutocorr/C              4642 ns         4579 ns
+BM_IsacFixFilterMaLoop/C           241 ns          233 ns
+BM_IsacFixEncode/SSE2            37873 ns        37022 ns
+BM_IsacFixEncode/AVX2            38913 ns        37894 ns
+BM_IsacFixAutocorr/SSE2            904 ns          886 ns
+BM_IsacFixAutocorr/AVX2            455 ns          450 ns
+BM_IsacFixFilterMaLoop/SSE2        108 ns          107 ns
+BM_IsacFixFilterMaLoop/AVX2       66.2 ns         65.2 ns
+
+*/
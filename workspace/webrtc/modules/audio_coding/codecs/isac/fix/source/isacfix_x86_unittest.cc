@@ -0,0 +1,211 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "modules/audio_coding/codecs/isac/fix/include/isacfix.h"
+#include "modules/audio_coding/codecs/isac/fix/source/codec.h"
+#include "modules/audio_coding/codecs/isac/fix/source/settings.h"
+#include "rtc_base/random.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#include "test/gtest.h"
+#include "test/testsupport/file_utils.h"
+
+namespace webrtc {
+namespace {
+
+struct Implementation {
+  const char* name;
+  AutocorrFix autocorr;
+  FilterMaLoopFix filter_ma_loop;
+};
+
+const Implementation kReference = {"C", WebRtcIsacfix_AutocorrC,
+                                   WebRtcIsacfix_FilterMaLoopC};
+
+std::vector<Implementation> X86Implementations() {
+  std::vector<Implementation> implementations = {
+      {"SSE2", WebRtcIsacfix_AutocorrSSE2, WebRtcIsacfix_FilterMaLoopSSE2}};
+  if (GetCPUInfo(kAVX2) != 0) {
+    implementations.push_back(
+        {"AVX2", WebRtcIsacfix_AutocorrAVX2, WebRtcIsacfix_FilterMaLoopAVX2});
+  }
+  return implementations;
+}
+
+// Values that use the full 16-bit range, but are scaled down by a random
+// number of bits so that both the overflow and the no-overflow cases are hit.
+std::vector<int16_t> RandomSamples(Random* random, size_t length) {
+  const int shift = random->Rand(0, 15);
+  std::vector<int16_t> samples(length);
+  for (int16_t& sample : samples) {
+    sample = random->Rand<int16_t>() >> shift;
+  }
+  return samples;
+}
+
+std::vector<int32_t> RandomStates(Random* random, size_t length) {
+  const int shift = random->Rand(0, 16);
+  std::vector<int32_t> states(length);
+  for (int32_t& state : states) {
+    state = random->Rand<int32_t>() >> shift;
+  }
+  return states;
+}
+
+struct CodecOutput {
+  std::vector<uint8_t> payloads;
+  std::vector<int16_t> decoded;
+};
+
+// Encodes and decodes |speech| with the function pointers of the codec set to
+// |implementation|.
+CodecOutput EncodeAndDecode(const std::vector<int16_t>& speech,
+                            int16_t rate_bps,
+                            int frame_size_ms,
+                            const Implementation& implementation) {
+  constexpr size_t kSamplesPer10Ms = 160;
+  ISACFIX_MainStruct* encoder = nullptr;
+  ISACFIX_MainStruct* decoder = nullptr;
+  EXPECT_EQ(0, WebRtcIsacfix_Create(&encoder));
+  EXPECT_EQ(0, WebRtcIsacfix_Create(&decoder));
+  EXPECT_EQ(0, WebRtcIsacfix_EncoderInit(encoder, /*CodingMode=*/1));
+  EXPECT_EQ(0, WebRtcIsacfix_Control(encoder, rate_bps, frame_size_ms));
+  WebRtcIsacfix_DecoderInit(decoder);
+  // The function pointers are set by the init functions above.
+  WebRtcIsacfix_AutocorrFix = implementation.autocorr;
+  WebRtcIsacfix_FilterMaLoopFix = implementation.filter_ma_loop;
+
+  CodecOutput output;
+  uint8_t payload[STREAM_MAXW16_60MS * 2];
+  int16_t decoded[FRAMESAMPLES * 2];
+  int16_t speech_type;
+  for (size_t i = 0; i + kSamplesPer10Ms <= speech.size();
+       i += kSamplesPer10Ms) {
+    const int payload_size =
+        WebRtcIsacfix_Encode(encoder, &speech[i], payload);
+    EXPECT_GE(payload_size, 0);
+    if (payload_size <= 0) {
+      continue;
+    }
+    output.payloads.insert(output.payloads.end(), payload,
+                           payload + payload_size);
+    const int decoded_size = WebRtcIsacfix_Decode(decoder, payload,
+                                                  payload_size, decoded,
+                                                  &speech_type);
+    EXPECT_EQ(frame_size_ms * 16, decoded_size);
+    output.decoded.insert(output.decoded.end(), decoded,
+                          decoded + decoded_size);
+  }
+
+  EXPECT_EQ(0, WebRtcIsacfix_Free(encoder));
+  EXPECT_EQ(0, WebRtcIsacfix_Free(decoder));
+  return output;
+}
+
+}  // namespace
+
+TEST(IsacFixX86Test, AutocorrIsBitExact) {
+  constexpr int16_t kOrder = MAX_AR_MODEL_ORDER;
+  Random random(42);
+  for (int i = 0; i < 1000; ++i) {
+    // Multiples of four, as required, around the SSE2 and AVX2 vector sizes
+    // and up to a frame.
+    const int16_t length = 4 * random.Rand(2, FRAMESAMPLES / 4);
+    std::vector<int16_t> x = RandomSamples(&random, length);
+    if (i == 0) {
+      // The largest products.
+      x.assign(length, -32768);
+    }
+    int32_t expected[kOrder + 1];
+    int16_t expected_scale;
+    EXPECT_EQ(kOrder + 1, kReference.autocorr(expected, x.data(), length,
+                                              kOrder, &expected_scale));
+    for (const Implementation& implementation : X86Implementations()) {
+      SCOPED_TRACE(implementation.name);
+      int32_t r[kOrder + 1];
+      int16_t scale;
+      EXPECT_EQ(kOrder + 1,
+                implementation.autocorr(r, x.data(), length, kOrder, &scale));
+      EXPECT_EQ(expected_scale, scale);
+      for (int k = 0; k <= kOrder; ++k) {
+        ASSERT_EQ(expected[k], r[k]) << "length: " << length << ", k: " << k;
+      }
+    }
+  }
+}
+
+TEST(IsacFixX86Test, FilterMaLoopIsBitExact) {
+  constexpr size_t kLength = HALF_SUBFRAMELEN - 1;
+  Random random(42);
+  for (int i = 0; i < 1000; ++i) {
+    const int16_t input0 = random.Rand<int16_t>();
+    const int16_t input1 = random.Rand<int16_t>();
+    const int32_t input2 = random.Rand<int32_t>();
+    std::vector<int32_t> ptr0 = RandomStates(&random, kLength);
+    const std::vector<int32_t> ptr2 = RandomStates(&random, kLength);
+    // One more element, which must be left alone.
+    std::vector<int32_t> expected_ptr1(kLength + 1, 4711);
+    std::vector<int32_t> expected_ptr2 = ptr2;
+    expected_ptr2.push_back(4711);
+    kReference.filter_ma_loop(input0, input1, input2,
+                              ptr0.data(),
+                              expected_ptr1.data(), expected_ptr2.data());
+    for (const Implementation& implementation : X86Implementations()) {
+      SCOPED_TRACE(implementation.name);
+      std::vector<int32_t> ptr1_out(kLength + 1, 4711);
+      std::vector<int32_t> ptr2_out = ptr2;
+      ptr2_out.push_back(4711);
+      implementation.filter_ma_loop(input0, input1, input2,
+                                    ptr0.data(),
+                                    ptr1_out.data(), ptr2_out.data());
+      ASSERT_EQ(expected_ptr1, ptr1_out);
+      ASSERT_EQ(expected_ptr2, ptr2_out);
+    }
+  }
+}
+
+// Encodes and decodes the iSAC test vector with every implementation, and
+// expects the same payloads and decoded audio as with the C version.
+TEST(IsacFixX86Test, EncodeDecodeIsBitExact) {
+  const std::string file_name =
+      test::ResourcePath("audio_coding/testfile16kHz", "pcm");
+  FILE* file = fopen(file_name.c_str(), "rb");
+  ASSERT_TRUE(file != nullptr);
+  // Ten seconds.
+  std::vector<int16_t> speech(160000);
+  speech.resize(fread(speech.data(), sizeof(int16_t), speech.size(), file));
+  fclose(file);
+  ASSERT_GT(speech.size(), 16000u);
+
+  const struct {
+    int16_t rate_bps;
+    int frame_size_ms;
+  } kSettings[] = {{32000, 30}, {10000, 60}};
+  for (const auto& settings : kSettings) {
+    const CodecOutput expected = EncodeAndDecode(
+        speech, settings.rate_bps, settings.frame_size_ms, kReference);
+    for (const Implementation& implementation : X86Implementations()) {
+      SCOPED_TRACE(std::string(implementation.name) + ", " +
+                   std::to_string(settings.rate_bps) + " bps, " +
+                   std::to_string(settings.frame_size_ms) + " ms");
+      const CodecOutput output =
+          EncodeAndDecode(speech, settings.rate_bps, settings.frame_size_ms,
+                          implementation);
+      EXPECT_EQ(expected.payloads, output.payloads);
+      EXPECT_EQ(expected.decoded, output.decoded);
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "modules/audio_coding/codecs/isac/fix/source/codec.h"
+#include "modules/audio_coding/codecs/isac/fix/source/settings.h"
+
+// See lattice_sse2.c for how the multiplications are done.
+
+// Returns a * (uint16_t)b.
+static inline __m256i MulU16(__m256i a_lo, __m256i a_hi, __m256i b) {
+  const __m256i prod = _mm256_madd_epi16(a_lo, b);
+  const __m256i negative = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 31);
+  return _mm256_add_epi32(prod, _mm256_and_si256(negative, a_hi));
+}
+
+// WEBRTC_SPL_MUL_16_32_RSFT15(a, b).
+static inline __m256i MulRsft15(__m256i a_lo, __m256i a_hi, __m256i b) {
+  const __m256i high = _mm256_slli_epi32(_mm256_madd_epi16(a_hi, b), 1);
+  const __m256i low = _mm256_srai_epi32(
+      _mm256_add_epi32(_mm256_srai_epi32(MulU16(a_lo, a_hi, b), 1),
+                       _mm256_set1_epi32(0x2000)),
+      14);
+  return _mm256_add_epi32(high, low);
+}
+
+// LATTICE_MUL_32_32_RSFT16(a32a, a32b, b32) of lattice.c.
+static inline __m256i LatticeMul(__m256i a_lo,
+                                 __m256i a_hi,
+                                 __m256i b_lo,
+                                 __m256i b_hi,
+                                 __m256i c) {
+  const __m256i prod =
+      _mm256_add_epi32(_mm256_slli_epi32(_mm256_madd_epi16(a_hi, c), 16),
+                       MulU16(a_lo, a_hi, c));
+  const __m256i c_low = _mm256_srli_epi32(_mm256_slli_epi32(c, 16), 17);
+  const __m256i rsft16 = _mm256_add_epi32(
+      _mm256_madd_epi16(b_hi, c),
+      _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(b_lo, c_low),
+                                         _mm256_set1_epi32(0x4000)),
+                        15));
+  return _mm256_add_epi32(prod, rsft16);
+}
+
+// AVX2 version of WebRtcIsacfix_FilterMaLoopC(), and bit-exact with it. Eight
+// iterations are done at a time, and the last, partial, group with masked
+// loads and stores.
+void WebRtcIsacfix_FilterMaLoopAVX2(int16_t input0,  // Filter coefficient
+                                    int16_t input1,  // Filter coefficient
+                                    int32_t input2,  // Inverse coefficient
+                                    int32_t* ptr0,   // Sample buffer
+                                    int32_t* ptr1,   // Sample buffer
+                                    int32_t* ptr2) { // Sample buffer
+  const int kLength = HALF_SUBFRAMELEN - 1;
+  int n = 0;
+
+  // Separate input2 into two 16-bit integers as the C version does.
+  int16_t t16a = (int16_t)(input2 >> 16);
+  int16_t t16b = (int16_t)input2;
+  if (t16b < 0) t16a++;
+
+  const __m256i input0_lo = _mm256_set1_epi32((uint16_t)input0);
+  const __m256i input0_hi = _mm256_set1_epi32(input0 * (1 << 16));
+  const __m256i input1_lo = _mm256_set1_epi32((uint16_t)input1);
+  const __m256i input1_hi = _mm256_set1_epi32(input1 * (1 << 16));
+  const __m256i t16a_lo = _mm256_set1_epi32((uint16_t)t16a);
+  const __m256i t16a_hi = _mm256_set1_epi32(t16a * (1 << 16));
+  const __m256i t16b_lo = _mm256_set1_epi32((uint16_t)t16b);
+  const __m256i t16b_hi = _mm256_set1_epi32(t16b * (1 << 16));
+  const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+  for (; n < kLength; n += 8) {
+    // All ones in the lanes that are within the buffers.
+    const __m256i mask =
+        _mm256_cmpgt_epi32(_mm256_set1_epi32(kLength - n), lanes);
+    const __m256i ptr0_v = _mm256_maskload_epi32(&ptr0[n], mask);
+    __m256i ptr2_v = _mm256_maskload_epi32(&ptr2[n], mask);
+
+    // Calculate *ptr2 = input2 * (*ptr2 + input0 * (*ptr0)).
+    ptr2_v = _mm256_add_epi32(ptr2_v, MulRsft15(input0_lo, input0_hi, ptr0_v));
+    ptr2_v = LatticeMul(t16a_lo, t16a_hi, t16b_lo, t16b_hi, ptr2_v);
+    _mm256_maskstore_epi32(&ptr2[n], mask, ptr2_v);
+
+    // Calculate *ptr1 = input1 * (*ptr0) + input0 * (*ptr2).
+    _mm256_maskstore_epi32(
+        &ptr1[n], mask,
+        _mm256_add_epi32(MulRsft15(input1_lo, input1_hi, ptr0_v),
+                         MulRsft15(input0_lo, input0_hi, ptr2_v)));
+  }
+}
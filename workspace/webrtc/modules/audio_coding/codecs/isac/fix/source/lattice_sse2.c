@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "modules/audio_coding/codecs/isac/fix/source/codec.h"
+#include "modules/audio_coding/codecs/isac/fix/source/settings.h"
+
+// The 16 x 32 bit multiplications of the C version are split into 16 x 16 bit
+// products, done with _mm_madd_epi16() on 32-bit lanes. A 16-bit factor |a| is
+// passed both as |a_lo|, with |a| in the low and zero in the high half of each
+// lane, and as |a_hi|, with the halves swapped. Then
+//   _mm_madd_epi16(a_hi, b) = a * (b >> 16) and
+//   _mm_madd_epi16(a_lo, b) = a * (int16_t)b.
+
+// Returns a * (uint16_t)b.
+static inline __m128i MulU16(__m128i a_lo, __m128i a_hi, __m128i b) {
+  const __m128i prod = _mm_madd_epi16(a_lo, b);
+  // Add a * 2^16 where the low half of b is negative as an int16_t.
+  const __m128i negative = _mm_srai_epi32(_mm_slli_epi32(b, 16), 31);
+  return _mm_add_epi32(prod, _mm_and_si128(negative, a_hi));
+}
+
+// WEBRTC_SPL_MUL_16_32_RSFT15(a, b).
+static inline __m128i MulRsft15(__m128i a_lo, __m128i a_hi, __m128i b) {
+  const __m128i high = _mm_slli_epi32(_mm_madd_epi16(a_hi, b), 1);
+  const __m128i low = _mm_srai_epi32(
+      _mm_add_epi32(_mm_srai_epi32(MulU16(a_lo, a_hi, b), 1),
+                    _mm_set1_epi32(0x2000)),
+      14);
+  return _mm_add_epi32(high, low);
+}
+
+// LATTICE_MUL_32_32_RSFT16(a32a, a32b, b32) of lattice.c, that is
+// a32a * b32 + WEBRTC_SPL_MUL_16_32_RSFT16(a32b, b32).
+static inline __m128i LatticeMul(__m128i a_lo,
+                                 __m128i a_hi,
+                                 __m128i b_lo,
+                                 __m128i b_hi,
+                                 __m128i c) {
+  // The low 32 bits of a32a * b32.
+  const __m128i prod = _mm_add_epi32(
+      _mm_slli_epi32(_mm_madd_epi16(a_hi, c), 16), MulU16(a_lo, a_hi, c));
+  // (b32 & 0xffff) >> 1.
+  const __m128i c_low = _mm_srli_epi32(_mm_slli_epi32(c, 16), 17);
+  const __m128i rsft16 = _mm_add_epi32(
+      _mm_madd_epi16(b_hi, c),
+      _mm_srai_epi32(
+          _mm_add_epi32(_mm_madd_epi16(b_lo, c_low), _mm_set1_epi32(0x4000)),
+          15));
+  return _mm_add_epi32(prod, rsft16);
+}
+
+// SSE2 version of WebRtcIsacfix_FilterMaLoopC(), and bit-exact with it. Each
+// iteration of the loop is independent of the others, so four are done at a
+// time.
+void WebRtcIsacfix_FilterMaLoopSSE2(int16_t input0,  // Filter coefficient
+                                    int16_t input1,  // Filter coefficient
+                                    int32_t input2,  // Inverse coefficient
+                                    int32_t* ptr0,   // Sample buffer
+                                    int32_t* ptr1,   // Sample buffer
+                                    int32_t* ptr2) { // Sample buffer
+  int n = 0;
+
+  // Separate input2 into two 16-bit integers as the C version does.
+  int16_t t16a = (int16_t)(input2 >> 16);
+  int16_t t16b = (int16_t)input2;
+  if (t16b < 0) t16a++;
+
+  const __m128i input0_lo = _mm_set1_epi32((uint16_t)input0);
+  const __m128i input0_hi = _mm_set1_epi32(input0 * (1 << 16));
+  const __m128i input1_lo = _mm_set1_epi32((uint16_t)input1);
+  const __m128i input1_hi = _mm_set1_epi32(input1 * (1 << 16));
+  const __m128i t16a_lo = _mm_set1_epi32((uint16_t)t16a);
+  const __m128i t16a_hi = _mm_set1_epi32(t16a * (1 << 16));
+  const __m128i t16b_lo = _mm_set1_epi32((uint16_t)t16b);
+  const __m128i t16b_hi = _mm_set1_epi32(t16b * (1 << 16));
+
+  for (; n + 4 <= HALF_SUBFRAMELEN - 1; n += 4) {
+    const __m128i ptr0_v = _mm_loadu_si128((const __m128i*)&ptr0[n]);
+    __m128i ptr2_v = _mm_loadu_si128((const __m128i*)&ptr2[n]);
+
+    // Calculate *ptr2 = input2 * (*ptr2 + input0 * (*ptr0)).
+    ptr2_v = _mm_add_epi32(ptr2_v, MulRsft15(input0_lo, input0_hi, ptr0_v));
+    ptr2_v = LatticeMul(t16a_lo, t16a_hi, t16b_lo, t16b_hi, ptr2_v);
+    _mm_storeu_si128((__m128i*)&ptr2[n], ptr2_v);
+
+    // Calculate *ptr1 = input1 * (*ptr0) + input0 * (*ptr2).
+    _mm_storeu_si128((__m128i*)&ptr1[n],
+                     _mm_add_epi32(MulRsft15(input1_lo, input1_hi, ptr0_v),
+                                   MulRsft15(input0_lo, input0_hi, ptr2_v)));
+  }
+
+  for (; n < HALF_SUBFRAMELEN - 1; n++) {
+    int32_t tmp32a;
+    int32_t tmp32b;
+
+    // Calculate *ptr2 = input2 * (*ptr2 + input0 * (*ptr0)).
+    tmp32a = WEBRTC_SPL_MUL_16_32_RSFT15(input0, ptr0[n]);
+    tmp32b = ptr2[n] + tmp32a;
+    ptr2[n] = (int32_t)(WEBRTC_SPL_MUL(t16a, tmp32b) +
+                        (WEBRTC_SPL_MUL_16_32_RSFT16(t16b, tmp32b)));
+
+    // Calculate *ptr1 = input1 * (*ptr0) + input0 * (*ptr2).
+    tmp32a = WEBRTC_SPL_MUL_16_32_RSFT15(input1, ptr0[n]);
+    tmp32b = WEBRTC_SPL_MUL_16_32_RSFT15(input0, ptr2[n]);
+    ptr1[n] = tmp32a + tmp32b;
+  }
+}
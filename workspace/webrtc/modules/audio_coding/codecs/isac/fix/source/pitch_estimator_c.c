@@ -10,8 +10,12 @@
 
 #include "modules/audio_coding/codecs/isac/fix/source/pitch_estimator.h"
 
+#include "rtc_base/system/arch.h"
+
 #ifdef WEBRTC_HAS_NEON
 #include <arm_neon.h>
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
 #endif
 
 #include "common_audio/signal_processing/include/signal_processing_library.h"
@@ -82,6 +86,40 @@ void WebRtcIsacfix_PCorr2Q32(const int16_t* in, int32_t* logcorQ8) {
       csum32 += vbuff[2];
       csum32 += vbuff[3];
     }
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+    {
+      // Only the low 32 bits of the sum are kept, so it can wrap around in
+      // 32 bits, and the result is still bit-exact with the generic code.
+      int32_t vbuff[4];
+      __m128i sum = _mm_setzero_si128();
+      const __m128i shift = _mm_cvtsi32_si128(scaling);
+      RTC_COMPILE_ASSERT(PITCH_CORR_LEN2 % 4 == 0);
+
+      if (scaling == 0) {
+        for (n = 0; n + 8 <= PITCH_CORR_LEN2; n += 8) {
+          const __m128i x_v = _mm_loadu_si128((const __m128i*)&x[n]);
+          const __m128i in_v = _mm_loadu_si128((const __m128i*)&inptr[n]);
+          sum = _mm_add_epi32(sum, _mm_madd_epi16(x_v, in_v));
+        }
+      } else {
+        for (n = 0; n + 8 <= PITCH_CORR_LEN2; n += 8) {
+          const __m128i x_v = _mm_loadu_si128((const __m128i*)&x[n]);
+          const __m128i in_v = _mm_loadu_si128((const __m128i*)&inptr[n]);
+          const __m128i lo = _mm_mullo_epi16(x_v, in_v);
+          const __m128i hi = _mm_mulhi_epi16(x_v, in_v);
+          sum = _mm_add_epi32(
+              sum, _mm_sra_epi32(_mm_unpacklo_epi16(lo, hi), shift));
+          sum = _mm_add_epi32(
+              sum, _mm_sra_epi32(_mm_unpackhi_epi16(lo, hi), shift));
+        }
+      }
+      _mm_storeu_si128((__m128i*)vbuff, sum);
+      csum32 = (int32_t)((uint32_t)vbuff[0] + vbuff[1] + vbuff[2] + vbuff[3]);
+      for (; n < PITCH_CORR_LEN2; n++) {
+        csum32 = (int32_t)((uint32_t)csum32 +
+                           (((int32_t)(x[n]) * inptr[n]) >> scaling));
+      }
+    }
 #else
     int64_t csum64_tmp = 0;
     if(scaling == 0) {
@@ -12,6 +12,7 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -40,6 +41,65 @@ static const size_t kMinValidCallTimeTimeInMilliseconds =
 static const double k2Pi = 6.28318530717959;
 #endif
 
+namespace {
+
+// Adds |value| to a counter that has a single writer. A relaxed load and store
+// is enough and, unlike fetch_add(), needs no locked instruction.
+template <typename T>
+void IncrementSingleWriter(std::atomic<T>* counter, T value) {
+  counter->store(counter->load(std::memory_order_relaxed) + value,
+                 std::memory_order_relaxed);
+}
+
+std::vector<uint32_t> CopyHistogram(
+    const std::unique_ptr<std::atomic<uint32_t>[]>& histogram) {
+  std::vector<uint32_t> copy;
+  if (histogram) {
+    copy.reserve(AudioDeviceBuffer::kNumCallbackIntervalBuckets);
+    for (size_t i = 0; i < AudioDeviceBuffer::kNumCallbackIntervalBuckets;
+         ++i) {
+      copy.push_back(histogram[i].load(std::memory_order_relaxed));
+    }
+  }
+  return copy;
+}
+
+}  // namespace
+
+constexpr int AudioDeviceBuffer::kCallbackIntervalBucketUs;
+constexpr size_t AudioDeviceBuffer::kNumCallbackIntervalBuckets;
+
+void AudioDeviceBuffer::DirectionStats::Reset() {
+  callbacks.store(0, std::memory_order_relaxed);
+  samples.store(0, std::memory_order_relaxed);
+  max_level.store(0, std::memory_order_relaxed);
+  last_callback_time_us = 0;
+  if (interval_histogram) {
+    for (size_t i = 0; i < kNumCallbackIntervalBuckets; ++i) {
+      interval_histogram[i].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+void AudioDeviceBuffer::DirectionStats::Update(int16_t max_abs,
+                                               size_t samples_per_channel) {
+  IncrementSingleWriter<uint64_t>(&callbacks, 1);
+  IncrementSingleWriter<uint64_t>(&samples, samples_per_channel);
+  if (max_abs > max_level.load(std::memory_order_relaxed)) {
+    max_level.store(max_abs, std::memory_order_relaxed);
+  }
+  if (interval_histogram) {
+    const int64_t now_us = rtc::TimeMicros();
+    if (last_callback_time_us != 0) {
+      const size_t bucket = std::min<int64_t>(
+          (now_us - last_callback_time_us) / kCallbackIntervalBucketUs,
+          kNumCallbackIntervalBuckets - 1);
+      IncrementSingleWriter<uint32_t>(&interval_histogram[bucket], 1);
+    }
+    last_callback_time_us = now_us;
+  }
+}
+
 AudioDeviceBuffer::AudioDeviceBuffer(TaskQueueFactory* task_queue_factory)
     : task_queue_(task_queue_factory->CreateTaskQueue(
           kTimerQueueName,
@@ -96,7 +156,10 @@ void AudioDeviceBuffer::StartPlayout() {
     return;
   }
   RTC_DLOG(INFO) << __FUNCTION__;
-  // Clear members tracking playout stats and do it on the task queue.
+  // Clear the playout counters. It is safe to do so here since we know by
+  // design that the owning ADM has not yet started the native audio playout.
+  play_stats_.Reset();
+  // Clear members tracking logged playout stats and do it on the task queue.
   task_queue_.PostTask([this] { ResetPlayStats(); });
   // Start a periodic timer based on task queue if not already done by the
   // recording side.
@@ -115,7 +178,10 @@ void AudioDeviceBuffer::StartRecording() {
     return;
   }
   RTC_DLOG(INFO) << __FUNCTION__;
-  // Clear members tracking recording stats and do it on the task queue.
+  // Clear the recording counters. Safe for the same reason as in
+  // StartPlayout().
+  rec_stats_.Reset();
+  // Clear members tracking logged recording stats and do it on the task queue.
   task_queue_.PostTask([this] { ResetRecStats(); });
   // Start a periodic timer based on task queue if not already done by the
   // playout side.
@@ -221,6 +287,42 @@ int32_t AudioDeviceBuffer::SetTypingStatus(bool typing_status) {
   return 0;
 }
 
+AudioDeviceBuffer::Stats AudioDeviceBuffer::GetStats() const {
+  Stats stats;
+  stats.rec_callbacks = rec_stats_.callbacks.load(std::memory_order_relaxed);
+  stats.play_callbacks = play_stats_.callbacks.load(std::memory_order_relaxed);
+  stats.rec_samples = rec_stats_.samples.load(std::memory_order_relaxed);
+  stats.play_samples = play_stats_.samples.load(std::memory_order_relaxed);
+  stats.max_rec_level = rec_stats_.max_level.load(std::memory_order_relaxed);
+  stats.max_play_level = play_stats_.max_level.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void AudioDeviceBuffer::EnableCallbackIntervalHistograms() {
+  RTC_DCHECK_RUN_ON(&main_thread_checker_);
+  RTC_DCHECK(!playing_);
+  RTC_DCHECK(!recording_);
+  for (DirectionStats* stats : {&rec_stats_, &play_stats_}) {
+    if (!stats->interval_histogram) {
+      stats->interval_histogram.reset(
+          new std::atomic<uint32_t>[kNumCallbackIntervalBuckets]);
+      for (size_t i = 0; i < kNumCallbackIntervalBuckets; ++i) {
+        stats->interval_histogram[i].store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+std::vector<uint32_t> AudioDeviceBuffer::GetPlayoutCallbackIntervalHistogram()
+    const {
+  return CopyHistogram(play_stats_.interval_histogram);
+}
+
+std::vector<uint32_t>
+AudioDeviceBuffer::GetRecordingCallbackIntervalHistogram() const {
+  return CopyHistogram(rec_stats_.interval_histogram);
+}
+
 void AudioDeviceBuffer::SetVQEData(int play_delay_ms, int rec_delay_ms) {
   play_delay_ms_ = play_delay_ms;
   rec_delay_ms_ = rec_delay_ms;
@@ -254,7 +356,7 @@ int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audio_buffer,
   }
   // Update recording stats which is used as base for periodic logging of the
   // audio input state.
-  UpdateRecStats(max_abs, samples_per_channel);
+  rec_stats_.Update(max_abs, samples_per_channel);
   return 0;
 }
 
@@ -317,7 +419,7 @@ int32_t AudioDeviceBuffer::RequestPlayoutData(size_t samples_per_channel) {
   }
   // Update playout stats which is used as base for periodic logging of the
   // audio output state.
-  UpdatePlayStats(max_abs, num_samples_out / play_channels_);
+  play_stats_.Update(max_abs, num_samples_out / play_channels_);
   return static_cast<int32_t>(num_samples_out / play_channels_);
 }
 
@@ -381,13 +483,12 @@ void AudioDeviceBuffer::LogStats(LogState state) {
   int64_t time_since_last = rtc::TimeDiff(now_time, last_timer_task_time_);
   last_timer_task_time_ = now_time;
 
-  Stats stats;
-  {
-    MutexLock lock(&lock_);
-    stats = stats_;
-    stats_.max_rec_level = 0;
-    stats_.max_play_level = 0;
-  }
+  Stats stats = GetStats();
+  // Start a new interval for the max levels.
+  stats.max_rec_level =
+      rec_stats_.max_level.exchange(0, std::memory_order_relaxed);
+  stats.max_play_level =
+      play_stats_.max_level.exchange(0, std::memory_order_relaxed);
 
   // Cache current sample rate from atomic members.
   const uint32_t rec_sample_rate = rec_sample_rate_;
@@ -397,9 +498,16 @@ void AudioDeviceBuffer::LogStats(LogState state) {
   // was set to LOG_START to ensure that we have at least one full stable
   // 10-second interval for sample-rate estimation. Hence, first printed log
   // will be after ~20 seconds.
+  //
+  // The counters of a direction are reset when it starts, before the task
+  // that resets |last_stats_| for it runs, so an interval in which they went
+  // backwards is skipped.
   if (++num_stat_reports_ > 2 &&
       static_cast<size_t>(time_since_last) > kTimerIntervalInMilliseconds / 2) {
-    uint32_t diff_samples = stats.rec_samples - last_stats_.rec_samples;
+    const bool rec_reset = stats.rec_samples < last_stats_.rec_samples ||
+                           stats.rec_callbacks < last_stats_.rec_callbacks;
+    uint32_t diff_samples =
+        rec_reset ? 0 : stats.rec_samples - last_stats_.rec_samples;
     float rate = diff_samples / (static_cast<float>(time_since_last) / 1000.0);
     uint32_t abs_diff_rate_in_percent = 0;
     if (rec_sample_rate > 0 && rate > 0) {
@@ -425,7 +533,10 @@ void AudioDeviceBuffer::LogStats(LogState state) {
                     << stats.max_rec_level;
     }
 
-    diff_samples = stats.play_samples - last_stats_.play_samples;
+    const bool play_reset = stats.play_samples < last_stats_.play_samples ||
+                            stats.play_callbacks < last_stats_.play_callbacks;
+    diff_samples =
+        play_reset ? 0 : stats.play_samples - last_stats_.play_samples;
     rate = diff_samples / (static_cast<float>(time_since_last) / 1000.0);
     abs_diff_rate_in_percent = 0;
     if (play_sample_rate > 0 && rate > 0) {
@@ -465,35 +576,11 @@ void AudioDeviceBuffer::LogStats(LogState state) {
 void AudioDeviceBuffer::ResetRecStats() {
   RTC_DCHECK_RUN_ON(&task_queue_);
   last_stats_.ResetRecStats();
-  MutexLock lock(&lock_);
-  stats_.ResetRecStats();
 }
 
 void AudioDeviceBuffer::ResetPlayStats() {
   RTC_DCHECK_RUN_ON(&task_queue_);
   last_stats_.ResetPlayStats();
-  MutexLock lock(&lock_);
-  stats_.ResetPlayStats();
-}
-
-void AudioDeviceBuffer::UpdateRecStats(int16_t max_abs,
-                                       size_t samples_per_channel) {
-  MutexLock lock(&lock_);
-  ++stats_.rec_callbacks;
-  stats_.rec_samples += samples_per_channel;
-  if (max_abs > stats_.max_rec_level) {
-    stats_.max_rec_level = max_abs;
-  }
-}
-
-void AudioDeviceBuffer::UpdatePlayStats(int16_t max_abs,
-                                        size_t samples_per_channel) {
-  MutexLock lock(&lock_);
-  ++stats_.play_callbacks;
-  stats_.play_samples += samples_per_channel;
-  if (max_abs > stats_.max_play_level) {
-    stats_.max_play_level = max_abs;
-  }
 }
 
 }  // namespace webrtc
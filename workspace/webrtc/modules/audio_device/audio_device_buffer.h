@@ -15,12 +15,13 @@
 #include <stdint.h>
 
 #include <atomic>
+#include <memory>
+#include <vector>
 
 #include "api/sequence_checker.h"
 #include "api/task_queue/task_queue_factory.h"
 #include "modules/audio_device/include/audio_device_defines.h"
 #include "rtc_base/buffer.h"
-#include "rtc_base/synchronization/mutex.h"
 #include "rtc_base/task_queue.h"
 #include "rtc_base/thread_annotations.h"
 
@@ -77,6 +78,12 @@ class AudioDeviceBuffer {
     int16_t max_play_level = 0;
   };
 
+  // Width and number of the buckets of the callback interval histograms. The
+  // last bucket holds all intervals of
+  // (kNumCallbackIntervalBuckets - 1) * kCallbackIntervalBucketUs and above.
+  static constexpr int kCallbackIntervalBucketUs = 100;
+  static constexpr size_t kNumCallbackIntervalBuckets = 501;
+
   explicit AudioDeviceBuffer(TaskQueueFactory* task_queue_factory);
   virtual ~AudioDeviceBuffer();
 
@@ -108,7 +115,42 @@ class AudioDeviceBuffer {
 
   int32_t SetTypingStatus(bool typing_status);
 
+  // Returns the stats of the current playout and recording sessions. Can be
+  // called on any thread and never blocks the audio threads. The max levels
+  // are those since the last periodic log.
+  Stats GetStats() const;
+
+  // Makes every following playout and recording callback record the time
+  // since the previous callback in a histogram, at the cost of reading the
+  // clock once per callback. Must be called before media is started.
+  void EnableCallbackIntervalHistograms();
+  // Return the number of callbacks per interval bucket in the current session,
+  // or an empty vector if the histograms are not enabled. Can be called on any
+  // thread.
+  std::vector<uint32_t> GetPlayoutCallbackIntervalHistogram() const;
+  std::vector<uint32_t> GetRecordingCallbackIntervalHistogram() const;
+
  private:
+  // Counters for one direction. They are written only by the native audio
+  // thread of that direction, and reset by the creating thread while that
+  // audio thread is known not to run, so updates are plain relaxed stores
+  // rather than locked or read-modify-write operations. Any thread may read
+  // them.
+  struct DirectionStats {
+    void Reset();
+    void Update(int16_t max_abs, size_t samples_per_channel);
+
+    std::atomic<uint64_t> callbacks{0};
+    std::atomic<uint64_t> samples{0};
+    // Also reset by LogStats(). A new max written while the level is reset
+    // may end up in either logging interval, which is fine for a diagnostic.
+    std::atomic<int16_t> max_level{0};
+    // Time of the previous callback, only touched on the audio thread.
+    int64_t last_callback_time_us = 0;
+    // Set when callback interval histograms are enabled.
+    std::unique_ptr<std::atomic<uint32_t>[]> interval_histogram;
+  };
+
   // Starts/stops periodic logging of audio stats.
   void StartPeriodicLogging();
   void StopPeriodicLogging();
@@ -121,12 +163,7 @@ class AudioDeviceBuffer {
   // state = LOG_ACTIVE => logs are printed and the timer is kept alive.
   void LogStats(LogState state);
 
-  // Updates counters in each play/record callback. These counters are later
-  // (periodically) read by LogStats() using a lock.
-  void UpdateRecStats(int16_t max_abs, size_t samples_per_channel);
-  void UpdatePlayStats(int16_t max_abs, size_t samples_per_channel);
-
-  // Clears all members tracking stats for recording and playout.
+  // Clears the stats last logged for recording and playout.
   // These methods both run on the task queue.
   void ResetRecStats();
   void ResetPlayStats();
@@ -142,8 +179,6 @@ class AudioDeviceBuffer {
   // Main thread on which this object is created.
   SequenceChecker main_thread_checker_;
 
-  Mutex lock_;
-
   // Task queue used to invoke LogStats() periodically. Tasks are executed on a
   // worker thread but it does not necessarily have to be the same thread for
   // each task.
@@ -203,7 +238,8 @@ class AudioDeviceBuffer {
   int64_t rec_start_time_ RTC_GUARDED_BY(main_thread_checker_);
 
   // Contains counters for playout and recording statistics.
-  Stats stats_ RTC_GUARDED_BY(lock_);
+  DirectionStats rec_stats_;
+  DirectionStats play_stats_;
 
   // Stores current stats at each timer task. Used to calculate differences
   // between two successive timer events.
@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_device/audio_device_buffer.h"
+
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "api/task_queue/default_task_queue_factory.h"
+#include "modules/audio_device/include/mock_audio_transport.h"
+#include "rtc_base/platform_thread.h"
+#include "system_wrappers/include/sleep.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::SetArgReferee;
+
+namespace webrtc {
+
+namespace {
+
+constexpr uint32_t kSampleRate = 48000;
+constexpr size_t kChannels = 2;
+constexpr size_t kFramesPerBuffer = kSampleRate / 100;
+
+class AudioDeviceBufferTest : public ::testing::Test {
+ public:
+  // Each call simulates one native audio callback.
+  void Record() {
+    audio_buffer_.SetRecordedBuffer(recorded_.data(), kFramesPerBuffer);
+    audio_buffer_.DeliverRecordedData();
+  }
+
+  void Play() {
+    audio_buffer_.RequestPlayoutData(kFramesPerBuffer);
+    audio_buffer_.GetPlayoutData(played_.data());
+  }
+
+ protected:
+  AudioDeviceBufferTest()
+      : task_queue_factory_(CreateDefaultTaskQueueFactory()),
+        audio_buffer_(task_queue_factory_.get()),
+        recorded_(kFramesPerBuffer * kChannels, 0),
+        played_(kFramesPerBuffer * kChannels) {
+    ON_CALL(transport_, NeedMorePlayData(_, _, _, _, _, _, _, _))
+        .WillByDefault(
+            DoAll(SetArgReferee<5>(kFramesPerBuffer * kChannels), Return(0)));
+    audio_buffer_.RegisterAudioCallback(&transport_);
+    audio_buffer_.SetRecordingSampleRate(kSampleRate);
+    audio_buffer_.SetPlayoutSampleRate(kSampleRate);
+    audio_buffer_.SetRecordingChannels(kChannels);
+    audio_buffer_.SetPlayoutChannels(kChannels);
+  }
+
+  ~AudioDeviceBufferTest() override {
+    audio_buffer_.StopRecording();
+    audio_buffer_.StopPlayout();
+  }
+
+  std::unique_ptr<TaskQueueFactory> task_queue_factory_;
+  NiceMock<test::MockAudioTransport> transport_;
+  AudioDeviceBuffer audio_buffer_;
+  std::vector<int16_t> recorded_;
+  std::vector<int16_t> played_;
+};
+
+}  // namespace
+
+TEST_F(AudioDeviceBufferTest, StatsCountCallbacksPerSession) {
+  audio_buffer_.StartRecording();
+  audio_buffer_.StartPlayout();
+  recorded_[7] = -1234;
+  // Levels are measured every 50 callbacks.
+  for (int i = 0; i < 50; ++i) {
+    Record();
+  }
+  for (int i = 0; i < 30; ++i) {
+    Play();
+  }
+
+  AudioDeviceBuffer::Stats stats = audio_buffer_.GetStats();
+  EXPECT_EQ(50u, stats.rec_callbacks);
+  EXPECT_EQ(50u * kFramesPerBuffer, stats.rec_samples);
+  EXPECT_EQ(1234, stats.max_rec_level);
+  EXPECT_EQ(30u, stats.play_callbacks);
+  EXPECT_EQ(30u * kFramesPerBuffer, stats.play_samples);
+
+  // A new session starts from zero.
+  audio_buffer_.StopRecording();
+  audio_buffer_.StartRecording();
+  stats = audio_buffer_.GetStats();
+  EXPECT_EQ(0u, stats.rec_callbacks);
+  EXPECT_EQ(0u, stats.rec_samples);
+  EXPECT_EQ(0, stats.max_rec_level);
+  EXPECT_EQ(30u, stats.play_callbacks);
+}
+
+TEST_F(AudioDeviceBufferTest, StatsCanBeReadWhileRecording) {
+  constexpr uint64_t kNumCallbacks = 2000;
+  audio_buffer_.StartRecording();
+  rtc::PlatformThread audio_thread(
+      [](void* obj) {
+        auto* test = static_cast<AudioDeviceBufferTest*>(obj);
+        for (uint64_t i = 0; i < kNumCallbacks; ++i) {
+          test->Record();
+        }
+      },
+      this, "audio_thread", rtc::kRealtimePriority);
+  audio_thread.Start();
+  uint64_t last_callbacks = 0;
+  while (last_callbacks < kNumCallbacks) {
+    const AudioDeviceBuffer::Stats stats = audio_buffer_.GetStats();
+    EXPECT_GE(stats.rec_callbacks, last_callbacks);
+    EXPECT_LE(stats.rec_callbacks, kNumCallbacks);
+    last_callbacks = stats.rec_callbacks;
+  }
+  audio_thread.Stop();
+  EXPECT_EQ(kNumCallbacks * kFramesPerBuffer,
+            audio_buffer_.GetStats().rec_samples);
+}
+
+TEST_F(AudioDeviceBufferTest, CallbackIntervalHistograms) {
+  EXPECT_TRUE(audio_buffer_.GetRecordingCallbackIntervalHistogram().empty());
+  EXPECT_TRUE(audio_buffer_.GetPlayoutCallbackIntervalHistogram().empty());
+  audio_buffer_.EnableCallbackIntervalHistograms();
+  audio_buffer_.StartRecording();
+  audio_buffer_.StartPlayout();
+  for (int i = 0; i < 5; ++i) {
+    SleepMs(2);
+    Record();
+    Play();
+  }
+
+  for (const std::vector<uint32_t>& histogram :
+       {audio_buffer_.GetRecordingCallbackIntervalHistogram(),
+        audio_buffer_.GetPlayoutCallbackIntervalHistogram()}) {
+    ASSERT_EQ(AudioDeviceBuffer::kNumCallbackIntervalBuckets,
+              histogram.size());
+    // The first callback has no interval.
+    EXPECT_EQ(4u, std::accumulate(histogram.begin(), histogram.end(), 0u));
+    // All intervals are at least 2 ms.
+    const size_t min_bucket =
+        2000 / AudioDeviceBuffer::kCallbackIntervalBucketUs;
+    EXPECT_EQ(0u, std::accumulate(histogram.begin(),
+                                  histogram.begin() + min_bucket, 0u));
+  }
+
+  // A new session starts from zero.
+  audio_buffer_.StopRecording();
+  audio_buffer_.StartRecording();
+  const std::vector<uint32_t> histogram =
+      audio_buffer_.GetRecordingCallbackIntervalHistogram();
+  EXPECT_EQ(0u, std::accumulate(histogram.begin(), histogram.end(), 0u));
+}
+
+}  // namespace webrtc
@@ -28,9 +28,14 @@ const size_t kPlayoutBufferSize =
     kPlayoutFixedSampleRate / 100 * kPlayoutNumChannels * 2;
 const size_t kRecordingBufferSize =
     kRecordingFixedSampleRate / 100 * kRecordingNumChannels * 2;
+// Delays reported with Pacing::kAsFastAsPossible: a rendered frame is played
+// out over the next 10 ms, and a captured frame was recorded over the last.
+const int kSimulatedPlayoutDelayMs = 10;
+const int kSimulatedRecordingDelayMs = 10;
 
 FileAudioDevice::FileAudioDevice(const char* inputFilename,
-                                 const char* outputFilename)
+                                 const char* outputFilename,
+                                 Pacing pacing)
     : _ptrAudioBuffer(NULL),
       _recordingBuffer(NULL),
       _playoutBuffer(NULL),
@@ -39,6 +44,10 @@ FileAudioDevice::FileAudioDevice(const char* inputFilename,
       _recordingBufferSizeIn10MS(0),
       _recordingFramesIn10MS(0),
       _playoutFramesIn10MS(0),
+      _pacing(pacing),
+      _simulatedClock(0),
+      _simulating(false),
+      _controlWaiting(0),
       _playing(false),
       _recording(false),
       _lastCallPlayoutMillis(0),
@@ -139,7 +148,7 @@ int32_t FileAudioDevice::PlayoutIsAvailable(bool& available) {
 }
 
 int32_t FileAudioDevice::InitPlayout() {
-  MutexLock lock(&mutex_);
+  ControlLock lock(this);
 
   if (_playing) {
     return -1;
@@ -169,7 +178,7 @@ int32_t FileAudioDevice::RecordingIsAvailable(bool& available) {
 }
 
 int32_t FileAudioDevice::InitRecording() {
-  MutexLock lock(&mutex_);
+  ControlLock lock(this);
 
   if (_recording) {
     return -1;
@@ -193,6 +202,9 @@ int32_t FileAudioDevice::StartPlayout() {
     return 0;
   }
 
+  // Recording may be running on the simulation thread; pause it while the
+  // playout state changes.
+  StopSimulation();
   _playing = true;
   _playoutFramesLeft = 0;
 
@@ -201,6 +213,7 @@ int32_t FileAudioDevice::StartPlayout() {
   }
   if (!_playoutBuffer) {
     _playing = false;
+    StartSimulation();
     return -1;
   }
 
@@ -212,14 +225,19 @@ int32_t FileAudioDevice::StartPlayout() {
       _playing = false;
       delete[] _playoutBuffer;
       _playoutBuffer = NULL;
+      StartSimulation();
       return -1;
     }
   }
 
-  _ptrThreadPlay.reset(new rtc::PlatformThread(
-      PlayThreadFunc, this, "webrtc_audio_module_play_thread",
-      rtc::kRealtimePriority));
-  _ptrThreadPlay->Start();
+  if (_pacing == Pacing::kAsFastAsPossible) {
+    StartSimulation();
+  } else {
+    _ptrThreadPlay.reset(new rtc::PlatformThread(
+        PlayThreadFunc, this, "webrtc_audio_module_play_thread",
+        rtc::kRealtimePriority));
+    _ptrThreadPlay->Start();
+  }
 
   RTC_LOG(LS_INFO) << "Started playout capture to output file: "
                    << _outputFilename;
@@ -228,7 +246,7 @@ int32_t FileAudioDevice::StartPlayout() {
 
 int32_t FileAudioDevice::StopPlayout() {
   {
-    MutexLock lock(&mutex_);
+    ControlLock lock(this);
     _playing = false;
   }
 
@@ -237,13 +255,22 @@ int32_t FileAudioDevice::StopPlayout() {
     _ptrThreadPlay->Stop();
     _ptrThreadPlay.reset();
   }
+  StopSimulation();
 
-  MutexLock lock(&mutex_);
-
-  _playoutFramesLeft = 0;
-  delete[] _playoutBuffer;
-  _playoutBuffer = NULL;
-  _outputFile.Close();
+  {
+    ControlLock lock(this);
+    _playoutFramesLeft = 0;
+    delete[] _playoutBuffer;
+    _playoutBuffer = NULL;
+    _outputFile.Close();
+    if (_pacing == Pacing::kAsFastAsPossible) {
+      // Like a hardware device, require InitPlayout() before the next start,
+      // so that recording alone keeps running.
+      _playoutFramesIn10MS = 0;
+    }
+  }
+  // Keep simulating recording, if it is still running.
+  StartSimulation();
 
   RTC_LOG(LS_INFO) << "Stopped playout capture to output file: "
                    << _outputFilename;
@@ -255,6 +282,9 @@ bool FileAudioDevice::Playing() const {
 }
 
 int32_t FileAudioDevice::StartRecording() {
+  // Playout may be running on the simulation thread; pause it while the
+  // recording state changes.
+  StopSimulation();
   _recording = true;
 
   // Make sure we only create the buffer once.
@@ -272,15 +302,19 @@ int32_t FileAudioDevice::StartRecording() {
       _recording = false;
       delete[] _recordingBuffer;
       _recordingBuffer = NULL;
+      StartSimulation();
       return -1;
     }
   }
 
-  _ptrThreadRec.reset(new rtc::PlatformThread(
-      RecThreadFunc, this, "webrtc_audio_module_capture_thread",
-      rtc::kRealtimePriority));
-
-  _ptrThreadRec->Start();
+  if (_pacing == Pacing::kAsFastAsPossible) {
+    StartSimulation();
+  } else {
+    _ptrThreadRec.reset(new rtc::PlatformThread(
+        RecThreadFunc, this, "webrtc_audio_module_capture_thread",
+        rtc::kRealtimePriority));
+    _ptrThreadRec->Start();
+  }
 
   RTC_LOG(LS_INFO) << "Started recording from input file: " << _inputFilename;
 
@@ -289,7 +323,7 @@ int32_t FileAudioDevice::StartRecording() {
 
 int32_t FileAudioDevice::StopRecording() {
   {
-    MutexLock lock(&mutex_);
+    ControlLock lock(this);
     _recording = false;
   }
 
@@ -297,14 +331,24 @@ int32_t FileAudioDevice::StopRecording() {
     _ptrThreadRec->Stop();
     _ptrThreadRec.reset();
   }
+  StopSimulation();
 
-  MutexLock lock(&mutex_);
-  _recordingFramesLeft = 0;
-  if (_recordingBuffer) {
-    delete[] _recordingBuffer;
-    _recordingBuffer = NULL;
+  {
+    ControlLock lock(this);
+    _recordingFramesLeft = 0;
+    if (_recordingBuffer) {
+      delete[] _recordingBuffer;
+      _recordingBuffer = NULL;
+    }
+    _inputFile.Close();
+    if (_pacing == Pacing::kAsFastAsPossible) {
+      // Like a hardware device, require InitRecording() before the next
+      // start, so that playout alone keeps running.
+      _recordingFramesIn10MS = 0;
+    }
   }
-  _inputFile.Close();
+  // Keep simulating playout, if it is still running.
+  StartSimulation();
 
   RTC_LOG(LS_INFO) << "Stopped recording from input file: " << _inputFilename;
   return 0;
@@ -422,11 +466,14 @@ int32_t FileAudioDevice::StereoRecording(bool& enabled) const {
 }
 
 int32_t FileAudioDevice::PlayoutDelay(uint16_t& delayMS) const {
+  if (_pacing == Pacing::kAsFastAsPossible) {
+    delayMS = kSimulatedPlayoutDelayMs;
+  }
   return 0;
 }
 
 void FileAudioDevice::AttachAudioBuffer(AudioDeviceBuffer* audioBuffer) {
-  MutexLock lock(&mutex_);
+  ControlLock lock(this);
 
   _ptrAudioBuffer = audioBuffer;
 
@@ -451,27 +498,19 @@ void FileAudioDevice::RecThreadFunc(void* pThis) {
   }
 }
 
+void FileAudioDevice::SimThreadFunc(void* pThis) {
+  FileAudioDevice* device = static_cast<FileAudioDevice*>(pThis);
+  while (device->SimThreadProcess()) {
+  }
+}
+
 bool FileAudioDevice::PlayThreadProcess() {
   if (!_playing) {
     return false;
   }
   int64_t currentTime = rtc::TimeMillis();
   mutex_.Lock();
-
-  if (_lastCallPlayoutMillis == 0 ||
-      currentTime - _lastCallPlayoutMillis >= 10) {
-    mutex_.Unlock();
-    _ptrAudioBuffer->RequestPlayoutData(_playoutFramesIn10MS);
-    mutex_.Lock();
-
-    _playoutFramesLeft = _ptrAudioBuffer->GetPlayoutData(_playoutBuffer);
-    RTC_DCHECK_EQ(_playoutFramesIn10MS, _playoutFramesLeft);
-    if (_outputFile.is_open()) {
-      _outputFile.Write(_playoutBuffer, kPlayoutBufferSize);
-    }
-    _lastCallPlayoutMillis = currentTime;
-  }
-  _playoutFramesLeft = 0;
+  PlayoutStep(currentTime);
   mutex_.Unlock();
 
   int64_t deltaTimeMillis = rtc::TimeMillis() - currentTime;
@@ -489,7 +528,61 @@ bool FileAudioDevice::RecThreadProcess() {
 
   int64_t currentTime = rtc::TimeMillis();
   mutex_.Lock();
+  RecordStep(currentTime);
+  mutex_.Unlock();
+
+  int64_t deltaTimeMillis = rtc::TimeMillis() - currentTime;
+  if (deltaTimeMillis < 10) {
+    SleepMs(10 - deltaTimeMillis);
+  }
 
+  return true;
+}
+
+bool FileAudioDevice::SimThreadProcess() {
+  if (!_simulating) {
+    return false;
+  }
+
+  mutex_.Lock();
+  // Render before capturing, so that the capture of each step can contain the
+  // echo of the frame rendered in the same step.
+  const int64_t currentTime = _simulatedClock.TimeInMilliseconds();
+  if (_playing) {
+    PlayoutStep(currentTime);
+  }
+  if (_recording) {
+    RecordStep(currentTime);
+  }
+  _simulatedClock.AdvanceTimeMilliseconds(10);
+  mutex_.Unlock();
+
+  // Relocking right away would usually win the lock again before a waiting
+  // control method runs, so hand it over until that method is done.
+  if (_controlWaiting.load(std::memory_order_acquire) > 0) {
+    _controlDone.Wait(rtc::Event::kForever);
+  }
+  return true;
+}
+
+void FileAudioDevice::PlayoutStep(int64_t currentTime) {
+  if (_lastCallPlayoutMillis == 0 ||
+      currentTime - _lastCallPlayoutMillis >= 10) {
+    mutex_.Unlock();
+    _ptrAudioBuffer->RequestPlayoutData(_playoutFramesIn10MS);
+    mutex_.Lock();
+
+    _playoutFramesLeft = _ptrAudioBuffer->GetPlayoutData(_playoutBuffer);
+    RTC_DCHECK_EQ(_playoutFramesIn10MS, _playoutFramesLeft);
+    if (_outputFile.is_open()) {
+      _outputFile.Write(_playoutBuffer, kPlayoutBufferSize);
+    }
+    _lastCallPlayoutMillis = currentTime;
+  }
+  _playoutFramesLeft = 0;
+}
+
+void FileAudioDevice::RecordStep(int64_t currentTime) {
   if (_lastCallRecordMillis == 0 || currentTime - _lastCallRecordMillis >= 10) {
     if (_inputFile.is_open()) {
       if (_inputFile.Read(_recordingBuffer, kRecordingBufferSize) > 0) {
@@ -498,21 +591,59 @@ bool FileAudioDevice::RecThreadProcess() {
       } else {
         _inputFile.Rewind();
       }
+      if (_pacing == Pacing::kAsFastAsPossible) {
+        _ptrAudioBuffer->SetVQEData(kSimulatedPlayoutDelayMs,
+                                    kSimulatedRecordingDelayMs);
+      }
       _lastCallRecordMillis = currentTime;
       mutex_.Unlock();
       _ptrAudioBuffer->DeliverRecordedData();
       mutex_.Lock();
     }
   }
+}
 
-  mutex_.Unlock();
-
-  int64_t deltaTimeMillis = rtc::TimeMillis() - currentTime;
-  if (deltaTimeMillis < 10) {
-    SleepMs(10 - deltaTimeMillis);
+void FileAudioDevice::StartSimulation() {
+  if (_pacing != Pacing::kAsFastAsPossible || _ptrThreadSim ||
+      (!_playing && !_recording)) {
+    return;
+  }
+  // Wait for every initialized direction to start, so that the first step
+  // does not depend on how far apart StartPlayout() and StartRecording()
+  // were called.
+  if ((PlayoutIsInitialized() && !_playing) ||
+      (RecordingIsInitialized() && !_recording)) {
+    return;
   }
+  _simulating = true;
+  // Set by a control method or StopSimulation() that the last simulation
+  // thread did not wait for.
+  _controlDone.Reset();
+  _ptrThreadSim.reset(new rtc::PlatformThread(
+      SimThreadFunc, this, "webrtc_audio_module_simulation_thread"));
+  _ptrThreadSim->Start();
+}
+
+void FileAudioDevice::StopSimulation() {
+  if (!_ptrThreadSim) {
+    return;
+  }
+  _simulating = false;
+  _controlDone.Set();
+  _ptrThreadSim->Stop();
+  _ptrThreadSim.reset();
+}
 
-  return true;
+FileAudioDevice::ControlLock::ControlLock(FileAudioDevice* device)
+    : device_(device) {
+  device_->_controlWaiting.fetch_add(1, std::memory_order_release);
+  device_->mutex_.Lock();
+  device_->_controlWaiting.fetch_sub(1, std::memory_order_relaxed);
+}
+
+FileAudioDevice::ControlLock::~ControlLock() {
+  device_->mutex_.Unlock();
+  device_->_controlDone.Set();
 }
 
 }  // namespace webrtc
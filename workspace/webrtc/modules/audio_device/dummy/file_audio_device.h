@@ -13,13 +13,17 @@
 
 #include <stdio.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 
 #include "modules/audio_device/audio_device_generic.h"
+#include "rtc_base/event.h"
 #include "rtc_base/synchronization/mutex.h"
 #include "rtc_base/system/file_wrapper.h"
+#include "rtc_base/thread_annotations.h"
 #include "rtc_base/time_utils.h"
+#include "system_wrappers/include/clock.h"
 
 namespace rtc {
 class PlatformThread;
@@ -31,13 +35,30 @@ namespace webrtc {
 // and plays out into a file.
 class FileAudioDevice : public AudioDeviceGeneric {
  public:
+  enum class Pacing {
+    // Playout and recording run on separate threads that sleep to deliver a
+    // 10 ms frame every 10 ms.
+    kRealTime,
+    // Playout and recording run on one thread, back to back, without sleeping.
+    // Each step renders one 10 ms frame, then captures one, and advances a
+    // simulated clock by 10 ms. Steps start once every initialized direction
+    // has been started, and a stopped direction must be initialized again
+    // before it is restarted. The order of the callbacks and the delays
+    // reported to the audio buffer are thus the same on every run, which makes
+    // this suitable for batch processing recordings through the full audio
+    // stack.
+    kAsFastAsPossible,
+  };
+
   // Constructs a file audio device with |id|. It will read audio from
   // |inputFilename| and record output audio to |outputFilename|.
   //
   // The input file should be a readable 48k stereo raw file, and the output
   // file should point to a writable location. The output format will also be
   // 48k stereo raw audio.
-  FileAudioDevice(const char* inputFilename, const char* outputFilename);
+  FileAudioDevice(const char* inputFilename,
+                  const char* outputFilename,
+                  Pacing pacing = Pacing::kRealTime);
   virtual ~FileAudioDevice();
 
   // Retrieve the currently utilized audio layer
@@ -129,8 +150,32 @@ class FileAudioDevice : public AudioDeviceGeneric {
  private:
   static void RecThreadFunc(void*);
   static void PlayThreadFunc(void*);
+  static void SimThreadFunc(void*);
   bool RecThreadProcess();
   bool PlayThreadProcess();
+  bool SimThreadProcess();
+
+  // Deliver one 10 ms frame if 10 ms have passed since the last one. Must be
+  // called with |mutex_| held; it is released during the callbacks.
+  void PlayoutStep(int64_t currentTime);
+  void RecordStep(int64_t currentTime);
+
+  // Start and stop the thread used by Pacing::kAsFastAsPossible.
+  void StartSimulation();
+  void StopSimulation();
+
+  // Holds |mutex_| for a control method. The simulation thread hands the lock
+  // over between steps while a control method waits for it, instead of taking
+  // it again right away.
+  class RTC_SCOPED_LOCKABLE ControlLock {
+   public:
+    explicit ControlLock(FileAudioDevice* device)
+        RTC_EXCLUSIVE_LOCK_FUNCTION(device->mutex_);
+    ~ControlLock() RTC_UNLOCK_FUNCTION();
+
+   private:
+    FileAudioDevice* const device_;
+  };
 
   int32_t _playout_index;
   int32_t _record_index;
@@ -148,6 +193,17 @@ class FileAudioDevice : public AudioDeviceGeneric {
   // TODO(pbos): Make plain members instead of pointers and stop resetting them.
   std::unique_ptr<rtc::PlatformThread> _ptrThreadRec;
   std::unique_ptr<rtc::PlatformThread> _ptrThreadPlay;
+  std::unique_ptr<rtc::PlatformThread> _ptrThreadSim;
+
+  const Pacing _pacing;
+  SimulatedClock _simulatedClock;
+  // Read without |mutex_|, which the simulation thread holds nearly all the
+  // time.
+  std::atomic<bool> _simulating;
+  // Number of control methods waiting for |mutex_|; the simulation thread
+  // waits on |_controlDone| after a step while there are any.
+  std::atomic<int> _controlWaiting;
+  rtc::Event _controlDone;
 
   bool _playing;
   bool _recording;
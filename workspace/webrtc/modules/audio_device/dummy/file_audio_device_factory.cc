@@ -20,6 +20,8 @@
 namespace webrtc {
 
 bool FileAudioDeviceFactory::_isConfigured = false;
+FileAudioDevice::Pacing FileAudioDeviceFactory::_pacing =
+    FileAudioDevice::Pacing::kRealTime;
 char FileAudioDeviceFactory::_inputAudioFilename[MAX_FILENAME_LEN] = "";
 char FileAudioDeviceFactory::_outputAudioFilename[MAX_FILENAME_LEN] = "";
 
@@ -34,7 +36,15 @@ FileAudioDevice* FileAudioDeviceFactory::CreateFileAudioDevice() {
 
     return nullptr;
   }
-  return new FileAudioDevice(_inputAudioFilename, _outputAudioFilename);
+  return new FileAudioDevice(_inputAudioFilename, _outputAudioFilename,
+                             _pacing);
+}
+
+FileAudioDevice* FileAudioDeviceFactory::CreateFileAudioDevice(
+    const char* inputAudioFilename,
+    const char* outputAudioFilename,
+    FileAudioDevice::Pacing pacing) {
+  return new FileAudioDevice(inputAudioFilename, outputAudioFilename, pacing);
 }
 
 void FileAudioDeviceFactory::SetFilenamesToUse(
@@ -57,4 +67,8 @@ void FileAudioDeviceFactory::SetFilenamesToUse(
 #endif
 }
 
+void FileAudioDeviceFactory::SetPacingToUse(FileAudioDevice::Pacing pacing) {
+  _pacing = pacing;
+}
+
 }  // namespace webrtc
@@ -13,9 +13,9 @@
 
 #include <stdint.h>
 
-namespace webrtc {
+#include "modules/audio_device/dummy/file_audio_device.h"
 
-class FileAudioDevice;
+namespace webrtc {
 
 // This class is used by audio_device_impl.cc when WebRTC is compiled with
 // WEBRTC_DUMMY_FILE_DEVICES. The application must include this file and set the
@@ -25,14 +25,28 @@ class FileAudioDeviceFactory {
  public:
   static FileAudioDevice* CreateFileAudioDevice();
 
+  // Creates a device for the given files and pacing, independently of the
+  // settings below. Test tools that batch-process recordings can create any
+  // number of devices this way, e.g. one per recording, and run them with
+  // FileAudioDevice::Pacing::kAsFastAsPossible.
+  static FileAudioDevice* CreateFileAudioDevice(
+      const char* inputAudioFilename,
+      const char* outputAudioFilename,
+      FileAudioDevice::Pacing pacing);
+
   // The input file must be a readable 48k stereo raw file. The output
   // file must be writable. The strings will be copied.
   static void SetFilenamesToUse(const char* inputAudioFilename,
                                 const char* outputAudioFilename);
 
+  // Sets the pacing of the devices created by CreateFileAudioDevice() without
+  // arguments. Defaults to FileAudioDevice::Pacing::kRealTime.
+  static void SetPacingToUse(FileAudioDevice::Pacing pacing);
+
  private:
   enum : uint32_t { MAX_FILENAME_LEN = 512 };
   static bool _isConfigured;
+  static FileAudioDevice::Pacing _pacing;
   static char _inputAudioFilename[MAX_FILENAME_LEN];
   static char _outputAudioFilename[MAX_FILENAME_LEN];
 };
@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_device/dummy/file_audio_device.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/task_queue/default_task_queue_factory.h"
+#include "modules/audio_device/mock_audio_device_buffer.h"
+#include "rtc_base/event.h"
+#include "rtc_base/system/file_wrapper.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "test/testsupport/file_utils.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kFramesIn10Ms = 480;
+constexpr size_t kChannels = 2;
+constexpr int kNumSteps = 1000;
+
+// Writes |num_frames| 10 ms frames of 48 kHz stereo audio to a new file.
+std::string CreateInputFile(int num_frames) {
+  const std::string filename =
+      test::TempFilename(test::OutputPath(), "file_audio_device_input");
+  FileWrapper file = FileWrapper::OpenWriteOnly(filename);
+  const std::vector<int16_t> samples(kFramesIn10Ms * kChannels, 1000);
+  for (int i = 0; i < num_frames; ++i) {
+    file.Write(samples.data(), samples.size() * sizeof(int16_t));
+  }
+  file.Close();
+  return filename;
+}
+
+TEST(FileAudioDeviceTest, AsFastAsPossibleRendersBeforeEachCapture) {
+  const std::string input_filename = CreateInputFile(kNumSteps);
+  auto task_queue_factory = CreateDefaultTaskQueueFactory();
+  MockAudioDeviceBuffer audio_buffer(task_queue_factory.get());
+
+  // Only the simulation thread makes the callbacks, so the log needs no lock
+  // as long as it is read after stopping.
+  std::string log;
+  int num_captures = 0;
+  rtc::Event done;
+  EXPECT_CALL(audio_buffer, RequestPlayoutData(kFramesIn10Ms))
+      .WillRepeatedly(Invoke([&](size_t) {
+        log += 'r';
+        return kFramesIn10Ms;
+      }));
+  EXPECT_CALL(audio_buffer, GetPlayoutData(_))
+      .WillRepeatedly(Invoke([&](void*) {
+        log += 'g';
+        return kFramesIn10Ms;
+      }));
+  EXPECT_CALL(audio_buffer, SetRecordedBuffer(_, kFramesIn10Ms))
+      .WillRepeatedly(Invoke([&](const void*, size_t) {
+        log += 's';
+        return 0;
+      }));
+  EXPECT_CALL(audio_buffer, SetVQEData(10, 10))
+      .WillRepeatedly(Invoke([&](int, int) { log += 'v'; }));
+  EXPECT_CALL(audio_buffer, DeliverRecordedData())
+      .WillRepeatedly(Invoke([&]() {
+        log += 'd';
+        if (++num_captures == kNumSteps) {
+          done.Set();
+        }
+        return 0;
+      }));
+
+  // Without an output file, playout runs without writing anything.
+  FileAudioDevice device(input_filename.c_str(), "",
+                         FileAudioDevice::Pacing::kAsFastAsPossible);
+  device.AttachAudioBuffer(&audio_buffer);
+  ASSERT_EQ(0, device.InitPlayout());
+  ASSERT_EQ(0, device.InitRecording());
+  uint16_t delay_ms = 0;
+  EXPECT_EQ(0, device.PlayoutDelay(delay_ms));
+  EXPECT_EQ(10, delay_ms);
+
+  ASSERT_EQ(0, device.StartPlayout());
+  ASSERT_EQ(0, device.StartRecording());
+  // Half the duration of the audio.
+  EXPECT_TRUE(done.Wait(/*give_up_after_ms=*/kNumSteps * 10 / 2));
+  EXPECT_EQ(0, device.StopRecording());
+  EXPECT_EQ(0, device.StopPlayout());
+
+  // Nothing runs until both directions have started; from then on every
+  // step renders and then captures.
+  ASSERT_GE(log.size(), 5u * kNumSteps);
+  for (int i = 0; i < kNumSteps; ++i) {
+    ASSERT_EQ("rgsvd", log.substr(5 * i, 5)) << "at step " << i;
+  }
+
+  test::RemoveFile(input_filename);
+}
+
+// Methods that take the lock, like InitPlayout(), are not locked out by a
+// running simulation.
+TEST(FileAudioDeviceTest, AsFastAsPossibleLetsControlMethodsRun) {
+  const std::string input_filename = CreateInputFile(kNumSteps);
+  auto task_queue_factory = CreateDefaultTaskQueueFactory();
+  ::testing::NiceMock<MockAudioDeviceBuffer> audio_buffer(
+      task_queue_factory.get());
+  int num_captures = 0;
+  rtc::Event capturing;
+  EXPECT_CALL(audio_buffer, DeliverRecordedData())
+      .WillRepeatedly(Invoke([&]() {
+        if (++num_captures == kNumSteps) {
+          capturing.Set();
+        }
+        return 0;
+      }));
+
+  FileAudioDevice device(input_filename.c_str(), "",
+                         FileAudioDevice::Pacing::kAsFastAsPossible);
+  device.AttachAudioBuffer(&audio_buffer);
+  ASSERT_EQ(0, device.InitRecording());
+  ASSERT_EQ(0, device.StartRecording());
+  EXPECT_TRUE(capturing.Wait(/*give_up_after_ms=*/kNumSteps * 10 / 2));
+  // The input is rewound at its end, so recording is still running.
+  EXPECT_EQ(0, device.InitPlayout());
+  EXPECT_TRUE(device.PlayoutIsInitialized());
+  EXPECT_TRUE(device.Recording());
+  EXPECT_EQ(0, device.StopRecording());
+
+  test::RemoveFile(input_filename);
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -0,0 +1,520 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_device/dummy/load_generator_audio_device.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "api/array_view.h"
+#include "modules/audio_device/audio_device_buffer.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/numerics/safe_conversions.h"
+#include "rtc_base/random.h"
+#include "rtc_base/ref_counted_object.h"
+#include "rtc_base/time_utils.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kTickPeriodUs = 10000;
+constexpr int kPlayoutDelayMs = 10;
+constexpr int kRecordingDelayMs = 10;
+constexpr float kTwoPi = 6.2831853f;
+// Rate at which the voiced tone of the synthetic speech is modulated.
+constexpr float kSyllablesPerSecond = 4.0f;
+
+// Alternates talk spurts of a voiced tone with a syllable envelope and pauses,
+// which is close enough to speech to keep VAD, AGC and AEC busy.
+class SyntheticSpeechCapturer final : public TestAudioDeviceModule::Capturer {
+ public:
+  SyntheticSpeechCapturer(int sampling_frequency_in_hz,
+                          int num_channels,
+                          int16_t max_amplitude,
+                          uint64_t seed)
+      : sampling_frequency_in_hz_(sampling_frequency_in_hz),
+        num_channels_(num_channels),
+        max_amplitude_(max_amplitude),
+        random_(seed),
+        pitch_phase_increment_(kTwoPi * random_.Rand(100, 250) /
+                               sampling_frequency_in_hz),
+        syllable_phase_increment_(kTwoPi * kSyllablesPerSecond /
+                                  sampling_frequency_in_hz) {
+    RTC_DCHECK_GT(num_channels, 0);
+  }
+
+  int SamplingFrequency() const override { return sampling_frequency_in_hz_; }
+
+  int NumChannels() const override { return num_channels_; }
+
+  bool Capture(rtc::BufferT<int16_t>* buffer) override {
+    const size_t samples_per_channel =
+        TestAudioDeviceModule::SamplesPerFrame(sampling_frequency_in_hz_);
+    buffer->SetData(
+        samples_per_channel * num_channels_, [&](rtc::ArrayView<int16_t> data) {
+          int16_t* sample = data.data();
+          for (size_t i = 0; i < samples_per_channel; ++i) {
+            const int16_t value = NextSample();
+            for (int c = 0; c < num_channels_; ++c) {
+              *sample++ = value;
+            }
+          }
+          return data.size();
+        });
+    return true;
+  }
+
+ private:
+  int16_t NextSample() {
+    if (samples_left_in_segment_ == 0) {
+      talking_ = !talking_;
+      const int duration_ms =
+          talking_ ? random_.Rand(800, 2000) : random_.Rand(300, 1000);
+      samples_left_in_segment_ = sampling_frequency_in_hz_ / 1000 * duration_ms;
+      syllable_phase_ = 0.0f;
+    }
+    --samples_left_in_segment_;
+    if (!talking_) {
+      return 0;
+    }
+    const float envelope = 0.5f * (1.0f - std::cos(syllable_phase_));
+    const float tone =
+        0.7f * std::sin(pitch_phase_) + 0.3f * std::sin(2.0f * pitch_phase_);
+    pitch_phase_ = std::fmod(pitch_phase_ + pitch_phase_increment_, kTwoPi);
+    syllable_phase_ =
+        std::fmod(syllable_phase_ + syllable_phase_increment_, kTwoPi);
+    return static_cast<int16_t>(max_amplitude_ * envelope * tone);
+  }
+
+  const int sampling_frequency_in_hz_;
+  const int num_channels_;
+  const int16_t max_amplitude_;
+  Random random_;
+  const float pitch_phase_increment_;
+  const float syllable_phase_increment_;
+  bool talking_ = false;
+  int samples_left_in_segment_ = 0;
+  float pitch_phase_ = 0.0f;
+  float syllable_phase_ = 0.0f;
+};
+
+}  // namespace
+
+struct LoadGeneratorAudioDeviceModule::Device {
+  Device(TaskQueueFactory* task_queue_factory,
+         DeviceConfig config,
+         uint64_t seed)
+      : capturer(std::move(config.capturer)),
+        echo_gain(config.echo_gain),
+        max_jitter_us(rtc::checked_cast<uint32_t>(
+            config.max_jitter_ms * rtc::kNumMicrosecsPerMillisec)),
+        tick_period_us(kTickPeriodUs * (1.0 + config.drift_ppm * 1e-6)),
+        samples_per_channel(TestAudioDeviceModule::SamplesPerFrame(
+            capturer->SamplingFrequency())),
+        num_channels(capturer->NumChannels()),
+        audio_buffer(task_queue_factory),
+        random(seed),
+        playout_buffer(samples_per_channel * num_channels, 0) {
+    audio_buffer.SetPlayoutSampleRate(capturer->SamplingFrequency());
+    audio_buffer.SetRecordingSampleRate(capturer->SamplingFrequency());
+    audio_buffer.SetPlayoutChannels(num_channels);
+    audio_buffer.SetRecordingChannels(num_channels);
+  }
+
+  // When tick |tick_index| of the device clock is due, before jitter.
+  int64_t NominalTickTimeUs(int64_t tick_index) const {
+    return start_time_us + std::llround(tick_index * tick_period_us);
+  }
+
+  // When the next tick is due, including jitter.
+  int64_t NextTickTimeUs() {
+    return NominalTickTimeUs(tick_index) + random.Rand(0u, max_jitter_us);
+  }
+
+  const std::unique_ptr<TestAudioDeviceModule::Capturer> capturer;
+  const float echo_gain;
+  const uint32_t max_jitter_us;
+  const double tick_period_us;
+  const size_t samples_per_channel;
+  const size_t num_channels;
+  AudioDeviceBuffer audio_buffer;
+  bool has_own_audio_callback = false;
+  Random random;
+  std::vector<int16_t> playout_buffer;
+  rtc::BufferT<int16_t> recording_buffer;
+  // True while the device has a tick in the schedule.
+  bool scheduled = false;
+  int64_t start_time_us = 0;
+  // Index of the next tick of the device clock since |start_time_us|.
+  int64_t tick_index = 0;
+  DeviceStats stats;
+};
+
+constexpr int LoadGeneratorAudioDeviceModule::DeviceStats::kLatencyBucketUs;
+constexpr size_t LoadGeneratorAudioDeviceModule::DeviceStats::kNumLatencyBuckets;
+
+LoadGeneratorAudioDeviceModule::DeviceStats::DeviceStats()
+    : latency_histogram(kNumLatencyBuckets, 0) {}
+
+LoadGeneratorAudioDeviceModule::DeviceStats::DeviceStats(const DeviceStats&) =
+    default;
+
+LoadGeneratorAudioDeviceModule::DeviceStats::~DeviceStats() = default;
+
+int LoadGeneratorAudioDeviceModule::DeviceStats::LatencyPercentileUs(
+    float fraction) const {
+  RTC_DCHECK_GE(fraction, 0.0f);
+  RTC_DCHECK_LE(fraction, 1.0f);
+  if (num_callbacks == 0) {
+    return -1;
+  }
+  const int64_t rank = std::max<int64_t>(
+      1, static_cast<int64_t>(std::ceil(fraction * num_callbacks)));
+  int64_t count = 0;
+  for (size_t i = 0; i + 1 < kNumLatencyBuckets; ++i) {
+    count += latency_histogram[i];
+    if (count >= rank) {
+      return std::min(static_cast<int>(i + 1) * kLatencyBucketUs,
+                      max_latency_us);
+    }
+  }
+  return max_latency_us;
+}
+
+// static
+std::unique_ptr<TestAudioDeviceModule::Capturer>
+LoadGeneratorAudioDeviceModule::CreateSyntheticSpeechCapturer(
+    int sampling_frequency_in_hz,
+    int num_channels,
+    int16_t max_amplitude,
+    uint64_t seed) {
+  return std::make_unique<SyntheticSpeechCapturer>(
+      sampling_frequency_in_hz, num_channels, max_amplitude, seed);
+}
+
+// static
+rtc::scoped_refptr<LoadGeneratorAudioDeviceModule>
+LoadGeneratorAudioDeviceModule::Create(TaskQueueFactory* task_queue_factory,
+                                       std::vector<DeviceConfig> devices) {
+  return new rtc::RefCountedObject<LoadGeneratorAudioDeviceModule>(
+      task_queue_factory, std::move(devices));
+}
+
+LoadGeneratorAudioDeviceModule::LoadGeneratorAudioDeviceModule(
+    TaskQueueFactory* task_queue_factory,
+    std::vector<DeviceConfig> devices) {
+  RTC_CHECK_LE(devices.size(), std::numeric_limits<int16_t>::max());
+  devices_.reserve(devices.size());
+  for (DeviceConfig& config : devices) {
+    RTC_CHECK(config.capturer);
+    devices_.push_back(std::make_unique<Device>(
+        task_queue_factory, std::move(config), devices_.size() + 1));
+  }
+}
+
+LoadGeneratorAudioDeviceModule::~LoadGeneratorAudioDeviceModule() {
+  Terminate();
+}
+
+int32_t LoadGeneratorAudioDeviceModule::Init() {
+  {
+    MutexLock lock(&mutex_);
+    if (running_) {
+      return 0;
+    }
+    running_ = true;
+  }
+  scheduler_thread_.reset(new rtc::PlatformThread(
+      SchedulerThreadFunc, this, "webrtc_audio_module_load_generator_thread",
+      rtc::kRealtimePriority));
+  scheduler_thread_->Start();
+  return 0;
+}
+
+int32_t LoadGeneratorAudioDeviceModule::Terminate() {
+  StopPlayout();
+  StopRecording();
+  {
+    MutexLock lock(&mutex_);
+    if (!running_) {
+      return 0;
+    }
+    running_ = false;
+  }
+  wakeup_.Set();
+  scheduler_thread_->Stop();
+  scheduler_thread_.reset();
+
+  const std::vector<DeviceStats> stats = GetStats();
+  for (size_t i = 0; i < stats.size(); ++i) {
+    RTC_LOG(LS_INFO) << "Load generator device " << i
+                     << ": callbacks=" << stats[i].num_callbacks
+                     << ", deadline misses=" << stats[i].num_deadline_misses
+                     << ", skipped=" << stats[i].num_skipped_callbacks
+                     << ", latency p50=" << stats[i].LatencyPercentileUs(0.5f)
+                     << "us, p99=" << stats[i].LatencyPercentileUs(0.99f)
+                     << "us, max=" << stats[i].max_latency_us << "us";
+  }
+  return 0;
+}
+
+bool LoadGeneratorAudioDeviceModule::Initialized() const {
+  MutexLock lock(&mutex_);
+  return running_;
+}
+
+int32_t LoadGeneratorAudioDeviceModule::RegisterAudioCallback(
+    AudioTransport* audio_callback) {
+  MutexLock callback_lock(&callback_mutex_);
+  MutexLock lock(&mutex_);
+  for (auto& device : devices_) {
+    if (!device->has_own_audio_callback &&
+        device->audio_buffer.RegisterAudioCallback(audio_callback) != 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int32_t LoadGeneratorAudioDeviceModule::RegisterDeviceAudioCallback(
+    size_t index,
+    AudioTransport* audio_callback) {
+  MutexLock callback_lock(&callback_mutex_);
+  MutexLock lock(&mutex_);
+  RTC_CHECK_LT(index, devices_.size());
+  Device* device = devices_[index].get();
+  device->has_own_audio_callback = true;
+  return device->audio_buffer.RegisterAudioCallback(audio_callback);
+}
+
+int16_t LoadGeneratorAudioDeviceModule::PlayoutDevices() {
+  MutexLock lock(&mutex_);
+  return rtc::dchecked_cast<int16_t>(devices_.size());
+}
+
+int16_t LoadGeneratorAudioDeviceModule::RecordingDevices() {
+  MutexLock lock(&mutex_);
+  return rtc::dchecked_cast<int16_t>(devices_.size());
+}
+
+int32_t LoadGeneratorAudioDeviceModule::StartPlayout() {
+  MutexLock lock(&mutex_);
+  if (playing_) {
+    return 0;
+  }
+  playing_ = true;
+  for (size_t i = 0; i < devices_.size(); ++i) {
+    devices_[i]->audio_buffer.StartPlayout();
+    ScheduleDevice(i);
+  }
+  wakeup_.Set();
+  return 0;
+}
+
+int32_t LoadGeneratorAudioDeviceModule::StopPlayout() {
+  MutexLock lock(&mutex_);
+  if (!playing_) {
+    return 0;
+  }
+  playing_ = false;
+  for (auto& device : devices_) {
+    device->audio_buffer.StopPlayout();
+  }
+  return 0;
+}
+
+bool LoadGeneratorAudioDeviceModule::Playing() const {
+  MutexLock lock(&mutex_);
+  return playing_;
+}
+
+int32_t LoadGeneratorAudioDeviceModule::StartRecording() {
+  MutexLock lock(&mutex_);
+  if (recording_) {
+    return 0;
+  }
+  recording_ = true;
+  for (size_t i = 0; i < devices_.size(); ++i) {
+    devices_[i]->audio_buffer.StartRecording();
+    ScheduleDevice(i);
+  }
+  wakeup_.Set();
+  return 0;
+}
+
+int32_t LoadGeneratorAudioDeviceModule::StopRecording() {
+  MutexLock lock(&mutex_);
+  if (!recording_) {
+    return 0;
+  }
+  recording_ = false;
+  for (auto& device : devices_) {
+    device->audio_buffer.StopRecording();
+  }
+  return 0;
+}
+
+bool LoadGeneratorAudioDeviceModule::Recording() const {
+  MutexLock lock(&mutex_);
+  return recording_;
+}
+
+int32_t LoadGeneratorAudioDeviceModule::PlayoutDelay(uint16_t* delay_ms) const {
+  *delay_ms = kPlayoutDelayMs;
+  return 0;
+}
+
+std::vector<LoadGeneratorAudioDeviceModule::DeviceStats>
+LoadGeneratorAudioDeviceModule::GetStats() const {
+  MutexLock lock(&mutex_);
+  std::vector<DeviceStats> stats;
+  stats.reserve(devices_.size());
+  for (const auto& device : devices_) {
+    stats.push_back(device->stats);
+  }
+  return stats;
+}
+
+// static
+void LoadGeneratorAudioDeviceModule::SchedulerThreadFunc(void* obj) {
+  auto* module = static_cast<LoadGeneratorAudioDeviceModule*>(obj);
+  while (module->SchedulerThreadProcess()) {
+  }
+}
+
+bool LoadGeneratorAudioDeviceModule::SchedulerThreadProcess() {
+  int wait_ms;
+  {
+    MutexLock callback_lock(&callback_mutex_);
+    Tick tick;
+    Device* device = nullptr;
+    bool playing = false;
+    bool recording = false;
+    {
+      // The lock is released between ticks so that an overloaded scheduler
+      // does not lock out the control methods.
+      MutexLock lock(&mutex_);
+      if (!running_) {
+        return false;
+      }
+      wait_ms = PopDueTick(&tick);
+      if (wait_ms == 0) {
+        device = devices_[tick.second].get();
+        playing = playing_;
+        recording = recording_;
+      }
+    }
+    if (wait_ms == 0) {
+      // The device stays scheduled while its tick runs, so ScheduleDevice()
+      // leaves its clock alone.
+      RunTick(device, playing, recording);
+      const int64_t done_time_us = rtc::TimeMicros();
+      MutexLock lock(&mutex_);
+      FinishTick(tick, done_time_us);
+    }
+  }
+  if (wait_ms > 0 || wait_ms == rtc::Event::kForever) {
+    wakeup_.Wait(wait_ms);
+  }
+  return true;
+}
+
+int LoadGeneratorAudioDeviceModule::PopDueTick(Tick* tick) {
+  while (!schedule_.empty()) {
+    *tick = schedule_.top();
+    if (!playing_ && !recording_) {
+      // The device went idle; it gets a new start time once restarted.
+      schedule_.pop();
+      devices_[tick->second]->scheduled = false;
+      continue;
+    }
+    // Waits have millisecond resolution, so ticks run up to a millisecond
+    // early rather than a millisecond late.
+    const int64_t wait_us = tick->first - rtc::TimeMicros();
+    if (wait_us >= rtc::kNumMicrosecsPerMillisec) {
+      return rtc::dchecked_cast<int>(wait_us / rtc::kNumMicrosecsPerMillisec);
+    }
+    schedule_.pop();
+    return 0;
+  }
+  return rtc::Event::kForever;
+}
+
+void LoadGeneratorAudioDeviceModule::RunTick(Device* device,
+                                             bool playing,
+                                             bool recording) {
+  const size_t num_samples = device->samples_per_channel * device->num_channels;
+  if (playing) {
+    device->audio_buffer.RequestPlayoutData(device->samples_per_channel);
+    device->audio_buffer.GetPlayoutData(device->playout_buffer.data());
+  }
+  if (recording) {
+    device->capturer->Capture(&device->recording_buffer);
+    // A capturer that has run dry is followed by silence.
+    RTC_DCHECK_LE(device->recording_buffer.size(), num_samples);
+    const size_t num_captured = device->recording_buffer.size();
+    device->recording_buffer.SetSize(num_samples);
+    std::fill(device->recording_buffer.begin() + num_captured,
+              device->recording_buffer.end(), 0);
+    if (playing && device->echo_gain != 0.0f) {
+      for (size_t i = 0; i < num_samples; ++i) {
+        device->recording_buffer[i] = rtc::saturated_cast<int16_t>(
+            device->recording_buffer[i] +
+            device->echo_gain * device->playout_buffer[i]);
+      }
+    }
+    device->audio_buffer.SetRecordedBuffer(device->recording_buffer.data(),
+                                           device->samples_per_channel);
+    device->audio_buffer.SetVQEData(kPlayoutDelayMs, kRecordingDelayMs);
+    device->audio_buffer.DeliverRecordedData();
+  }
+}
+
+void LoadGeneratorAudioDeviceModule::FinishTick(const Tick& tick,
+                                                int64_t done_time_us) {
+  Device* device = devices_[tick.second].get();
+  DeviceStats& stats = device->stats;
+  const int latency_us = rtc::saturated_cast<int>(
+      std::max<int64_t>(0, done_time_us - tick.first));
+  ++stats.num_callbacks;
+  ++stats.latency_histogram[std::min<size_t>(
+      latency_us / DeviceStats::kLatencyBucketUs,
+      DeviceStats::kNumLatencyBuckets - 1)];
+  stats.max_latency_us = std::max(stats.max_latency_us, latency_us);
+
+  ++device->tick_index;
+  if (done_time_us > device->NominalTickTimeUs(device->tick_index)) {
+    ++stats.num_deadline_misses;
+    // Drop the ticks that could only run after their own deadline.
+    while (done_time_us >= device->NominalTickTimeUs(device->tick_index + 1)) {
+      ++device->tick_index;
+      ++stats.num_skipped_callbacks;
+    }
+  }
+  schedule_.push(Tick(device->NextTickTimeUs(), tick.second));
+}
+
+void LoadGeneratorAudioDeviceModule::ScheduleDevice(size_t index) {
+  Device* device = devices_[index].get();
+  if (device->scheduled) {
+    return;
+  }
+  device->scheduled = true;
+  device->start_time_us = rtc::TimeMicros();
+  device->tick_index = 0;
+  schedule_.push(Tick(device->NextTickTimeUs(), index));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,188 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_DEVICE_DUMMY_LOAD_GENERATOR_AUDIO_DEVICE_H_
+#define MODULES_AUDIO_DEVICE_DUMMY_LOAD_GENERATOR_AUDIO_DEVICE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "api/scoped_refptr.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "modules/audio_device/include/audio_device.h"
+#include "modules/audio_device/include/audio_device_default.h"
+#include "modules/audio_device/include/test_audio_device.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// LoadGeneratorAudioDeviceModule simulates a number of full-duplex audio
+// devices without any sound hardware, for capacity testing of the audio
+// processing and mixing done behind AudioTransport.
+//
+// Every device has its own AudioDeviceBuffer and AudioTransport, and is driven
+// in 10 ms ticks by a single scheduler thread shared by all devices. Each tick
+// first renders a frame and then captures one, where the captured frame is
+// synthetic speech from the device's Capturer plus an attenuated copy of the
+// rendered frame as echo. Ticks follow the device clock, which may drift from
+// the system clock, and are delayed by a random jitter.
+//
+// The module reports, per device, how many ticks missed their deadline and a
+// histogram of the latency from when each tick was due until its callbacks
+// returned. When the scheduler is overloaded, latency grows and ticks are
+// eventually skipped, just as a real device would drop audio.
+class LoadGeneratorAudioDeviceModule
+    : public webrtc_impl::AudioDeviceModuleDefault<AudioDeviceModule> {
+ public:
+  struct DeviceConfig {
+    // Source of the speech signal. Its sampling frequency and number of
+    // channels are used for both directions of the device. Must be set.
+    std::unique_ptr<TestAudioDeviceModule::Capturer> capturer;
+    // Gain applied to the rendered frame before it is added to the captured
+    // frame. Zero disables the echo.
+    float echo_gain = 0.5f;
+    // Each tick is delayed by a uniformly distributed random time between zero
+    // and |max_jitter_ms|. The delay does not accumulate over ticks.
+    int max_jitter_ms = 0;
+    // Deviation of the device clock from the system clock, in parts per
+    // million. A positive drift makes ticks come less often.
+    int drift_ppm = 0;
+  };
+
+  struct DeviceStats {
+    // Width of the latency histogram buckets.
+    static constexpr int kLatencyBucketUs = 100;
+    // Number of latency histogram buckets. The last bucket holds all
+    // latencies of (kNumLatencyBuckets - 1) * kLatencyBucketUs and above.
+    static constexpr size_t kNumLatencyBuckets = 201;
+
+    DeviceStats();
+    DeviceStats(const DeviceStats&);
+    ~DeviceStats();
+
+    // Returns the upper bound of the latency histogram bucket that holds the
+    // given fraction of the ticks, e.g. 0.99 for the 99th percentile, or -1
+    // if no tick has run.
+    int LatencyPercentileUs(float fraction) const;
+
+    // Number of ticks that ran.
+    int64_t num_callbacks = 0;
+    // Number of ticks whose callbacks returned after the next tick of the
+    // device clock was due.
+    int64_t num_deadline_misses = 0;
+    // Number of ticks that never ran because the scheduler fell more than a
+    // full tick behind.
+    int64_t num_skipped_callbacks = 0;
+    // The largest latency seen.
+    int max_latency_us = 0;
+    // Number of ticks per latency bucket.
+    std::vector<int64_t> latency_histogram;
+  };
+
+  // Returns a Capturer that produces speech-like talk spurts: a voiced tone
+  // with a syllable envelope, interleaved with pauses. Durations and pitch are
+  // drawn from |seed|, which must not be zero, so different devices can talk
+  // differently.
+  static std::unique_ptr<TestAudioDeviceModule::Capturer>
+  CreateSyntheticSpeechCapturer(int sampling_frequency_in_hz,
+                                int num_channels,
+                                int16_t max_amplitude,
+                                uint64_t seed);
+
+  static rtc::scoped_refptr<LoadGeneratorAudioDeviceModule> Create(
+      TaskQueueFactory* task_queue_factory,
+      std::vector<DeviceConfig> devices);
+
+  LoadGeneratorAudioDeviceModule(TaskQueueFactory* task_queue_factory,
+                                 std::vector<DeviceConfig> devices);
+  ~LoadGeneratorAudioDeviceModule() override;
+
+  // Starts and stops the scheduler thread.
+  int32_t Init() override;
+  int32_t Terminate() override;
+  bool Initialized() const override;
+
+  // Registers |audio_callback| with every device that has no callback of its
+  // own set by RegisterDeviceAudioCallback(). Waits for a running tick, so the
+  // previous callback is not called once this returns. Must not be called from
+  // an audio callback; the other methods may be.
+  int32_t RegisterAudioCallback(AudioTransport* audio_callback) override;
+  // Registers |audio_callback| with device |index| only. Must be called while
+  // the device is neither playing nor recording, and not from an audio
+  // callback.
+  int32_t RegisterDeviceAudioCallback(size_t index,
+                                      AudioTransport* audio_callback);
+
+  // Every simulated device is both a playout and a recording device.
+  int16_t PlayoutDevices() override;
+  int16_t RecordingDevices() override;
+
+  // Starting or stopping a direction applies to all devices.
+  int32_t StartPlayout() override;
+  int32_t StopPlayout() override;
+  bool Playing() const override;
+  int32_t StartRecording() override;
+  int32_t StopRecording() override;
+  bool Recording() const override;
+
+  int32_t PlayoutDelay(uint16_t* delay_ms) const override;
+
+  // Returns the stats of every device, in the order they were configured.
+  std::vector<DeviceStats> GetStats() const;
+
+ private:
+  struct Device;
+  // A device tick waiting in |schedule_|, ordered by when it is due.
+  using Tick = std::pair<int64_t, size_t>;
+
+  static void SchedulerThreadFunc(void* obj);
+  bool SchedulerThreadProcess();
+
+  // Takes the earliest tick off |schedule_| if it is due. Returns the time in
+  // milliseconds until the next tick is due, or rtc::Event::kForever if no
+  // device is active, and 0 if |tick| was taken.
+  int PopDueTick(Tick* tick) RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Calls the audio callbacks of |device|. Runs without |mutex_|, so that the
+  // callbacks may call back into the module.
+  void RunTick(Device* device, bool playing, bool recording)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(callback_mutex_);
+  // Updates the stats of the device of |tick| and schedules its next tick.
+  void FinishTick(const Tick& tick, int64_t done_time_us)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Adds the first tick of a device that has just become active.
+  void ScheduleDevice(size_t index) RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Held by the scheduler thread while a tick runs, and taken before |mutex_|
+  // when the audio callbacks are replaced.
+  Mutex callback_mutex_ RTC_ACQUIRED_BEFORE(mutex_);
+  mutable Mutex mutex_;
+  std::vector<std::unique_ptr<Device>> devices_ RTC_GUARDED_BY(mutex_);
+  std::priority_queue<Tick, std::vector<Tick>, std::greater<Tick>> schedule_
+      RTC_GUARDED_BY(mutex_);
+  bool playing_ RTC_GUARDED_BY(mutex_) = false;
+  bool recording_ RTC_GUARDED_BY(mutex_) = false;
+  bool running_ RTC_GUARDED_BY(mutex_) = false;
+  // Wakes the scheduler thread when a device becomes active or on Terminate().
+  rtc::Event wakeup_;
+  std::unique_ptr<rtc::PlatformThread> scheduler_thread_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_DEVICE_DUMMY_LOAD_GENERATOR_AUDIO_DEVICE_H_
@@ -0,0 +1,249 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_device/dummy/load_generator_audio_device.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "api/task_queue/default_task_queue_factory.h"
+#include "modules/audio_device/include/mock_audio_transport.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/event.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::SetArgReferee;
+
+namespace webrtc {
+namespace {
+
+using DeviceConfig = LoadGeneratorAudioDeviceModule::DeviceConfig;
+using DeviceStats = LoadGeneratorAudioDeviceModule::DeviceStats;
+
+constexpr int kNumFrames = 20;
+
+DeviceConfig CreateDeviceConfig(int sampling_frequency_in_hz,
+                                int num_channels,
+                                int16_t max_amplitude) {
+  DeviceConfig config;
+  config.capturer =
+      LoadGeneratorAudioDeviceModule::CreateSyntheticSpeechCapturer(
+          sampling_frequency_in_hz, num_channels, max_amplitude, /*seed=*/1);
+  return config;
+}
+
+TEST(LoadGeneratorAudioDeviceTest, SyntheticSpeechAlternatesTalkAndPauses) {
+  constexpr int16_t kMaxAmplitude = 10000;
+  auto capturer = LoadGeneratorAudioDeviceModule::CreateSyntheticSpeechCapturer(
+      16000, 2, kMaxAmplitude, /*seed=*/1);
+  EXPECT_EQ(16000, capturer->SamplingFrequency());
+  EXPECT_EQ(2, capturer->NumChannels());
+
+  int num_silent_frames = 0;
+  int num_talk_frames = 0;
+  rtc::BufferT<int16_t> buffer;
+  // Five seconds hold at least one talk spurt and one pause.
+  for (int i = 0; i < 500; ++i) {
+    ASSERT_TRUE(capturer->Capture(&buffer));
+    ASSERT_EQ(2u * 160, buffer.size());
+    int max_abs = 0;
+    for (size_t j = 0; j < buffer.size(); j += 2) {
+      ASSERT_EQ(buffer[j], buffer[j + 1]);
+      max_abs = std::max(max_abs, abs(buffer[j]));
+    }
+    EXPECT_LE(max_abs, kMaxAmplitude);
+    if (max_abs == 0) {
+      ++num_silent_frames;
+    } else {
+      ++num_talk_frames;
+    }
+  }
+  EXPECT_GT(num_silent_frames, 0);
+  EXPECT_GT(num_talk_frames, 0);
+}
+
+TEST(LoadGeneratorAudioDeviceTest, CapturesRenderedAudioAsEcho) {
+  auto task_queue_factory = CreateDefaultTaskQueueFactory();
+  std::vector<DeviceConfig> configs;
+  // Silent speech, so that only the echo is captured.
+  configs.push_back(CreateDeviceConfig(16000, 1, /*max_amplitude=*/0));
+  configs[0].echo_gain = 0.5f;
+  auto adm = LoadGeneratorAudioDeviceModule::Create(task_queue_factory.get(),
+                                                    std::move(configs));
+
+  NiceMock<test::MockAudioTransport> transport;
+  EXPECT_CALL(transport, NeedMorePlayData(160, 2, 1, 16000, _, _, _, _))
+      .WillRepeatedly(Invoke(
+          [](size_t samples, size_t, size_t, uint32_t, void* audio_samples,
+             size_t& samples_out, int64_t*, int64_t*) {
+            int16_t* data = static_cast<int16_t*>(audio_samples);
+            std::fill(data, data + samples, 1000);
+            samples_out = samples;
+            return 0;
+          }));
+  int num_recorded = 0;
+  rtc::Event done;
+  EXPECT_CALL(transport,
+              RecordedDataIsAvailable(_, 160, 2, 1, 16000, 20, _, _, _, _))
+      .WillRepeatedly(Invoke([&](const void* audio_samples, size_t samples,
+                                 size_t, size_t, uint32_t, uint32_t, int32_t,
+                                 uint32_t, bool, uint32_t&) {
+        const int16_t* data = static_cast<const int16_t*>(audio_samples);
+        EXPECT_TRUE(std::all_of(data, data + samples,
+                                [](int16_t sample) { return sample == 500; }));
+        if (++num_recorded == kNumFrames) {
+          done.Set();
+        }
+        return 0;
+      }));
+
+  ASSERT_EQ(0, adm->Init());
+  ASSERT_EQ(0, adm->RegisterAudioCallback(&transport));
+  uint16_t delay_ms = 0;
+  EXPECT_EQ(0, adm->PlayoutDelay(&delay_ms));
+  EXPECT_EQ(10, delay_ms);
+  // Playout starts first, so every captured frame has an echo.
+  ASSERT_EQ(0, adm->StartPlayout());
+  ASSERT_EQ(0, adm->StartRecording());
+  EXPECT_TRUE(done.Wait(/*give_up_after_ms=*/5000));
+  EXPECT_EQ(0, adm->Terminate());
+  EXPECT_FALSE(adm->Playing());
+  EXPECT_FALSE(adm->Recording());
+}
+
+TEST(LoadGeneratorAudioDeviceTest, DrivesEveryDeviceAndReportsStats) {
+  auto task_queue_factory = CreateDefaultTaskQueueFactory();
+  std::vector<DeviceConfig> configs;
+  configs.push_back(CreateDeviceConfig(16000, 1, 1000));
+  configs.back().max_jitter_ms = 3;
+  configs.push_back(CreateDeviceConfig(48000, 2, 1000));
+  configs.back().drift_ppm = 1000;
+  configs.push_back(CreateDeviceConfig(44100, 1, 1000));
+  configs.back().echo_gain = 0.0f;
+  const size_t kNumDevices = configs.size();
+  const size_t kSamplesPerChannel[] = {160, 480, 441};
+  auto adm = LoadGeneratorAudioDeviceModule::Create(task_queue_factory.get(),
+                                                    std::move(configs));
+  EXPECT_EQ(3, adm->PlayoutDevices());
+  EXPECT_EQ(3, adm->RecordingDevices());
+
+  // All callbacks come from the scheduler thread, so the counts need no lock.
+  std::vector<int> num_recorded(kNumDevices, 0);
+  rtc::Event done;
+  std::vector<std::unique_ptr<NiceMock<test::MockAudioTransport>>> transports;
+  for (size_t i = 0; i < kNumDevices; ++i) {
+    transports.push_back(
+        std::make_unique<NiceMock<test::MockAudioTransport>>());
+    EXPECT_CALL(*transports[i],
+                NeedMorePlayData(kSamplesPerChannel[i], _, _, _, _, _, _, _))
+        .WillRepeatedly(
+            DoAll(SetArgReferee<5>(kSamplesPerChannel[i]), Return(0)));
+    EXPECT_CALL(*transports[i],
+                RecordedDataIsAvailable(_, kSamplesPerChannel[i], _, _, _, _,
+                                        _, _, _, _))
+        .WillRepeatedly(Invoke([&, i](const void*, size_t, size_t, size_t,
+                                      uint32_t, uint32_t, int32_t, uint32_t,
+                                      bool, uint32_t&) {
+          ++num_recorded[i];
+          if (*std::min_element(num_recorded.begin(), num_recorded.end()) ==
+              kNumFrames) {
+            done.Set();
+          }
+          return 0;
+        }));
+    ASSERT_EQ(0, adm->RegisterDeviceAudioCallback(i, transports[i].get()));
+  }
+
+  ASSERT_EQ(0, adm->Init());
+  ASSERT_EQ(0, adm->StartPlayout());
+  ASSERT_EQ(0, adm->StartRecording());
+  EXPECT_TRUE(done.Wait(/*give_up_after_ms=*/5000));
+  EXPECT_EQ(0, adm->Terminate());
+
+  const std::vector<DeviceStats> stats = adm->GetStats();
+  ASSERT_EQ(kNumDevices, stats.size());
+  for (size_t i = 0; i < kNumDevices; ++i) {
+    EXPECT_GE(stats[i].num_callbacks, kNumFrames);
+    EXPECT_LE(stats[i].num_deadline_misses, stats[i].num_callbacks);
+    ASSERT_EQ(DeviceStats::kNumLatencyBuckets,
+              stats[i].latency_histogram.size());
+    EXPECT_EQ(stats[i].num_callbacks,
+              std::accumulate(stats[i].latency_histogram.begin(),
+                              stats[i].latency_histogram.end(), int64_t{0}));
+    EXPECT_LE(stats[i].LatencyPercentileUs(0.5f),
+              stats[i].LatencyPercentileUs(0.99f));
+    EXPECT_LE(stats[i].LatencyPercentileUs(0.99f), stats[i].max_latency_us);
+  }
+}
+
+// The audio callbacks run without the module lock, so they can call back into
+// the module and do not block the control methods.
+TEST(LoadGeneratorAudioDeviceTest, CallbacksRunWithoutTheModuleLock) {
+  auto task_queue_factory = CreateDefaultTaskQueueFactory();
+  std::vector<DeviceConfig> configs;
+  configs.push_back(CreateDeviceConfig(16000, 1, 1000));
+  auto adm = LoadGeneratorAudioDeviceModule::Create(task_queue_factory.get(),
+                                                    std::move(configs));
+
+  NiceMock<test::MockAudioTransport> transport;
+  rtc::Event in_callback;
+  rtc::Event stopped;
+  EXPECT_CALL(transport, RecordedDataIsAvailable(_, _, _, _, _, _, _, _, _, _))
+      .WillOnce(Invoke([&](const void*, size_t, size_t, size_t, uint32_t,
+                           uint32_t, int32_t, uint32_t, bool, uint32_t&) {
+        EXPECT_TRUE(adm->Recording());
+        EXPECT_FALSE(adm->Playing());
+        EXPECT_EQ(1u, adm->GetStats().size());
+        in_callback.Set();
+        EXPECT_TRUE(stopped.Wait(/*give_up_after_ms=*/5000));
+        EXPECT_FALSE(adm->Recording());
+        return 0;
+      }));
+
+  ASSERT_EQ(0, adm->Init());
+  ASSERT_EQ(0, adm->RegisterAudioCallback(&transport));
+  ASSERT_EQ(0, adm->StartRecording());
+  ASSERT_TRUE(in_callback.Wait(/*give_up_after_ms=*/5000));
+  EXPECT_EQ(0, adm->StopRecording());
+  stopped.Set();
+  // Waits for the callback to return, after which it is no longer called.
+  EXPECT_EQ(0, adm->RegisterAudioCallback(nullptr));
+  EXPECT_EQ(0, adm->Terminate());
+}
+
+TEST(LoadGeneratorAudioDeviceTest, LatencyPercentiles) {
+  DeviceStats stats;
+  EXPECT_EQ(-1, stats.LatencyPercentileUs(0.5f));
+  // 90 ticks in the first bucket, 9 in the third and one beyond the last.
+  stats.num_callbacks = 100;
+  stats.latency_histogram[0] = 90;
+  stats.latency_histogram[2] = 9;
+  stats.latency_histogram[DeviceStats::kNumLatencyBuckets - 1] = 1;
+  stats.max_latency_us = 50000;
+  EXPECT_EQ(DeviceStats::kLatencyBucketUs, stats.LatencyPercentileUs(0.5f));
+  EXPECT_EQ(DeviceStats::kLatencyBucketUs, stats.LatencyPercentileUs(0.9f));
+  EXPECT_EQ(3 * DeviceStats::kLatencyBucketUs,
+            stats.LatencyPercentileUs(0.95f));
+  EXPECT_EQ(50000, stats.LatencyPercentileUs(1.0f));
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -10,6 +10,7 @@
 
 #include "modules/audio_device/fine_audio_buffer.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 
@@ -27,7 +28,10 @@ FineAudioBuffer::FineAudioBuffer(AudioDeviceBuffer* audio_device_buffer)
       record_samples_per_channel_10ms_(rtc::dchecked_cast<size_t>(
           audio_device_buffer->RecordingSampleRate() * 10 / 1000)),
       playout_channels_(audio_device_buffer->PlayoutChannels()),
-      record_channels_(audio_device_buffer->RecordingChannels()) {
+      record_channels_(audio_device_buffer->RecordingChannels()),
+      playout_buffer_(playout_channels_ * playout_samples_per_channel_10ms_),
+      playout_read_index_(playout_buffer_.size()),
+      record_buffer_(0, record_channels_ * record_samples_per_channel_10ms_) {
   RTC_DCHECK(audio_device_buffer_);
   RTC_DLOG(INFO) << __FUNCTION__;
   if (IsReadyForPlayout()) {
@@ -47,7 +51,7 @@ FineAudioBuffer::~FineAudioBuffer() {
 }
 
 void FineAudioBuffer::ResetPlayout() {
-  playout_buffer_.Clear();
+  playout_read_index_ = playout_buffer_.size();
 }
 
 void FineAudioBuffer::ResetRecord() {
@@ -65,42 +69,45 @@ bool FineAudioBuffer::IsReadyForRecord() const {
 void FineAudioBuffer::GetPlayoutData(rtc::ArrayView<int16_t> audio_buffer,
                                      int playout_delay_ms) {
   RTC_DCHECK(IsReadyForPlayout());
-  // Ask WebRTC for new data in chunks of 10ms until we have enough to
-  // fulfill the request. It is possible that the buffer already contains
-  // enough samples from the last round.
-  while (playout_buffer_.size() < audio_buffer.size()) {
+  const size_t num_elements_10ms =
+      playout_channels_ * playout_samples_per_channel_10ms_;
+  // Start with what is left of the last 10ms chunk.
+  size_t num_written = std::min(audio_buffer.size(),
+                                playout_buffer_.size() - playout_read_index_);
+  memcpy(audio_buffer.data(), playout_buffer_.data() + playout_read_index_,
+         num_written * sizeof(int16_t));
+  playout_read_index_ += num_written;
+  // Ask WebRTC for new data in chunks of 10ms until the request is fulfilled.
+  while (num_written < audio_buffer.size()) {
     // Get 10ms decoded audio from WebRTC. The ADB knows about number of
     // channels; hence we can ask for number of samples per channel here.
     if (audio_device_buffer_->RequestPlayoutData(
-            playout_samples_per_channel_10ms_) ==
+            playout_samples_per_channel_10ms_) !=
         static_cast<int32_t>(playout_samples_per_channel_10ms_)) {
-      // Append 10ms to the end of the local buffer taking number of channels
-      // into account.
-      const size_t num_elements_10ms =
-          playout_channels_ * playout_samples_per_channel_10ms_;
-      const size_t written_elements = playout_buffer_.AppendData(
-          num_elements_10ms, [&](rtc::ArrayView<int16_t> buf) {
-            const size_t samples_per_channel_10ms =
-                audio_device_buffer_->GetPlayoutData(buf.data());
-            return playout_channels_ * samples_per_channel_10ms;
-          });
-      RTC_DCHECK_EQ(num_elements_10ms, written_elements);
-    } else {
       // Provide silence if AudioDeviceBuffer::RequestPlayoutData() fails.
       // Can e.g. happen when an AudioTransport has not been registered.
       const size_t num_bytes = audio_buffer.size() * sizeof(int16_t);
       std::memset(audio_buffer.data(), 0, num_bytes);
       return;
     }
+    const size_t num_remaining = audio_buffer.size() - num_written;
+    if (num_remaining >= num_elements_10ms) {
+      // A whole chunk fits, so let the ADB write it to the consumer directly.
+      const size_t samples_per_channel_10ms =
+          audio_device_buffer_->GetPlayoutData(audio_buffer.data() +
+                                               num_written);
+      RTC_DCHECK_EQ(num_elements_10ms,
+                    playout_channels_ * samples_per_channel_10ms);
+      num_written += num_elements_10ms;
+    } else {
+      // Cache the chunk and hand out the part that fits.
+      audio_device_buffer_->GetPlayoutData(playout_buffer_.data());
+      memcpy(audio_buffer.data() + num_written, playout_buffer_.data(),
+             num_remaining * sizeof(int16_t));
+      playout_read_index_ = num_remaining;
+      num_written += num_remaining;
+    }
   }
-
-  // Provide the requested number of bytes to the consumer.
-  const size_t num_bytes = audio_buffer.size() * sizeof(int16_t);
-  memcpy(audio_buffer.data(), playout_buffer_.data(), num_bytes);
-  // Move remaining samples to start of buffer to prepare for next round.
-  memmove(playout_buffer_.data(), playout_buffer_.data() + audio_buffer.size(),
-          (playout_buffer_.size() - audio_buffer.size()) * sizeof(int16_t));
-  playout_buffer_.SetSize(playout_buffer_.size() - audio_buffer.size());
   // Cache playout latency for usage in DeliverRecordedData();
   playout_delay_ms_ = playout_delay_ms;
 }
@@ -109,22 +116,37 @@ void FineAudioBuffer::DeliverRecordedData(
     rtc::ArrayView<const int16_t> audio_buffer,
     int record_delay_ms) {
   RTC_DCHECK(IsReadyForRecord());
-  // Always append new data and grow the buffer when needed.
-  record_buffer_.AppendData(audio_buffer.data(), audio_buffer.size());
-  // Consume samples from buffer in chunks of 10ms until there is not
-  // enough data left. The number of remaining samples in the cache is given by
-  // the new size of the internal |record_buffer_|.
   const size_t num_elements_10ms =
       record_channels_ * record_samples_per_channel_10ms_;
-  while (record_buffer_.size() >= num_elements_10ms) {
+  const int16_t* data = audio_buffer.data();
+  size_t num_left = audio_buffer.size();
+  // Complete the partial chunk left by the last call, if any.
+  if (!record_buffer_.empty()) {
+    const size_t num_missing = num_elements_10ms - record_buffer_.size();
+    if (num_left < num_missing) {
+      record_buffer_.AppendData(data, num_left);
+      return;
+    }
+    record_buffer_.AppendData(data, num_missing);
+    data += num_missing;
+    num_left -= num_missing;
     audio_device_buffer_->SetRecordedBuffer(record_buffer_.data(),
                                             record_samples_per_channel_10ms_);
     audio_device_buffer_->SetVQEData(playout_delay_ms_, record_delay_ms);
     audio_device_buffer_->DeliverRecordedData();
-    memmove(record_buffer_.data(), record_buffer_.data() + num_elements_10ms,
-            (record_buffer_.size() - num_elements_10ms) * sizeof(int16_t));
-    record_buffer_.SetSize(record_buffer_.size() - num_elements_10ms);
+    record_buffer_.Clear();
+  }
+  // Send whole chunks of 10ms straight from the producer's buffer.
+  while (num_left >= num_elements_10ms) {
+    audio_device_buffer_->SetRecordedBuffer(data,
+                                            record_samples_per_channel_10ms_);
+    audio_device_buffer_->SetVQEData(playout_delay_ms_, record_delay_ms);
+    audio_device_buffer_->DeliverRecordedData();
+    data += num_elements_10ms;
+    num_left -= num_elements_10ms;
   }
+  // Keep the start of the next chunk. Fits without reallocation.
+  record_buffer_.AppendData(data, num_left);
 }
 
 }  // namespace webrtc
@@ -27,6 +27,9 @@ class AudioDeviceBuffer;
 // buffers differs from 10ms.
 // As an example: calling DeliverRecordedData() with 5ms buffers will deliver
 // accumulated 10ms worth of data to the ADB every second call.
+// Whole 10ms chunks are passed between the ADB and the caller's buffer
+// directly; only a partial chunk at either end of a buffer goes through a
+// small internal cache. Hence, buffers of exactly 10ms are never copied here.
 class FineAudioBuffer {
  public:
   // |device_buffer| is a buffer that provides 10ms of audio data.
@@ -79,11 +82,13 @@ class FineAudioBuffer {
   // |audio_device_buffer|.
   const size_t playout_channels_;
   const size_t record_channels_;
-  // Storage for output samples from which a consumer can read audio buffers
-  // in any size using GetPlayoutData().
+  // Holds the last 10ms chunk of output samples that did not fit in the
+  // buffer given to GetPlayoutData(). Samples from |playout_read_index_| on
+  // are handed out first by the next call.
   rtc::BufferT<int16_t> playout_buffer_;
-  // Storage for input samples that are about to be delivered to the WebRTC
-  // ADB or remains from the last successful delivery of a 10ms audio buffer.
+  size_t playout_read_index_;
+  // Holds the start of a 10ms chunk of input samples until the rest of it is
+  // given to DeliverRecordedData(). Allocated for 10ms at construction.
   rtc::BufferT<int16_t> record_buffer_;
   // Contains latest delay estimate given to GetPlayoutData().
   int playout_delay_ms_ = 0;
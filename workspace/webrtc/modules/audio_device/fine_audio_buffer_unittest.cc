@@ -92,6 +92,9 @@ void RunFineBufferTest(int frame_size_in_samples) {
   // Ceiling of integer division: 1 + ((x - 1) / y)
   const int kNumberOfUpdateBufferCalls =
       1 + ((kNumberOfFrames * frame_size_in_samples - 1) / kSamplesPer10Ms);
+  // Only complete 10ms chunks are delivered.
+  const int kNumberOfDeliveries =
+      kNumberOfFrames * frame_size_in_samples / kSamplesPer10Ms;
 
   auto task_queue_factory = CreateDefaultTaskQueueFactory();
   MockAudioDeviceBuffer audio_device_buffer(task_queue_factory.get());
@@ -112,16 +115,16 @@ void RunFineBufferTest(int frame_size_in_samples) {
   }
   {
     InSequence s;
-    for (int j = 0; j < kNumberOfUpdateBufferCalls - 1; ++j) {
+    for (int j = 0; j < kNumberOfDeliveries; ++j) {
       EXPECT_CALL(audio_device_buffer, SetRecordedBuffer(_, kSamplesPer10Ms))
           .WillOnce(VerifyInputBuffer(j, kChannels * kSamplesPer10Ms))
           .RetiresOnSaturation();
     }
   }
   EXPECT_CALL(audio_device_buffer, SetVQEData(_, _))
-      .Times(kNumberOfUpdateBufferCalls - 1);
+      .Times(kNumberOfDeliveries);
   EXPECT_CALL(audio_device_buffer, DeliverRecordedData())
-      .Times(kNumberOfUpdateBufferCalls - 1)
+      .Times(kNumberOfDeliveries)
       .WillRepeatedly(Return(0));
 
   FineAudioBuffer fine_buffer(&audio_device_buffer);
@@ -155,4 +158,52 @@ TEST(FineBufferTest, GreaterThan10ms) {
   RunFineBufferTest(kFrameSizeSamples);
 }
 
+TEST(FineBufferTest, Exactly10ms) {
+  RunFineBufferTest(kSamplesPer10Ms);
+}
+
+TEST(FineBufferTest, SeveralTimes10ms) {
+  const int kFrameSizeSamples = 5 * kSamplesPer10Ms / 2;
+  RunFineBufferTest(kFrameSizeSamples);
+}
+
+TEST(FineBufferTest, WholeChunksUseTheCallersBuffer) {
+  auto task_queue_factory = CreateDefaultTaskQueueFactory();
+  MockAudioDeviceBuffer audio_device_buffer(task_queue_factory.get());
+  audio_device_buffer.SetPlayoutSampleRate(kSampleRate);
+  audio_device_buffer.SetPlayoutChannels(kChannels);
+  audio_device_buffer.SetRecordingSampleRate(kSampleRate);
+  audio_device_buffer.SetRecordingChannels(kChannels);
+  FineAudioBuffer fine_buffer(&audio_device_buffer);
+
+  const int kSamples10Ms = kChannels * kSamplesPer10Ms;
+  std::unique_ptr<int16_t[]> buffer(new int16_t[2 * kSamples10Ms]());
+  EXPECT_CALL(audio_device_buffer, RequestPlayoutData(_))
+      .WillRepeatedly(Return(kSamplesPer10Ms));
+  {
+    InSequence s;
+    EXPECT_CALL(audio_device_buffer, GetPlayoutData(buffer.get()))
+        .WillOnce(Return(kSamplesPer10Ms));
+    EXPECT_CALL(audio_device_buffer,
+                GetPlayoutData(buffer.get() + kSamples10Ms))
+        .WillOnce(Return(kSamplesPer10Ms));
+  }
+  fine_buffer.GetPlayoutData(
+      rtc::ArrayView<int16_t>(buffer.get(), 2 * kSamples10Ms), 0);
+
+  {
+    InSequence s;
+    EXPECT_CALL(audio_device_buffer,
+                SetRecordedBuffer(buffer.get(), kSamplesPer10Ms));
+    EXPECT_CALL(audio_device_buffer,
+                SetRecordedBuffer(buffer.get() + kSamples10Ms, kSamplesPer10Ms));
+  }
+  EXPECT_CALL(audio_device_buffer, SetVQEData(_, _)).Times(2);
+  EXPECT_CALL(audio_device_buffer, DeliverRecordedData())
+      .Times(2)
+      .WillRepeatedly(Return(0));
+  fine_buffer.DeliverRecordedData(
+      rtc::ArrayView<const int16_t>(buffer.get(), 2 * kSamples10Ms), 0);
+}
+
 }  // namespace webrtc
@@ -0,0 +1,269 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "api/audio/audio_frame.h"
+#include "api/audio/audio_mixer.h"
+#include "benchmark/benchmark.h"
+#include "modules/audio_mixer/audio_mixer_impl.h"
+#include "modules/audio_mixer/default_output_rate_calculator.h"
+#include "modules/audio_mixer/frame_combiner.h"
+#include "modules/audio_mixer/sine_wave_generator.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSampleRateHz = 48000;
+
+// Produces a sine wave per frame, which is roughly as much work per sample as
+// fetching a frame from a NetEq with a decoded packet waiting.
+class SineSource : public AudioMixer::Source {
+ public:
+  SineSource(int ssrc, float frequency_hz, int16_t amplitude)
+      : ssrc_(ssrc), generator_(frequency_hz, amplitude) {}
+
+  AudioFrameInfo GetAudioFrameWithInfo(int sample_rate_hz,
+                                       AudioFrame* audio_frame) override {
+    audio_frame->sample_rate_hz_ = sample_rate_hz;
+    audio_frame->samples_per_channel_ = sample_rate_hz / 100;
+    audio_frame->num_channels_ = 1;
+    generator_.GenerateNextFrame(audio_frame);
+    return AudioFrameInfo::kNormal;
+  }
+
+  int Ssrc() const override { return ssrc_; }
+  int PreferredSampleRate() const override { return kSampleRateHz; }
+
+ private:
+  const int ssrc_;
+  SineWaveGenerator generator_;
+};
+
+// Returns the same frame every time, so that the mixing itself is measured.
+class FixedFrameSource : public AudioMixer::Source {
+ public:
+  FixedFrameSource(int ssrc, float frequency_hz, int16_t amplitude)
+      : ssrc_(ssrc) {
+    frame_.sample_rate_hz_ = kSampleRateHz;
+    frame_.samples_per_channel_ = kSampleRateHz / 100;
+    frame_.num_channels_ = 1;
+    SineWaveGenerator(frequency_hz, amplitude).GenerateNextFrame(&frame_);
+  }
+
+  AudioFrameInfo GetAudioFrameWithInfo(int sample_rate_hz,
+                                       AudioFrame* audio_frame) override {
+    audio_frame->CopyFrom(frame_);
+    return AudioFrameInfo::kNormal;
+  }
+
+  int Ssrc() const override { return ssrc_; }
+  int PreferredSampleRate() const override { return kSampleRateHz; }
+
+  const AudioFrame& frame() const { return frame_; }
+
+ private:
+  const int ssrc_;
+  AudioFrame frame_;
+};
+
+// Arguments: number of sources, number of pull threads.
+void BM_AudioMixerMix(benchmark::State& state) {
+  const int num_sources = state.range(0);
+  const auto mixer = AudioMixerImpl::Create(
+      std::make_unique<DefaultOutputRateCalculator>(), /*use_limiter=*/true,
+      AudioMixerImpl::kMaximumAmountOfMixedAudioSources,
+      /*num_pull_threads=*/state.range(1));
+  std::vector<std::unique_ptr<SineSource>> sources;
+  for (int i = 0; i < num_sources; ++i) {
+    // Different levels, so that the selection has something to do.
+    sources.push_back(std::make_unique<SineSource>(
+        i, 100.f + 10.f * (i % 50),
+        static_cast<int16_t>(100 + (25 * i) % 10000)));
+    mixer->AddSource(sources.back().get());
+  }
+  AudioFrame frame;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    mixer->Mix(1, &frame);
+    benchmark::DoNotOptimize(frame.data());
+  }
+  for (const auto& source : sources) {
+    mixer->RemoveSource(source.get());
+  }
+}
+
+void Arguments(benchmark::internal::Benchmark* b) {
+  for (int num_sources : {10, 100, 1000}) {
+    for (int num_pull_threads : {0, 3}) {
+      b->Args({num_sources, num_pull_threads});
+    }
+  }
+}
+
+BENCHMARK(BM_AudioMixerMix)
+    ->Apply(Arguments)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+std::vector<std::unique_ptr<FixedFrameSource>> CreateParticipants(
+    int num_participants) {
+  std::vector<std::unique_ptr<FixedFrameSource>> participants;
+  for (int i = 0; i < num_participants; ++i) {
+    // The sums of the louder participants clip now and then.
+    participants.push_back(std::make_unique<FixedFrameSource>(
+        i, 100.f + 10.f * i, static_cast<int16_t>(200 + (50 * i) % 1000)));
+  }
+  return participants;
+}
+
+// Everyone is mixed, and each participant gets the mix of all the others.
+void BM_MixMinus(benchmark::State& state) {
+  const int num_participants = state.range(0);
+  const auto mixer = AudioMixerImpl::Create(
+      std::make_unique<DefaultOutputRateCalculator>(), /*use_limiter=*/true,
+      num_participants, /*num_pull_threads=*/0);
+  const auto participants = CreateParticipants(num_participants);
+  for (const auto& participant : participants) {
+    mixer->AddSource(participant.get());
+  }
+  AudioFrame frame;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    benchmark::DoNotOptimize(mixer->MixMinus(1, &frame).data());
+  }
+  for (const auto& participant : participants) {
+    mixer->RemoveSource(participant.get());
+  }
+}
+
+// The same outputs with one FrameCombiner per participant, which is what
+// running a mixer per participant costs without fetching the audio.
+void BM_MixMinusWithFrameCombiners(benchmark::State& state) {
+  const int num_participants = state.range(0);
+  const auto participants = CreateParticipants(num_participants);
+  std::vector<std::unique_ptr<FrameCombiner>> combiners;
+  std::vector<AudioFrame> frames(num_participants);
+  for (int i = 0; i < num_participants; ++i) {
+    combiners.push_back(std::make_unique<FrameCombiner>(true));
+  }
+  std::vector<AudioFrame*> mix_list;
+  AudioFrame output;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    for (int i = 0; i < num_participants; ++i) {
+      mix_list.clear();
+      for (int j = 0; j < num_participants; ++j) {
+        if (j != i) {
+          frames[j].CopyFrom(participants[j]->frame());
+          mix_list.push_back(&frames[j]);
+        }
+      }
+      combiners[i]->Combine(mix_list, 1, kSampleRateHz, mix_list.size(),
+                            &output);
+      benchmark::DoNotOptimize(output.data());
+    }
+  }
+}
+
+BENCHMARK(BM_MixMinus)
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(128)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MixMinusWithFrameCombiners)
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(128)
+    ->Unit(benchmark::kMicrosecond);
+
+// Arguments: number of channels, number of frames. The frames are loud enough
+// for the limiter to attenuate the mix.
+void BM_FrameCombiner(benchmark::State& state) {
+  const size_t num_channels = state.range(0);
+  const int num_frames = state.range(1);
+  std::vector<AudioFrame> frames(num_frames);
+  std::vector<AudioFrame*> mix_list;
+  for (int i = 0; i < num_frames; ++i) {
+    frames[i].UpdateFrame(0, nullptr, kSampleRateHz / 100, kSampleRateHz,
+                          AudioFrame::kNormalSpeech, AudioFrame::kVadActive,
+                          num_channels);
+    SineWaveGenerator(100.f + 50.f * i, 20000).GenerateNextFrame(&frames[i]);
+    mix_list.push_back(&frames[i]);
+  }
+  FrameCombiner combiner(/*use_limiter=*/true);
+  AudioFrame output;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    combiner.Combine(mix_list, num_channels, kSampleRateHz, mix_list.size(),
+                     &output);
+    benchmark::DoNotOptimize(output.data());
+  }
+}
+
+BENCHMARK(BM_FrameCombiner)
+    ->Args({1, 3})
+    ->Args({2, 3})
+    ->Args({6, 3})
+    ->Args({1, 16})
+    ->Args({2, 16})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace webrtc
+
+/*
+
+Results (Linux, x86-64, a single core, 48 kHz mono, 3 sources mixed):
+
+---------------------------------------------------------------
+Benchmark                              Time             CPU
+---------------------------------------------------------------
+BM_AudioMixerMix/10/0/real_time      65.8 us         65.0 us
+BM_AudioMixerMix/10/3/real_time      90.1 us         28.0 us
+BM_AudioMixerMix/100/0/real_time      634 us          628 us
+BM_AudioMixerMix/100/3/real_time      727 us          210 us
+BM_AudioMixerMix/1000/0/real_time    6895 us         6818 us
+BM_AudioMixerMix/1000/3/real_time    7229 us         2061 us
+
+Before the top-K selection, the sequential runs took 75.7 us, 724 us and
+6885 us. Most of the time is spent generating the sine waves in the sources.
+With pull threads, the CPU time of the mixing thread drops to about a third;
+the wall time only drops when there are cores to spare, which this machine
+did not have.
+
+-------------------------------------------------------------
+Benchmark                             Time             CPU
+-------------------------------------------------------------
+BM_MixMinus/8                      22.1 us         21.8 us
+BM_MixMinus/32                      105 us          104 us
+BM_MixMinus/128                     899 us          886 us
+BM_MixMinusWithFrameCombiners/8    92.8 us         91.8 us
+BM_MixMinusWithFrameCombiners/32   1599 us         1513 us
+BM_MixMinusWithFrameCombiners/128 19230 us        19044 us
+
+With 128 participants all mix-minus outputs clip, so all of them are limited.
+
+------------------------------------------------------
+Benchmark                    Time             CPU
+------------------------------------------------------
+BM_FrameCombiner/1/3      1.63 us         1.61 us
+BM_FrameCombiner/2/3      2.86 us         2.81 us
+BM_FrameCombiner/6/3      10.7 us         10.6 us
+BM_FrameCombiner/1/16     5.17 us         5.09 us
+BM_FrameCombiner/2/16     6.25 us         6.15 us
+
+With the scalar planar mixing buffer and a separate limiter pass these took
+9.47 us, 13.3 us, 38.6 us, 21.8 us and 45.6 us. Since then,
+BM_MixMinusWithFrameCombiners takes 26.7 us, 294 us and 4323 us.
+
+*/
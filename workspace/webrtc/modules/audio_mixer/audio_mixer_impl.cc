@@ -13,14 +13,19 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
+#include <string>
 #include <type_traits>
 #include <utility>
 
+#include "api/function_view.h"
 #include "modules/audio_mixer/audio_frame_manipulator.h"
 #include "modules/audio_mixer/default_output_rate_calculator.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
 #include "rtc_base/ref_counted_object.h"
 
 namespace webrtc {
@@ -34,6 +39,10 @@ struct AudioMixerImpl::SourceStatus {
 
   // A frame that will be passed to audio_source->GetAudioFrameWithInfo.
   AudioFrame audio_frame;
+  // Result of the last GetAudioFrameWithInfo() call.
+  Source::AudioFrameInfo audio_frame_info = Source::AudioFrameInfo::kError;
+  // Created on the first MixMinus() call that mixes the source.
+  std::unique_ptr<MixMinusCombiner::Output> mix_minus_output;
 };
 
 namespace {
@@ -47,9 +56,6 @@ struct SourceFrame {
       : source_status(source_status), audio_frame(audio_frame), muted(muted) {
     RTC_DCHECK(source_status);
     RTC_DCHECK(audio_frame);
-    if (!muted) {
-      energy = AudioMixerCalculateEnergy(*audio_frame);
-    }
   }
 
   SourceFrame(AudioMixerImpl::SourceStatus* source_status,
@@ -97,28 +103,113 @@ void RampAndUpdateGain(
   }
 }
 
-std::vector<std::unique_ptr<AudioMixerImpl::SourceStatus>>::const_iterator
-FindSourceInList(
-    AudioMixerImpl::Source const* audio_source,
-    std::vector<std::unique_ptr<AudioMixerImpl::SourceStatus>> const*
-        audio_source_list) {
-  return std::find_if(
-      audio_source_list->begin(), audio_source_list->end(),
-      [audio_source](const std::unique_ptr<AudioMixerImpl::SourceStatus>& p) {
-        return p->audio_source == audio_source;
-      });
-}
 }  // namespace
 
+// Calls a function for a range of indices, split over a number of worker
+// threads and the calling thread. Used to fetch audio from the sources in
+// parallel.
+class AudioMixerImpl::PullThreadPool {
+ public:
+  explicit PullThreadPool(int num_threads) : workers_(num_threads) {
+    for (size_t i = 0; i < workers_.size(); ++i) {
+      Worker& worker = workers_[i];
+      worker.pool = this;
+      // The calling thread takes the first part of the range.
+      worker.part = i + 1;
+      worker.thread = std::make_unique<rtc::PlatformThread>(
+          &PullThreadPool::WorkerThread, &worker,
+          "AudioMixerPull" + std::to_string(i), rtc::kRealtimePriority);
+      worker.thread->Start();
+    }
+  }
+
+  ~PullThreadPool() {
+    stopping_ = true;
+    for (Worker& worker : workers_) {
+      worker.start.Set();
+      worker.thread->Stop();
+    }
+  }
+
+  // Calls |function| for each index in [0, |count|) and returns when all calls
+  // are done. Must not be called concurrently.
+  void Run(size_t count, rtc::FunctionView<void(size_t)> function) {
+    const size_t num_parts = workers_.size() + 1;
+    // Waking up the workers is not worth it for a few calls.
+    if (count < 2 * num_parts) {
+      for (size_t i = 0; i < count; ++i) {
+        function(i);
+      }
+      return;
+    }
+    count_ = count;
+    function_ = &function;
+    num_running_workers_ = static_cast<int>(workers_.size());
+    for (Worker& worker : workers_) {
+      worker.start.Set();
+    }
+    RunPart(0);
+    done_.Wait(rtc::Event::kForever);
+    function_ = nullptr;
+  }
+
+ private:
+  struct Worker {
+    PullThreadPool* pool = nullptr;
+    size_t part = 0;
+    rtc::Event start;
+    std::unique_ptr<rtc::PlatformThread> thread;
+  };
+
+  static void WorkerThread(void* obj) {
+    Worker* worker = static_cast<Worker*>(obj);
+    PullThreadPool* pool = worker->pool;
+    while (true) {
+      worker->start.Wait(rtc::Event::kForever);
+      if (pool->stopping_) {
+        return;
+      }
+      pool->RunPart(worker->part);
+      if (pool->num_running_workers_.fetch_sub(1) == 1) {
+        pool->done_.Set();
+      }
+    }
+  }
+
+  void RunPart(size_t part) {
+    const size_t num_parts = workers_.size() + 1;
+    const size_t begin = count_ * part / num_parts;
+    const size_t end = count_ * (part + 1) / num_parts;
+    for (size_t i = begin; i < end; ++i) {
+      (*function_)(i);
+    }
+  }
+
+  std::vector<Worker> workers_;
+  // Set before the workers are started, which synchronizes them.
+  size_t count_ = 0;
+  rtc::FunctionView<void(size_t)>* function_ = nullptr;
+  std::atomic<int> num_running_workers_{0};
+  std::atomic<bool> stopping_{false};
+  rtc::Event done_;
+};
+
 struct AudioMixerImpl::HelperContainers {
   void resize(size_t size) {
     audio_to_mix.resize(size);
     audio_source_mixing_data_list.resize(size);
     ramp_list.resize(size);
     preferred_rates.resize(size);
+    mixed_sources.resize(size);
+    mix_minus_outputs.resize(size);
+    mix_minus_frames.resize(size);
   }
 
   std::vector<AudioFrame*> audio_to_mix;
+  // The source of each frame in |audio_to_mix|.
+  std::vector<SourceStatus*> mixed_sources;
+  std::vector<MixMinusCombiner::Output*> mix_minus_outputs;
+  std::vector<MixMinusFrame> mix_minus_frames;
   std::vector<SourceFrame> audio_source_mixing_data_list;
   std::vector<SourceFrame> ramp_list;
   std::vector<int> preferred_rates;
@@ -127,10 +218,26 @@ struct AudioMixerImpl::HelperContainers {
 AudioMixerImpl::AudioMixerImpl(
     std::unique_ptr<OutputRateCalculator> output_rate_calculator,
     bool use_limiter)
-    : output_rate_calculator_(std::move(output_rate_calculator)),
+    : AudioMixerImpl(std::move(output_rate_calculator),
+                     use_limiter,
+                     kMaximumAmountOfMixedAudioSources,
+                     /*num_pull_threads=*/0) {}
+
+AudioMixerImpl::AudioMixerImpl(
+    std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+    bool use_limiter,
+    int max_sources_to_mix,
+    int num_pull_threads)
+    : max_sources_to_mix_(max_sources_to_mix),
+      output_rate_calculator_(std::move(output_rate_calculator)),
       audio_source_list_(),
       helper_containers_(std::make_unique<HelperContainers>()),
-      frame_combiner_(use_limiter) {
+      pull_thread_pool_(num_pull_threads > 0
+                            ? std::make_unique<PullThreadPool>(num_pull_threads)
+                            : nullptr),
+      frame_combiner_(use_limiter),
+      mix_minus_combiner_(use_limiter) {
+  RTC_CHECK_GE(max_sources_to_mix, 1);
   const int kTypicalMaxNumberOfMixedStreams = 3;
   audio_source_list_.reserve(kTypicalMaxNumberOfMixedStreams);
   helper_containers_->resize(kTypicalMaxNumberOfMixedStreams);
@@ -152,10 +259,63 @@ rtc::scoped_refptr<AudioMixerImpl> AudioMixerImpl::Create(
           std::move(output_rate_calculator), use_limiter));
 }
 
+rtc::scoped_refptr<AudioMixerImpl> AudioMixerImpl::Create(
+    std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+    bool use_limiter,
+    int max_sources_to_mix,
+    int num_pull_threads) {
+  return rtc::scoped_refptr<AudioMixerImpl>(
+      new rtc::RefCountedObject<AudioMixerImpl>(
+          std::move(output_rate_calculator), use_limiter, max_sources_to_mix,
+          num_pull_threads));
+}
+
 void AudioMixerImpl::Mix(size_t number_of_channels,
                          AudioFrame* audio_frame_for_mixing) {
-  RTC_DCHECK(number_of_channels >= 1);
   MutexLock lock(&mutex_);
+  MixLocked(number_of_channels, audio_frame_for_mixing);
+}
+
+rtc::ArrayView<const AudioMixerImpl::MixMinusFrame> AudioMixerImpl::MixMinus(
+    size_t number_of_channels,
+    AudioFrame* audio_frame_for_mixing) {
+  MutexLock lock(&mutex_);
+  const rtc::ArrayView<AudioFrame* const> mix_list =
+      MixLocked(number_of_channels, audio_frame_for_mixing);
+
+  // The frames in |mix_list| have been remixed to |number_of_channels|.
+  for (size_t i = 0; i < mix_list.size(); ++i) {
+    SourceStatus* source_status = helper_containers_->mixed_sources[i];
+    if (!source_status->mix_minus_output) {
+      source_status->mix_minus_output =
+          std::make_unique<MixMinusCombiner::Output>();
+    }
+    helper_containers_->mix_minus_outputs[i] =
+        source_status->mix_minus_output.get();
+  }
+  mix_minus_combiner_.Combine(
+      mix_list, number_of_channels, audio_frame_for_mixing->sample_rate_hz_,
+      rtc::ArrayView<MixMinusCombiner::Output* const>(
+          helper_containers_->mix_minus_outputs.data(), mix_list.size()));
+
+  for (size_t i = 0; i < audio_source_list_.size(); ++i) {
+    helper_containers_->mix_minus_frames[i] = {
+        audio_source_list_[i]->audio_source, audio_frame_for_mixing};
+  }
+  for (size_t i = 0; i < mix_list.size(); ++i) {
+    const SourceStatus* source_status = helper_containers_->mixed_sources[i];
+    const size_t index = audio_source_index_[source_status->audio_source];
+    helper_containers_->mix_minus_frames[index].audio_frame =
+        &source_status->mix_minus_output->frame();
+  }
+  return rtc::ArrayView<const MixMinusFrame>(
+      helper_containers_->mix_minus_frames.data(), audio_source_list_.size());
+}
+
+rtc::ArrayView<AudioFrame* const> AudioMixerImpl::MixLocked(
+    size_t number_of_channels,
+    AudioFrame* audio_frame_for_mixing) {
+  RTC_DCHECK(number_of_channels >= 1);
 
   size_t number_of_streams = audio_source_list_.size();
 
@@ -169,17 +329,23 @@ void AudioMixerImpl::Mix(size_t number_of_channels,
       rtc::ArrayView<const int>(helper_containers_->preferred_rates.data(),
                                 number_of_streams));
 
-  frame_combiner_.Combine(GetAudioFromSources(output_frequency),
-                          number_of_channels, output_frequency,
+  const rtc::ArrayView<AudioFrame* const> mix_list =
+      GetAudioFromSources(output_frequency);
+  frame_combiner_.Combine(mix_list, number_of_channels, output_frequency,
                           number_of_streams, audio_frame_for_mixing);
+  return mix_list;
 }
 
 bool AudioMixerImpl::AddSource(Source* audio_source) {
   RTC_DCHECK(audio_source);
   MutexLock lock(&mutex_);
-  RTC_DCHECK(FindSourceInList(audio_source, &audio_source_list_) ==
-             audio_source_list_.end())
-      << "Source already added to mixer";
+  const bool inserted =
+      audio_source_index_.emplace(audio_source, audio_source_list_.size())
+          .second;
+  RTC_DCHECK(inserted) << "Source already added to mixer";
+  if (!inserted) {
+    return false;
+  }
   audio_source_list_.emplace_back(new SourceStatus(audio_source, false, 0));
   helper_containers_->resize(audio_source_list_.size());
   return true;
@@ -188,38 +354,86 @@ bool AudioMixerImpl::AddSource(Source* audio_source) {
 void AudioMixerImpl::RemoveSource(Source* audio_source) {
   RTC_DCHECK(audio_source);
   MutexLock lock(&mutex_);
-  const auto iter = FindSourceInList(audio_source, &audio_source_list_);
-  RTC_DCHECK(iter != audio_source_list_.end()) << "Source not present in mixer";
-  audio_source_list_.erase(iter);
+  const auto iter = audio_source_index_.find(audio_source);
+  RTC_DCHECK(iter != audio_source_index_.end())
+      << "Source not present in mixer";
+  if (iter == audio_source_index_.end()) {
+    return;
+  }
+  // Move the last source into the position of the removed one.
+  const size_t index = iter->second;
+  audio_source_index_.erase(iter);
+  if (index != audio_source_list_.size() - 1) {
+    audio_source_list_[index] = std::move(audio_source_list_.back());
+    audio_source_index_[audio_source_list_[index]->audio_source] = index;
+  }
+  audio_source_list_.pop_back();
+}
+
+void AudioMixerImpl::PullAudioFrames(int output_frequency) {
+  // The list is not modified while |mutex_| is held by this thread, also when
+  // the pull thread pool accesses it.
+  const std::vector<std::unique_ptr<SourceStatus>>* audio_source_list =
+      &audio_source_list_;
+  auto pull = [audio_source_list, output_frequency](size_t i) {
+    SourceStatus* source_status = (*audio_source_list)[i].get();
+    source_status->audio_frame_info =
+        source_status->audio_source->GetAudioFrameWithInfo(
+            output_frequency, &source_status->audio_frame);
+  };
+  if (pull_thread_pool_) {
+    pull_thread_pool_->Run(audio_source_list->size(), pull);
+  } else {
+    for (size_t i = 0; i < audio_source_list->size(); ++i) {
+      pull(i);
+    }
+  }
 }
 
 rtc::ArrayView<AudioFrame* const> AudioMixerImpl::GetAudioFromSources(
     int output_frequency) {
-  // Get audio from the audio sources and put it in the SourceFrame vector.
+  PullAudioFrames(output_frequency);
+
+  // Put the audio from the audio sources in the SourceFrame vector.
   int audio_source_mixing_data_count = 0;
+  int num_unmuted = 0;
   for (auto& source_and_status : audio_source_list_) {
-    const auto audio_frame_info =
-        source_and_status->audio_source->GetAudioFrameWithInfo(
-            output_frequency, &source_and_status->audio_frame);
-
+    const auto audio_frame_info = source_and_status->audio_frame_info;
     if (audio_frame_info == Source::AudioFrameInfo::kError) {
       RTC_LOG_F(LS_WARNING) << "failed to GetAudioFrameWithInfo() from source";
       continue;
     }
+    const bool muted = audio_frame_info == Source::AudioFrameInfo::kMuted;
+    num_unmuted += muted ? 0 : 1;
     helper_containers_
         ->audio_source_mixing_data_list[audio_source_mixing_data_count++] =
         SourceFrame(source_and_status.get(), &source_and_status->audio_frame,
-                    audio_frame_info == Source::AudioFrameInfo::kMuted);
+                    muted);
   }
   rtc::ArrayView<SourceFrame> audio_source_mixing_data_view(
       helper_containers_->audio_source_mixing_data_list.data(),
       audio_source_mixing_data_count);
 
-  // Sort frames by sorting function.
-  std::sort(audio_source_mixing_data_view.begin(),
-            audio_source_mixing_data_view.end(), ShouldMixBefore);
+  // The energy is only needed to choose among the unmuted sources, which is
+  // only necessary when there are more of them than can be mixed.
+  if (num_unmuted > max_sources_to_mix_) {
+    for (auto& p : audio_source_mixing_data_view) {
+      if (!p.muted) {
+        p.energy = AudioMixerCalculateEnergy(*p.audio_frame);
+      }
+    }
+  }
+
+  // Only the frames that may be mixed need to be in order, the rest are
+  // neither mixed nor ramped.
+  const size_t num_candidates =
+      std::min(audio_source_mixing_data_view.size(),
+               static_cast<size_t>(max_sources_to_mix_));
+  std::partial_sort(audio_source_mixing_data_view.begin(),
+                    audio_source_mixing_data_view.begin() + num_candidates,
+                    audio_source_mixing_data_view.end(), ShouldMixBefore);
 
-  int max_audio_frame_counter = kMaximumAmountOfMixedAudioSources;
+  int max_audio_frame_counter = max_sources_to_mix_;
   int ramp_list_lengh = 0;
   int audio_to_mix_count = 0;
   // Go through list in order and put unmuted frames in result list.
@@ -234,6 +448,7 @@ rtc::ArrayView<AudioFrame* const> AudioMixerImpl::GetAudioFromSources(
     bool is_mixed = false;
     if (max_audio_frame_counter > 0) {
       --max_audio_frame_counter;
+      helper_containers_->mixed_sources[audio_to_mix_count] = p.source_status;
       helper_containers_->audio_to_mix[audio_to_mix_count++] = p.audio_frame;
       helper_containers_->ramp_list[ramp_list_lengh++] =
           SourceFrame(p.source_status, p.audio_frame, false, -1);
@@ -251,9 +466,9 @@ bool AudioMixerImpl::GetAudioSourceMixabilityStatusForTest(
     AudioMixerImpl::Source* audio_source) const {
   MutexLock lock(&mutex_);
 
-  const auto iter = FindSourceInList(audio_source, &audio_source_list_);
-  if (iter != audio_source_list_.end()) {
-    return (*iter)->is_mixed;
+  const auto iter = audio_source_index_.find(audio_source);
+  if (iter != audio_source_index_.end()) {
+    return audio_source_list_[iter->second]->is_mixed;
   }
 
   RTC_LOG(LS_ERROR) << "Audio source unknown";
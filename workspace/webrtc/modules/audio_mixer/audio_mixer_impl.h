@@ -13,6 +13,7 @@
 
 #include <stddef.h>
 
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -21,6 +22,7 @@
 #include "api/audio/audio_mixer.h"
 #include "api/scoped_refptr.h"
 #include "modules/audio_mixer/frame_combiner.h"
+#include "modules/audio_mixer/mix_minus_combiner.h"
 #include "modules/audio_mixer/output_rate_calculator.h"
 #include "rtc_base/constructor_magic.h"
 #include "rtc_base/race_checker.h"
@@ -35,14 +37,32 @@ class AudioMixerImpl : public AudioMixer {
 
   // AudioProcessing only accepts 10 ms frames.
   static const int kFrameDurationInMs = 10;
+  // Default number of sources that are mixed.
   enum : int { kMaximumAmountOfMixedAudioSources = 3 };
 
+  // The audio of all sources except one, see MixMinus().
+  struct MixMinusFrame {
+    Source* source;
+    const AudioFrame* audio_frame;
+  };
+
   static rtc::scoped_refptr<AudioMixerImpl> Create();
 
   static rtc::scoped_refptr<AudioMixerImpl> Create(
       std::unique_ptr<OutputRateCalculator> output_rate_calculator,
       bool use_limiter);
 
+  // Mixes at most |max_sources_to_mix| sources. If |num_pull_threads| is
+  // positive, the audio is fetched from the sources on that many worker
+  // threads in addition to the thread calling Mix(), so the sources must
+  // allow GetAudioFrameWithInfo() to be called from any thread. Intended for
+  // mixers with many sources, such as in large conferences.
+  static rtc::scoped_refptr<AudioMixerImpl> Create(
+      std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+      bool use_limiter,
+      int max_sources_to_mix,
+      int num_pull_threads);
+
   ~AudioMixerImpl() override;
 
   // AudioMixer functions
@@ -53,6 +73,16 @@ class AudioMixerImpl : public AudioMixer {
            AudioFrame* audio_frame_for_mixing) override
       RTC_LOCKS_EXCLUDED(mutex_);
 
+  // Mixes like Mix(), and also produces the mix-minus (N-1) output of each
+  // source: the mix without the source's own audio. The sources that are
+  // not mixed get |audio_frame_for_mixing|; the outputs of the mixed sources
+  // are derived from the full mix by subtraction, and are only limited when
+  // they would clip. The returned frames are valid until the next call to
+  // Mix() or MixMinus(), or until the source is removed.
+  rtc::ArrayView<const MixMinusFrame> MixMinus(
+      size_t number_of_channels,
+      AudioFrame* audio_frame_for_mixing) RTC_LOCKS_EXCLUDED(mutex_);
+
   // Returns true if the source was mixed last round. Returns
   // false and logs an error if the source was never added to the
   // mixer.
@@ -61,16 +91,33 @@ class AudioMixerImpl : public AudioMixer {
  protected:
   AudioMixerImpl(std::unique_ptr<OutputRateCalculator> output_rate_calculator,
                  bool use_limiter);
+  AudioMixerImpl(std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+                 bool use_limiter,
+                 int max_sources_to_mix,
+                 int num_pull_threads);
 
  private:
   struct HelperContainers;
+  class PullThreadPool;
 
   // Compute what audio sources to mix from audio_source_list_. Ramp
   // in and out. Update mixed status. Mixes up to
-  // kMaximumAmountOfMixedAudioSources audio sources.
+  // |max_sources_to_mix_| audio sources.
   rtc::ArrayView<AudioFrame* const> GetAudioFromSources(int output_frequency)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Mixes into |audio_frame_for_mixing| and returns the frames that were
+  // mixed, in the same order as |HelperContainers::mixed_sources|.
+  rtc::ArrayView<AudioFrame* const> MixLocked(
+      size_t number_of_channels,
+      AudioFrame* audio_frame_for_mixing) RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Fetches a frame from each source into its SourceStatus.
+  void PullAudioFrames(int output_frequency)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const int max_sources_to_mix_;
+
   // The critical section lock guards audio source insertion and
   // removal, which can be done from any thread. The race checker
   // checks that mixing is done sequentially.
@@ -78,14 +125,20 @@ class AudioMixerImpl : public AudioMixer {
 
   std::unique_ptr<OutputRateCalculator> output_rate_calculator_;
 
-  // List of all audio sources.
+  // List of all audio sources, in no particular order.
   std::vector<std::unique_ptr<SourceStatus>> audio_source_list_
       RTC_GUARDED_BY(mutex_);
+  // Position of each source in |audio_source_list_|.
+  std::map<const Source*, size_t> audio_source_index_ RTC_GUARDED_BY(mutex_);
   const std::unique_ptr<HelperContainers> helper_containers_
       RTC_GUARDED_BY(mutex_);
 
+  // Null if the sources are pulled on the mixing thread only.
+  const std::unique_ptr<PullThreadPool> pull_thread_pool_;
+
   // Component that handles actual adding of audio frames.
   FrameCombiner frame_combiner_;
+  MixMinusCombiner mix_minus_combiner_ RTC_GUARDED_BY(mutex_);
 
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioMixerImpl);
 };
@@ -12,6 +12,7 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <string>
@@ -201,6 +202,153 @@ TEST(AudioMixer, LargestEnergyVadActiveMixed) {
   }
 }
 
+TEST(AudioMixer, LargestEnergySourcesMixedWithConfiguredMaximum) {
+  constexpr int kMaxSourcesToMix = 5;
+  constexpr int kAudioSources = 40;
+
+  const auto mixer = AudioMixerImpl::Create(
+      std::make_unique<DefaultOutputRateCalculator>(), true, kMaxSourcesToMix,
+      /*num_pull_threads=*/0);
+
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    // Interleave the energies, so that the loudest sources are not added last.
+    participants[i].fake_frame()->mutable_data()[80] = (i * 7) % kAudioSources;
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+  }
+
+  mixer->Mix(1, &frame_for_mixing);
+
+  for (int i = 0; i < kAudioSources; ++i) {
+    const bool should_be_mixed =
+        (i * 7) % kAudioSources >= kAudioSources - kMaxSourcesToMix;
+    EXPECT_EQ(should_be_mixed,
+              mixer->GetAudioSourceMixabilityStatusForTest(&participants[i]))
+        << "Mixing status of AudioSource #" << i << " wrong.";
+  }
+}
+
+TEST(AudioMixer, RemovingSourceKeepsOtherSources) {
+  constexpr int kAudioSources = 5;
+  const auto mixer = AudioMixerImpl::Create(
+      std::make_unique<DefaultOutputRateCalculator>(), true, kAudioSources,
+      /*num_pull_threads=*/0);
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+  }
+  mixer->RemoveSource(&participants[1]);
+  mixer->RemoveSource(&participants[kAudioSources - 1]);
+
+  EXPECT_CALL(participants[1], GetAudioFrameWithInfo(_, _)).Times(0);
+  EXPECT_CALL(participants[kAudioSources - 1], GetAudioFrameWithInfo(_, _))
+      .Times(0);
+  mixer->Mix(1, &frame_for_mixing);
+
+  for (int i : {0, 2, 3}) {
+    EXPECT_TRUE(mixer->GetAudioSourceMixabilityStatusForTest(&participants[i]));
+  }
+  // A removed source can be added again.
+  ::testing::Mock::VerifyAndClearExpectations(&participants[1]);
+  EXPECT_TRUE(mixer->AddSource(&participants[1]));
+  mixer->Mix(1, &frame_for_mixing);
+  EXPECT_TRUE(mixer->GetAudioSourceMixabilityStatusForTest(&participants[1]));
+}
+
+TEST(AudioMixer, PullThreadsGiveSameResultAsSequentialPulls) {
+  constexpr int kMaxSourcesToMix = 4;
+  constexpr int kAudioSources = 50;
+
+  const auto sequential_mixer = AudioMixerImpl::Create(
+      std::make_unique<DefaultOutputRateCalculator>(), true, kMaxSourcesToMix,
+      /*num_pull_threads=*/0);
+  const auto parallel_mixer = AudioMixerImpl::Create(
+      std::make_unique<DefaultOutputRateCalculator>(), true, kMaxSourcesToMix,
+      /*num_pull_threads=*/3);
+
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    int16_t* data = participants[i].fake_frame()->mutable_data();
+    for (size_t j = 0; j < participants[i].fake_frame()->samples_per_channel_;
+         ++j) {
+      data[j] = static_cast<int16_t>((i * 31 + j * 17) % 2000 - 1000);
+    }
+    if (i % 5 == 0) {
+      participants[i].set_fake_info(AudioMixer::Source::AudioFrameInfo::kMuted);
+    }
+    EXPECT_TRUE(sequential_mixer->AddSource(&participants[i]));
+    EXPECT_TRUE(parallel_mixer->AddSource(&participants[i]));
+    // Once per mixer and iteration.
+    EXPECT_CALL(participants[i], GetAudioFrameWithInfo(_, _)).Times(6);
+  }
+
+  AudioFrame sequential_frame;
+  AudioFrame parallel_frame;
+  for (int iteration = 0; iteration < 3; ++iteration) {
+    sequential_mixer->Mix(1, &sequential_frame);
+    parallel_mixer->Mix(1, &parallel_frame);
+    ASSERT_EQ(sequential_frame.samples_per_channel_,
+              parallel_frame.samples_per_channel_);
+    EXPECT_EQ(0, memcmp(sequential_frame.data(), parallel_frame.data(),
+                        sequential_frame.samples_per_channel_ *
+                            sizeof(int16_t)));
+    for (int i = 0; i < kAudioSources; ++i) {
+      EXPECT_EQ(
+          sequential_mixer->GetAudioSourceMixabilityStatusForTest(
+              &participants[i]),
+          parallel_mixer->GetAudioSourceMixabilityStatusForTest(
+              &participants[i]));
+    }
+  }
+}
+
+TEST(AudioMixer, MixMinusLeavesOutOwnAudio) {
+  constexpr int kAudioSources = 4;
+  // Without a limiter, the outputs are exact sums.
+  const auto mixer = AudioMixerImpl::Create(
+      std::make_unique<DefaultOutputRateCalculator>(), false);
+
+  // The quietest source is not mixed.
+  const int16_t kValues[kAudioSources] = {1000, 2000, 3000, 10};
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    int16_t* data = participants[i].fake_frame()->mutable_data();
+    std::fill(data, data + participants[i].fake_frame()->samples_per_channel_,
+              kValues[i]);
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+  }
+
+  // The first frame is ramped in.
+  mixer->MixMinus(1, &frame_for_mixing);
+  const rtc::ArrayView<const AudioMixerImpl::MixMinusFrame> outputs =
+      mixer->MixMinus(1, &frame_for_mixing);
+  ASSERT_EQ(static_cast<size_t>(kAudioSources), outputs.size());
+  EXPECT_EQ(6000, frame_for_mixing.data()[0]);
+  for (int i = 0; i < kAudioSources; ++i) {
+    const auto output =
+        std::find_if(outputs.begin(), outputs.end(),
+                     [&](const AudioMixerImpl::MixMinusFrame& frame) {
+                       return frame.source == &participants[i];
+                     });
+    ASSERT_NE(output, outputs.end());
+    if (i == kAudioSources - 1) {
+      EXPECT_EQ(&frame_for_mixing, output->audio_frame);
+      continue;
+    }
+    const AudioFrame& frame = *output->audio_frame;
+    EXPECT_EQ(kDefaultSampleRateHz, frame.sample_rate_hz_);
+    ASSERT_EQ(frame_for_mixing.samples_per_channel_,
+              frame.samples_per_channel_);
+    for (size_t j = 0; j < frame.samples_per_channel_; ++j) {
+      ASSERT_EQ(6000 - kValues[i], frame.data()[j]);
+    }
+  }
+}
+
 TEST(AudioMixer, FrameNotModifiedForSingleParticipant) {
   const auto mixer = AudioMixerImpl::Create();
 
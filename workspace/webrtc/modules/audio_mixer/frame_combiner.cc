@@ -18,10 +18,9 @@
 #include <string>
 
 #include "api/array_view.h"
-#include "common_audio/include/audio_util.h"
 #include "modules/audio_mixer/audio_frame_manipulator.h"
 #include "modules/audio_mixer/audio_mixer_impl.h"
-#include "modules/audio_processing/include/audio_frame_view.h"
+#include "modules/audio_mixer/mixing_kernels.h"
 #include "modules/audio_processing/include/audio_processing.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/arraysize.h"
@@ -31,10 +30,6 @@
 namespace webrtc {
 namespace {
 
-using MixingBuffer =
-    std::array<std::array<float, FrameCombiner::kMaximumChannelSize>,
-               FrameCombiner::kMaximumNumberOfChannels>;
-
 void SetAudioFrameFields(rtc::ArrayView<const AudioFrame* const> mix_list,
                          size_t number_of_channels,
                          int sample_rate,
@@ -74,69 +69,31 @@ void MixFewFramesWithNoLimiter(rtc::ArrayView<const AudioFrame* const> mix_list,
             audio_frame_for_mixing->mutable_data());
 }
 
+// Converts the interleaved frames to FloatS16 and adds them.
 void MixToFloatFrame(rtc::ArrayView<const AudioFrame* const> mix_list,
-                     size_t samples_per_channel,
-                     size_t number_of_channels,
-                     MixingBuffer* mixing_buffer) {
-  RTC_DCHECK_LE(samples_per_channel, FrameCombiner::kMaximumChannelSize);
-  RTC_DCHECK_LE(number_of_channels, FrameCombiner::kMaximumNumberOfChannels);
-  // Clear the mixing buffer.
-  for (auto& one_channel_buffer : *mixing_buffer) {
-    std::fill(one_channel_buffer.begin(), one_channel_buffer.end(), 0.f);
+                     rtc::ArrayView<float> mixing_buffer) {
+  if (mix_list.empty()) {
+    std::fill(mixing_buffer.begin(), mixing_buffer.end(), 0.f);
+    return;
   }
-
-  // Convert to FloatS16 and mix.
-  for (size_t i = 0; i < mix_list.size(); ++i) {
-    const AudioFrame* const frame = mix_list[i];
-    for (size_t j = 0; j < std::min(number_of_channels,
-                                    FrameCombiner::kMaximumNumberOfChannels);
-         ++j) {
-      for (size_t k = 0; k < std::min(samples_per_channel,
-                                      FrameCombiner::kMaximumChannelSize);
-           ++k) {
-        (*mixing_buffer)[j][k] += frame->data()[number_of_channels * k + j];
-      }
-    }
-  }
-}
-
-void RunLimiter(AudioFrameView<float> mixing_buffer_view, Limiter* limiter) {
-  const size_t sample_rate = mixing_buffer_view.samples_per_channel() * 1000 /
-                             AudioMixerImpl::kFrameDurationInMs;
-  // TODO(alessiob): Avoid calling SetSampleRate every time.
-  limiter->SetSampleRate(sample_rate);
-  limiter->Process(mixing_buffer_view);
-}
-
-// Both interleaves and rounds.
-void InterleaveToAudioFrame(AudioFrameView<const float> mixing_buffer_view,
-                            AudioFrame* audio_frame_for_mixing) {
-  const size_t number_of_channels = mixing_buffer_view.num_channels();
-  const size_t samples_per_channel = mixing_buffer_view.samples_per_channel();
-  // Put data in the result frame.
-  for (size_t i = 0; i < number_of_channels; ++i) {
-    for (size_t j = 0; j < samples_per_channel; ++j) {
-      audio_frame_for_mixing->mutable_data()[number_of_channels * j + i] =
-          FloatS16ToS16(mixing_buffer_view.channel(i)[j]);
-    }
+  ConvertS16ToFloatS16(
+      rtc::ArrayView<const int16_t>(mix_list[0]->data(), mixing_buffer.size()),
+      mixing_buffer);
+  for (size_t i = 1; i < mix_list.size(); ++i) {
+    AddS16ToFloatS16(
+        rtc::ArrayView<const int16_t>(mix_list[i]->data(), mixing_buffer.size()),
+        mixing_buffer);
   }
 }
 }  // namespace
 
-constexpr size_t FrameCombiner::kMaximumNumberOfChannels;
 constexpr size_t FrameCombiner::kMaximumChannelSize;
 
 FrameCombiner::FrameCombiner(bool use_limiter)
     : data_dumper_(new ApmDataDumper(0)),
-      mixing_buffer_(
-          std::make_unique<std::array<std::array<float, kMaximumChannelSize>,
-                                      kMaximumNumberOfChannels>>()),
+      mixing_buffer_(std::make_unique<MixingBuffer>()),
       limiter_(static_cast<size_t>(48000), data_dumper_.get(), "AudioMixer"),
-      use_limiter_(use_limiter) {
-  static_assert(kMaximumChannelSize * kMaximumNumberOfChannels <=
-                    AudioFrame::kMaxDataSizeSamples,
-                "");
-}
+      use_limiter_(use_limiter) {}
 
 FrameCombiner::~FrameCombiner() = default;
 
@@ -171,28 +128,27 @@ void FrameCombiner::Combine(rtc::ArrayView<AudioFrame* const> mix_list,
     return;
   }
 
-  MixToFloatFrame(mix_list, samples_per_channel, number_of_channels,
-                  mixing_buffer_.get());
-
-  const size_t output_number_of_channels =
-      std::min(number_of_channels, kMaximumNumberOfChannels);
-  const size_t output_samples_per_channel =
-      std::min(samples_per_channel, kMaximumChannelSize);
-
-  // Put float data in an AudioFrameView.
-  std::array<float*, kMaximumNumberOfChannels> channel_pointers{};
-  for (size_t i = 0; i < output_number_of_channels; ++i) {
-    channel_pointers[i] = &(*mixing_buffer_.get())[i][0];
-  }
-  AudioFrameView<float> mixing_buffer_view(&channel_pointers[0],
-                                           output_number_of_channels,
-                                           output_samples_per_channel);
+  RTC_DCHECK_LE(samples_per_channel, kMaximumChannelSize);
+  const size_t num_samples = samples_per_channel * number_of_channels;
+  RTC_DCHECK_LE(num_samples, mixing_buffer_->size());
+  const rtc::ArrayView<float> mixing_buffer(mixing_buffer_->data(),
+                                            num_samples);
+  MixToFloatFrame(mix_list, mixing_buffer);
 
+  // The samples are scaled and converted in the same pass.
+  const rtc::ArrayView<int16_t> output(audio_frame_for_mixing->mutable_data(),
+                                       num_samples);
   if (use_limiter_) {
-    RunLimiter(mixing_buffer_view, &limiter_);
+    // TODO(alessiob): Avoid calling SetSampleRate every time.
+    limiter_.SetSampleRate(sample_rate);
+    const rtc::ArrayView<const float> scaling_factors =
+        limiter_.ComputeScalingFactors(ComputeSubFramePeaks(mixing_buffer),
+                                       samples_per_channel);
+    ScaleAndConvertFloatS16ToS16(mixing_buffer, scaling_factors,
+                                 number_of_channels, output);
+  } else {
+    ConvertFloatS16ToS16(mixing_buffer, output);
   }
-
-  InterleaveToAudioFrame(mixing_buffer_view, audio_frame_for_mixing);
 }
 
 void FrameCombiner::LogMixingStats(
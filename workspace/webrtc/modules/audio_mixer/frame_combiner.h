@@ -39,12 +39,11 @@ class FrameCombiner {
                size_t number_of_streams,
                AudioFrame* audio_frame_for_mixing);
 
-  // Stereo, 48 kHz, 10 ms.
-  static constexpr size_t kMaximumNumberOfChannels = 8;
+  // 48 kHz, 10 ms.
   static constexpr size_t kMaximumChannelSize = 48 * 10;
 
-  using MixingBuffer = std::array<std::array<float, kMaximumChannelSize>,
-                                  kMaximumNumberOfChannels>;
+  // Interleaved FloatS16 samples of any number of channels.
+  using MixingBuffer = std::array<float, AudioFrame::kMaxDataSizeSamples>;
 
  private:
   void LogMixingStats(rtc::ArrayView<const AudioFrame* const> mix_list,
@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/mix_minus_combiner.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "modules/audio_mixer/audio_mixer_impl.h"
+#include "modules/audio_mixer/mixing_kernels.h"
+#include "modules/audio_processing/agc2/limiter.h"
+#include "modules/audio_processing/logging/apm_data_dumper.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+// Number of frames the limiter of an output stays on after the output last
+// clipped; roughly the release time of the limiter.
+constexpr int kLimiterHoldFrames = 100;
+
+}  // namespace
+
+struct MixMinusCombiner::Output::LimiterState {
+  LimiterState()
+      : data_dumper(0),
+        limiter(static_cast<size_t>(48000),
+                &data_dumper,
+                "AudioMixer.MixMinus") {}
+
+  ApmDataDumper data_dumper;
+  Limiter limiter;
+};
+
+MixMinusCombiner::Output::Output() = default;
+MixMinusCombiner::Output::~Output() = default;
+
+MixMinusCombiner::MixMinusCombiner(bool use_limiter)
+    : use_limiter_(use_limiter),
+      limiter_buffer_(std::make_unique<FrameCombiner::MixingBuffer>()) {}
+
+MixMinusCombiner::~MixMinusCombiner() = default;
+
+void MixMinusCombiner::Combine(
+    rtc::ArrayView<const AudioFrame* const> mix_list,
+    size_t number_of_channels,
+    int sample_rate,
+    rtc::ArrayView<Output* const> outputs) {
+  RTC_DCHECK_EQ(mix_list.size(), outputs.size());
+  const size_t samples_per_channel = static_cast<size_t>(
+      (sample_rate * AudioMixerImpl::kFrameDurationInMs) / 1000);
+  RTC_DCHECK_LE(samples_per_channel, FrameCombiner::kMaximumChannelSize);
+  const size_t num_samples = samples_per_channel * number_of_channels;
+  RTC_DCHECK_LE(num_samples, sum_.size());
+
+  // 32-bit sums of up to 65535 frames cannot overflow.
+  std::fill(sum_.begin(), sum_.begin() + num_samples, 0);
+  for (const AudioFrame* frame : mix_list) {
+    RTC_DCHECK_EQ(number_of_channels, frame->num_channels_);
+    RTC_DCHECK_EQ(samples_per_channel, frame->samples_per_channel_);
+    const int16_t* const data = frame->data();
+    for (size_t i = 0; i < num_samples; ++i) {
+      sum_[i] += data[i];
+    }
+  }
+
+  for (size_t n = 0; n < mix_list.size(); ++n) {
+    Output* const output = outputs[n];
+    const int16_t* const own_frame = mix_list[n]->data();
+    output->frame_.UpdateFrame(0, nullptr, samples_per_channel, sample_rate,
+                               AudioFrame::kUndefined, AudioFrame::kVadUnknown,
+                               number_of_channels);
+    int16_t* const output_data = output->frame_.mutable_data();
+    int32_t min_value = 0;
+    int32_t max_value = 0;
+    for (size_t i = 0; i < num_samples; ++i) {
+      const int32_t value = sum_[i] - own_frame[i];
+      min_value = std::min(min_value, value);
+      max_value = std::max(max_value, value);
+      output_data[i] = static_cast<int16_t>(
+          std::min<int32_t>(std::max<int32_t>(value, -32768), 32767));
+    }
+
+    if (!use_limiter_) {
+      continue;
+    }
+    const bool clipped = min_value < std::numeric_limits<int16_t>::min() ||
+                         max_value > std::numeric_limits<int16_t>::max();
+    if (clipped) {
+      if (!output->limiter_state_) {
+        output->limiter_state_ = std::make_unique<Output::LimiterState>();
+      } else if (output->limiter_hold_frames_ == 0) {
+        // Forget the levels from the last time the limiter was on.
+        output->limiter_state_->limiter.Reset();
+      }
+      output->limiter_hold_frames_ = kLimiterHoldFrames;
+    } else if (output->limiter_hold_frames_ > 0) {
+      --output->limiter_hold_frames_;
+    }
+    if (output->limiter_hold_frames_ > 0) {
+      RunLimiter(own_frame, number_of_channels, samples_per_channel,
+                 sample_rate, output);
+    }
+  }
+}
+
+void MixMinusCombiner::RunLimiter(const int16_t* own_frame,
+                                  size_t number_of_channels,
+                                  size_t samples_per_channel,
+                                  int sample_rate,
+                                  Output* output) {
+  const size_t num_samples = samples_per_channel * number_of_channels;
+  const rtc::ArrayView<float> buffer(limiter_buffer_->data(), num_samples);
+  for (size_t i = 0; i < num_samples; ++i) {
+    buffer[i] = static_cast<float>(sum_[i] - own_frame[i]);
+  }
+  Limiter& limiter = output->limiter_state_->limiter;
+  limiter.SetSampleRate(sample_rate);
+  ScaleAndConvertFloatS16ToS16(
+      buffer,
+      limiter.ComputeScalingFactors(ComputeSubFramePeaks(buffer),
+                                    samples_per_channel),
+      number_of_channels,
+      rtc::ArrayView<int16_t>(output->frame_.mutable_data(), num_samples));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_MIXER_MIX_MINUS_COMBINER_H_
+#define MODULES_AUDIO_MIXER_MIX_MINUS_COMBINER_H_
+
+#include <stdint.h>
+
+#include <array>
+#include <memory>
+
+#include "api/array_view.h"
+#include "api/audio/audio_frame.h"
+#include "modules/audio_mixer/frame_combiner.h"
+
+namespace webrtc {
+
+// Produces mix-minus (N-1) outputs: for each of a number of frames, the sum of
+// all the other frames. The sum of all frames is computed once in a 32-bit
+// accumulator and each output is derived from it by subtracting its own frame,
+// so the cost is linear in the number of frames rather than quadratic.
+//
+// An output is only passed through a limiter when it would otherwise clip.
+// The limiter then stays on for a while, so that its gain is released
+// smoothly.
+class MixMinusCombiner {
+ public:
+  // The output for one source. Keeps the limiter state of the output, so the
+  // same Output should be passed for the same source on every call.
+  class Output {
+   public:
+    Output();
+    ~Output();
+    Output(const Output&) = delete;
+    Output& operator=(const Output&) = delete;
+
+    const AudioFrame& frame() const { return frame_; }
+    // True if the limiter was applied to the last frame.
+    bool limiter_active() const { return limiter_hold_frames_ > 0; }
+
+   private:
+    friend class MixMinusCombiner;
+    struct LimiterState;
+
+    AudioFrame frame_;
+    // Created the first time the output clips.
+    std::unique_ptr<LimiterState> limiter_state_;
+    int limiter_hold_frames_ = 0;
+  };
+
+  explicit MixMinusCombiner(bool use_limiter);
+  ~MixMinusCombiner();
+  MixMinusCombiner(const MixMinusCombiner&) = delete;
+  MixMinusCombiner& operator=(const MixMinusCombiner&) = delete;
+
+  // Sets the frame of |outputs[i]| to the sum of all frames in |mix_list|
+  // except |mix_list[i]|. All frames must have |number_of_channels| channels
+  // and hold 10 ms of audio at |sample_rate|.
+  void Combine(rtc::ArrayView<const AudioFrame* const> mix_list,
+               size_t number_of_channels,
+               int sample_rate,
+               rtc::ArrayView<Output* const> outputs);
+
+ private:
+  void RunLimiter(const int16_t* own_frame,
+                  size_t number_of_channels,
+                  size_t samples_per_channel,
+                  int sample_rate,
+                  Output* output);
+
+  const bool use_limiter_;
+  std::array<int32_t, AudioFrame::kMaxDataSizeSamples> sum_;
+  const std::unique_ptr<FrameCombiner::MixingBuffer> limiter_buffer_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_MIXER_MIX_MINUS_COMBINER_H_
@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/mix_minus_combiner.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSampleRateHz = 48000;
+constexpr size_t kSamplesPerChannel = kSampleRateHz / 100;
+
+class MixMinusCombinerTest : public ::testing::Test {
+ protected:
+  void SetUpFrames(size_t num_frames, size_t number_of_channels) {
+    frames_.clear();
+    outputs_.clear();
+    for (size_t i = 0; i < num_frames; ++i) {
+      frames_.push_back(std::make_unique<AudioFrame>());
+      frames_[i]->UpdateFrame(0, nullptr, kSamplesPerChannel, kSampleRateHz,
+                             AudioFrame::kNormalSpeech, AudioFrame::kVadActive,
+                             number_of_channels);
+      outputs_.push_back(std::make_unique<MixMinusCombiner::Output>());
+    }
+  }
+
+  void FillFrames(int16_t max_amplitude) {
+    for (const auto& frame : frames_) {
+      int16_t* data = frame->mutable_data();
+      for (size_t i = 0; i < frame->samples_per_channel_ * frame->num_channels_;
+           ++i) {
+        data[i] = random_.Rand(-max_amplitude, max_amplitude);
+      }
+    }
+  }
+
+  void Combine(MixMinusCombiner* combiner) {
+    std::vector<const AudioFrame*> mix_list;
+    std::vector<MixMinusCombiner::Output*> outputs;
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      mix_list.push_back(frames_[i].get());
+      outputs.push_back(outputs_[i].get());
+    }
+    combiner->Combine(mix_list, frames_[0]->num_channels_, kSampleRateHz,
+                      outputs);
+  }
+
+  // The sum of all frames but |excluded|, at sample |i|.
+  int32_t SumOfOthers(size_t excluded, size_t i) const {
+    int32_t sum = 0;
+    for (size_t n = 0; n < frames_.size(); ++n) {
+      if (n != excluded) {
+        sum += frames_[n]->data()[i];
+      }
+    }
+    return sum;
+  }
+
+  Random random_{42};
+  std::vector<std::unique_ptr<AudioFrame>> frames_;
+  std::vector<std::unique_ptr<MixMinusCombiner::Output>> outputs_;
+};
+
+TEST_F(MixMinusCombinerTest, OutputsAreSumsOfAllOtherFrames) {
+  MixMinusCombiner combiner(/*use_limiter=*/true);
+  for (size_t number_of_channels : {1, 2, 8}) {
+    SCOPED_TRACE(number_of_channels);
+    SetUpFrames(5, number_of_channels);
+    // Low enough that no output clips.
+    FillFrames(8000);
+    Combine(&combiner);
+    for (size_t n = 0; n < frames_.size(); ++n) {
+      const AudioFrame& output = outputs_[n]->frame();
+      EXPECT_FALSE(outputs_[n]->limiter_active());
+      EXPECT_EQ(number_of_channels, output.num_channels_);
+      EXPECT_EQ(kSamplesPerChannel, output.samples_per_channel_);
+      EXPECT_EQ(kSampleRateHz, output.sample_rate_hz_);
+      for (size_t i = 0; i < kSamplesPerChannel * number_of_channels; ++i) {
+        ASSERT_EQ(SumOfOthers(n, i), output.data()[i]);
+      }
+    }
+  }
+}
+
+TEST_F(MixMinusCombinerTest, SingleFrameGivesSilence) {
+  MixMinusCombiner combiner(/*use_limiter=*/true);
+  SetUpFrames(1, 2);
+  FillFrames(10000);
+  Combine(&combiner);
+  const AudioFrame& output = outputs_[0]->frame();
+  for (size_t i = 0; i < kSamplesPerChannel * 2; ++i) {
+    ASSERT_EQ(0, output.data()[i]);
+  }
+}
+
+TEST_F(MixMinusCombinerTest, SaturatesWithoutLimiter) {
+  MixMinusCombiner combiner(/*use_limiter=*/false);
+  SetUpFrames(3, 1);
+  for (const auto& frame : frames_) {
+    std::fill(frame->mutable_data(), frame->mutable_data() + kSamplesPerChannel,
+              30000);
+  }
+  Combine(&combiner);
+  for (const auto& output : outputs_) {
+    EXPECT_FALSE(output->limiter_active());
+    for (size_t i = 0; i < kSamplesPerChannel; ++i) {
+      ASSERT_EQ(32767, output->frame().data()[i]);
+    }
+  }
+}
+
+TEST_F(MixMinusCombinerTest, LimiterOnlyRunsForClippingOutputs) {
+  MixMinusCombiner combiner(/*use_limiter=*/true);
+  SetUpFrames(3, 1);
+  // Only the output without the quiet frame clips.
+  FillFrames(100);
+  for (size_t n : {1, 2}) {
+    std::fill(frames_[n]->mutable_data(),
+              frames_[n]->mutable_data() + kSamplesPerChannel, 17000);
+  }
+  Combine(&combiner);
+  EXPECT_TRUE(outputs_[0]->limiter_active());
+  EXPECT_FALSE(outputs_[1]->limiter_active());
+  EXPECT_FALSE(outputs_[2]->limiter_active());
+  // The limiter lowers the level instead of clipping.
+  EXPECT_LT(outputs_[0]->frame().data()[kSamplesPerChannel - 1], 32767);
+  for (size_t i = 0; i < kSamplesPerChannel; ++i) {
+    ASSERT_EQ(SumOfOthers(1, i), outputs_[1]->frame().data()[i]);
+    ASSERT_EQ(SumOfOthers(2, i), outputs_[2]->frame().data()[i]);
+  }
+
+  // The limiter stays on for a while after the output stops clipping, then
+  // the output is the exact sum again.
+  FillFrames(100);
+  Combine(&combiner);
+  EXPECT_TRUE(outputs_[0]->limiter_active());
+  bool limiter_turned_off = false;
+  for (int i = 0; i < 1000 && !limiter_turned_off; ++i) {
+    Combine(&combiner);
+    limiter_turned_off = !outputs_[0]->limiter_active();
+  }
+  EXPECT_TRUE(limiter_turned_off);
+  for (size_t i = 0; i < kSamplesPerChannel; ++i) {
+    ASSERT_EQ(SumOfOthers(0, i), outputs_[0]->frame().data()[i]);
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -0,0 +1,241 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/mixing_kernels.h"
+
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#include "common_audio/include/audio_util.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+
+void LoadS16(const int16_t* src, __m128* low, __m128* high) {
+  const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  // Sign extension by duplicating each value and shifting.
+  *low = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+  *high = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+}
+
+// Rounds like FloatS16ToS16().
+__m128i RoundToInt32(__m128 x) {
+  x = _mm_min_ps(x, _mm_set1_ps(32767.f));
+  x = _mm_max_ps(x, _mm_set1_ps(-32768.f));
+  const __m128 half =
+      _mm_or_ps(_mm_set1_ps(0.5f), _mm_and_ps(x, _mm_set1_ps(-0.f)));
+  return _mm_cvttps_epi32(_mm_add_ps(x, half));
+}
+
+void StoreS16(__m128 low, __m128 high, int16_t* dst) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                   _mm_packs_epi32(RoundToInt32(low), RoundToInt32(high)));
+}
+
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+
+void LoadS16(const int16_t* src, float32x4_t* low, float32x4_t* high) {
+  const int16x8_t x = vld1q_s16(src);
+  *low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(x)));
+  *high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(x)));
+}
+
+// Rounds like FloatS16ToS16().
+int32x4_t RoundToInt32(float32x4_t x) {
+  x = vminq_f32(x, vdupq_n_f32(32767.f));
+  x = vmaxq_f32(x, vdupq_n_f32(-32768.f));
+  const uint32x4_t sign =
+      vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x80000000u));
+  const float32x4_t half = vreinterpretq_f32_u32(
+      vorrq_u32(vreinterpretq_u32_f32(vdupq_n_f32(0.5f)), sign));
+  return vcvtq_s32_f32(vaddq_f32(x, half));
+}
+
+void StoreS16(float32x4_t low, float32x4_t high, int16_t* dst) {
+  vst1q_s16(dst, vcombine_s16(vqmovn_s32(RoundToInt32(low)),
+                              vqmovn_s32(RoundToInt32(high))));
+}
+
+#endif
+
+}  // namespace
+
+void ConvertS16ToFloatS16(rtc::ArrayView<const int16_t> src,
+                          rtc::ArrayView<float> dst) {
+  RTC_DCHECK_EQ(src.size(), dst.size());
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  for (; i + 8 <= src.size(); i += 8) {
+    __m128 low, high;
+    LoadS16(&src[i], &low, &high);
+    _mm_storeu_ps(&dst[i], low);
+    _mm_storeu_ps(&dst[i + 4], high);
+  }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  for (; i + 8 <= src.size(); i += 8) {
+    float32x4_t low, high;
+    LoadS16(&src[i], &low, &high);
+    vst1q_f32(&dst[i], low);
+    vst1q_f32(&dst[i + 4], high);
+  }
+#endif
+  for (; i < src.size(); ++i) {
+    dst[i] = src[i];
+  }
+}
+
+void AddS16ToFloatS16(rtc::ArrayView<const int16_t> src,
+                      rtc::ArrayView<float> dst) {
+  RTC_DCHECK_EQ(src.size(), dst.size());
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  for (; i + 8 <= src.size(); i += 8) {
+    __m128 low, high;
+    LoadS16(&src[i], &low, &high);
+    _mm_storeu_ps(&dst[i], _mm_add_ps(_mm_loadu_ps(&dst[i]), low));
+    _mm_storeu_ps(&dst[i + 4], _mm_add_ps(_mm_loadu_ps(&dst[i + 4]), high));
+  }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  for (; i + 8 <= src.size(); i += 8) {
+    float32x4_t low, high;
+    LoadS16(&src[i], &low, &high);
+    vst1q_f32(&dst[i], vaddq_f32(vld1q_f32(&dst[i]), low));
+    vst1q_f32(&dst[i + 4], vaddq_f32(vld1q_f32(&dst[i + 4]), high));
+  }
+#endif
+  for (; i < src.size(); ++i) {
+    dst[i] += src[i];
+  }
+}
+
+std::array<float, kSubFramesInFrame> ComputeSubFramePeaks(
+    rtc::ArrayView<const float> samples) {
+  const size_t sub_frame_size =
+      rtc::CheckedDivExact(samples.size(), kSubFramesInFrame);
+  std::array<float, kSubFramesInFrame> peaks;
+  for (size_t sub_frame = 0; sub_frame < kSubFramesInFrame; ++sub_frame) {
+    const float* const x = &samples[sub_frame * sub_frame_size];
+    float peak = 0.f;
+    size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (sub_frame_size >= 4) {
+      const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+      __m128 peak4 = _mm_setzero_ps();
+      for (; i + 4 <= sub_frame_size; i += 4) {
+        peak4 = _mm_max_ps(peak4, _mm_and_ps(_mm_loadu_ps(&x[i]), abs_mask));
+      }
+      peak4 = _mm_max_ps(peak4, _mm_movehl_ps(peak4, peak4));
+      peak4 = _mm_max_ss(peak4, _mm_shuffle_ps(peak4, peak4, 1));
+      peak = _mm_cvtss_f32(peak4);
+    }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+    if (sub_frame_size >= 4) {
+      float32x4_t peak4 = vdupq_n_f32(0.f);
+      for (; i + 4 <= sub_frame_size; i += 4) {
+        peak4 = vmaxq_f32(peak4, vabsq_f32(vld1q_f32(&x[i])));
+      }
+      peak = vmaxvq_f32(peak4);
+    }
+#endif
+    for (; i < sub_frame_size; ++i) {
+      peak = std::max(peak, std::abs(x[i]));
+    }
+    peaks[sub_frame] = peak;
+  }
+  return peaks;
+}
+
+void ConvertFloatS16ToS16(rtc::ArrayView<const float> src,
+                          rtc::ArrayView<int16_t> dst) {
+  RTC_DCHECK_EQ(src.size(), dst.size());
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  for (; i + 8 <= src.size(); i += 8) {
+    StoreS16(_mm_loadu_ps(&src[i]), _mm_loadu_ps(&src[i + 4]), &dst[i]);
+  }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  for (; i + 8 <= src.size(); i += 8) {
+    StoreS16(vld1q_f32(&src[i]), vld1q_f32(&src[i + 4]), &dst[i]);
+  }
+#endif
+  for (; i < src.size(); ++i) {
+    dst[i] = FloatS16ToS16(src[i]);
+  }
+}
+
+void ScaleAndConvertFloatS16ToS16(rtc::ArrayView<const float> src,
+                                  rtc::ArrayView<const float> scaling_factors,
+                                  size_t num_channels,
+                                  rtc::ArrayView<int16_t> dst) {
+  RTC_DCHECK_EQ(src.size(), dst.size());
+  RTC_DCHECK_EQ(src.size(), scaling_factors.size() * num_channels);
+  // Index of the first sample per channel not handled by the vector code.
+  size_t k = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (num_channels == 1) {
+    for (; k + 8 <= scaling_factors.size(); k += 8) {
+      StoreS16(
+          _mm_mul_ps(_mm_loadu_ps(&src[k]), _mm_loadu_ps(&scaling_factors[k])),
+          _mm_mul_ps(_mm_loadu_ps(&src[k + 4]),
+                     _mm_loadu_ps(&scaling_factors[k + 4])),
+          &dst[k]);
+    }
+  } else if (num_channels == 2) {
+    for (; k + 4 <= scaling_factors.size(); k += 4) {
+      const __m128 factors = _mm_loadu_ps(&scaling_factors[k]);
+      StoreS16(_mm_mul_ps(_mm_loadu_ps(&src[2 * k]),
+                          _mm_unpacklo_ps(factors, factors)),
+               _mm_mul_ps(_mm_loadu_ps(&src[2 * k + 4]),
+                          _mm_unpackhi_ps(factors, factors)),
+               &dst[2 * k]);
+    }
+  }
+#elif defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+  if (num_channels == 1) {
+    for (; k + 8 <= scaling_factors.size(); k += 8) {
+      StoreS16(vmulq_f32(vld1q_f32(&src[k]), vld1q_f32(&scaling_factors[k])),
+               vmulq_f32(vld1q_f32(&src[k + 4]),
+                         vld1q_f32(&scaling_factors[k + 4])),
+               &dst[k]);
+    }
+  } else if (num_channels == 2) {
+    for (; k + 4 <= scaling_factors.size(); k += 4) {
+      const float32x4_t factors = vld1q_f32(&scaling_factors[k]);
+      StoreS16(vmulq_f32(vld1q_f32(&src[2 * k]), vzip1q_f32(factors, factors)),
+               vmulq_f32(vld1q_f32(&src[2 * k + 4]),
+                         vzip2q_f32(factors, factors)),
+               &dst[2 * k]);
+    }
+  }
+#endif
+  // More channels are less common, and left to the compiler.
+  for (; k < scaling_factors.size(); ++k) {
+    const float factor = scaling_factors[k];
+    for (size_t ch = 0; ch < num_channels; ++ch) {
+      const size_t i = k * num_channels + ch;
+      dst[i] = FloatS16ToS16(src[i] * factor);
+    }
+  }
+}
+
+}  // namespace webrtc
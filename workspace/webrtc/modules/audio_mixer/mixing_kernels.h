@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_MIXER_MIXING_KERNELS_H_
+#define MODULES_AUDIO_MIXER_MIXING_KERNELS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/agc2/agc2_common.h"
+
+namespace webrtc {
+
+// Vectorized building blocks for mixing interleaved audio in FloatS16 format.
+// The results are identical to those of the obvious scalar loops.
+
+// Sets |dst| to the samples of |src|.
+void ConvertS16ToFloatS16(rtc::ArrayView<const int16_t> src,
+                          rtc::ArrayView<float> dst);
+
+// Adds the samples of |src| to |dst|.
+void AddS16ToFloatS16(rtc::ArrayView<const int16_t> src,
+                      rtc::ArrayView<float> dst);
+
+// Returns the largest absolute value in each of kSubFramesInFrame equally
+// long parts of |samples|, as needed by Limiter::ComputeScalingFactors().
+std::array<float, kSubFramesInFrame> ComputeSubFramePeaks(
+    rtc::ArrayView<const float> samples);
+
+// Sets |dst| to |src| rounded and saturated to int16, like FloatS16ToS16().
+void ConvertFloatS16ToS16(rtc::ArrayView<const float> src,
+                          rtc::ArrayView<int16_t> dst);
+
+// Like ConvertFloatS16ToS16(), but first scales the interleaved |src| with
+// |num_channels| channels by one factor per sample in each channel.
+void ScaleAndConvertFloatS16ToS16(rtc::ArrayView<const float> src,
+                                  rtc::ArrayView<const float> scaling_factors,
+                                  size_t num_channels,
+                                  rtc::ArrayView<int16_t> dst);
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_MIXER_MIXING_KERNELS_H_
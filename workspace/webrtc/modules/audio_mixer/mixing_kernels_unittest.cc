@@ -0,0 +1,119 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/mixing_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "common_audio/include/audio_util.h"
+#include "rtc_base/arraysize.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+// Odd sizes exercise the scalar tails after the vector loops.
+constexpr size_t kSizes[] = {1, 7, 8, 9, 80, 161, 480, 963};
+
+std::vector<int16_t> RandomS16(Random* random, size_t size) {
+  std::vector<int16_t> x(size);
+  for (auto& v : x) {
+    v = random->Rand(-32768, 32767);
+  }
+  return x;
+}
+
+std::vector<float> RandomFloatS16(Random* random, size_t size, float range) {
+  std::vector<float> x(size);
+  for (auto& v : x) {
+    v = (random->Rand<float>() * 2.f - 1.f) * range;
+  }
+  return x;
+}
+
+TEST(MixingKernels, ConvertAndAddS16ToFloatS16) {
+  Random random(42);
+  for (size_t size : kSizes) {
+    SCOPED_TRACE(size);
+    const std::vector<int16_t> a = RandomS16(&random, size);
+    const std::vector<int16_t> b = RandomS16(&random, size);
+    std::vector<float> mix(size);
+    ConvertS16ToFloatS16(a, mix);
+    AddS16ToFloatS16(b, mix);
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(static_cast<float>(a[i]) + b[i], mix[i]);
+    }
+  }
+}
+
+TEST(MixingKernels, ComputeSubFramePeaks) {
+  Random random(42);
+  for (size_t sub_frame_size : {1, 3, 4, 12, 48}) {
+    SCOPED_TRACE(sub_frame_size);
+    const std::vector<float> x =
+        RandomFloatS16(&random, sub_frame_size * kSubFramesInFrame, 100000.f);
+    const auto peaks = ComputeSubFramePeaks(x);
+    for (size_t n = 0; n < kSubFramesInFrame; ++n) {
+      float expected = 0.f;
+      for (size_t i = 0; i < sub_frame_size; ++i) {
+        expected = std::max(expected, std::abs(x[n * sub_frame_size + i]));
+      }
+      EXPECT_EQ(expected, peaks[n]);
+    }
+  }
+}
+
+TEST(MixingKernels, ConvertFloatS16ToS16RoundsAndSaturates) {
+  Random random(42);
+  for (size_t size : kSizes) {
+    SCOPED_TRACE(size);
+    std::vector<float> x = RandomFloatS16(&random, size, 40000.f);
+    // Ties and the saturation limits.
+    const float special[] = {0.5f, -0.5f, 1.5f, -2.5f, 32767.5f, -32768.5f};
+    for (size_t i = 0; i < std::min(size, arraysize(special)); ++i) {
+      x[i] = special[i];
+    }
+    std::vector<int16_t> y(size);
+    ConvertFloatS16ToS16(x, y);
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(FloatS16ToS16(x[i]), y[i]) << x[i];
+    }
+  }
+}
+
+TEST(MixingKernels, ScaleAndConvertFloatS16ToS16) {
+  Random random(42);
+  for (size_t num_channels : {1, 2, 3, 8}) {
+    for (size_t samples_per_channel : {1, 5, 8, 80, 161, 480}) {
+      SCOPED_TRACE(num_channels);
+      SCOPED_TRACE(samples_per_channel);
+      const size_t size = samples_per_channel * num_channels;
+      const std::vector<float> x = RandomFloatS16(&random, size, 60000.f);
+      std::vector<float> factors(samples_per_channel);
+      for (auto& factor : factors) {
+        factor = random.Rand<float>();
+      }
+      std::vector<int16_t> y(size);
+      ScaleAndConvertFloatS16ToS16(x, factors, num_channels, y);
+      for (size_t k = 0; k < samples_per_channel; ++k) {
+        for (size_t ch = 0; ch < num_channels; ++ch) {
+          const size_t i = k * num_channels + ch;
+          ASSERT_EQ(FloatS16ToS16(x[i] * factors[k]), y[i]);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -63,6 +63,22 @@ std::array<float, kSubFramesInFrame> FixedDigitalLevelEstimator::ComputeLevel(
     }
   }
 
+  // Dump data for debug.
+  RTC_DCHECK(apm_data_dumper_);
+  const auto channel = float_frame.channel(0);
+  for (size_t sub_frame = 0; sub_frame < kSubFramesInFrame; ++sub_frame) {
+    apm_data_dumper_->DumpRaw("agc2_level_estimator_samples",
+                              samples_in_sub_frame_,
+                              &channel[sub_frame * samples_in_sub_frame_]);
+  }
+
+  return ComputeLevelFromPeaks(envelope);
+}
+
+std::array<float, kSubFramesInFrame>
+FixedDigitalLevelEstimator::ComputeLevelFromPeaks(
+    std::array<float, kSubFramesInFrame> peak_levels) {
+  std::array<float, kSubFramesInFrame>& envelope = peak_levels;
   // Make sure envelope increases happen one step earlier so that the
   // corresponding *gain decrease* doesn't miss a sudden signal
   // increase due to interpolation.
@@ -85,11 +101,6 @@ std::array<float, kSubFramesInFrame> FixedDigitalLevelEstimator::ComputeLevel(
     filter_state_level_ = envelope[sub_frame];
 
     // Dump data for debug.
-    RTC_DCHECK(apm_data_dumper_);
-    const auto channel = float_frame.channel(0);
-    apm_data_dumper_->DumpRaw("agc2_level_estimator_samples",
-                              samples_in_sub_frame_,
-                              &channel[sub_frame * samples_in_sub_frame_]);
     apm_data_dumper_->DumpRaw("agc2_level_estimator_level",
                               envelope[sub_frame]);
   }
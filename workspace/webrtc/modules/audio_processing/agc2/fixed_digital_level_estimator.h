@@ -41,6 +41,12 @@ class FixedDigitalLevelEstimator {
   std::array<float, kSubFramesInFrame> ComputeLevel(
       const AudioFrameView<const float>& float_frame);
 
+  // Same as ComputeLevel(), for a frame whose largest absolute sample value
+  // in each sub-frame, over all channels, is given by |peak_levels|. Lets
+  // the caller find the peaks while producing the frame.
+  std::array<float, kSubFramesInFrame> ComputeLevelFromPeaks(
+      std::array<float, kSubFramesInFrame> peak_levels);
+
   // Rate may be changed at any time (but not concurrently) from the
   // value passed to the constructor. The class is not thread safe.
   void SetSampleRate(size_t sample_rate_hz);
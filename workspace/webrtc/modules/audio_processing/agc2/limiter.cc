@@ -105,7 +105,21 @@ Limiter::~Limiter() = default;
 
 void Limiter::Process(AudioFrameView<float> signal) {
   const auto level_estimate = level_estimator_.ComputeLevel(signal);
+  ScaleSamples(ComputePerSampleScalingFactors(level_estimate,
+                                              signal.samples_per_channel()),
+               signal);
+}
+
+rtc::ArrayView<const float> Limiter::ComputeScalingFactors(
+    const std::array<float, kSubFramesInFrame>& peak_levels,
+    size_t samples_per_channel) {
+  return ComputePerSampleScalingFactors(
+      level_estimator_.ComputeLevelFromPeaks(peak_levels), samples_per_channel);
+}
 
+rtc::ArrayView<const float> Limiter::ComputePerSampleScalingFactors(
+    const std::array<float, kSubFramesInFrame>& level_estimate,
+    size_t samples_per_channel) {
   RTC_DCHECK_EQ(level_estimate.size() + 1, scaling_factors_.size());
   scaling_factors_[0] = last_scaling_factor_;
   std::transform(level_estimate.begin(), level_estimate.end(),
@@ -113,14 +127,12 @@ void Limiter::Process(AudioFrameView<float> signal) {
                    return interp_gain_curve_.LookUpGainToApply(x);
                  });
 
-  const size_t samples_per_channel = signal.samples_per_channel();
   RTC_DCHECK_LE(samples_per_channel, kMaximalNumberOfSamplesPerChannel);
 
   auto per_sample_scaling_factors = rtc::ArrayView<float>(
       &per_sample_scaling_factors_[0], samples_per_channel);
   ComputePerSampleSubframeFactors(scaling_factors_, samples_per_channel,
                                   per_sample_scaling_factors);
-  ScaleSamples(per_sample_scaling_factors, signal);
 
   last_scaling_factor_ = scaling_factors_.back();
 
@@ -128,6 +140,7 @@ void Limiter::Process(AudioFrameView<float> signal) {
   apm_data_dumper_->DumpRaw("agc2_gain_curve_applier_scaling_factors",
                             samples_per_channel,
                             per_sample_scaling_factors_.data());
+  return per_sample_scaling_factors;
 }
 
 InterpolatedGainCurve::Stats Limiter::GetGainCurveStats() const {
@@ -11,9 +11,12 @@
 #ifndef MODULES_AUDIO_PROCESSING_AGC2_LIMITER_H_
 #define MODULES_AUDIO_PROCESSING_AGC2_LIMITER_H_
 
+#include <array>
 #include <string>
 #include <vector>
 
+#include "api/array_view.h"
+#include "modules/audio_processing/agc2/agc2_common.h"
 #include "modules/audio_processing/agc2/fixed_digital_level_estimator.h"
 #include "modules/audio_processing/agc2/interpolated_gain_curve.h"
 #include "modules/audio_processing/include/audio_frame_view.h"
@@ -33,6 +36,16 @@ class Limiter {
 
   // Applies limiter and hard-clipping to |signal|.
   void Process(AudioFrameView<float> signal);
+
+  // Updates the limiter like Process() does for a frame whose largest
+  // absolute sample value in each sub-frame is |peak_levels|, but leaves
+  // applying the gain to the caller. Returns the factor by which each of the
+  // |samples_per_channel| samples of every channel is to be scaled, before
+  // hard-clipping. Valid until the next call.
+  rtc::ArrayView<const float> ComputeScalingFactors(
+      const std::array<float, kSubFramesInFrame>& peak_levels,
+      size_t samples_per_channel);
+
   InterpolatedGainCurve::Stats GetGainCurveStats() const;
 
   // Supported rates must be
@@ -48,6 +61,10 @@ class Limiter {
   float LastAudioLevel() const;
 
  private:
+  rtc::ArrayView<const float> ComputePerSampleScalingFactors(
+      const std::array<float, kSubFramesInFrame>& level_estimate,
+      size_t samples_per_channel);
+
   const InterpolatedGainCurve interp_gain_curve_;
   FixedDigitalLevelEstimator level_estimator_;
   ApmDataDumper* const apm_data_dumper_ = nullptr;
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/scoped_refptr.h"
+#include "benchmark/benchmark.h"
+#include "modules/audio_processing/include/audio_processing.h"
+#include "rtc_base/system/unused.h"
+#include "system_wrappers/include/field_trial.h"
+
+namespace webrtc {
+namespace {
+
+// Field trials like those of a client in the field: mostly trials of other
+// modules, and a few of AEC3 and APM.
+constexpr char kFieldTrials[] =
+    "WebRTC-Aec3AecStateFullResetKillSwitch/Disabled/"
+    "WebRTC-Aec3EnforceLowActiveRenderLimit/Enabled/"
+    "WebRTC-Aec3SuppressorTuningOverride/Disabled/"
+    "WebRTC-Aec3UseShortConfigChangeDuration/Enabled/"
+    "WebRTC-Audio-ABWENoTWCC/Disabled/"
+    "WebRTC-Audio-Allocation/min:6kbps,max:32kbps/"
+    "WebRTC-Audio-OpusMinPacketLossRate/Enabled-5/"
+    "WebRTC-Audio-SendSideBwe/Enabled/"
+    "WebRTC-Audio-StableTargetAdaptation/Enabled/"
+    "WebRTC-Bwe-AllocationProbing/Enabled/"
+    "WebRTC-Bwe-AlrLimitedBackoff/Enabled/"
+    "WebRTC-Bwe-LossBasedControl/Enabled/"
+    "WebRTC-Bwe-SafeResetOnRouteChange/Enabled/"
+    "WebRTC-Bwe-TrendlineEstimatorSettings/sort:true,cap:true/"
+    "WebRTC-DataChannel-Dcsctp/Disabled/"
+    "WebRTC-FlexFEC-03/Enabled/"
+    "WebRTC-FlexFEC-03-Advertised/Enabled/"
+    "WebRTC-IncreasedReceivebuffers/Enabled/"
+    "WebRTC-KeyframeInterval/min_keyframe_send_interval_ms:300/"
+    "WebRTC-MutedStateKillSwitch/Disabled/"
+    "WebRTC-Pacer-PadInSilence/Enabled/"
+    "WebRTC-SendSideBwe-WithOverhead/Enabled/"
+    "WebRTC-StableTargetRate/enabled:true/"
+    "WebRTC-TaskQueuePacer/Enabled/"
+    "WebRTC-Video-BalancedDegradation/Enabled/"
+    "WebRTC-Video-DiscardPacketsWithUnknownSsrc/Enabled/"
+    "WebRTC-Video-QualityScaling/Enabled-29,95,149,205,24,37,26,36,0.9995,"
+    "0.9999,1/"
+    "WebRTC-VideoFrameTrackingIdAdvertised/Enabled/"
+    "WebRTC-Vp9DependencyDescriptor/Enabled/"
+    "WebRTC-ZeroHertzScreenshare/Enabled/";
+
+// The time it takes to create and configure an audio processing module with
+// all submodules enabled, with no field trials (0) or with kFieldTrials (1).
+// AEC3 and APM look up field trials while they are created and configured.
+void BM_CreateAudioProcessing(benchmark::State& state) {
+  const char* previous_field_trials = field_trial::GetFieldTrialString();
+  field_trial::InitFieldTrialsFromString(state.range(0) ? kFieldTrials : "");
+  AudioProcessing::Config config;
+  config.echo_canceller.enabled = true;
+  config.gain_controller1.enabled = true;
+  config.gain_controller2.enabled = true;
+  config.high_pass_filter.enabled = true;
+  config.noise_suppression.enabled = true;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    rtc::scoped_refptr<AudioProcessing> apm = AudioProcessingBuilder().Create();
+    apm->ApplyConfig(config);
+    benchmark::DoNotOptimize(apm.get());
+  }
+  field_trial::InitFieldTrialsFromString(previous_field_trials);
+}
+
+BENCHMARK(BM_CreateAudioProcessing)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace webrtc
+
+/*
+
+Results (Linux, a single x86-64 core):
+
+Parsing the field trials string for every lookup:
+---------------------------------------------------------------------
+Benchmark                           Time             CPU   Iterations
+---------------------------------------------------------------------
+BM_CreateAudioProcessing/0        176 us          173 us         3197
+BM_CreateAudioProcessing/1        405 us          399 us         1708
+
+Looking up the field trials in the index built by InitFieldTrialsFromString:
+---------------------------------------------------------------------
+Benchmark                           Time             CPU   Iterations
+---------------------------------------------------------------------
+BM_CreateAudioProcessing/0        171 us          169 us         4091
+BM_CreateAudioProcessing/1        192 us          188 us         4192
+
+*/
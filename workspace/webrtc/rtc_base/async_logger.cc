@@ -0,0 +1,247 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "rtc_base/async_logger.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/config.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/synchronization/spsc_record_buffer.h"
+#include "rtc_base/thread_annotations.h"
+#if !defined(ABSL_HAVE_THREAD_LOCAL) && defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
+
+namespace rtc {
+namespace {
+
+constexpr int kOutputIntervalMs = 50;
+// Per thread. Holds 32 messages of the maximum size, and about 500 typical
+// ones.
+constexpr size_t kBufferSize = 1 << 16;
+
+// The messages of a thread, written by it and read by the logger.
+class ThreadBuffer {
+ public:
+  ThreadBuffer() : records_(kBufferSize) {}
+
+  // Called on the buffer's thread.
+  void Write(const void* data, size_t size) {
+    uint8_t* record = records_.Reserve(size);
+    if (!record) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    memcpy(record, data, size);
+    records_.Commit();
+  }
+
+  // Called when the buffer's thread exits. No messages are written after.
+  void Retire() { retired_.store(true, std::memory_order_release); }
+
+  // The rest is called by the logger.
+  bool retired() const { return retired_.load(std::memory_order_acquire); }
+  webrtc::SpscRecordBuffer& records() { return records_; }
+  int64_t TakeDropped() {
+    return dropped_.exchange(0, std::memory_order_relaxed);
+  }
+
+ private:
+  webrtc::SpscRecordBuffer records_;
+  std::atomic<int64_t> dropped_{0};
+  std::atomic<bool> retired_{false};
+};
+
+// The buffers of the threads that logged since the current logger was
+// created. Unlike the logger, it's never destroyed, since a thread can still
+// be capturing a message when the logger goes away.
+class BufferRegistry {
+ public:
+  // Called by a new logger. Threads create new buffers for it.
+  void StartGeneration() {
+    webrtc::MutexLock lock(&mutex_);
+    RTC_CHECK(!logger_exists_) << "Only one AsyncLogger can exist at a time.";
+    logger_exists_ = true;
+    generation_.fetch_add(1, std::memory_order_release);
+  }
+  // Called by the logger once it has output the last messages.
+  void EndGeneration() {
+    webrtc::MutexLock lock(&mutex_);
+    logger_exists_ = false;
+    buffers_.clear();
+  }
+  int generation() const { return generation_.load(std::memory_order_acquire); }
+
+  void Add(std::shared_ptr<ThreadBuffer> buffer, int generation) {
+    webrtc::MutexLock lock(&mutex_);
+    if (generation == generation_.load(std::memory_order_relaxed))
+      buffers_.push_back(std::move(buffer));
+  }
+  void Remove(const std::shared_ptr<ThreadBuffer>& buffer) {
+    webrtc::MutexLock lock(&mutex_);
+    auto it = std::find(buffers_.begin(), buffers_.end(), buffer);
+    if (it != buffers_.end())
+      buffers_.erase(it);
+  }
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers() {
+    webrtc::MutexLock lock(&mutex_);
+    return buffers_;
+  }
+
+ private:
+  webrtc::Mutex mutex_;
+  std::atomic<int> generation_{0};
+  bool logger_exists_ RTC_GUARDED_BY(mutex_) = false;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_ RTC_GUARDED_BY(mutex_);
+};
+
+BufferRegistry& GetRegistry() {
+  static BufferRegistry* const registry = new BufferRegistry();
+  return *registry;
+}
+
+// The current thread's buffer, which it shares with the registry, so that
+// either can go away first.
+struct ThreadBufferRef {
+  ~ThreadBufferRef() {
+    if (buffer)
+      buffer->Retire();
+  }
+
+  std::shared_ptr<ThreadBuffer> buffer;
+  int generation = 0;
+};
+
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+
+ABSL_CONST_INIT thread_local ThreadBufferRef g_current_thread_buffer;
+
+ThreadBufferRef& CurrentThreadBufferRef() {
+  return g_current_thread_buffer;
+}
+
+#elif defined(WEBRTC_POSIX)
+
+// Allocated on the thread's first message, and deleted when it exits.
+ABSL_CONST_INIT pthread_key_t g_current_thread_buffer_tls = 0;
+
+void DeleteThreadBufferRef(void* ref) {
+  delete static_cast<ThreadBufferRef*>(ref);
+}
+
+void InitializeTls() {
+  RTC_CHECK_EQ(
+      pthread_key_create(&g_current_thread_buffer_tls, &DeleteThreadBufferRef),
+      0);
+}
+
+ThreadBufferRef& CurrentThreadBufferRef() {
+  static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+  RTC_CHECK_EQ(pthread_once(&init_once, &InitializeTls), 0);
+  ThreadBufferRef* ref = static_cast<ThreadBufferRef*>(
+      pthread_getspecific(g_current_thread_buffer_tls));
+  if (!ref) {
+    ref = new ThreadBufferRef();
+    pthread_setspecific(g_current_thread_buffer_tls, ref);
+  }
+  return *ref;
+}
+
+#else
+#error Unsupported platform
+#endif
+
+void CaptureMessage(const void* data, size_t size) {
+  BufferRegistry& registry = GetRegistry();
+  ThreadBufferRef& ref = CurrentThreadBufferRef();
+  const int generation = registry.generation();
+  if (ref.generation != generation) {
+    // The thread's first message, for this logger.
+    if (ref.buffer)
+      ref.buffer->Retire();
+    ref.buffer = std::make_shared<ThreadBuffer>();
+    ref.generation = generation;
+    registry.Add(ref.buffer, generation);
+  }
+  ref.buffer->Write(data, size);
+}
+
+}  // namespace
+
+AsyncLogger::AsyncLogger()
+    : thread_(&AsyncLogger::Run, this, "AsyncLogger", kLowPriority) {
+  GetRegistry().StartGeneration();
+  thread_.Start();
+  LogMessage::SetCaptureFunction(&CaptureMessage);
+}
+
+AsyncLogger::~AsyncLogger() {
+  LogMessage::SetCaptureFunction(nullptr);
+  stop_.Set();
+  thread_.Stop();
+  OutputMessages();
+  GetRegistry().EndGeneration();
+}
+
+void AsyncLogger::Flush() {
+  OutputMessages();
+}
+
+// static
+void AsyncLogger::Run(void* logger) {
+  AsyncLogger* self = static_cast<AsyncLogger*>(logger);
+  while (!self->stop_.Wait(kOutputIntervalMs))
+    self->OutputMessages();
+}
+
+void AsyncLogger::OutputMessages() {
+  // Each buffer is read by one thread at a time.
+  webrtc::MutexLock lock(&output_mutex_);
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers =
+      GetRegistry().buffers();
+  std::vector<bool> retired;
+  std::vector<const void*> messages;
+  int64_t dropped = 0;
+  for (auto& buffer : buffers) {
+    // Read before peeking, so that the buffer is empty if it is retired.
+    retired.push_back(buffer->retired());
+    dropped += buffer->TakeDropped();
+    buffer->records().Peek([&messages](const uint8_t* data, size_t /*size*/) {
+      messages.push_back(data);
+    });
+  }
+  // Merges the threads' messages, which are in order already.
+  std::stable_sort(messages.begin(), messages.end(),
+                   [](const void* a, const void* b) {
+                     return LogMessage::CapturedMessageTimeUs(a) <
+                            LogMessage::CapturedMessageTimeUs(b);
+                   });
+  if (!messages.empty())
+    LogMessage::OutputCapturedMessages(messages.data(), messages.size());
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    buffers[i]->records().Release();
+    if (retired[i])
+      GetRegistry().Remove(buffers[i]);
+  }
+  if (dropped > 0) {
+    dropped_messages_.fetch_add(dropped, std::memory_order_relaxed);
+    RTC_LOG(LS_WARNING) << "Dropped " << dropped
+                        << " log messages, logged while their thread's "
+                           "buffer was full.";
+  }
+}
+
+}  // namespace rtc
@@ -0,0 +1,63 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_ASYNC_LOGGER_H_
+#define RTC_BASE_ASYNC_LOGGER_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/synchronization/mutex.h"
+
+namespace rtc {
+
+// Moves formatting log messages, and passing them to the log sinks, off the
+// threads that log. While an AsyncLogger exists, the RTC_LOG macros only copy
+// the message's metadata and arguments to a ring buffer of the logging
+// thread's, without taking locks. A thread of the logger's formats the
+// messages of all threads in the order they were logged, and passes them to
+// the sinks in batches. Messages logged while their thread's buffer is full
+// are dropped, and the logger logs how many.
+//
+// Only one AsyncLogger can exist at a time. Messages logged with LogMessage
+// directly are still formatted and output on the logging thread.
+class AsyncLogger {
+ public:
+  AsyncLogger();
+  // Outputs the messages that are left.
+  ~AsyncLogger();
+
+  AsyncLogger(const AsyncLogger&) = delete;
+  AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+  // Outputs the messages logged so far before returning.
+  void Flush();
+
+  // The number of messages dropped so far.
+  int64_t dropped_messages() const {
+    return dropped_messages_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static void Run(void* logger);
+  void OutputMessages();
+
+  rtc::Event stop_;
+  rtc::PlatformThread thread_;
+  webrtc::Mutex output_mutex_;
+  std::atomic<int64_t> dropped_messages_{0};
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_ASYNC_LOGGER_H_
@@ -0,0 +1,176 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/async_logger.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "rtc_base/event.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+#if RTC_LOG_ENABLED()
+
+// Keeps the messages that contain "async test", which other messages don't.
+class TestSink : public LogSink {
+ public:
+  TestSink() { LogMessage::AddLogToStream(this, LS_INFO); }
+  ~TestSink() override { LogMessage::RemoveLogToStream(this); }
+
+  void OnLogMessage(const std::string& message) override {
+    if (message.find("async test") == std::string::npos)
+      return;
+    webrtc::MutexLock lock(&mutex_);
+    messages_.push_back(message);
+    threads_.push_back(CurrentThreadId());
+    if (in_batch_)
+      ++messages_in_batches_;
+    received_.Set();
+  }
+  void OnLogBatchBegin() override { in_batch_ = true; }
+  void OnLogBatchEnd() override { in_batch_ = false; }
+
+  std::vector<std::string> messages() {
+    webrtc::MutexLock lock(&mutex_);
+    return messages_;
+  }
+  std::vector<PlatformThreadId> threads() {
+    webrtc::MutexLock lock(&mutex_);
+    return threads_;
+  }
+  int messages_in_batches() {
+    webrtc::MutexLock lock(&mutex_);
+    return messages_in_batches_;
+  }
+  Event& received() { return received_; }
+
+ private:
+  webrtc::Mutex mutex_;
+  std::vector<std::string> messages_;
+  std::vector<PlatformThreadId> threads_;
+  int messages_in_batches_ = 0;
+  bool in_batch_ = false;
+  Event received_;
+};
+
+void LogAllTypes() {
+  const std::string str = "string";
+  const absl::string_view view = "view";
+  const char* const null_str = nullptr;
+  RTC_LOG(LS_INFO) << "async test " << -1 << " " << -2L << " " << -3LL << " "
+                   << 4u << " " << 5ul << " " << 6ull << " " << 0.5 << " "
+                   << 1.5L << " " << str << " " << view << " " << null_str
+                   << " " << reinterpret_cast<const void*>(0xbeef);
+}
+
+void LogFromOtherThread(void* /*context*/) {
+  RTC_LOG(LS_INFO) << "async test from other thread";
+}
+
+TEST(AsyncLoggerTest, FormatsMessagesLikeSynchronousLogging) {
+  TestSink sink;
+  LogAllTypes();
+  {
+    AsyncLogger logger;
+    LogAllTypes();
+    RTC_LOG_ERRNO_EX(LS_INFO, EINVAL) << "async test errno";
+  }
+  std::vector<std::string> messages = sink.messages();
+  ASSERT_EQ(messages.size(), 3u);
+  EXPECT_EQ(messages[0], messages[1]);
+  EXPECT_THAT(messages[1],
+              HasSubstr("async test -1 -2 -3 4 5 6 0.5 1.5 string view (null) "
+                        "beef\n"));
+  EXPECT_THAT(messages[2],
+              HasSubstr("async test errno : [0x00000016] Invalid argument"));
+}
+
+TEST(AsyncLoggerTest, OutputsMessagesOnItsThread) {
+  TestSink sink;
+  AsyncLogger logger;
+  RTC_LOG(LS_INFO) << "async test";
+  EXPECT_TRUE(sink.received().Wait(Event::kForever));
+  std::vector<PlatformThreadId> threads = sink.threads();
+  ASSERT_EQ(threads.size(), 1u);
+  EXPECT_NE(threads[0], CurrentThreadId());
+  EXPECT_EQ(sink.messages_in_batches(), 1);
+}
+
+TEST(AsyncLoggerTest, OutputsMessagesOfAllThreadsInOrder) {
+  TestSink sink;
+  AsyncLogger logger;
+  RTC_LOG(LS_INFO) << "async test first";
+  // The thread exits before its message is output.
+  PlatformThread thread(&LogFromOtherThread, nullptr, "Other");
+  thread.Start();
+  thread.Stop();
+  RTC_LOG(LS_INFO) << "async test last";
+  logger.Flush();
+  std::vector<std::string> messages = sink.messages();
+  ASSERT_EQ(messages.size(), 3u);
+  EXPECT_THAT(messages[0], HasSubstr("async test first"));
+  EXPECT_THAT(messages[1], HasSubstr("async test from other thread"));
+  EXPECT_THAT(messages[2], HasSubstr("async test last"));
+}
+
+TEST(AsyncLoggerTest, TruncatesLongMessages) {
+  TestSink sink;
+  AsyncLogger logger;
+  const std::string long_string(10000, 'x');
+  RTC_LOG(LS_INFO) << "async test " << long_string << " " << 1;
+  logger.Flush();
+  std::vector<std::string> messages = sink.messages();
+  ASSERT_EQ(messages.size(), 1u);
+  EXPECT_THAT(messages[0], HasSubstr("async test xxx"));
+  EXPECT_LT(messages[0].size(), long_string.size());
+  EXPECT_EQ(messages[0].back(), '\n');
+}
+
+// More messages than a thread's buffer holds are either output or counted as
+// dropped.
+TEST(AsyncLoggerTest, CountsDroppedMessages) {
+  constexpr int kNumMessages = 10000;
+  TestSink sink;
+  int64_t dropped;
+  {
+    AsyncLogger logger;
+    for (int i = 0; i < kNumMessages; ++i)
+      RTC_LOG(LS_INFO) << "async test " << i;
+    logger.Flush();
+    dropped = logger.dropped_messages();
+  }
+  EXPECT_GT(dropped, 0);
+  EXPECT_EQ(sink.messages().size() + dropped, kNumMessages);
+}
+
+TEST(AsyncLoggerTest, LogsSynchronouslyAgainWhenDestroyed) {
+  TestSink sink;
+  { AsyncLogger logger; }
+  RTC_LOG(LS_INFO) << "async test";
+  EXPECT_THAT(sink.messages(), ElementsAre(HasSubstr("async test")));
+  EXPECT_EQ(sink.threads()[0], CurrentThreadId());
+}
+
+#endif  // RTC_LOG_ENABLED()
+
+}  // namespace
+}  // namespace rtc
@@ -10,6 +10,8 @@
 
 #include "rtc_base/async_packet_socket.h"
 
+#include "rtc_base/checks.h"
+
 namespace rtc {
 
 PacketTimeUpdateParams::PacketTimeUpdateParams() = default;
@@ -28,6 +30,20 @@ AsyncPacketSocket::AsyncPacketSocket() = default;
 
 AsyncPacketSocket::~AsyncPacketSocket() = default;
 
+int AsyncPacketSocket::SendToBatch(ArrayView<const OutgoingDatagram> packets,
+                                   ArrayView<const PacketOptions> options) {
+  RTC_DCHECK_EQ(packets.size(), options.size());
+  int sent = 0;
+  for (const OutgoingDatagram& packet : packets) {
+    int result =
+        SendTo(packet.data, packet.size, packet.address, options[sent]);
+    if (result < 0)
+      return sent > 0 ? sent : result;
+    ++sent;
+  }
+  return sent;
+}
+
 void CopySocketInformationToPacketInfo(size_t packet_size_bytes,
                                        const AsyncPacketSocket& socket_from,
                                        bool is_connectionless,
@@ -13,6 +13,7 @@
 
 #include <vector>
 
+#include "api/array_view.h"
 #include "rtc_base/constructor_magic.h"
 #include "rtc_base/dscp.h"
 #include "rtc_base/network/sent_packet.h"
@@ -54,6 +55,14 @@ struct RTC_EXPORT PacketOptions {
   PacketInfo info_signaled_after_sent;
 };
 
+// A packet read by an AsyncPacketSocket, for SignalReadPacketBatch.
+struct ReceivedPacket {
+  const char* data = nullptr;
+  size_t size = 0;
+  SocketAddress remote_address;
+  int64_t packet_time_us = -1;
+};
+
 // Provides the ability to receive packets asynchronously. Sends are not
 // buffered since it is acceptable to drop packets under high load.
 class RTC_EXPORT AsyncPacketSocket : public sigslot::has_slots<> {
@@ -82,6 +91,11 @@ class RTC_EXPORT AsyncPacketSocket : public sigslot::has_slots<> {
                      size_t cb,
                      const SocketAddress& addr,
                      const PacketOptions& options) = 0;
+  // Sends the packets in order, and returns how many were sent, or a negative
+  // value if none were. |options| has the options of each packet. By default,
+  // sends them one by one with SendTo.
+  virtual int SendToBatch(ArrayView<const OutgoingDatagram> packets,
+                          ArrayView<const PacketOptions> options);
 
   // Close the socket.
   virtual int Close() = 0;
@@ -109,6 +123,11 @@ class RTC_EXPORT AsyncPacketSocket : public sigslot::has_slots<> {
                    const int64_t&>
       SignalReadPacket;
 
+  // Emitted instead of SignalReadPacket, while a slot is connected, with all
+  // the packets read at once by sockets that read in batches (UDP sockets).
+  sigslot::signal2<AsyncPacketSocket*, ArrayView<const ReceivedPacket>>
+      SignalReadPacketBatch;
+
   // Emitted each time a packet is sent.
   sigslot::signal2<AsyncPacketSocket*, const SentPacket&> SignalSentPacket;
 
@@ -12,7 +12,9 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <string>
+#include <utility>
 
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -23,6 +25,14 @@
 namespace rtc {
 
 static const int BUF_SIZE = 64 * 1024;
+// The number of packets to read with one RecvFromBatch, and the size of the
+// buffer for each but the first, which is as large as the one RecvFrom reads
+// into, since sockets that can't read batches only read into it. Packets
+// that are too large for their buffer are dropped, and the buffers grow to
+// BUF_SIZE. With UDP GRO, a buffer receives several packets that the kernel
+// has coalesced into up to 64 KiB.
+static const size_t kBatchSize = 16;
+static const size_t kBatchPacketSize = 4 * 1024;
 
 AsyncUDPSocket* AsyncUDPSocket::Create(AsyncSocket* socket,
                                        const SocketAddress& bind_address) {
@@ -87,6 +97,22 @@ int AsyncUDPSocket::SendTo(const void* pv,
   return ret;
 }
 
+int AsyncUDPSocket::SendToBatch(ArrayView<const OutgoingDatagram> packets,
+                                ArrayView<const rtc::PacketOptions> options) {
+  RTC_DCHECK_EQ(packets.size(), options.size());
+  const int64_t send_time_ms = rtc::TimeMillis();
+  int ret = socket_->SendToBatch(packets);
+  // Only the packets that were sent, which are the first ones.
+  for (int i = 0; i < ret; ++i) {
+    rtc::SentPacket sent_packet(options[i].packet_id, send_time_ms,
+                                options[i].info_signaled_after_sent);
+    CopySocketInformationToPacketInfo(packets[i].size, *this, true,
+                                      &sent_packet.info);
+    SignalSentPacket(this, sent_packet);
+  }
+  return ret;
+}
+
 int AsyncUDPSocket::Close() {
   return socket_->Close();
 }
@@ -100,7 +126,12 @@ int AsyncUDPSocket::GetOption(Socket::Option opt, int* value) {
 }
 
 int AsyncUDPSocket::SetOption(Socket::Option opt, int value) {
-  return socket_->SetOption(opt, value);
+  int ret = socket_->SetOption(opt, value);
+  if (opt == Socket::OPT_UDP_GRO && ret == 0) {
+    // The next ReadBatch reallocates the buffer with the size for GRO.
+    udp_gro_ = value != 0;
+  }
+  return ret;
 }
 
 int AsyncUDPSocket::GetError() const {
@@ -114,6 +145,11 @@ void AsyncUDPSocket::SetError(int error) {
 void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
   RTC_DCHECK(socket_.get() == socket);
 
+  if (udp_gro_ || !SignalReadPacketBatch.is_empty()) {
+    ReadBatch();
+    return;
+  }
+
   SocketAddress remote_addr;
   int64_t timestamp;
   int len = socket_->RecvFrom(buf_, size_, &remote_addr, &timestamp);
@@ -134,6 +170,90 @@ void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
                    (timestamp > -1 ? timestamp : TimeMicros()));
 }
 
+void AsyncUDPSocket::ReadBatch() {
+  const size_t packet_size =
+      udp_gro_ || large_packets_ ? BUF_SIZE : kBatchPacketSize;
+  if (!batch_buffer_ || batch_packet_size_ != packet_size) {
+    batch_buffer_.reset(new char[BUF_SIZE + (kBatchSize - 1) * packet_size]);
+    batch_packet_size_ = packet_size;
+    batch_.resize(kBatchSize);
+    batch_[0].data = &batch_buffer_[0];
+    batch_[0].capacity = BUF_SIZE;
+    for (size_t i = 1; i < kBatchSize; ++i) {
+      batch_[i].data = &batch_buffer_[BUF_SIZE + (i - 1) * packet_size];
+      batch_[i].capacity = packet_size;
+    }
+  }
+
+  int received = socket_->RecvFromBatch(batch_);
+  if (received < 0) {
+    // See OnReadEvent.
+    SocketAddress local_addr = socket_->GetLocalAddress();
+    RTC_LOG(LS_INFO) << "AsyncUDPSocket[" << local_addr.ToSensitiveString()
+                     << "] receive failed with error " << socket_->GetError();
+    return;
+  }
+
+  int64_t now_us = -1;
+  batch_packets_.clear();
+  for (int i = 0; i < received; ++i) {
+    const IncomingDatagram& datagram = batch_[i];
+    if (datagram.truncated) {
+      RTC_LOG(LS_WARNING) << "AsyncUDPSocket["
+                          << socket_->GetLocalAddress().ToSensitiveString()
+                          << "] dropped a packet larger than "
+                          << datagram.capacity << " bytes";
+      // The next ReadBatch reallocates the buffer with larger packet buffers.
+      large_packets_ = true;
+      continue;
+    }
+    int64_t packet_time_us = datagram.timestamp;
+    if (packet_time_us < 0) {
+      if (now_us < 0)
+        now_us = TimeMicros();
+      packet_time_us = now_us;
+    }
+    // Split the packets that the kernel has coalesced.
+    const char* data = static_cast<const char*>(datagram.data);
+    const size_t segment_size =
+        datagram.segment_size > 0 ? datagram.segment_size : datagram.size;
+    size_t offset = 0;
+    do {
+      ReceivedPacket packet;
+      packet.data = data + offset;
+      packet.size = std::min(segment_size, datagram.size - offset);
+      packet.remote_address = datagram.address;
+      packet.packet_time_us = packet_time_us;
+      batch_packets_.push_back(packet);
+      offset += packet.size;
+    } while (offset < datagram.size);
+  }
+
+  // A slot may destroy the socket, so the packets and the buffer they point
+  // into are moved out of it while they are signalled.
+  std::unique_ptr<char[]> buffer = std::move(batch_buffer_);
+  std::vector<ReceivedPacket> packets = std::move(batch_packets_);
+  rtc::scoped_refptr<webrtc::PendingTaskSafetyFlag> safety = safety_.flag();
+  if (!SignalReadPacketBatch.is_empty()) {
+    SignalReadPacketBatch(this, packets);
+  } else {
+    for (const ReceivedPacket& packet : packets) {
+      SignalReadPacket(this, packet.data, packet.size, packet.remote_address,
+                       packet.packet_time_us);
+      if (!safety->alive())
+        return;
+    }
+  }
+  if (!safety->alive())
+    return;
+  // Kept for the next ReadBatch, unless a slot has read a batch in the
+  // meantime.
+  if (!batch_buffer_) {
+    batch_buffer_ = std::move(buffer);
+    batch_packets_ = std::move(packets);
+  }
+}
+
 void AsyncUDPSocket::OnWriteEvent(AsyncSocket* socket) {
   SignalReadyToSend(this);
 }
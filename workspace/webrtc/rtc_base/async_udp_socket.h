@@ -14,12 +14,14 @@
 #include <stddef.h>
 
 #include <memory>
+#include <vector>
 
 #include "rtc_base/async_packet_socket.h"
 #include "rtc_base/async_socket.h"
 #include "rtc_base/socket.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/socket_factory.h"
+#include "rtc_base/task_utils/pending_task_safety_flag.h"
 
 namespace rtc {
 
@@ -48,6 +50,8 @@ class AsyncUDPSocket : public AsyncPacketSocket {
              size_t cb,
              const SocketAddress& addr,
              const rtc::PacketOptions& options) override;
+  int SendToBatch(ArrayView<const OutgoingDatagram> packets,
+                  ArrayView<const rtc::PacketOptions> options) override;
   int Close() override;
 
   State GetState() const override;
@@ -61,10 +65,25 @@ class AsyncUDPSocket : public AsyncPacketSocket {
   void OnReadEvent(AsyncSocket* socket);
   // Called when the underlying socket is ready to send.
   void OnWriteEvent(AsyncSocket* socket);
+  // Reads the available packets with one RecvFromBatch, for
+  // SignalReadPacketBatch or since the socket uses UDP GRO.
+  void ReadBatch();
 
   std::unique_ptr<AsyncSocket> socket_;
   char* buf_;
   size_t size_;
+  // Whether OPT_UDP_GRO is set.
+  bool udp_gro_ = false;
+  // Whether a datagram has been too large for its buffer in a batch.
+  bool large_packets_ = false;
+  // Allocated by ReadBatch, again when the buffer size for the packets after
+  // the first, |batch_packet_size_|, has to change.
+  std::unique_ptr<char[]> batch_buffer_;
+  size_t batch_packet_size_ = 0;
+  std::vector<IncomingDatagram> batch_;
+  std::vector<ReceivedPacket> batch_packets_;
+  // Lets ReadBatch stop signalling packets when a slot destroys the socket.
+  webrtc::ScopedTaskSafetyDetached safety_;
 };
 
 }  // namespace rtc
@@ -12,9 +12,11 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rtc_base/gunit.h"
 #include "rtc_base/physical_socket_server.h"
+#include "rtc_base/thread.h"
 #include "rtc_base/virtual_socket_server.h"
 
 namespace rtc {
@@ -22,9 +24,8 @@ namespace rtc {
 class AsyncUdpSocketTest : public ::testing::Test, public sigslot::has_slots<> {
  public:
   AsyncUdpSocketTest()
-      : pss_(new rtc::PhysicalSocketServer),
-        vss_(new rtc::VirtualSocketServer(pss_.get())),
-        socket_(vss_->CreateAsyncSocket(SOCK_DGRAM)),
+      : vss_(new rtc::VirtualSocketServer()),
+        socket_(vss_->CreateAsyncSocket(AF_INET, SOCK_DGRAM)),
         udp_socket_(new AsyncUDPSocket(socket_)),
         ready_to_send_(false) {
     udp_socket_->SignalReadyToSend.connect(this,
@@ -34,7 +35,6 @@ class AsyncUdpSocketTest : public ::testing::Test, public sigslot::has_slots<> {
   void OnReadyToSend(rtc::AsyncPacketSocket* socket) { ready_to_send_ = true; }
 
  protected:
-  std::unique_ptr<PhysicalSocketServer> pss_;
   std::unique_ptr<VirtualSocketServer> vss_;
   AsyncSocket* socket_;
   std::unique_ptr<AsyncUDPSocket> udp_socket_;
@@ -47,4 +47,143 @@ TEST_F(AsyncUdpSocketTest, OnWriteEvent) {
   EXPECT_TRUE(ready_to_send_);
 }
 
+class BatchReceiver : public sigslot::has_slots<> {
+ public:
+  void OnReadPacketBatch(AsyncPacketSocket* socket,
+                         ArrayView<const ReceivedPacket> packets) {
+    ++num_batches;
+    for (const ReceivedPacket& packet : packets) {
+      payloads.emplace_back(packet.data, packet.size);
+      EXPECT_GT(packet.packet_time_us, 0);
+    }
+  }
+
+  int num_batches = 0;
+  std::vector<std::string> payloads;
+};
+
+TEST(AsyncUdpSocketBatchTest, SendsAndReadsPacketsInBatches) {
+  PhysicalSocketServer ss;
+  AutoSocketServerThread thread(&ss);
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(&ss, SocketAddress("127.0.0.1", 0)));
+  std::unique_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(&ss, SocketAddress("127.0.0.1", 0)));
+  ASSERT_TRUE(sender);
+  ASSERT_TRUE(receiver);
+  BatchReceiver batch_receiver;
+  receiver->SignalReadPacketBatch.connect(&batch_receiver,
+                                          &BatchReceiver::OnReadPacketBatch);
+
+  std::vector<std::string> payloads = {"first", "second", "third"};
+  std::vector<OutgoingDatagram> packets(payloads.size());
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    packets[i].data = payloads[i].data();
+    packets[i].size = payloads[i].size();
+    packets[i].address = receiver->GetLocalAddress();
+  }
+  std::vector<PacketOptions> options(packets.size());
+  EXPECT_EQ(3, sender->SendToBatch(packets, options));
+  EXPECT_TRUE_WAIT(batch_receiver.payloads.size() == payloads.size(), 1000);
+  EXPECT_EQ(payloads, batch_receiver.payloads);
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  EXPECT_EQ(1, batch_receiver.num_batches);
+#endif
+}
+
+class SentPacketCounter : public sigslot::has_slots<> {
+ public:
+  void OnSentPacket(AsyncPacketSocket* socket, const SentPacket& packet) {
+    ids.push_back(packet.packet_id);
+    sizes.push_back(packet.info.packet_size_bytes);
+  }
+
+  std::vector<int> ids;
+  std::vector<size_t> sizes;
+};
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+// A packet that is larger than its buffer in a batch is dropped rather than
+// cut short, and the buffers then grow so that the next one is read.
+TEST(AsyncUdpSocketBatchTest, DropsTruncatedPacketsAndGrowsBuffers) {
+  PhysicalSocketServer ss;
+  AutoSocketServerThread thread(&ss);
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(&ss, SocketAddress("127.0.0.1", 0)));
+  std::unique_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(&ss, SocketAddress("127.0.0.1", 0)));
+  ASSERT_TRUE(sender);
+  ASSERT_TRUE(receiver);
+  BatchReceiver batch_receiver;
+  receiver->SignalReadPacketBatch.connect(&batch_receiver,
+                                          &BatchReceiver::OnReadPacketBatch);
+  SentPacketCounter sent_packets;
+  sender->SignalSentPacket.connect(&sent_packets,
+                                   &SentPacketCounter::OnSentPacket);
+
+  // The first packet of a batch is read into a 64 KiB buffer, so the large
+  // packet comes second.
+  const std::string large(6000, 'l');
+  std::vector<std::string> payloads = {"first", large, "last"};
+  std::vector<OutgoingDatagram> packets(payloads.size());
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    packets[i].data = payloads[i].data();
+    packets[i].size = payloads[i].size();
+    packets[i].address = receiver->GetLocalAddress();
+  }
+  std::vector<PacketOptions> options(packets.size());
+  EXPECT_EQ(3, sender->SendToBatch(packets, options));
+  EXPECT_EQ(sent_packets.sizes, std::vector<size_t>({5, 6000, 4}));
+  EXPECT_TRUE_WAIT(batch_receiver.payloads.size() == 2, 1000);
+  EXPECT_EQ(batch_receiver.payloads,
+            std::vector<std::string>({"first", "last"}));
+
+  batch_receiver.payloads.clear();
+  EXPECT_EQ(3, sender->SendToBatch(packets, options));
+  EXPECT_TRUE_WAIT(batch_receiver.payloads.size() == 3, 1000);
+  EXPECT_EQ(batch_receiver.payloads, payloads);
+}
+#endif
+
+// Fails to send packets of 3 bytes.
+class FailingSocket : public AsyncSocketAdapter {
+ public:
+  explicit FailingSocket(AsyncSocket* socket) : AsyncSocketAdapter(socket) {}
+
+  int SendTo(const void* pv, size_t cb, const SocketAddress& addr) override {
+    if (cb == 3) {
+      SetError(EWOULDBLOCK);
+      return -1;
+    }
+    return AsyncSocketAdapter::SendTo(pv, cb, addr);
+  }
+};
+
+// Only the packets that were sent are signalled as sent, each with its own
+// options.
+TEST(AsyncUdpSocketBatchTest, SignalsOnlySentPackets) {
+  VirtualSocketServer ss;
+  AsyncSocket* socket =
+      new FailingSocket(ss.CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, socket->Bind(SocketAddress("127.0.0.1", 0)));
+  std::unique_ptr<AsyncUDPSocket> sender(new AsyncUDPSocket(socket));
+  SentPacketCounter sent_packets;
+  sender->SignalSentPacket.connect(&sent_packets,
+                                   &SentPacketCounter::OnSentPacket);
+
+  std::vector<OutgoingDatagram> packets(3);
+  for (OutgoingDatagram& packet : packets) {
+    packet.data = "packet";
+    packet.size = 6;
+    packet.address = SocketAddress("127.0.0.1", 1234);
+  }
+  packets[2].size = 3;
+  std::vector<PacketOptions> options(packets.size());
+  for (size_t i = 0; i < options.size(); ++i)
+    options[i].packet_id = 10 + i;
+  EXPECT_EQ(2, sender->SendToBatch(packets, options));
+  EXPECT_EQ(sent_packets.ids, std::vector<int>({10, 11}));
+  EXPECT_EQ(sent_packets.sizes, std::vector<size_t>({6, 6}));
+}
+
 }  // namespace rtc
@@ -0,0 +1,678 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "rtc_base/binary_event_tracer.h"
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/config.h"
+#include "api/sequence_checker.h"
+#include "rtc_base/atomic_ops.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+#include "rtc_base/event_tracer.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/synchronization/spsc_record_buffer.h"
+#include "rtc_base/thread_annotations.h"
+#include "rtc_base/time_utils.h"
+#include "rtc_base/trace_event.h"
+#if !defined(ABSL_HAVE_THREAD_LOCAL) && defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
+
+namespace rtc {
+namespace tracing {
+namespace {
+
+// Starts every capture file.
+constexpr char kMagic[8] = {'W', 'R', 'T', 'C', 'T', 'R', 'C', '1'};
+
+constexpr int kFlushIntervalMs = 50;
+// Per thread. Holds 1820 events without copied strings, which is 36000
+// events per second per thread before any are dropped.
+constexpr size_t kBufferSize = 1 << 17;
+// As many as the TRACE_EVENT macros take.
+constexpr int kMaxArgs = 2;
+constexpr size_t kMaxCopiedStringLength = 256;
+constexpr size_t kMaxStringLength = 1024;
+
+enum RecordKind : uint8_t {
+  kEvent = 1,
+  // Defines a string that events refer to by its id, its address.
+  kString = 2,
+  // The events that follow are from thread |value|.
+  kThread = 3,
+  // The thread dropped |value| events since its previous records.
+  kDropped = 4,
+};
+
+// The start of every record. |size| includes the header and is a multiple of
+// 8. A kString header is followed by the id, and the |value| bytes of the
+// string, padded.
+struct RecordHeader {
+  uint16_t size;
+  uint8_t kind;
+  uint8_t reserved;
+  uint32_t value;
+};
+
+// Followed by the string arguments that were copied, padded. Their
+// |arg_values| are their lengths. String arguments that aren't copied live as
+// long as names, and are written as strings too.
+struct EventRecord {
+  uint16_t size;
+  uint8_t kind;
+  char phase;
+  uint8_t num_args;
+  uint8_t arg_types[kMaxArgs];
+  uint8_t reserved;
+  uint64_t timestamp_us;
+  uint64_t name;
+  uint64_t category;
+  uint64_t arg_names[kMaxArgs];
+  uint64_t arg_values[kMaxArgs];
+};
+static_assert(sizeof(EventRecord) == 64, "EventRecord isn't packed.");
+
+constexpr size_t kMaxRecordSize =
+    sizeof(EventRecord) + kMaxArgs * kMaxCopiedStringLength;
+static_assert(kMaxRecordSize <= UINT16_MAX &&
+                  sizeof(RecordHeader) + 8 + kMaxStringLength + 8 <=
+                      UINT16_MAX,
+              "Records don't fit in RecordHeader::size.");
+
+size_t PaddedSize(size_t size) {
+  return (size + 7) & ~size_t{7};
+}
+
+const char* AsString(uint64_t value) {
+  return reinterpret_cast<const char*>(static_cast<uintptr_t>(value));
+}
+
+// The records of a thread, written by it and read by the flusher.
+class ThreadBuffer {
+ public:
+  explicit ThreadBuffer(PlatformThreadId thread_id)
+      : thread_id_(thread_id), records_(kBufferSize) {}
+
+  // Called on the buffer's thread. Returns space for a record of |size|
+  // bytes, or null if the buffer is full, in which case the record is
+  // counted as dropped.
+  uint8_t* Reserve(size_t size) {
+    uint8_t* data = records_.Reserve(size);
+    if (!data)
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+    return data;
+  }
+
+  // Called on the buffer's thread to make the record from the last
+  // Reserve() readable.
+  void Commit() { records_.Commit(); }
+
+  // Called when the buffer's thread exits. No records are written after.
+  void Retire() { retired_.store(true, std::memory_order_release); }
+
+  // The rest is called by the flusher.
+  bool retired() const { return retired_.load(std::memory_order_acquire); }
+  PlatformThreadId thread_id() const { return thread_id_; }
+  webrtc::SpscRecordBuffer& records() { return records_; }
+  uint64_t TakeDropped() {
+    return dropped_.exchange(0, std::memory_order_relaxed);
+  }
+  void Discard() {
+    records_.Clear();
+    TakeDropped();
+  }
+
+ private:
+  const PlatformThreadId thread_id_;
+  webrtc::SpscRecordBuffer records_;
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<bool> retired_{false};
+};
+
+// The current thread's buffer, which it shares with the tracer that it was
+// created by, so that either can go away first.
+struct ThreadBufferRef {
+  ~ThreadBufferRef() {
+    if (buffer)
+      buffer->Retire();
+  }
+
+  std::shared_ptr<ThreadBuffer> buffer;
+  int tracer_id = 0;
+};
+
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+
+ABSL_CONST_INIT thread_local ThreadBufferRef g_current_thread_buffer;
+
+ThreadBufferRef& CurrentThreadBufferRef() {
+  return g_current_thread_buffer;
+}
+
+#elif defined(WEBRTC_POSIX)
+
+// Allocated on the thread's first event, and deleted when it exits.
+ABSL_CONST_INIT pthread_key_t g_current_thread_buffer_tls = 0;
+
+void DeleteThreadBufferRef(void* ref) {
+  delete static_cast<ThreadBufferRef*>(ref);
+}
+
+void InitializeTls() {
+  RTC_CHECK_EQ(
+      pthread_key_create(&g_current_thread_buffer_tls, &DeleteThreadBufferRef),
+      0);
+}
+
+ThreadBufferRef& CurrentThreadBufferRef() {
+  static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+  RTC_CHECK_EQ(pthread_once(&init_once, &InitializeTls), 0);
+  ThreadBufferRef* ref = static_cast<ThreadBufferRef*>(
+      pthread_getspecific(g_current_thread_buffer_tls));
+  if (!ref) {
+    ref = new ThreadBufferRef();
+    pthread_setspecific(g_current_thread_buffer_tls, ref);
+  }
+  return *ref;
+}
+
+#else
+#error Unsupported platform
+#endif
+
+static void FlusherThreadFunc(void* params);
+
+// Atomic-int fast path for avoiding tracing when disabled.
+static volatile int g_binary_tracing_active = 0;
+
+class BinaryTracer final {
+ public:
+  BinaryTracer()
+      : id_(NextId()),
+        flusher_thread_(FlusherThreadFunc,
+                        this,
+                        "BinaryTraceFlusher",
+                        kLowPriority) {}
+  ~BinaryTracer() { RTC_DCHECK(thread_checker_.IsCurrent()); }
+
+  void AddTraceEvent(const char* name,
+                     const unsigned char* category_enabled,
+                     char phase,
+                     int num_args,
+                     const char** arg_names,
+                     const unsigned char* arg_types,
+                     const unsigned long long* arg_values) {
+    num_args = std::min(num_args, kMaxArgs);
+    size_t copied_lengths[kMaxArgs] = {};
+    size_t size = sizeof(EventRecord);
+    for (int i = 0; i < num_args; ++i) {
+      if (arg_types[i] == TRACE_VALUE_TYPE_COPY_STRING) {
+        copied_lengths[i] =
+            strnlen(AsString(arg_values[i]), kMaxCopiedStringLength);
+        size += PaddedSize(copied_lengths[i]);
+      }
+    }
+    ThreadBuffer* buffer = CurrentThreadBuffer();
+    uint8_t* data = buffer->Reserve(size);
+    if (!data)
+      return;
+
+    EventRecord* record = reinterpret_cast<EventRecord*>(data);
+    record->size = static_cast<uint16_t>(size);
+    record->kind = kEvent;
+    record->phase = phase;
+    record->num_args = static_cast<uint8_t>(num_args);
+    record->reserved = 0;
+    record->timestamp_us = rtc::TimeMicros();
+    record->name = reinterpret_cast<uintptr_t>(name);
+    record->category = reinterpret_cast<uintptr_t>(category_enabled);
+    char* copied = reinterpret_cast<char*>(record + 1);
+    for (int i = 0; i < kMaxArgs; ++i) {
+      if (i >= num_args) {
+        record->arg_types[i] = 0;
+        record->arg_names[i] = 0;
+        record->arg_values[i] = 0;
+        continue;
+      }
+      record->arg_types[i] = arg_types[i];
+      record->arg_names[i] = reinterpret_cast<uintptr_t>(arg_names[i]);
+      record->arg_values[i] = arg_values[i];
+      if (arg_types[i] == TRACE_VALUE_TYPE_COPY_STRING) {
+        // The string is temporary, so it's copied into the record.
+        record->arg_values[i] = copied_lengths[i];
+        memcpy(copied, AsString(arg_values[i]), copied_lengths[i]);
+        copied += PaddedSize(copied_lengths[i]);
+      }
+    }
+    buffer->Commit();
+  }
+
+  void Log() {
+    RTC_DCHECK(output_file_);
+    while (true) {
+      bool shutting_down = shutdown_event_.Wait(kFlushIntervalMs);
+      Flush();
+      if (shutting_down)
+        break;
+    }
+    if (output_file_owned_)
+      fclose(output_file_);
+    else
+      fflush(output_file_);
+    output_file_ = nullptr;
+  }
+
+  void Start(FILE* file, bool owned) {
+    RTC_DCHECK(thread_checker_.IsCurrent());
+    RTC_DCHECK(file);
+    RTC_DCHECK(!output_file_);
+    output_file_ = file;
+    output_file_owned_ = owned;
+    written_strings_.clear();
+    fwrite(kMagic, sizeof(kMagic), 1, output_file_);
+    {
+      webrtc::MutexLock lock(&mutex_);
+      // Events can be added while the flusher is shutting down, so drop what
+      // is left from the previous capture, and the buffers of threads that
+      // have exited since.
+      buffers_.erase(
+          std::remove_if(buffers_.begin(), buffers_.end(),
+                         [](const std::shared_ptr<ThreadBuffer>& buffer) {
+                           return buffer->retired();
+                         }),
+          buffers_.end());
+      for (auto& buffer : buffers_)
+        buffer->Discard();
+    }
+    // Enable tracing (fast-path). This should be disabled since starting
+    // shouldn't be done twice.
+    RTC_CHECK_EQ(0, rtc::AtomicOps::CompareAndSwap(&g_binary_tracing_active,
+                                                   0, 1));
+
+    // Finally start, everything should be set up now.
+    flusher_thread_.Start();
+    TRACE_EVENT_INSTANT0("webrtc", "BinaryTracer::Start");
+  }
+
+  void Stop() {
+    RTC_DCHECK(thread_checker_.IsCurrent());
+    TRACE_EVENT_INSTANT0("webrtc", "BinaryTracer::Stop");
+    // Try to stop. Abort if we're not currently tracing.
+    if (rtc::AtomicOps::CompareAndSwap(&g_binary_tracing_active, 1, 0) == 0)
+      return;
+
+    // Wake up the flusher to write what's left.
+    shutdown_event_.Set();
+    // Join the flusher.
+    flusher_thread_.Stop();
+  }
+
+ private:
+  static int NextId() {
+    static std::atomic<int> next_id{1};
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  ThreadBuffer* CurrentThreadBuffer() {
+    ThreadBufferRef& ref = CurrentThreadBufferRef();
+    if (ref.tracer_id != id_) {
+      // The thread's first event, for this tracer.
+      if (ref.buffer)
+        ref.buffer->Retire();
+      ref.buffer = std::make_shared<ThreadBuffer>(rtc::CurrentThreadId());
+      ref.tracer_id = id_;
+      webrtc::MutexLock lock(&mutex_);
+      buffers_.push_back(ref.buffer);
+    }
+    return ref.buffer.get();
+  }
+
+  void Flush() {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+      webrtc::MutexLock lock(&mutex_);
+      buffers = buffers_;
+    }
+    for (auto& buffer : buffers) {
+      // Read before draining, so that the buffer is empty if it is retired.
+      bool retired = buffer->retired();
+      Drain(buffer.get());
+      if (retired) {
+        webrtc::MutexLock lock(&mutex_);
+        buffers_.erase(std::find(buffers_.begin(), buffers_.end(), buffer));
+      }
+    }
+    fflush(output_file_);
+  }
+
+  void Drain(ThreadBuffer* buffer) {
+    const uint64_t dropped = buffer->TakeDropped();
+    bool wrote_thread = false;
+    buffer->records().Peek([&](const uint8_t* data, size_t /*size*/) {
+      if (!wrote_thread) {
+        WriteHeader(kThread, buffer->thread_id());
+        wrote_thread = true;
+      }
+      WriteEvent(*reinterpret_cast<const EventRecord*>(data));
+    });
+    buffer->records().Release();
+    if (dropped > 0) {
+      if (!wrote_thread)
+        WriteHeader(kThread, buffer->thread_id());
+      WriteHeader(kDropped, static_cast<uint32_t>(dropped));
+    }
+  }
+
+  void WriteHeader(RecordKind kind, uint32_t value) {
+    RecordHeader header = {sizeof(RecordHeader), kind, 0, value};
+    fwrite(&header, sizeof(header), 1, output_file_);
+  }
+
+  void WriteEvent(const EventRecord& record) {
+    WriteString(record.name);
+    WriteString(record.category);
+    for (int i = 0; i < record.num_args; ++i) {
+      WriteString(record.arg_names[i]);
+      if (record.arg_types[i] == TRACE_VALUE_TYPE_STRING &&
+          record.arg_values[i] != 0) {
+        WriteString(record.arg_values[i]);
+      }
+    }
+    fwrite(&record, record.size, 1, output_file_);
+  }
+
+  // Writes the string the first time it's referred to in the capture.
+  void WriteString(uint64_t id) {
+    if (!written_strings_.insert(id).second)
+      return;
+    static const uint64_t kZeros = 0;
+    const char* str = AsString(id);
+    const size_t length = strnlen(str, kMaxStringLength);
+    const size_t padded = PaddedSize(length);
+    RecordHeader header = {
+        static_cast<uint16_t>(sizeof(RecordHeader) + sizeof(id) + padded),
+        kString, 0, static_cast<uint32_t>(length)};
+    fwrite(&header, sizeof(header), 1, output_file_);
+    fwrite(&id, sizeof(id), 1, output_file_);
+    fwrite(str, 1, length, output_file_);
+    fwrite(&kZeros, 1, padded - length, output_file_);
+  }
+
+  // Tells the buffers that threads created for an earlier tracer apart.
+  const int id_;
+  webrtc::Mutex mutex_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_ RTC_GUARDED_BY(mutex_);
+  rtc::PlatformThread flusher_thread_;
+  rtc::Event shutdown_event_;
+  webrtc::SequenceChecker thread_checker_;
+  FILE* output_file_ = nullptr;
+  bool output_file_owned_ = false;
+  // Only accessed by the flusher while capturing.
+  std::unordered_set<uint64_t> written_strings_;
+};
+
+static void FlusherThreadFunc(void* params) {
+  static_cast<BinaryTracer*>(params)->Log();
+}
+
+static BinaryTracer* volatile g_binary_tracer = nullptr;
+static const char* const kDisabledTracePrefix = TRACE_DISABLED_BY_DEFAULT("");
+const unsigned char* BinaryGetCategoryEnabled(const char* name) {
+  const char* prefix_ptr = &kDisabledTracePrefix[0];
+  const char* name_ptr = name;
+  // Check whether name contains the default-disabled prefix.
+  while (*prefix_ptr == *name_ptr && *prefix_ptr != '\0') {
+    ++prefix_ptr;
+    ++name_ptr;
+  }
+  return reinterpret_cast<const unsigned char*>(*prefix_ptr == '\0' ? ""
+                                                                    : name);
+}
+
+void BinaryAddTraceEvent(char phase,
+                         const unsigned char* category_enabled,
+                         const char* name,
+                         unsigned long long id,
+                         int num_args,
+                         const char** arg_names,
+                         const unsigned char* arg_types,
+                         const unsigned long long* arg_values,
+                         unsigned char flags) {
+  // Fast path for when tracing is inactive.
+  if (rtc::AtomicOps::AcquireLoad(&g_binary_tracing_active) == 0)
+    return;
+
+  g_binary_tracer->AddTraceEvent(name, category_enabled, phase, num_args,
+                                 arg_names, arg_types, arg_values);
+}
+
+// Appends |str| as a JSON string.
+void AppendJsonString(const char* str, size_t length, std::string* output) {
+  *output += '"';
+  for (size_t i = 0; i < length; ++i) {
+    const unsigned char c = static_cast<unsigned char>(str[i]);
+    if (c < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      *output += escaped;
+      continue;
+    }
+    if (c == '"' || c == '\\')
+      *output += '\\';
+    *output += str[i];
+  }
+  *output += '"';
+}
+
+void AppendJsonString(const std::string& str, std::string* output) {
+  AppendJsonString(str.data(), str.size(), output);
+}
+
+// |copied| is where the value of a copied string is, and |strings| has the
+// values of other strings.
+void AppendArgValue(unsigned char type,
+                    uint64_t value,
+                    const char* copied,
+                    std::unordered_map<uint64_t, std::string>* strings,
+                    std::string* output) {
+  char buffer[32];
+  switch (type) {
+    case TRACE_VALUE_TYPE_BOOL:
+      *output += value ? "true" : "false";
+      return;
+    case TRACE_VALUE_TYPE_UINT:
+      snprintf(buffer, sizeof(buffer), "%" PRIu64, value);
+      break;
+    case TRACE_VALUE_TYPE_INT:
+      snprintf(buffer, sizeof(buffer), "%" PRId64,
+               static_cast<int64_t>(value));
+      break;
+    case TRACE_VALUE_TYPE_DOUBLE: {
+      double as_double;
+      memcpy(&as_double, &value, sizeof(as_double));
+      snprintf(buffer, sizeof(buffer), "%f", as_double);
+      break;
+    }
+    case TRACE_VALUE_TYPE_POINTER:
+      snprintf(buffer, sizeof(buffer), "\"0x%" PRIx64 "\"", value);
+      break;
+    case TRACE_VALUE_TYPE_COPY_STRING:
+      AppendJsonString(copied, value, output);
+      return;
+    case TRACE_VALUE_TYPE_STRING:
+      AppendJsonString((*strings)[value], output);
+      return;
+    default:
+      *output += "\"\"";
+      return;
+  }
+  *output += buffer;
+}
+
+}  // namespace
+
+void SetupBinaryTracer() {
+  RTC_CHECK(rtc::AtomicOps::CompareAndSwapPtr(
+                &g_binary_tracer, static_cast<BinaryTracer*>(nullptr),
+                new BinaryTracer()) == nullptr);
+  webrtc::SetupEventTracer(BinaryGetCategoryEnabled, BinaryAddTraceEvent);
+}
+
+void StartBinaryCaptureToFile(FILE* file) {
+  if (g_binary_tracer) {
+    g_binary_tracer->Start(file, false);
+  }
+}
+
+bool StartBinaryCapture(const char* filename) {
+  if (!g_binary_tracer)
+    return false;
+
+  FILE* file = fopen(filename, "wb");
+  if (!file) {
+    RTC_LOG(LS_ERROR) << "Failed to open trace file '" << filename
+                      << "' for writing.";
+    return false;
+  }
+  g_binary_tracer->Start(file, true);
+  return true;
+}
+
+void StopBinaryCapture() {
+  if (g_binary_tracer) {
+    g_binary_tracer->Stop();
+  }
+}
+
+void ShutdownBinaryTracer() {
+  StopBinaryCapture();
+  BinaryTracer* old_tracer = rtc::AtomicOps::AcquireLoadPtr(&g_binary_tracer);
+  RTC_DCHECK(old_tracer);
+  RTC_CHECK(rtc::AtomicOps::CompareAndSwapPtr(
+                &g_binary_tracer, old_tracer,
+                static_cast<BinaryTracer*>(nullptr)) == old_tracer);
+  delete old_tracer;
+  webrtc::SetupEventTracer(nullptr, nullptr);
+}
+
+bool ConvertBinaryTraceToJson(FILE* binary_trace, FILE* json) {
+  char magic[sizeof(kMagic)];
+  if (fread(magic, sizeof(magic), 1, binary_trace) != 1 ||
+      memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+    return false;
+  }
+
+  // Strings that aren't defined are empty.
+  std::unordered_map<uint64_t, std::string> strings;
+  // Large enough for any record, and aligned for it.
+  std::vector<uint64_t> record_buffer(UINT16_MAX / 8 + 1);
+  uint8_t* record = reinterpret_cast<uint8_t*>(record_buffer.data());
+  const RecordHeader& header = *reinterpret_cast<RecordHeader*>(record);
+  uint32_t thread_id = 0;
+  uint64_t timestamp_us = 0;
+  bool complete = true;
+  const char* separator = " ";
+  std::string event;
+  fprintf(json, "{ \"traceEvents\": [\n");
+  while (true) {
+    size_t read = fread(record, 1, sizeof(RecordHeader), binary_trace);
+    if (read == 0)
+      break;
+    if (read != sizeof(RecordHeader) || header.size < sizeof(RecordHeader) ||
+        header.size % 8 != 0) {
+      complete = false;
+      break;
+    }
+    const size_t body_size = header.size - sizeof(RecordHeader);
+    if (fread(record + sizeof(RecordHeader), 1, body_size, binary_trace) !=
+        body_size) {
+      complete = false;
+      break;
+    }
+
+    event.clear();
+    if (header.kind == kString) {
+      if (body_size < sizeof(uint64_t) + header.value) {
+        complete = false;
+        break;
+      }
+      strings[record_buffer[1]].assign(
+          reinterpret_cast<const char*>(&record_buffer[2]), header.value);
+      continue;
+    } else if (header.kind == kThread) {
+      thread_id = header.value;
+      continue;
+    } else if (header.kind == kDropped) {
+      event = "{ \"name\": \"TraceEventsDropped\", \"cat\": \"webrtc\"";
+      event += ", \"ph\": \"I\"";
+      event += ", \"ts\": " + std::to_string(timestamp_us);
+      event += ", \"pid\": 1, \"tid\": " + std::to_string(thread_id);
+      event += ", \"args\": { \"count\": " + std::to_string(header.value);
+      event += " }";
+    } else if (header.kind == kEvent && header.size >= sizeof(EventRecord)) {
+      const EventRecord& e = *reinterpret_cast<EventRecord*>(record);
+      timestamp_us = e.timestamp_us;
+      event = "{ \"name\": ";
+      AppendJsonString(strings[e.name], &event);
+      event += ", \"cat\": ";
+      AppendJsonString(strings[e.category], &event);
+      event += ", \"ph\": \"";
+      event += e.phase;
+      event += "\", \"ts\": " + std::to_string(e.timestamp_us);
+      event += ", \"pid\": 1, \"tid\": " + std::to_string(thread_id);
+      const char* copied = reinterpret_cast<const char*>(&e + 1);
+      const char* end = reinterpret_cast<const char*>(record) + e.size;
+      const int num_args = std::min<int>(e.num_args, kMaxArgs);
+      for (int i = 0; i < num_args; ++i) {
+        event += i == 0 ? ", \"args\": { " : ", ";
+        AppendJsonString(strings[e.arg_names[i]], &event);
+        event += ": ";
+        if (e.arg_types[i] == TRACE_VALUE_TYPE_COPY_STRING &&
+            static_cast<uint64_t>(end - copied) < e.arg_values[i]) {
+          complete = false;
+          break;
+        }
+        AppendArgValue(e.arg_types[i], e.arg_values[i], copied, &strings,
+                       &event);
+        if (e.arg_types[i] == TRACE_VALUE_TYPE_COPY_STRING)
+          copied += PaddedSize(e.arg_values[i]);
+      }
+      if (!complete)
+        break;
+      if (num_args > 0)
+        event += " }";
+    } else {
+      complete = false;
+      break;
+    }
+    fprintf(json, "%s%s}\n", separator, event.c_str());
+    separator = ",";
+  }
+  fprintf(json, "]}\n");
+  return complete;
+}
+
+}  // namespace tracing
+}  // namespace rtc
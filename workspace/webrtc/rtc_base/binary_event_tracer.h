@@ -0,0 +1,50 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// A low-overhead alternative to the internal tracer in event_tracer.h, for
+// tracing in production.
+//
+// Each thread appends its trace events to its own ring buffer, without locks,
+// as fixed-size binary records that refer to the event's strings by address.
+// A background thread moves the records to the capture file, together with
+// the strings the first time they are referred to. A full ring buffer drops
+// events, and the number of dropped events is recorded, so memory use is
+// bounded by the number of tracing threads.
+//
+// The capture is converted to the Chrome trace event JSON format, which
+// chrome://tracing and Perfetto read, with ConvertBinaryTraceToJson().
+// Records are in host byte order.
+
+#ifndef RTC_BASE_BINARY_EVENT_TRACER_H_
+#define RTC_BASE_BINARY_EVENT_TRACER_H_
+
+#include <stdio.h>
+
+namespace rtc {
+namespace tracing {
+
+// Set up the binary event tracer. It replaces the internal tracer, and they
+// can't be used at the same time.
+void SetupBinaryTracer();
+bool StartBinaryCapture(const char* filename);
+void StartBinaryCaptureToFile(FILE* file);
+void StopBinaryCapture();
+// Make sure we run this, this will tear down the binary tracing.
+void ShutdownBinaryTracer();
+
+// Reads a capture written by the binary tracer from |binary_trace| and writes
+// it to |json| in the trace event format. Returns false if |binary_trace|
+// isn't a complete capture; the events up to the error are still written.
+bool ConvertBinaryTraceToJson(FILE* binary_trace, FILE* json);
+
+}  // namespace tracing
+}  // namespace rtc
+
+#endif  // RTC_BASE_BINARY_EVENT_TRACER_H_
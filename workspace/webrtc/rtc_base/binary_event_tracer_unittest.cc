@@ -0,0 +1,206 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/binary_event_tracer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/trace_event.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace tracing {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+#if RTC_TRACE_EVENTS_ENABLED
+
+std::string ReadAll(FILE* file) {
+  std::string contents;
+  rewind(file);
+  char buffer[4096];
+  size_t read;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    contents.append(buffer, read);
+  return contents;
+}
+
+// Converts |binary_trace| to JSON, which is expected to succeed.
+std::string ConvertToJson(FILE* binary_trace) {
+  rewind(binary_trace);
+  FILE* json = tmpfile();
+  EXPECT_TRUE(ConvertBinaryTraceToJson(binary_trace, json));
+  std::string contents = ReadAll(json);
+  fclose(json);
+  return contents;
+}
+
+int CountOccurrences(const std::string& str, const std::string& pattern) {
+  int count = 0;
+  for (size_t pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+void TraceFromOtherThread(void* /*context*/) {
+  TRACE_EVENT_INSTANT1("test", "OtherThread", "value", -7);
+}
+
+TEST(BinaryEventTracerTest, ConvertsEventsFromAllThreads) {
+  SetupBinaryTracer();
+  FILE* capture = tmpfile();
+  StartBinaryCaptureToFile(capture);
+  {
+    TRACE_EVENT2("test", "Scoped", "count", 42, "label",
+                 TRACE_STR_COPY(std::string("say \"hi\"").c_str()));
+  }
+  // The thread exits before the capture stops.
+  PlatformThread thread(&TraceFromOtherThread, nullptr, "Other");
+  thread.Start();
+  thread.Stop();
+  TRACE_EVENT_INSTANT0(TRACE_DISABLED_BY_DEFAULT("test"), "Disabled");
+  StopBinaryCapture();
+  ShutdownBinaryTracer();
+
+  std::string json = ConvertToJson(capture);
+  fclose(capture);
+  EXPECT_EQ(json.find("{ \"traceEvents\": [\n"), 0u);
+  EXPECT_EQ(json.substr(json.size() - 3), "]}\n");
+  EXPECT_THAT(json, HasSubstr("\"name\": \"Scoped\", \"cat\": \"test\", "
+                              "\"ph\": \"B\""));
+  EXPECT_THAT(json, HasSubstr("\"ph\": \"E\""));
+  EXPECT_THAT(json, HasSubstr("\"args\": { \"count\": 42, "
+                              "\"label\": \"say \\\"hi\\\"\" }"));
+  EXPECT_THAT(json, HasSubstr("\"name\": \"OtherThread\""));
+  EXPECT_THAT(json, HasSubstr("\"args\": { \"value\": -7 }"));
+  EXPECT_THAT(json, HasSubstr("\"name\": \"BinaryTracer::Stop\""));
+  EXPECT_THAT(json, Not(HasSubstr("Disabled")));
+}
+
+TEST(BinaryEventTracerTest, RestartedCaptureOnlyHasNewEvents) {
+  SetupBinaryTracer();
+  FILE* first = tmpfile();
+  StartBinaryCaptureToFile(first);
+  TRACE_EVENT_INSTANT0("test", "First");
+  StopBinaryCapture();
+  TRACE_EVENT_INSTANT0("test", "BetweenCaptures");
+  FILE* second = tmpfile();
+  StartBinaryCaptureToFile(second);
+  TRACE_EVENT_INSTANT0("test", "Second");
+  StopBinaryCapture();
+  ShutdownBinaryTracer();
+
+  std::string first_json = ConvertToJson(first);
+  std::string second_json = ConvertToJson(second);
+  fclose(first);
+  fclose(second);
+  EXPECT_THAT(first_json, HasSubstr("\"First\""));
+  EXPECT_THAT(first_json, Not(HasSubstr("\"Second\"")));
+  EXPECT_THAT(second_json, HasSubstr("\"Second\""));
+  EXPECT_THAT(second_json, Not(HasSubstr("\"First\"")));
+  EXPECT_THAT(second_json, Not(HasSubstr("\"BetweenCaptures\"")));
+}
+
+// Strings that aren't copied are written once, like names, and control
+// characters are escaped.
+TEST(BinaryEventTracerTest, ConvertsStringArgs) {
+  SetupBinaryTracer();
+  FILE* capture = tmpfile();
+  StartBinaryCaptureToFile(capture);
+  for (int i = 0; i < 2; ++i) {
+    TRACE_EVENT_INSTANT2("test", "Strings", "src_file", "thread.cc", "text",
+                         TRACE_STR_COPY(std::string("a\tb\n").c_str()));
+  }
+  StopBinaryCapture();
+  ShutdownBinaryTracer();
+  std::string contents = ReadAll(capture);
+
+  std::string json = ConvertToJson(capture);
+  fclose(capture);
+  EXPECT_EQ(CountOccurrences(json,
+                             "\"args\": { \"src_file\": \"thread.cc\", "
+                             "\"text\": \"a\\u0009b\\u000a\" }"),
+            2);
+  EXPECT_EQ(CountOccurrences(contents, "thread.cc"), 1);
+}
+
+// More events than a thread's buffer holds are either written or counted as
+// dropped.
+TEST(BinaryEventTracerTest, AccountsForDroppedEvents) {
+  constexpr int kNumEvents = 20000;
+  SetupBinaryTracer();
+  FILE* capture = tmpfile();
+  StartBinaryCaptureToFile(capture);
+  for (int i = 0; i < kNumEvents; ++i)
+    TRACE_EVENT_INSTANT1("test", "Burst", "i", i);
+  StopBinaryCapture();
+  ShutdownBinaryTracer();
+
+  std::string json = ConvertToJson(capture);
+  fclose(capture);
+  int dropped = 0;
+  const std::string kDropped = "\"TraceEventsDropped\"";
+  const std::string kCount = "\"count\": ";
+  for (size_t pos = json.find(kDropped); pos != std::string::npos;
+       pos = json.find(kDropped, pos + 1)) {
+    dropped += atoi(json.c_str() + json.find(kCount, pos) + kCount.size());
+  }
+  // StopBinaryCapture() traces an event too, which is likely dropped.
+  EXPECT_EQ(CountOccurrences(json, "\"Burst\"") +
+                CountOccurrences(json, "\"BinaryTracer::Stop\"") + dropped,
+            kNumEvents + 1);
+  EXPECT_GT(dropped, 0);
+}
+
+TEST(BinaryEventTracerTest, RejectsTruncatedCapture) {
+  SetupBinaryTracer();
+  FILE* capture = tmpfile();
+  StartBinaryCaptureToFile(capture);
+  TRACE_EVENT_INSTANT0("test", "Truncated");
+  StopBinaryCapture();
+  ShutdownBinaryTracer();
+  std::string contents = ReadAll(capture);
+  fclose(capture);
+
+  FILE* truncated = tmpfile();
+  fwrite(contents.data(), 1, contents.size() - 4, truncated);
+  rewind(truncated);
+  FILE* json = tmpfile();
+  EXPECT_FALSE(ConvertBinaryTraceToJson(truncated, json));
+  // The JSON is still well-formed.
+  std::string truncated_json = ReadAll(json);
+  EXPECT_EQ(truncated_json.find("{ \"traceEvents\": [\n"), 0u);
+  EXPECT_EQ(truncated_json.substr(truncated_json.size() - 3), "]}\n");
+  fclose(truncated);
+  fclose(json);
+
+  FILE* not_a_capture = tmpfile();
+  fputs("{ \"traceEvents\": [] }", not_a_capture);
+  rewind(not_a_capture);
+  json = tmpfile();
+  EXPECT_FALSE(ConvertBinaryTraceToJson(not_a_capture, json));
+  fclose(not_a_capture);
+  fclose(json);
+}
+
+#endif  // RTC_TRACE_EVENTS_ENABLED
+
+}  // namespace
+}  // namespace tracing
+}  // namespace rtc
@@ -41,6 +41,10 @@ void FileRotatingLogSink::OnLogMessage(const std::string& message) {
     std::fprintf(stderr, "Init() must be called before adding this sink.\n");
     return;
   }
+  if (in_batch_) {
+    batch_ += message;
+    return;
+  }
   stream_->WriteAll(message.c_str(), message.size(), nullptr, nullptr);
 }
 
@@ -51,11 +55,26 @@ void FileRotatingLogSink::OnLogMessage(const std::string& message,
     std::fprintf(stderr, "Init() must be called before adding this sink.\n");
     return;
   }
+  if (in_batch_) {
+    batch_.append(tag).append(": ").append(message);
+    return;
+  }
   stream_->WriteAll(tag, strlen(tag), nullptr, nullptr);
   stream_->WriteAll(": ", 2, nullptr, nullptr);
   stream_->WriteAll(message.c_str(), message.size(), nullptr, nullptr);
 }
 
+void FileRotatingLogSink::OnLogBatchBegin() {
+  in_batch_ = true;
+}
+
+void FileRotatingLogSink::OnLogBatchEnd() {
+  in_batch_ = false;
+  if (!batch_.empty())
+    stream_->WriteAll(batch_.data(), batch_.size(), nullptr, nullptr);
+  batch_.clear();
+}
+
 bool FileRotatingLogSink::Init() {
   return stream_->Open();
 }
@@ -40,6 +40,10 @@ class FileRotatingLogSink : public LogSink {
   void OnLogMessage(const std::string& message,
                     LoggingSeverity sev,
                     const char* tag) override;
+  // The messages of a batch are written to the stream all at once, at its
+  // end.
+  void OnLogBatchBegin() override;
+  void OnLogBatchEnd() override;
 
   // Deletes any existing files in the directory and creates a new log file.
   virtual bool Init();
@@ -52,6 +56,8 @@ class FileRotatingLogSink : public LogSink {
 
  private:
   std::unique_ptr<FileRotatingStream> stream_;
+  bool in_batch_ = false;
+  std::string batch_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(FileRotatingLogSink);
 };
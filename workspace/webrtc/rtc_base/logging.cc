@@ -48,6 +48,7 @@ static const int kMaxLogLineSize = 1024 - 60;
 #include "rtc_base/string_utils.h"
 #include "rtc_base/strings/string_builder.h"
 #include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/system_time.h"
 #include "rtc_base/thread_annotations.h"
 #include "rtc_base/time_utils.h"
 
@@ -76,6 +77,77 @@ const char* FilenameFromPath(const char* file) {
 // TODO(bugs.webrtc.org/11665): this is not currently constant initialized and
 // trivially destructible.
 webrtc::Mutex g_log_mutex_;
+
+ABSL_CONST_INIT std::atomic<LogMessage::CaptureFunction> g_capture_function(
+    nullptr);
+
+// The encoding of a log call for a capture function: a CapturedCall, followed
+// by each argument as its LogArgType and its value, with strings as their
+// size and characters, and then LogArgType::kEnd.
+struct CapturedCall {
+  int64_t time_us;
+  PlatformThreadId thread_id;
+  webrtc_logging_impl::LogMetadataErr meta;
+  const char* tag;
+};
+
+// The arguments that don't fit are left out, and the string that doesn't fit
+// is truncated.
+constexpr size_t kMaxCapturedSize = 2048;
+
+template <typename T>
+T ReadCaptured(const char** data) {
+  T value;
+  memcpy(&value, *data, sizeof(T));
+  *data += sizeof(T);
+  return value;
+}
+
+void StreamCapturedArgs(const char* data, rtc::StringBuilder* stream) {
+  using webrtc_logging_impl::LogArgType;
+  while (true) {
+    switch (static_cast<LogArgType>(*data++)) {
+      case LogArgType::kEnd:
+        return;
+      case LogArgType::kInt:
+        *stream << ReadCaptured<int>(&data);
+        break;
+      case LogArgType::kLong:
+        *stream << ReadCaptured<long>(&data);
+        break;
+      case LogArgType::kLongLong:
+        *stream << ReadCaptured<long long>(&data);
+        break;
+      case LogArgType::kUInt:
+        *stream << ReadCaptured<unsigned>(&data);
+        break;
+      case LogArgType::kULong:
+        *stream << ReadCaptured<unsigned long>(&data);
+        break;
+      case LogArgType::kULongLong:
+        *stream << ReadCaptured<unsigned long long>(&data);
+        break;
+      case LogArgType::kDouble:
+        *stream << ReadCaptured<double>(&data);
+        break;
+      case LogArgType::kLongDouble:
+        *stream << ReadCaptured<long double>(&data);
+        break;
+      case LogArgType::kStringView: {
+        const uint32_t length = ReadCaptured<uint32_t>(&data);
+        *stream << absl::string_view(data, length);
+        data += length;
+        break;
+      }
+      case LogArgType::kVoidP:
+        *stream << rtc::ToHex(ReadCaptured<uintptr_t>(&data));
+        break;
+      default:
+        RTC_NOTREACHED();
+        return;
+    }
+  }
+}
 }  // namespace
 
 /////////////////////////////////////////////////////////////////////////////
@@ -103,11 +175,28 @@ LogMessage::LogMessage(const char* file,
                        LoggingSeverity sev,
                        LogErrorContext err_ctx,
                        int err)
-    : severity_(sev) {
+    : LogMessage(file,
+                 line,
+                 sev,
+                 err_ctx,
+                 err,
+                 // Use SystemTimeMillis so that even if tests use fake clocks,
+                 // the timestamp in log messages represents the real system
+                 // time.
+                 timestamp_ ? TimeDiff(SystemTimeMillis(), LogStartTime()) : 0,
+                 thread_ ? CurrentThreadId() : 0,
+                 /*output=*/true) {}
+
+LogMessage::LogMessage(const char* file,
+                       int line,
+                       LoggingSeverity sev,
+                       LogErrorContext err_ctx,
+                       int err,
+                       int64_t time_ms,
+                       PlatformThreadId thread_id,
+                       bool output)
+    : severity_(sev), output_(output) {
   if (timestamp_) {
-    // Use SystemTimeMillis so that even if tests use fake clocks, the timestamp
-    // in log messages represents the real system time.
-    int64_t time = TimeDiff(SystemTimeMillis(), LogStartTime());
     // Also ensure WallClockStartTime is initialized, so that it matches
     // LogStartTime.
     WallClockStartTime();
@@ -115,14 +204,13 @@ LogMessage::LogMessage(const char* file,
     char timestamp[50];  // Maximum string length of an int64_t is 20.
     int len =
         snprintf(timestamp, sizeof(timestamp), "[%03" PRId64 ":%03" PRId64 "]",
-                 time / 1000, time % 1000);
+                 time_ms / 1000, time_ms % 1000);
     RTC_DCHECK_LT(len, sizeof(timestamp));
     print_stream_ << timestamp;
   }
 
   if (thread_) {
-    PlatformThreadId id = CurrentThreadId();
-    print_stream_ << "[" << id << "] ";
+    print_stream_ << "[" << thread_id << "] ";
   }
 
   if (file != nullptr) {
@@ -189,6 +277,9 @@ LogMessage::LogMessage(const char* file,
 }
 
 LogMessage::~LogMessage() {
+  if (!output_)
+    return;
+
   FinishPrintStream();
 
   const std::string str = print_stream_.Release();
@@ -441,6 +532,78 @@ void LogMessage::OutputToDebug(const std::string& str,
   }
 }
 
+void LogMessage::SetCaptureFunction(CaptureFunction capture) {
+  // Captured messages are timestamped relative to these.
+  LogStartTime();
+  WallClockStartTime();
+  g_capture_function.store(capture, std::memory_order_release);
+}
+
+int64_t LogMessage::CapturedMessageTimeUs(const void* data) {
+  CapturedCall call;
+  memcpy(&call, data, sizeof(call));
+  return call.time_us;
+}
+
+void LogMessage::OutputCapturedMessages(const void* const* messages,
+                                        size_t count) {
+  struct FormattedMessage {
+    std::string str;
+    LoggingSeverity severity;
+    const char* tag;
+  };
+  // Formats the messages before taking the lock, which is taken once.
+  std::vector<FormattedMessage> formatted;
+  formatted.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const char* data = static_cast<const char*>(messages[i]);
+    CapturedCall call;
+    memcpy(&call, data, sizeof(call));
+    LogMessage message(
+        call.meta.meta.File(), call.meta.meta.Line(), call.meta.meta.Severity(),
+        call.meta.err_ctx, call.meta.err,
+        TimeDiff(call.time_us / kNumMicrosecsPerMillisec, LogStartTime()),
+        call.thread_id, /*output=*/false);
+    if (call.tag) {
+      message.AddTag(call.tag);
+    }
+    StreamCapturedArgs(data + sizeof(call), &message.stream());
+    message.FinishPrintStream();
+#if defined(WEBRTC_ANDROID)
+    const char* tag = message.tag_;
+#else
+    const char* tag = nullptr;
+#endif
+    formatted.push_back({message.print_stream_.Release(), message.severity_,
+                         tag});
+  }
+
+  for (const FormattedMessage& message : formatted) {
+    if (message.severity >= g_dbg_sev) {
+#if defined(WEBRTC_ANDROID)
+      OutputToDebug(message.str, message.severity, message.tag);
+#else
+      OutputToDebug(message.str, message.severity);
+#endif
+    }
+  }
+
+  webrtc::MutexLock lock(&g_log_mutex_);
+  for (LogSink* entry = streams_; entry != nullptr; entry = entry->next_) {
+    entry->OnLogBatchBegin();
+    for (const FormattedMessage& message : formatted) {
+      if (message.severity >= entry->min_severity_) {
+#if defined(WEBRTC_ANDROID)
+        entry->OnLogMessage(message.str, message.severity, message.tag);
+#else
+        entry->OnLogMessage(message.str, message.severity);
+#endif
+      }
+    }
+    entry->OnLogBatchEnd();
+  }
+}
+
 // static
 bool LogMessage::IsNoop(LoggingSeverity severity) {
   if (severity >= g_dbg_sev || severity >= g_min_sev)
@@ -455,6 +618,117 @@ void LogMessage::FinishPrintStream() {
 }
 
 namespace webrtc_logging_impl {
+namespace {
+
+// Appends arguments to an encoded log call, until one doesn't fit.
+class CapturedCallWriter {
+ public:
+  CapturedCallWriter(char* buffer, const CapturedCall& call)
+      : buffer_(buffer), size_(sizeof(call)) {
+    memcpy(buffer_, &call, sizeof(call));
+  }
+
+  template <typename T>
+  void Append(LogArgType type, T value) {
+    if (full_ || Available() < 1 + sizeof(value)) {
+      full_ = true;
+      return;
+    }
+    buffer_[size_++] = static_cast<char>(type);
+    memcpy(buffer_ + size_, &value, sizeof(value));
+    size_ += sizeof(value);
+  }
+
+  void AppendString(absl::string_view str) {
+    if (full_ || Available() < 1 + sizeof(uint32_t)) {
+      full_ = true;
+      return;
+    }
+    const size_t available = Available() - 1 - sizeof(uint32_t);
+    full_ = str.size() > available;
+    const uint32_t length =
+        static_cast<uint32_t>(std::min(str.size(), available));
+    buffer_[size_++] = static_cast<char>(LogArgType::kStringView);
+    memcpy(buffer_ + size_, &length, sizeof(length));
+    size_ += sizeof(length);
+    memcpy(buffer_ + size_, str.data(), length);
+    size_ += length;
+  }
+
+  // Returns the size of the encoded call.
+  size_t Finish() {
+    buffer_[size_++] = static_cast<char>(LogArgType::kEnd);
+    return size_;
+  }
+
+ private:
+  // Leaves room for LogArgType::kEnd.
+  size_t Available() const { return kMaxCapturedSize - 1 - size_; }
+
+  char* const buffer_;
+  size_t size_;
+  bool full_ = false;
+};
+
+void CaptureLog(LogMessage::CaptureFunction capture,
+                const LogMetadataErr& meta,
+                const char* tag,
+                const LogArgType* fmt,
+                va_list args) {
+  char buffer[kMaxCapturedSize];
+  CapturedCallWriter writer(
+      buffer, {SystemTimeNanos() / kNumNanosecsPerMicrosec, CurrentThreadId(),
+               meta, tag});
+  for (; *fmt != LogArgType::kEnd; ++fmt) {
+    switch (*fmt) {
+      case LogArgType::kInt:
+        writer.Append(*fmt, va_arg(args, int));
+        break;
+      case LogArgType::kLong:
+        writer.Append(*fmt, va_arg(args, long));
+        break;
+      case LogArgType::kLongLong:
+        writer.Append(*fmt, va_arg(args, long long));
+        break;
+      case LogArgType::kUInt:
+        writer.Append(*fmt, va_arg(args, unsigned));
+        break;
+      case LogArgType::kULong:
+        writer.Append(*fmt, va_arg(args, unsigned long));
+        break;
+      case LogArgType::kULongLong:
+        writer.Append(*fmt, va_arg(args, unsigned long long));
+        break;
+      case LogArgType::kDouble:
+        writer.Append(*fmt, va_arg(args, double));
+        break;
+      case LogArgType::kLongDouble:
+        writer.Append(*fmt, va_arg(args, long double));
+        break;
+      case LogArgType::kCharP: {
+        const char* s = va_arg(args, const char*);
+        writer.AppendString(s ? s : "(null)");
+        break;
+      }
+      case LogArgType::kStdString:
+        writer.AppendString(*va_arg(args, const std::string*));
+        break;
+      case LogArgType::kStringView:
+        writer.AppendString(*va_arg(args, const absl::string_view*));
+        break;
+      case LogArgType::kVoidP:
+        writer.Append(*fmt,
+                      reinterpret_cast<uintptr_t>(va_arg(args, const void*)));
+        break;
+      default:
+        RTC_NOTREACHED();
+        return;
+    }
+  }
+  capture(buffer, writer.Finish());
+}
+
+}  // namespace
 
 void Log(const LogArgType* fmt, ...) {
   va_list args;
@@ -486,6 +760,13 @@ void Log(const LogArgType* fmt, ...) {
     }
   }
 
+  if (LogMessage::CaptureFunction capture =
+          g_capture_function.load(std::memory_order_acquire)) {
+    CaptureLog(capture, meta, tag, fmt + 1, args);
+    va_end(args);
+    return;
+  }
+
   LogMessage log_message(meta.meta.File(), meta.meta.Line(),
                          meta.meta.Severity(), meta.err_ctx, meta.err);
   if (tag) {
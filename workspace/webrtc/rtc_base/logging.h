@@ -55,6 +55,7 @@
 #include "absl/meta/type_traits.h"
 #include "absl/strings/string_view.h"
 #include "rtc_base/constructor_magic.h"
+#include "rtc_base/platform_thread_types.h"
 #include "rtc_base/strings/string_builder.h"
 #include "rtc_base/system/inline.h"
 
@@ -117,6 +118,11 @@ class LogSink {
   virtual void OnLogMessage(const std::string& message,
                             LoggingSeverity severity);
   virtual void OnLogMessage(const std::string& message) = 0;
+  // Called around a batch of messages, which asynchronous logging delivers
+  // many messages at a time in. A sink may buffer the messages of a batch and
+  // write them all at its end.
+  virtual void OnLogBatchBegin() {}
+  virtual void OnLogBatchEnd() {}
 
  private:
   friend class ::rtc::LogMessage;
@@ -493,6 +499,20 @@ class LogMessage {
   RTC_NO_INLINE static bool IsNoop() {
     return IsNoop(S);
   }
+  // While a capture function is set, the RTC_LOG macros don't format and
+  // output their messages, but encode their metadata and arguments into
+  // |size| bytes at |data|, which are valid for the duration of the call,
+  // and pass them to it. It must not block, since it's called on the logging
+  // thread. Pass null to format and output messages as they are logged again.
+  typedef void (*CaptureFunction)(const void* data, size_t size);
+  static void SetCaptureFunction(CaptureFunction capture);
+  // Returns the time an encoded message was logged at, in microseconds of
+  // SystemTimeNanos().
+  static int64_t CapturedMessageTimeUs(const void* data);
+  // Formats and outputs |count| encoded messages, in order. Each sink receives
+  // them as one batch.
+  static void OutputCapturedMessages(const void* const* messages,
+                                     size_t count);
 #else
   // Next methods do nothing; no one will call these functions.
   LogMessage(const char* file, int line, LoggingSeverity sev) {}
@@ -536,12 +556,28 @@ class LogMessage {
   static constexpr bool IsNoop() {
     return IsNoop(S);
   }
+  typedef void (*CaptureFunction)(const void* data, size_t size);
+  inline static void SetCaptureFunction(CaptureFunction capture) {}
+  inline static int64_t CapturedMessageTimeUs(const void* data) { return 0; }
+  inline static void OutputCapturedMessages(const void* const* messages,
+                                            size_t count) {}
 #endif  // RTC_LOG_ENABLED()
 
  private:
   friend class LogMessageForTesting;
 
 #if RTC_LOG_ENABLED()
+  // Formats a message that was logged |time_ms| after LogStartTime(), on
+  // |thread_id|. The destructor outputs it if |output| is true.
+  LogMessage(const char* file,
+             int line,
+             LoggingSeverity sev,
+             LogErrorContext err_ctx,
+             int err,
+             int64_t time_ms,
+             PlatformThreadId thread_id,
+             bool output);
+
   // Updates min_sev_ appropriately when debug sinks change.
   static void UpdateMinLogSeverity();
 
@@ -561,6 +597,9 @@ class LogMessage {
   // The severity level of this message
   LoggingSeverity severity_;
 
+  // False for messages that OutputCapturedMessages() outputs itself.
+  bool output_;
+
 #if defined(WEBRTC_ANDROID)
   // The default Android debug output tag.
   const char* tag_ = "libjingle";
@@ -0,0 +1,141 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "rtc_base/async_logger.h"
+#include "rtc_base/event.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/system/unused.h"
+
+namespace rtc {
+namespace {
+
+// Writes the messages to a file, like FileRotatingLogSink.
+class FileSink : public LogSink {
+ public:
+  FileSink() : file_(tmpfile()) { LogMessage::AddLogToStream(this, LS_INFO); }
+  ~FileSink() override {
+    LogMessage::RemoveLogToStream(this);
+    fclose(file_);
+  }
+
+  void OnLogMessage(const std::string& message) override {
+    fwrite(message.data(), 1, message.size(), file_);
+    fflush(file_);
+  }
+
+ private:
+  FILE* const file_;
+};
+
+struct Synchronous {
+  std::unique_ptr<AsyncLogger> Create() { return nullptr; }
+};
+
+struct Asynchronous {
+  std::unique_ptr<AsyncLogger> Create() {
+    return std::make_unique<AsyncLogger>();
+  }
+};
+
+// Fits in a thread's buffer of the asynchronous logger, so that no messages
+// are dropped.
+constexpr int kMessagesPerBatch = 200;
+// Long enough for the asynchronous logger to output the previous batch.
+constexpr int kBatchIntervalMs = 100;
+
+// Logs a message per millisecond.
+void LogUntilStopped(void* context) {
+  Event* stop = static_cast<Event*>(context);
+  int i = 0;
+  while (!stop->Wait(1))
+    RTC_LOG(LS_INFO) << "Other thread: " << ++i;
+}
+
+// The time it takes to log a message, while state.range(0) other threads log
+// too. The messages are logged in batches, with pauses for the asynchronous
+// logger to output them.
+template <typename Logger>
+void BM_LogMessage(benchmark::State& state) {
+  LoggingSeverity debug_severity = LogMessage::GetLogToDebug();
+  LogMessage::LogToDebug(LS_NONE);
+  FileSink sink;
+  std::unique_ptr<AsyncLogger> logger = Logger().Create();
+  Event stop(/*manual_reset=*/true, /*initially_signaled=*/false);
+  std::vector<std::unique_ptr<PlatformThread>> threads;
+  for (int i = 0; i < state.range(0); ++i) {
+    threads.push_back(
+        std::make_unique<PlatformThread>(&LogUntilStopped, &stop, "Other"));
+    threads.back()->Start();
+  }
+  const std::string name = "benchmark";
+  Event pause;
+  int i = 0;
+  double total_seconds = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    const auto start = std::chrono::steady_clock::now();
+    for (int j = 0; j < kMessagesPerBatch; ++j)
+      RTC_LOG(LS_INFO) << "Message " << ++i << " from " << name;
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    state.SetIterationTime(elapsed.count());
+    total_seconds += elapsed.count();
+    pause.Wait(kBatchIntervalMs);
+  }
+  stop.Set();
+  for (auto& thread : threads)
+    thread->Stop();
+  logger = nullptr;
+  LogMessage::LogToDebug(debug_severity);
+  state.counters["ns_per_message"] =
+      total_seconds * 1e9 / (state.iterations() * kMessagesPerBatch);
+}
+
+BENCHMARK_TEMPLATE(BM_LogMessage, Synchronous)
+    ->Arg(0)
+    ->Arg(3)
+    ->UseManualTime()
+    ->Iterations(20);
+BENCHMARK_TEMPLATE(BM_LogMessage, Asynchronous)
+    ->Arg(0)
+    ->Arg(3)
+    ->UseManualTime()
+    ->Iterations(20);
+
+}  // namespace
+}  // namespace rtc
+
+/*
+
+Results (Linux, a single x86-64 core):
+
+----------------------------------------------------------------------------
+Benchmark                                               Time  UserCounters...
+----------------------------------------------------------------------------
+BM_LogMessage<Synchronous>/0/iterations:20/manual_time      ns_per_message=2353
+BM_LogMessage<Synchronous>/3/iterations:20/manual_time      ns_per_message=1584
+BM_LogMessage<Asynchronous>/0/iterations:20/manual_time     ns_per_message=324
+BM_LogMessage<Asynchronous>/3/iterations:20/manual_time     ns_per_message=325
+
+Logging synchronously formats the message, takes the log lock and writes to
+the file on the logging thread. Logging asynchronously copies the arguments
+and reads the clock; the logger's thread formats the messages and writes each
+batch to the sinks under the lock once.
+
+*/
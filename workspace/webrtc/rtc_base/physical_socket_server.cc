@@ -55,6 +55,23 @@
 #include <linux/sockios.h>
 #endif
 
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+// Batched UDP I/O with recvmmsg and sendmmsg, and UDP GSO and GRO where the
+// kernel supports them.
+#define WEBRTC_USE_MMSG 1
+#include <netinet/udp.h>
+// UDP_SEGMENT and UDP_GRO are only defined starting with Linux 4.18 and 5.0.
+#if !defined(SOL_UDP)
+#define SOL_UDP 17
+#endif
+#if !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
+#if !defined(UDP_GRO)
+#define UDP_GRO 104
+#endif
+#endif
+
 #if defined(WEBRTC_WIN)
 #define LAST_SYSTEM_ERROR (::GetLastError())
 #elif defined(__native_client__) && __native_client__
@@ -105,6 +122,84 @@ typedef char* SockOptArg;
 #endif
 
 namespace {
+#if defined(WEBRTC_USE_MMSG)
+// The number of datagrams to receive or send with one system call.
+constexpr size_t kMaxBatchSize = 64;
+// The limits of a message sent with UDP GSO.
+constexpr size_t kMaxGsoSegments = 64;
+constexpr size_t kMaxGsoBytes = 64000;
+
+// Sends as many of |datagrams| as fit in one call to sendmmsg, as one message
+// each or, with |use_gso|, with consecutive datagrams of the same size to the
+// same address as one message that the kernel segments. Returns how many of
+// the datagrams were sent, or -1.
+int SendMmsg(int s,
+             rtc::ArrayView<const rtc::OutgoingDatagram> datagrams,
+             bool use_gso) {
+  union ControlBuffer {
+    char buffer[CMSG_SPACE(sizeof(uint16_t))];
+    cmsghdr align;
+  };
+  mmsghdr messages[kMaxBatchSize];
+  iovec buffers[kMaxBatchSize];
+  sockaddr_storage addresses[kMaxBatchSize];
+  ControlBuffer control[kMaxBatchSize];
+  size_t segments[kMaxBatchSize];
+  const size_t count = std::min(datagrams.size(), kMaxBatchSize);
+  size_t num_messages = 0;
+  size_t i = 0;
+  while (i < count) {
+    const rtc::OutgoingDatagram& first = datagrams[i];
+    size_t num_segments = 1;
+    size_t bytes = first.size;
+    while (use_gso && first.size > 0 && i + num_segments < count &&
+           num_segments < kMaxGsoSegments) {
+      const rtc::OutgoingDatagram& next = datagrams[i + num_segments];
+      if (next.size == 0 || next.size > first.size ||
+          bytes + next.size > kMaxGsoBytes || next.address != first.address) {
+        break;
+      }
+      bytes += next.size;
+      ++num_segments;
+      // Only the last segment may be shorter.
+      if (next.size < first.size)
+        break;
+    }
+
+    mmsghdr& message = messages[num_messages];
+    memset(&message, 0, sizeof(message));
+    for (size_t j = 0; j < num_segments; ++j) {
+      buffers[i + j].iov_base = const_cast<void*>(datagrams[i + j].data);
+      buffers[i + j].iov_len = datagrams[i + j].size;
+    }
+    message.msg_hdr.msg_name = &addresses[num_messages];
+    message.msg_hdr.msg_namelen =
+        first.address.ToSockAddrStorage(&addresses[num_messages]);
+    message.msg_hdr.msg_iov = &buffers[i];
+    message.msg_hdr.msg_iovlen = num_segments;
+    if (num_segments > 1) {
+      message.msg_hdr.msg_control = control[num_messages].buffer;
+      message.msg_hdr.msg_controllen = sizeof(control[num_messages].buffer);
+      cmsghdr* cmsg = CMSG_FIRSTHDR(&message.msg_hdr);
+      cmsg->cmsg_level = SOL_UDP;
+      cmsg->cmsg_type = UDP_SEGMENT;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+      const uint16_t segment_size = static_cast<uint16_t>(first.size);
+      memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+    }
+    segments[num_messages++] = num_segments;
+    i += num_segments;
+  }
+  int result = ::sendmmsg(s, messages, num_messages, MSG_NOSIGNAL);
+  if (result < 0)
+    return result;
+  size_t sent = 0;
+  for (int m = 0; m < result; ++m)
+    sent += segments[m];
+  return static_cast<int>(sent);
+}
+#endif  // WEBRTC_USE_MMSG
+
 class ScopedSetTrue {
  public:
   ScopedSetTrue(bool* value) : value_(value) {
@@ -361,6 +456,7 @@ int PhysicalSocket::Send(const void* pv, size_t cb) {
   RTC_DCHECK(sent <= static_cast<int>(cb));
   if ((sent > 0 && sent < static_cast<int>(cb)) ||
       (sent < 0 && IsBlockingError(GetError()))) {
+    SetReady(DE_WRITE, false);
     EnableEvents(DE_WRITE);
   }
   return sent;
@@ -386,6 +482,7 @@ int PhysicalSocket::SendTo(const void* buffer,
   RTC_DCHECK(sent <= static_cast<int>(length));
   if ((sent > 0 && sent < static_cast<int>(length)) ||
       (sent < 0 && IsBlockingError(GetError()))) {
+    SetReady(DE_WRITE, false);
     EnableEvents(DE_WRITE);
   }
   return sent;
@@ -401,6 +498,7 @@ int PhysicalSocket::Recv(void* buffer, size_t length, int64_t* timestamp) {
     RTC_LOG(LS_WARNING) << "EOF from socket; deferring close event";
     // Must turn this back on so that the select() loop will notice the close
     // event.
+    SetReady(DE_READ, true);
     EnableEvents(DE_READ);
     SetError(EWOULDBLOCK);
     return SOCKET_ERROR;
@@ -412,6 +510,10 @@ int PhysicalSocket::Recv(void* buffer, size_t length, int64_t* timestamp) {
   int error = GetError();
   bool success = (received >= 0) || IsBlockingError(error);
   if (udp_ || success) {
+    // A stream is drained if it had less to receive than was asked for.
+    SetReady(DE_READ, received < 0 ? !IsBlockingError(error)
+                                   : udp_ || static_cast<size_t>(received) ==
+                                                 length);
     EnableEvents(DE_READ);
   }
   if (!success) {
@@ -438,6 +540,10 @@ int PhysicalSocket::RecvFrom(void* buffer,
   int error = GetError();
   bool success = (received >= 0) || IsBlockingError(error);
   if (udp_ || success) {
+    // A stream is drained if it had less to receive than was asked for.
+    SetReady(DE_READ, received < 0 ? !IsBlockingError(error)
+                                   : udp_ || static_cast<size_t>(received) ==
+                                                 length);
     EnableEvents(DE_READ);
   }
   if (!success) {
@@ -446,6 +552,119 @@ int PhysicalSocket::RecvFrom(void* buffer,
   return received;
 }
 
+int PhysicalSocket::RecvFromBatch(ArrayView<IncomingDatagram> datagrams) {
+#if defined(WEBRTC_USE_MMSG)
+  if (!udp_ || datagrams.empty())
+    return AsyncSocket::RecvFromBatch(datagrams);
+  if (!receive_timestamps_) {
+    // Read the timestamps from the control messages, rather than with an
+    // ioctl per datagram.
+    int value = 1;
+    setsockopt(s_, SOL_SOCKET, SO_TIMESTAMP, &value, sizeof(value));
+    receive_timestamps_ = true;
+  }
+  union ControlBuffer {
+    char buffer[CMSG_SPACE(sizeof(timeval)) + CMSG_SPACE(sizeof(int))];
+    cmsghdr align;
+  };
+  const size_t count = std::min(datagrams.size(), kMaxBatchSize);
+  mmsghdr messages[kMaxBatchSize];
+  iovec buffers[kMaxBatchSize];
+  sockaddr_storage addresses[kMaxBatchSize];
+  ControlBuffer control[kMaxBatchSize];
+  memset(messages, 0, count * sizeof(messages[0]));
+  for (size_t i = 0; i < count; ++i) {
+    buffers[i].iov_base = datagrams[i].data;
+    buffers[i].iov_len = datagrams[i].capacity;
+    msghdr& header = messages[i].msg_hdr;
+    header.msg_name = &addresses[i];
+    header.msg_namelen = sizeof(addresses[i]);
+    header.msg_iov = &buffers[i];
+    header.msg_iovlen = 1;
+    header.msg_control = control[i].buffer;
+    header.msg_controllen = sizeof(control[i].buffer);
+  }
+  int received = ::recvmmsg(s_, messages, count, 0, nullptr);
+  UpdateLastError();
+  SetReady(DE_READ, received < 0 ? !IsBlockingError(GetError())
+                                 : static_cast<size_t>(received) == count);
+  EnableEvents(DE_READ);
+  if (received < 0) {
+    if (!IsBlockingError(GetError()))
+      RTC_LOG_F(LS_VERBOSE) << "Error = " << GetError();
+    return received;
+  }
+  for (int i = 0; i < received; ++i) {
+    IncomingDatagram& datagram = datagrams[i];
+    msghdr& header = messages[i].msg_hdr;
+    datagram.size = messages[i].msg_len;
+    datagram.segment_size = 0;
+    datagram.timestamp = -1;
+    datagram.truncated = (header.msg_flags & MSG_TRUNC) != 0;
+    SocketAddressFromSockAddrStorage(addresses[i], &datagram.address);
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&header, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMP) {
+        timeval tv;
+        memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+        datagram.timestamp =
+            kNumMicrosecsPerSec * static_cast<int64_t>(tv.tv_sec) +
+            static_cast<int64_t>(tv.tv_usec);
+      } else if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+        int segment_size;
+        memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+        if (segment_size > 0 &&
+            static_cast<size_t>(segment_size) < datagram.size) {
+          datagram.segment_size = segment_size;
+        }
+      }
+    }
+  }
+  return received;
+#else
+  return AsyncSocket::RecvFromBatch(datagrams);
+#endif  // WEBRTC_USE_MMSG
+}
+
+int PhysicalSocket::SendToBatch(ArrayView<const OutgoingDatagram> datagrams) {
+#if defined(WEBRTC_USE_MMSG)
+  if (!udp_)
+    return AsyncSocket::SendToBatch(datagrams);
+  if (!udp_gso_checked_) {
+    int segment_size = 0;
+    socklen_t length = sizeof(segment_size);
+    udp_gso_ =
+        getsockopt(s_, SOL_UDP, UDP_SEGMENT, &segment_size, &length) == 0;
+    udp_gso_checked_ = true;
+  }
+  size_t sent = 0;
+  int result = 0;
+  while (sent < datagrams.size()) {
+    result = SendMmsg(s_, datagrams.subview(sent), udp_gso_);
+    if (result < 0 && udp_gso_ && (errno == EINVAL || errno == EIO)) {
+      // The kernel refuses to segment the datagrams, e.g. since they don't
+      // fit in the MTU of the route, so send them one by one from now on.
+      RTC_LOG(LS_INFO) << "UDP GSO failed with error " << errno
+                       << ", disabling it.";
+      udp_gso_ = false;
+      continue;
+    }
+    UpdateLastError();
+    MaybeRemapSendError();
+    if (result < 0)
+      break;
+    sent += result;
+  }
+  if (sent < datagrams.size() && IsBlockingError(GetError())) {
+    SetReady(DE_WRITE, false);
+    EnableEvents(DE_WRITE);
+  }
+  return sent > 0 ? static_cast<int>(sent) : result;
+#else
+  return AsyncSocket::SendToBatch(datagrams);
+#endif  // WEBRTC_USE_MMSG
+}
+
 int PhysicalSocket::Listen(int backlog) {
   int err = ::listen(s_, backlog);
   UpdateLastError();
@@ -469,6 +688,7 @@ AsyncSocket* PhysicalSocket::Accept(SocketAddress* out_addr) {
   sockaddr* addr = reinterpret_cast<sockaddr*>(&addr_storage);
   SOCKET s = DoAccept(s_, addr, &addr_len);
   UpdateLastError();
+  SetReady(DE_READ, s != INVALID_SOCKET || !IsBlockingError(GetError()));
   if (s == INVALID_SOCKET)
     return nullptr;
   if (out_addr != nullptr)
@@ -600,6 +820,15 @@ int PhysicalSocket::TranslateOption(Option opt, int* slevel, int* sopt) {
 #endif
     case OPT_RTP_SENDTIME_EXTN_ID:
       return -1;  // No logging is necessary as this not a OS socket option.
+    case OPT_UDP_GRO:
+#if defined(WEBRTC_USE_MMSG)
+      *slevel = SOL_UDP;
+      *sopt = UDP_GRO;
+      break;
+#else
+      RTC_LOG(LS_WARNING) << "Socket::OPT_UDP_GRO not supported.";
+      return -1;
+#endif
     default:
       RTC_NOTREACHED();
       return -1;
@@ -896,6 +1125,10 @@ void SocketDispatcher::DisableEvents(uint8_t events) {
   MaybeUpdateDispatcher(old_events);
 }
 
+void SocketDispatcher::SetReady(uint8_t events, bool ready) {
+  ss_->SetReady(this, events, ready);
+}
+
 #endif  // WEBRTC_USE_EPOLL
 
 int SocketDispatcher::Close() {
@@ -1042,12 +1275,16 @@ class Signaler : public Dispatcher {
 #endif  // WEBRTC_WIN
 
 PhysicalSocketServer::PhysicalSocketServer()
+    : PhysicalSocketServer(/*edge_triggered=*/false) {}
+
+PhysicalSocketServer::PhysicalSocketServer(bool edge_triggered)
     :
 #if defined(WEBRTC_USE_EPOLL)
       // Since Linux 2.6.8, the size argument is ignored, but must be greater
       // than zero. Before that the size served as hint to the kernel for the
       // amount of space to initially allocate in internal data structures.
       epoll_fd_(epoll_create(FD_SETSIZE)),
+      edge_triggered_(edge_triggered),
 #endif
 #if defined(WEBRTC_WIN)
       socket_ev_(WSACreateEvent()),
@@ -1076,6 +1313,9 @@ PhysicalSocketServer::~PhysicalSocketServer() {
 #endif
   RTC_DCHECK(dispatcher_by_key_.empty());
   RTC_DCHECK(key_by_dispatcher_.empty());
+#if defined(WEBRTC_USE_EPOLL)
+  RTC_DCHECK(!ready_head_);
+#endif
 }
 
 void PhysicalSocketServer::WakeUp() {
@@ -1159,10 +1399,48 @@ void PhysicalSocketServer::Update(Dispatcher* pdispatcher) {
     return;
   }
 
+  if (edge_triggered_) {
+    // The descriptor stays registered for all events, but the dispatcher may
+    // now request events it is ready for.
+    MaybeLinkReady(pdispatcher);
+    return;
+  }
   UpdateEpoll(pdispatcher, key_by_dispatcher_.at(pdispatcher));
 #endif
 }
 
+void PhysicalSocketServer::SetReady(Dispatcher* pdispatcher,
+                                    uint8_t events,
+                                    bool ready) {
+#if defined(WEBRTC_USE_EPOLL)
+  if (!edge_triggered_) {
+    return;
+  }
+
+  CritScope cs(&crit_);
+  if (!pdispatcher->edge_triggered_) {
+    // Not added, or already removed.
+    return;
+  }
+  // After a hangup, reading finds the end of the stream rather than blocking,
+  // so the descriptor stays ready to read until the dispatcher is closed.
+  if ((events & DE_READ) && (pdispatcher->ready_events_ & DE_CLOSE)) {
+    ready = true;
+  }
+  if (ready) {
+    pdispatcher->ready_events_ |= events;
+    // Linked even if the events aren't requested now, since they may be
+    // requested again before the dispatcher is updated, while it handles an
+    // event.
+    if (!pdispatcher->in_ready_list_) {
+      LinkReady(pdispatcher);
+    }
+  } else {
+    pdispatcher->ready_events_ &= ~events;
+  }
+#endif
+}
+
 #if defined(WEBRTC_POSIX)
 
 bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
@@ -1182,10 +1460,13 @@ bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
   return WaitSelect(cmsWait, process_io);
 }
 
+// |check_closed| is false if the descriptor can't have been closed by the peer
+// since it hasn't hung up, so it needn't be peeked at when readable.
 static void ProcessEvents(Dispatcher* dispatcher,
                           bool readable,
                           bool writable,
-                          bool check_error) {
+                          bool check_error,
+                          bool check_closed = true) {
   int errcode = 0;
   // TODO(pthatcher): Should we set errcode if getsockopt fails?
   if (check_error) {
@@ -1206,7 +1487,8 @@ static void ProcessEvents(Dispatcher* dispatcher,
   if (readable) {
     if (requested_events & DE_ACCEPT) {
       ff |= DE_ACCEPT;
-    } else if (errcode || dispatcher->IsDescriptorClosed()) {
+    } else if (errcode ||
+               (check_closed && dispatcher->IsDescriptorClosed())) {
       ff |= DE_CLOSE;
     } else {
       ff |= DE_READ;
@@ -1368,7 +1650,15 @@ void PhysicalSocketServer::AddEpoll(Dispatcher* pdispatcher, uint64_t key) {
   }
 
   struct epoll_event event = {0};
-  event.events = GetEpollEvents(pdispatcher->GetRequestedEvents());
+  if (edge_triggered_) {
+    // Registered for all events once, and the events the dispatcher is
+    // ready for are kept in it.
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    pdispatcher->edge_triggered_ = true;
+    pdispatcher->ready_events_ = 0;
+  } else {
+    event.events = GetEpollEvents(pdispatcher->GetRequestedEvents());
+  }
   event.data.u64 = key;
   int err = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
   RTC_DCHECK_EQ(err, 0);
@@ -1379,6 +1669,10 @@ void PhysicalSocketServer::AddEpoll(Dispatcher* pdispatcher, uint64_t key) {
 
 void PhysicalSocketServer::RemoveEpoll(Dispatcher* pdispatcher) {
   RTC_DCHECK(epoll_fd_ != INVALID_SOCKET);
+  if (pdispatcher->edge_triggered_) {
+    pdispatcher->edge_triggered_ = false;
+    UnlinkReady(pdispatcher);
+  }
   int fd = pdispatcher->GetDescriptor();
   RTC_DCHECK(fd != INVALID_SOCKET);
   if (fd == INVALID_SOCKET) {
@@ -1427,12 +1721,17 @@ bool PhysicalSocketServer::WaitEpoll(int cmsWait) {
 
   fWait_ = true;
   while (fWait_) {
+    bool has_ready_dispatchers;
+    {
+      CritScope cr(&crit_);
+      has_ready_dispatchers = ready_head_ != nullptr;
+    }
     // Wait then call handlers as appropriate
     // < 0 means error
     // 0 means timeout
     // > 0 means count of descriptors ready
     int n = epoll_wait(epoll_fd_, epoll_events_.data(), epoll_events_.size(),
-                       static_cast<int>(tvWait));
+                       has_ready_dispatchers ? 0 : static_cast<int>(tvWait));
     if (n < 0) {
       if (errno != EINTR) {
         RTC_LOG_E(LS_ERROR, EN, errno) << "epoll";
@@ -1442,9 +1741,12 @@ bool PhysicalSocketServer::WaitEpoll(int cmsWait) {
       // signals managed by this PhysicalSocketServer, the
       // PosixSignalDeliveryDispatcher will be in the signaled state in the next
       // iteration.
-    } else if (n == 0) {
+    } else if (n == 0 && !has_ready_dispatchers) {
       // If timeout, return success
       return true;
+    } else if (edge_triggered_) {
+      CritScope cr(&crit_);
+      ProcessEdgeTriggeredEvents(n);
     } else {
       // We have signaled descriptors
       CritScope cr(&crit_);
@@ -1477,6 +1779,111 @@ bool PhysicalSocketServer::WaitEpoll(int cmsWait) {
   return true;
 }
 
+void PhysicalSocketServer::ProcessEdgeTriggeredEvents(int num_events) {
+  // The dispatchers that were ready before this wait, rather than the ones
+  // that become ready while handling the events.
+  size_t num_ready = ready_count_;
+  for (int i = 0; i < num_events; ++i) {
+    const epoll_event& event = epoll_events_[i];
+    auto it = dispatcher_by_key_.find(event.data.u64);
+    if (it == dispatcher_by_key_.end()) {
+      // The dispatcher for this socket no longer exists.
+      continue;
+    }
+    Dispatcher* pdispatcher = it->second;
+    // An error or hangup is left to the read or write that the dispatcher
+    // requests next to find.
+    if (event.events & (EPOLLIN | EPOLLPRI | EPOLLERR | EPOLLHUP)) {
+      pdispatcher->ready_events_ |= DE_READ;
+    }
+    if (event.events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
+      pdispatcher->ready_events_ |= DE_WRITE;
+    }
+    if (event.events & (EPOLLRDHUP | EPOLLHUP)) {
+      pdispatcher->ready_events_ |= DE_CLOSE;
+    }
+    DispatchReadyEvents(pdispatcher,
+                        event.events & (EPOLLRDHUP | EPOLLERR | EPOLLHUP));
+  }
+
+  // Then the dispatchers that may still be ready.
+  for (; num_ready > 0 && ready_head_; --num_ready) {
+    DispatchReadyEvents(ready_head_, /*check_error=*/false);
+  }
+}
+
+void PhysicalSocketServer::DispatchReadyEvents(Dispatcher* pdispatcher,
+                                               bool check_error) {
+  UnlinkReady(pdispatcher);
+  const uint32_t requested_events = pdispatcher->GetRequestedEvents();
+  const bool readable = (pdispatcher->ready_events_ & DE_READ) &&
+                        (requested_events & (DE_READ | DE_ACCEPT));
+  const bool writable = (pdispatcher->ready_events_ & DE_WRITE) &&
+                        (requested_events & (DE_WRITE | DE_CONNECT));
+  if (!readable && !writable && !check_error) {
+    return;
+  }
+  // The dispatcher sets the events again if it may still be ready for them
+  // after handling them.
+  if (readable) {
+    pdispatcher->ready_events_ &= ~DE_READ;
+  }
+  if (writable) {
+    pdispatcher->ready_events_ &= ~DE_WRITE;
+  }
+  // The peer's hangup is signalled with its own edge, so the descriptor is
+  // only peeked at to tell the end of the stream from data after that.
+  ProcessEvents(pdispatcher, readable, writable, check_error,
+                pdispatcher->ready_events_ & DE_CLOSE);
+}
+
+void PhysicalSocketServer::LinkReady(Dispatcher* pdispatcher) {
+  RTC_DCHECK(!pdispatcher->in_ready_list_);
+  pdispatcher->in_ready_list_ = true;
+  pdispatcher->prev_ready_ = ready_tail_;
+  pdispatcher->next_ready_ = nullptr;
+  if (ready_tail_) {
+    ready_tail_->next_ready_ = pdispatcher;
+  } else {
+    ready_head_ = pdispatcher;
+  }
+  ready_tail_ = pdispatcher;
+  ++ready_count_;
+}
+
+void PhysicalSocketServer::MaybeLinkReady(Dispatcher* pdispatcher) {
+  if (pdispatcher->in_ready_list_ || !pdispatcher->ready_events_) {
+    return;
+  }
+  const uint32_t requested_events = pdispatcher->GetRequestedEvents();
+  if (((pdispatcher->ready_events_ & DE_READ) &&
+       (requested_events & (DE_READ | DE_ACCEPT))) ||
+      ((pdispatcher->ready_events_ & DE_WRITE) &&
+       (requested_events & (DE_WRITE | DE_CONNECT)))) {
+    LinkReady(pdispatcher);
+  }
+}
+
+void PhysicalSocketServer::UnlinkReady(Dispatcher* pdispatcher) {
+  if (!pdispatcher->in_ready_list_) {
+    return;
+  }
+  pdispatcher->in_ready_list_ = false;
+  if (pdispatcher->prev_ready_) {
+    pdispatcher->prev_ready_->next_ready_ = pdispatcher->next_ready_;
+  } else {
+    ready_head_ = pdispatcher->next_ready_;
+  }
+  if (pdispatcher->next_ready_) {
+    pdispatcher->next_ready_->prev_ready_ = pdispatcher->prev_ready_;
+  } else {
+    ready_tail_ = pdispatcher->prev_ready_;
+  }
+  pdispatcher->prev_ready_ = nullptr;
+  pdispatcher->next_ready_ = nullptr;
+  --ready_count_;
+}
+
 bool PhysicalSocketServer::WaitPoll(int cmsWait, Dispatcher* dispatcher) {
   RTC_DCHECK(dispatcher);
   int64_t tvWait = -1;
@@ -59,12 +59,33 @@ class Dispatcher {
   virtual int GetDescriptor() = 0;
   virtual bool IsDescriptorClosed() = 0;
 #endif
+
+#if defined(WEBRTC_USE_EPOLL)
+ private:
+  friend class PhysicalSocketServer;
+
+  // Kept by an edge-triggered PhysicalSocketServer, under its lock: whether
+  // the dispatcher is added to it, the events (DE_READ, DE_WRITE) the
+  // descriptor may be ready for, and DE_CLOSE once the peer has hung up, and
+  // the links of the server's list of dispatchers that may be ready for
+  // events they request.
+  bool edge_triggered_ = false;
+  uint8_t ready_events_ = 0;
+  bool in_ready_list_ = false;
+  Dispatcher* prev_ready_ = nullptr;
+  Dispatcher* next_ready_ = nullptr;
+#endif
 };
 
 // A socket server that provides the real sockets of the underlying OS.
 class RTC_EXPORT PhysicalSocketServer : public SocketServer {
  public:
   PhysicalSocketServer();
+  // Where epoll is used and |edge_triggered| is set, descriptors are
+  // registered once for all events, edge triggered, rather than again each
+  // time the events a dispatcher requests change, and the server keeps the
+  // dispatchers that may still be ready for more in a list.
+  explicit PhysicalSocketServer(bool edge_triggered);
   ~PhysicalSocketServer() override;
 
   // SocketFactory:
@@ -81,6 +102,10 @@ class RTC_EXPORT PhysicalSocketServer : public SocketServer {
   void Add(Dispatcher* dispatcher);
   void Remove(Dispatcher* dispatcher);
   void Update(Dispatcher* dispatcher);
+  // Whether the descriptor of |dispatcher| may still be ready for |events|
+  // (DE_READ or DE_WRITE), since reading or writing didn't block. Only used
+  // when edge triggered.
+  void SetReady(Dispatcher* dispatcher, uint8_t events, bool ready);
 
  private:
   // The number of events to process with one call to "epoll_wait".
@@ -95,6 +120,11 @@ class RTC_EXPORT PhysicalSocketServer : public SocketServer {
   void UpdateEpoll(Dispatcher* dispatcher, uint64_t key);
   bool WaitEpoll(int cms);
   bool WaitPoll(int cms, Dispatcher* dispatcher);
+  void ProcessEdgeTriggeredEvents(int num_events);
+  void DispatchReadyEvents(Dispatcher* dispatcher, bool check_error);
+  void LinkReady(Dispatcher* dispatcher);
+  void MaybeLinkReady(Dispatcher* dispatcher);
+  void UnlinkReady(Dispatcher* dispatcher);
 
   // This array is accessed in isolation by a thread calling into Wait().
   // It's useless to use a SequenceChecker to guard it because a socket
@@ -102,6 +132,12 @@ class RTC_EXPORT PhysicalSocketServer : public SocketServer {
   // to have to reset the sequence checker on Wait calls.
   std::array<epoll_event, kNumEpollEvents> epoll_events_;
   const int epoll_fd_ = INVALID_SOCKET;
+  const bool edge_triggered_;
+  // The dispatchers that may be ready for events they request, in the order
+  // they became ready.
+  Dispatcher* ready_head_ RTC_GUARDED_BY(crit_) = nullptr;
+  Dispatcher* ready_tail_ RTC_GUARDED_BY(crit_) = nullptr;
+  size_t ready_count_ RTC_GUARDED_BY(crit_) = 0;
 #endif  // WEBRTC_USE_EPOLL
   // uint64_t keys are used to uniquely identify a dispatcher in order to avoid
   // the ABA problem during the epoll loop (a dispatcher being destroyed and
@@ -163,6 +199,12 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
                SocketAddress* out_addr,
                int64_t* timestamp) override;
 
+  // On Linux, UDP sockets receive and send the datagrams with recvmmsg and
+  // sendmmsg, and send consecutive datagrams of the same size to the same
+  // address as one with UDP GSO where the kernel supports it.
+  int RecvFromBatch(ArrayView<IncomingDatagram> datagrams) override;
+  int SendToBatch(ArrayView<const OutgoingDatagram> datagrams) override;
+
   int Listen(int backlog) override;
   AsyncSocket* Accept(SocketAddress* out_addr) override;
 
@@ -196,6 +238,9 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
   virtual void SetEnabledEvents(uint8_t events);
   virtual void EnableEvents(uint8_t events);
   virtual void DisableEvents(uint8_t events);
+  // Called after reading (DE_READ) or writing (DE_WRITE) with whether the
+  // descriptor may still be ready for more, i.e. whether it didn't block.
+  virtual void SetReady(uint8_t events, bool ready) {}
 
   int TranslateOption(Option opt, int* slevel, int* sopt);
 
@@ -214,6 +259,11 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
 
  private:
   uint8_t enabled_events_ = 0;
+  // Whether SO_TIMESTAMP is set, for RecvFromBatch.
+  bool receive_timestamps_ = false;
+  // Whether the kernel supports UDP GSO, checked by the first SendToBatch.
+  bool udp_gso_checked_ = false;
+  bool udp_gso_ = false;
 };
 
 class SocketDispatcher : public Dispatcher, public PhysicalSocket {
@@ -249,6 +299,7 @@ class SocketDispatcher : public Dispatcher, public PhysicalSocket {
   void SetEnabledEvents(uint8_t events) override;
   void EnableEvents(uint8_t events) override;
   void DisableEvents(uint8_t events) override;
+  void SetReady(uint8_t events, bool ready) override;
 #endif
 
  private:
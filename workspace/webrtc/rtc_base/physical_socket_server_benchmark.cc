@@ -0,0 +1,123 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "rtc_base/async_socket.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/physical_socket_server.h"
+#include "rtc_base/socket_address.h"
+#include "rtc_base/system/unused.h"
+
+namespace rtc {
+namespace {
+
+// As many packets of an audio packet's size as a busy server reads at once.
+constexpr int kPacketsPerRound = 64;
+constexpr size_t kPacketSize = 160;
+constexpr size_t kBufferSize = 64 * 1024;
+
+enum Mode { kOneByOne = 0, kBatched = 1, kBatchedWithGro = 2 };
+
+std::unique_ptr<AsyncSocket> CreateBoundSocket(SocketServer* ss) {
+  std::unique_ptr<AsyncSocket> socket(
+      ss->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  RTC_CHECK(socket);
+  RTC_CHECK_EQ(socket->Bind(SocketAddress("127.0.0.1", 0)), 0);
+  return socket;
+}
+
+// Sends kPacketsPerRound packets over loopback and reads them, one by one with
+// SendTo and RecvFrom (0), with SendToBatch and RecvFromBatch (1), or with
+// them and UDP GRO (2). SendToBatch uses UDP GSO where the kernel has it.
+void BM_UdpLoopback(benchmark::State& state) {
+  const Mode mode = static_cast<Mode>(state.range(0));
+  PhysicalSocketServer ss;
+  std::unique_ptr<AsyncSocket> sender = CreateBoundSocket(&ss);
+  std::unique_ptr<AsyncSocket> receiver = CreateBoundSocket(&ss);
+  const SocketAddress address = receiver->GetLocalAddress();
+  if (mode == kBatchedWithGro && receiver->SetOption(Socket::OPT_UDP_GRO, 1)) {
+    state.SkipWithError("UDP GRO is not supported");
+    return;
+  }
+
+  const std::vector<char> payload(kPacketSize, 'x');
+  std::vector<OutgoingDatagram> outgoing(kPacketsPerRound);
+  for (OutgoingDatagram& datagram : outgoing) {
+    datagram.data = payload.data();
+    datagram.size = payload.size();
+    datagram.address = address;
+  }
+  std::vector<char> buffer(kPacketsPerRound * kBufferSize);
+  std::vector<IncomingDatagram> incoming(kPacketsPerRound);
+  for (int i = 0; i < kPacketsPerRound; ++i) {
+    incoming[i].data = &buffer[i * kBufferSize];
+    incoming[i].capacity = kBufferSize;
+  }
+
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    int received = 0;
+    if (mode == kOneByOne) {
+      for (const OutgoingDatagram& datagram : outgoing) {
+        sender->SendTo(datagram.data, datagram.size, datagram.address);
+      }
+      SocketAddress from;
+      int64_t timestamp;
+      while (received < kPacketsPerRound &&
+             receiver->RecvFrom(buffer.data(), kBufferSize, &from,
+                                &timestamp) > 0) {
+        ++received;
+      }
+    } else {
+      RTC_CHECK_EQ(sender->SendToBatch(outgoing), kPacketsPerRound);
+      int count;
+      while (received < kPacketsPerRound &&
+             (count = receiver->RecvFromBatch(incoming)) > 0) {
+        for (int i = 0; i < count; ++i) {
+          const IncomingDatagram& datagram = incoming[i];
+          received += datagram.segment_size
+                          ? (datagram.size + datagram.segment_size - 1) /
+                                datagram.segment_size
+                          : 1;
+        }
+      }
+    }
+    RTC_CHECK_EQ(received, kPacketsPerRound);
+  }
+  state.SetItemsProcessed(state.iterations() * kPacketsPerRound);
+}
+
+BENCHMARK(BM_UdpLoopback)
+    ->Arg(kOneByOne)
+    ->Arg(kBatched)
+    ->Arg(kBatchedWithGro)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace rtc
+
+/*
+
+Results (Linux, a single x86-64 core):
+
+---------------------------------------------------------------------------
+Benchmark                 Time             CPU   Iterations UserCounters...
+---------------------------------------------------------------------------
+BM_UdpLoopback/0        234 us          229 us         2642 items_per_second=279.018k/s
+BM_UdpLoopback/1       73.1 us         71.8 us        13108 items_per_second=891.518k/s
+BM_UdpLoopback/2       8.97 us         8.88 us        79035 items_per_second=7.20658M/s
+
+With GSO the 64 packets are sent in one datagram, which the loopback device
+hands to the receiver as one datagram with GRO, or as 64 without.
+
+*/
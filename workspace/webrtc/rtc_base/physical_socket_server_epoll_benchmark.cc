@@ -0,0 +1,265 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "rtc_base/async_socket.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/ip_address.h"
+#include "rtc_base/physical_socket_server.h"
+#include "rtc_base/socket_address.h"
+#include "rtc_base/system/unused.h"
+#include "rtc_base/third_party/sigslot/sigslot.h"
+
+namespace {
+
+std::atomic<int64_t> g_epoll_ctl_calls{0};
+
+}  // namespace
+
+// Counts the calls of the socket server, which calls this rather than the
+// epoll_ctl of the C library.
+extern "C" int epoll_ctl(int epfd, int op, int fd, epoll_event* event) __THROW {
+  g_epoll_ctl_calls.fetch_add(1, std::memory_order_relaxed);
+  return static_cast<int>(syscall(SYS_epoll_ctl, epfd, op, fd, event));
+}
+
+namespace rtc {
+namespace {
+
+// Requests that as many connections get at once, and the responses they get,
+// which take several writes since they are sent from and received into small
+// buffers.
+constexpr int kActiveConnections = 1000;
+constexpr size_t kRequestSize = 100;
+constexpr size_t kResponseSize = 16 * 1024;
+constexpr int kBufferSize = 4 * 1024;
+// The clients are bound to several loopback addresses, since there are fewer
+// ephemeral ports than connections.
+constexpr int kClientAddresses = 8;
+
+class Connection : public sigslot::has_slots<> {
+ public:
+  Connection(std::unique_ptr<AsyncSocket> client, int* num_connected)
+      : client_(std::move(client)), num_connected_(num_connected) {
+    client_->SignalConnectEvent.connect(this, &Connection::OnConnect);
+    client_->SignalReadEvent.connect(this, &Connection::OnClientRead);
+  }
+
+  void Accept(std::unique_ptr<AsyncSocket> server) {
+    server_ = std::move(server);
+    RTC_CHECK_EQ(server_->SetOption(Socket::OPT_SNDBUF, kBufferSize), 0);
+    server_->SignalReadEvent.connect(this, &Connection::OnServerRead);
+    server_->SignalWriteEvent.connect(this, &Connection::OnServerWrite);
+  }
+
+  // Sends a request, and counts |num_responses| up when the response has been
+  // received.
+  void Request(int* num_responses) {
+    static const std::string request(kRequestSize, 'q');
+    num_responses_ = num_responses;
+    RTC_CHECK_EQ(client_->Send(request.data(), request.size()),
+                 static_cast<int>(request.size()));
+  }
+
+ private:
+  void OnConnect(AsyncSocket* socket) { ++*num_connected_; }
+
+  void OnServerRead(AsyncSocket* socket) {
+    char buffer[kRequestSize];
+    int received = server_->Recv(buffer, sizeof(buffer), nullptr);
+    if (received <= 0)
+      return;
+    request_received_ += received;
+    if (request_received_ == kRequestSize) {
+      request_received_ = 0;
+      response_remaining_ = kResponseSize;
+      OnServerWrite(server_.get());
+    }
+  }
+
+  void OnServerWrite(AsyncSocket* socket) {
+    static const std::string response(kResponseSize, 'r');
+    while (response_remaining_ > 0) {
+      int sent = server_->Send(
+          response.data() + kResponseSize - response_remaining_,
+          response_remaining_);
+      if (sent <= 0)
+        return;
+      response_remaining_ -= sent;
+    }
+  }
+
+  void OnClientRead(AsyncSocket* socket) {
+    char buffer[kBufferSize];
+    int received = client_->Recv(buffer, sizeof(buffer), nullptr);
+    if (received <= 0)
+      return;
+    response_received_ += received;
+    if (response_received_ == kResponseSize) {
+      response_received_ = 0;
+      ++*num_responses_;
+    }
+  }
+
+  const std::unique_ptr<AsyncSocket> client_;
+  std::unique_ptr<AsyncSocket> server_;
+  int* const num_connected_;
+  int* num_responses_ = nullptr;
+  size_t request_received_ = 0;
+  size_t response_remaining_ = 0;
+  size_t response_received_ = 0;
+};
+
+class Listener : public sigslot::has_slots<> {
+ public:
+  Listener(SocketServer* ss, std::vector<std::unique_ptr<Connection>>* pending)
+      : socket_(ss->CreateAsyncSocket(AF_INET, SOCK_STREAM)),
+        pending_(pending) {
+    RTC_CHECK_EQ(socket_->Bind(SocketAddress("127.0.0.1", 0)), 0);
+    RTC_CHECK_EQ(socket_->Listen(SOMAXCONN), 0);
+    socket_->SignalReadEvent.connect(this, &Listener::OnAccept);
+  }
+
+  SocketAddress address() const { return socket_->GetLocalAddress(); }
+  int num_accepted() const { return num_accepted_; }
+
+ private:
+  // An accepted socket needn't go with the connection of its peer, since each
+  // side only handles its own socket.
+  void OnAccept(AsyncSocket* socket) {
+    std::unique_ptr<AsyncSocket> server(socket_->Accept(nullptr));
+    if (server)
+      (*pending_)[num_accepted_++]->Accept(std::move(server));
+  }
+
+  const std::unique_ptr<AsyncSocket> socket_;
+  std::vector<std::unique_ptr<Connection>>* const pending_;
+  int num_accepted_ = 0;
+};
+
+bool RaiseFileDescriptorLimit(rlim_t needed) {
+  rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+    return false;
+  if (limit.rlim_cur >= needed)
+    return true;
+  limit.rlim_cur = std::min(limit.rlim_max, needed);
+  return setrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur >= needed;
+}
+
+// Exchanges requests and responses over kActiveConnections of
+// |state.range(0)| loopback connections at a time, with a level-triggered (0)
+// or edge-triggered (1) socket server. Reports the epoll_ctl calls per
+// connection made, and per request.
+void BM_EpollConnections(benchmark::State& state) {
+  const int num_connections = state.range(0);
+  if (!RaiseFileDescriptorLimit(2 * num_connections + 64)) {
+    state.SkipWithError("Too few file descriptors");
+    return;
+  }
+  PhysicalSocketServer ss(/*edge_triggered=*/state.range(1));
+  std::vector<std::unique_ptr<Connection>> connections;
+  connections.reserve(num_connections);
+  Listener listener(&ss, &connections);
+
+  const int64_t setup_epoll_ctl_calls = g_epoll_ctl_calls.load();
+  int num_connected = 0;
+  while (static_cast<int>(connections.size()) < num_connections) {
+    // No more connections at a time than the listener has backlog for.
+    const int batch_end =
+        std::min<int>(num_connections, connections.size() + 1000);
+    while (static_cast<int>(connections.size()) < batch_end) {
+      std::unique_ptr<AsyncSocket> client(
+          ss.CreateAsyncSocket(AF_INET, SOCK_STREAM));
+      RTC_CHECK(client);
+      RTC_CHECK_EQ(client->SetOption(Socket::OPT_RCVBUF, kBufferSize), 0);
+      IPAddress ip(INADDR_LOOPBACK + 1 + connections.size() % kClientAddresses);
+      RTC_CHECK_EQ(client->Bind(SocketAddress(ip, 0)), 0);
+      RTC_CHECK_EQ(client->Connect(listener.address()), 0);
+      connections.push_back(
+          std::make_unique<Connection>(std::move(client), &num_connected));
+    }
+    while (listener.num_accepted() < batch_end || num_connected < batch_end) {
+      ss.Wait(0, /*process_io=*/true);
+    }
+  }
+  state.counters["setup_epoll_ctl"] = benchmark::Counter(
+      static_cast<double>(g_epoll_ctl_calls.load() - setup_epoll_ctl_calls) /
+      num_connections);
+
+  const int64_t epoll_ctl_calls = g_epoll_ctl_calls.load();
+  int next = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    int num_responses = 0;
+    for (int i = 0; i < kActiveConnections; ++i) {
+      connections[next]->Request(&num_responses);
+      next = (next + 1) % num_connections;
+    }
+    while (num_responses < kActiveConnections) {
+      ss.Wait(0, /*process_io=*/true);
+    }
+  }
+  const int64_t num_requests = state.iterations() * kActiveConnections;
+  state.counters["epoll_ctl"] = benchmark::Counter(
+      static_cast<double>(g_epoll_ctl_calls.load() - epoll_ctl_calls) /
+      num_requests);
+  state.SetItemsProcessed(num_requests);
+}
+
+BENCHMARK(BM_EpollConnections)
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Args({9000, 0})
+    ->Args({9000, 1})
+    ->Args({10000, 0})
+    ->Args({10000, 1})
+    ->Args({50000, 0})
+    ->Args({50000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace rtc
+
+/*
+
+Results (Linux, a single x86-64 core, at most 20000 file descriptors):
+
+--------------------------------------------------------------------------------------
+Benchmark                            Time             CPU   Iterations UserCounters...
+--------------------------------------------------------------------------------------
+BM_EpollConnections/1000/0         118 ms          109 ms           12 epoll_ctl=1.99992 items_per_second=9.21547k/s setup_epoll_ctl=4.999
+BM_EpollConnections/1000/1         107 ms          102 ms           12 epoll_ctl=0 items_per_second=9.79793k/s setup_epoll_ctl=2
+BM_EpollConnections/9000/0         113 ms          101 ms            7 epoll_ctl=2.00014 items_per_second=9.86269k/s setup_epoll_ctl=4.99989
+BM_EpollConnections/9000/1         103 ms         98.7 ms            7 epoll_ctl=0 items_per_second=10.1296k/s setup_epoll_ctl=2
+BM_EpollConnections/10000/0 ERROR OCCURRED: 'Too few file descriptors'
+BM_EpollConnections/10000/1 ERROR OCCURRED: 'Too few file descriptors'
+BM_EpollConnections/50000/0 ERROR OCCURRED: 'Too few file descriptors'
+BM_EpollConnections/50000/1 ERROR OCCURRED: 'Too few file descriptors'
+
+Level triggered, a connection takes two EPOLL_CTL_ADDs and three
+EPOLL_CTL_MODs to set up, and each response that fills the send buffer two
+EPOLL_CTL_MODs. Edge triggered, only the EPOLL_CTL_ADDs are left, at the cost
+of a read that would block after each socket is drained. Both look the
+dispatcher of each event up by its key. The times vary by
+about 20% between runs on this machine.
+
+*/
@@ -14,6 +14,8 @@
 
 #include <algorithm>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "rtc_base/gunit.h"
 #include "rtc_base/ip_address.h"
@@ -123,6 +125,7 @@ class PhysicalSocketTest : public SocketTest {
 
   void ConnectInternalAcceptError(const IPAddress& loopback);
   void WritableAfterPartialWrite(const IPAddress& loopback);
+  void UdpBatch(const IPAddress& loopback, bool udp_gro);
 
   std::unique_ptr<FakePhysicalSocketServer> server_;
   rtc::AutoSocketServerThread thread_;
@@ -457,6 +460,124 @@ TEST_F(PhysicalSocketTest, TestGetSetOptionsIPv6) {
   SocketTest::TestGetSetOptionsIPv6();
 }
 
+void PhysicalSocketTest::UdpBatch(const IPAddress& loopback, bool udp_gro) {
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(loopback.family(), SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(loopback.family(), SOCK_DGRAM));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(loopback, 0)));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(loopback, 0)));
+  if (udp_gro && receiver->SetOption(Socket::OPT_UDP_GRO, 1) != 0) {
+    RTC_LOG(LS_INFO) << "No UDP GRO... skipping";
+    return;
+  }
+
+  // Datagrams of the same size, which may be sent as one with UDP GSO, but
+  // for the last that is shorter, and one to another address.
+  const size_t kNumDatagrams = 10;
+  std::vector<std::string> payloads;
+  std::vector<OutgoingDatagram> datagrams(kNumDatagrams + 1);
+  for (size_t i = 0; i < kNumDatagrams; ++i) {
+    payloads.push_back(std::string(i + 1 < kNumDatagrams ? 100 : 50, 'a' + i));
+    datagrams[i].data = payloads[i].data();
+    datagrams[i].size = payloads[i].size();
+    datagrams[i].address = receiver->GetLocalAddress();
+  }
+  datagrams[kNumDatagrams].data = "x";
+  datagrams[kNumDatagrams].size = 1;
+  datagrams[kNumDatagrams].address = sender->GetLocalAddress();
+  EXPECT_EQ(static_cast<int>(kNumDatagrams + 1),
+            sender->SendToBatch(datagrams));
+
+  const size_t kBufferSize = 64 * 1024;
+  std::vector<char> buffer(kNumDatagrams * kBufferSize);
+  std::vector<IncomingDatagram> incoming(kNumDatagrams);
+  for (size_t i = 0; i < kNumDatagrams; ++i) {
+    incoming[i].data = &buffer[i * kBufferSize];
+    incoming[i].capacity = kBufferSize;
+  }
+  std::vector<std::string> received;
+  while (received.size() < kNumDatagrams) {
+    int result = receiver->RecvFromBatch(incoming);
+    ASSERT_GT(result, 0);
+    for (int i = 0; i < result; ++i) {
+      EXPECT_EQ(sender->GetLocalAddress(), incoming[i].address);
+#if defined(WEBRTC_POSIX) && !defined(WEBRTC_MAC)
+      EXPECT_GT(incoming[i].timestamp, 0);
+#endif
+      const char* data = static_cast<const char*>(incoming[i].data);
+      const size_t segment_size = incoming[i].segment_size > 0
+                                      ? incoming[i].segment_size
+                                      : incoming[i].size;
+      for (size_t offset = 0; offset < incoming[i].size;
+           offset += segment_size) {
+        received.emplace_back(
+            data + offset, std::min(segment_size, incoming[i].size - offset));
+      }
+    }
+  }
+  EXPECT_EQ(payloads, received);
+  EXPECT_EQ(-1, receiver->RecvFromBatch(incoming));
+  EXPECT_TRUE(receiver->IsBlocking());
+
+  char single[1];
+  EXPECT_EQ(1, sender->RecvFrom(single, sizeof(single), nullptr, nullptr));
+}
+
+TEST_F(PhysicalSocketTest, TestUdpBatchIPv4) {
+  MAYBE_SKIP_IPV4;
+  UdpBatch(kIPv4Loopback, /*udp_gro=*/false);
+}
+
+TEST_F(PhysicalSocketTest, TestUdpBatchIPv6) {
+  MAYBE_SKIP_IPV6;
+  UdpBatch(kIPv6Loopback, /*udp_gro=*/false);
+}
+
+TEST_F(PhysicalSocketTest, TestUdpBatchWithGroIPv4) {
+  MAYBE_SKIP_IPV4;
+  UdpBatch(kIPv4Loopback, /*udp_gro=*/true);
+}
+
+TEST_F(PhysicalSocketTest, TestUdpBatchWithGroIPv6) {
+  MAYBE_SKIP_IPV6;
+  UdpBatch(kIPv6Loopback, /*udp_gro=*/true);
+}
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+// A datagram that is larger than its buffer is reported as truncated.
+TEST_F(PhysicalSocketTest, TestUdpBatchTruncatedIPv4) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  const std::string small(100, 's');
+  const std::string large(6000, 'l');
+  ASSERT_EQ(static_cast<int>(small.size()),
+            sender->SendTo(small.data(), small.size(),
+                           receiver->GetLocalAddress()));
+  ASSERT_EQ(static_cast<int>(large.size()),
+            sender->SendTo(large.data(), large.size(),
+                           receiver->GetLocalAddress()));
+
+  const size_t kBufferSize = 4096;
+  std::vector<char> buffer(2 * kBufferSize);
+  std::vector<IncomingDatagram> incoming(2);
+  for (size_t i = 0; i < incoming.size(); ++i) {
+    incoming[i].data = &buffer[i * kBufferSize];
+    incoming[i].capacity = kBufferSize;
+  }
+  ASSERT_EQ(2, receiver->RecvFromBatch(incoming));
+  EXPECT_FALSE(incoming[0].truncated);
+  EXPECT_EQ(small.size(), incoming[0].size);
+  EXPECT_TRUE(incoming[1].truncated);
+  EXPECT_EQ(kBufferSize, incoming[1].size);
+}
+#endif
+
 #if defined(WEBRTC_POSIX)
 
 // We don't get recv timestamps on Mac.
@@ -513,4 +634,137 @@ TEST_F(PhysicalSocketTest,
 
 #endif
 
+#if defined(WEBRTC_USE_EPOLL)
+
+class EdgeTriggeredPhysicalSocketTest : public SocketTest {
+ protected:
+  EdgeTriggeredPhysicalSocketTest()
+      : server_(/*edge_triggered=*/true), thread_(&server_) {}
+
+  PhysicalSocketServer server_;
+  rtc::AutoSocketServerThread thread_;
+};
+
+// Reads |read_size| bytes for each read event.
+class ChunkReader : public sigslot::has_slots<> {
+ public:
+  explicit ChunkReader(size_t read_size) : read_size_(read_size) {}
+
+  void OnReadEvent(AsyncSocket* socket) {
+    char buffer[64];
+    int received = socket->Recv(buffer, std::min(read_size_, sizeof(buffer)),
+                                nullptr);
+    if (received > 0) {
+      ++num_reads;
+      data.append(buffer, received);
+    }
+  }
+
+  int num_reads = 0;
+  std::string data;
+
+ private:
+  const size_t read_size_;
+};
+
+TEST_F(EdgeTriggeredPhysicalSocketTest, TestConnectIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestConnectIPv4();
+}
+
+TEST_F(EdgeTriggeredPhysicalSocketTest, TestConnectFailIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestConnectFailIPv4();
+}
+
+TEST_F(EdgeTriggeredPhysicalSocketTest, TestServerCloseIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestServerCloseIPv4();
+}
+
+TEST_F(EdgeTriggeredPhysicalSocketTest, TestCloseInClosedCallbackIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestCloseInClosedCallbackIPv4();
+}
+
+TEST_F(EdgeTriggeredPhysicalSocketTest, TestDeleteInReadCallbackIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestDeleteInReadCallbackIPv4();
+}
+
+TEST_F(EdgeTriggeredPhysicalSocketTest, TestSocketServerWaitIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestSocketServerWaitIPv4();
+}
+
+TEST_F(EdgeTriggeredPhysicalSocketTest, TestTcpIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestTcpIPv4();
+}
+
+TEST_F(EdgeTriggeredPhysicalSocketTest, TestSingleFlowControlCallbackIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestSingleFlowControlCallbackIPv4();
+}
+
+TEST_F(EdgeTriggeredPhysicalSocketTest, TestUdpIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestUdpIPv4();
+}
+
+TEST_F(EdgeTriggeredPhysicalSocketTest, TestUdpReadyToSendIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestUdpReadyToSendIPv4();
+}
+
+// The datagrams that arrive together are signalled with one edge, but each is
+// read with a read event of its own.
+TEST_F(EdgeTriggeredPhysicalSocketTest, ReadsDatagramsThatArrivedTogether) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> sender(
+      server_.CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> receiver(
+      server_.CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ChunkReader reader(/*read_size=*/64);
+  receiver->SignalReadEvent.connect(&reader, &ChunkReader::OnReadEvent);
+
+  const std::string kDatagrams[] = {"a", "b", "c", "d", "e"};
+  for (const std::string& datagram : kDatagrams) {
+    ASSERT_EQ(1, sender->SendTo(datagram.data(), datagram.size(),
+                                receiver->GetLocalAddress()));
+  }
+  EXPECT_EQ_WAIT("abcde", reader.data, kTimeout);
+  EXPECT_EQ(5, reader.num_reads);
+}
+
+// A stream that is read in chunks smaller than what has arrived is read to
+// the end, without another edge.
+TEST_F(EdgeTriggeredPhysicalSocketTest, ReadsStreamInChunks) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> server(
+      server_.CreateAsyncSocket(AF_INET, SOCK_STREAM));
+  std::unique_ptr<AsyncSocket> client(
+      server_.CreateAsyncSocket(AF_INET, SOCK_STREAM));
+  ASSERT_EQ(0, server->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, server->Listen(5));
+  ASSERT_EQ(0, client->Connect(server->GetLocalAddress()));
+  EXPECT_EQ_WAIT(AsyncSocket::CS_CONNECTED, client->GetState(), kTimeout);
+  AsyncSocket* accepted_socket = nullptr;
+  EXPECT_TRUE_WAIT((accepted_socket = server->Accept(nullptr)) != nullptr,
+                   kTimeout);
+  ASSERT_TRUE(accepted_socket);
+  std::unique_ptr<AsyncSocket> accepted(accepted_socket);
+  ChunkReader reader(/*read_size=*/10);
+  accepted->SignalReadEvent.connect(&reader, &ChunkReader::OnReadEvent);
+
+  const std::string kData(100, 'x');
+  ASSERT_EQ(100, client->Send(kData.data(), kData.size()));
+  EXPECT_EQ_WAIT(kData, reader.data, kTimeout);
+  EXPECT_EQ(10, reader.num_reads);
+}
+
+#endif  // WEBRTC_USE_EPOLL
+
 }  // namespace rtc
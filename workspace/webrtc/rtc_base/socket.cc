@@ -10,4 +10,31 @@
 
 #include "rtc_base/socket.h"
 
-namespace rtc {}  // namespace rtc
+namespace rtc {
+
+int Socket::RecvFromBatch(ArrayView<IncomingDatagram> datagrams) {
+  if (datagrams.empty())
+    return 0;
+  IncomingDatagram& datagram = datagrams[0];
+  int received = RecvFrom(datagram.data, datagram.capacity, &datagram.address,
+                          &datagram.timestamp);
+  if (received < 0)
+    return received;
+  datagram.size = received;
+  datagram.segment_size = 0;
+  datagram.truncated = false;
+  return 1;
+}
+
+int Socket::SendToBatch(ArrayView<const OutgoingDatagram> datagrams) {
+  int sent = 0;
+  for (const OutgoingDatagram& datagram : datagrams) {
+    int result = SendTo(datagram.data, datagram.size, datagram.address);
+    if (result < 0)
+      return sent > 0 ? sent : result;
+    ++sent;
+  }
+  return sent;
+}
+
+}  // namespace rtc
@@ -25,6 +25,7 @@
 #include "rtc_base/win32.h"
 #endif
 
+#include "api/array_view.h"
 #include "rtc_base/constructor_magic.h"
 #include "rtc_base/socket_address.h"
 
@@ -76,6 +77,32 @@ inline bool IsBlockingError(int e) {
   return (e == EWOULDBLOCK) || (e == EAGAIN) || (e == EINPROGRESS);
 }
 
+// A datagram for Socket::SendToBatch.
+struct OutgoingDatagram {
+  const void* data = nullptr;
+  size_t size = 0;
+  SocketAddress address;
+};
+
+// A buffer for Socket::RecvFromBatch to receive a datagram into.
+struct IncomingDatagram {
+  void* data = nullptr;
+  size_t capacity = 0;
+
+  // Set when a datagram has been received.
+  size_t size = 0;
+  // When the socket has received several datagrams from the same address into
+  // the buffer at once (see OPT_UDP_GRO), the size of each of them but the
+  // last, which may be shorter. Otherwise 0.
+  size_t segment_size = 0;
+  SocketAddress address;
+  // In microseconds, or -1 if the socket has no timestamp for the datagram.
+  int64_t timestamp = -1;
+  // Whether the datagram was larger than |capacity| and has been cut short.
+  // Only set by sockets that can tell.
+  bool truncated = false;
+};
+
 // General interface for the socket implementations of various networks.  The
 // methods match those of normal UNIX sockets very closely.
 class Socket {
@@ -100,6 +127,14 @@ class Socket {
                        size_t cb,
                        SocketAddress* paddr,
                        int64_t* timestamp) = 0;
+  // Receives up to |datagrams.size()| datagrams, with as few system calls as
+  // the socket can, and returns how many were received, or SOCKET_ERROR. By
+  // default, receives one datagram with RecvFrom.
+  virtual int RecvFromBatch(ArrayView<IncomingDatagram> datagrams);
+  // Sends the datagrams in order, with as few system calls as the socket can,
+  // and returns how many were sent, or SOCKET_ERROR if none were. By default,
+  // sends them one by one with SendTo.
+  virtual int SendToBatch(ArrayView<const OutgoingDatagram> datagrams);
   virtual int Listen(int backlog) = 0;
   virtual Socket* Accept(SocketAddress* paddr) = 0;
   virtual int Close() = 0;
@@ -120,6 +155,10 @@ class Socket {
     OPT_RTP_SENDTIME_EXTN_ID,  // This is a non-traditional socket option param.
                                // This is specific to libjingle and will be used
                                // if SendTime option is needed at socket level.
+    OPT_UDP_GRO,               // Whether RecvFromBatch may receive datagrams
+                               // from the same address into one buffer, which
+                               // should then hold 64 KiB. Only for sockets
+                               // that are read with RecvFromBatch.
   };
   virtual int GetOption(Option opt, int* value) = 0;
   virtual int SetOption(Option opt, int value) = 0;
@@ -0,0 +1,123 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_SYNCHRONIZATION_MPSC_QUEUE_H_
+#define RTC_BASE_SYNCHRONIZATION_MPSC_QUEUE_H_
+
+#include <atomic>
+
+namespace webrtc {
+
+// Link for an element of an MpscQueue. Elements derive from it.
+class MpscQueueNode {
+ public:
+  MpscQueueNode() = default;
+  MpscQueueNode(const MpscQueueNode&) = delete;
+  MpscQueueNode& operator=(const MpscQueueNode&) = delete;
+
+ private:
+  template <typename T>
+  friend class MpscQueue;
+
+  std::atomic<MpscQueueNode*> mpsc_next_{nullptr};
+};
+
+// An intrusive, unbounded, lock-free queue for many producers and a single
+// consumer (D. Vyukov's). Push() is wait-free, a single atomic exchange, and
+// never allocates, since the link lives in the element. Elements are of type
+// T, which derives from MpscQueueNode; the queue doesn't own them.
+//
+// Push() also tells the producer whether the consumer has to be woken up, so
+// that a consumer that is busy, or already woken up, isn't woken up again for
+// every element. The consumer calls PrepareToPop() before it pops the queue
+// empty, and the next Push() after that returns true.
+//
+// Pop(), PushInProgress() and PrepareToPop() must not be called concurrently,
+// but needn't all be called on the same thread.
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(&stub_), tail_(&stub_) {}
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  // Adds |element| last. Returns true if the consumer needs to be woken up,
+  // that is, if the consumer has called PrepareToPop() since the last time
+  // Push() returned true.
+  bool Push(T* element) {
+    Link(element);
+    return !wake_up_pending_.exchange(true, std::memory_order_acq_rel);
+  }
+
+  // Called by the consumer before it pops elements, to be woken up for
+  // elements that it doesn't see.
+  void PrepareToPop() {
+    wake_up_pending_.exchange(false, std::memory_order_acq_rel);
+  }
+
+  // Removes and returns the first element, or null if there is none. It can
+  // also return null while a Push() is in progress, in which case that Push()
+  // returns true if PrepareToPop() was called before.
+  T* Pop() {
+    MpscQueueNode* tail = tail_;
+    MpscQueueNode* next = tail->mpsc_next_.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (!next)
+        return nullptr;
+      tail_ = next;
+      tail = next;
+      next = next->mpsc_next_.load(std::memory_order_acquire);
+    }
+    if (next) {
+      tail_ = next;
+      return static_cast<T*>(tail);
+    }
+    // |tail| is the only element, unless a producer is about to link another
+    // one after it. Put the stub back behind it, so that it can be taken
+    // without leaving the queue without a node.
+    if (tail != head_.load(std::memory_order_acquire))
+      return nullptr;
+    Link(&stub_);
+    next = tail->mpsc_next_.load(std::memory_order_acquire);
+    if (next) {
+      tail_ = next;
+      return static_cast<T*>(tail);
+    }
+    return nullptr;
+  }
+
+  // Called by the consumer after Pop() returned null. Returns true if that
+  // was because a Push() is in progress, rather than because the queue is
+  // empty, in which case an element that another producer has pushed since
+  // can be stuck behind it until it completes.
+  bool PushInProgress() const {
+    return head_.load(std::memory_order_acquire) != tail_;
+  }
+
+ private:
+  void Link(MpscQueueNode* node) {
+    node->mpsc_next_.store(nullptr, std::memory_order_relaxed);
+    MpscQueueNode* prev = head_.exchange(node, std::memory_order_acq_rel);
+    // Until this store, the consumer sees the queue end at |prev|.
+    prev->mpsc_next_.store(node, std::memory_order_release);
+  }
+
+  // The last node, where producers link new elements.
+  std::atomic<MpscQueueNode*> head_;
+  // The first node, where the consumer takes elements. Only accessed by the
+  // consumer.
+  MpscQueueNode* tail_;
+  MpscQueueNode stub_;
+  std::atomic<bool> wake_up_pending_{false};
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_SYNCHRONIZATION_MPSC_QUEUE_H_
@@ -0,0 +1,129 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/synchronization/mpsc_queue.h"
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+struct Element : public MpscQueueNode {
+  Element(int producer, int sequence)
+      : producer(producer), sequence(sequence) {}
+
+  const int producer;
+  const int sequence;
+};
+
+TEST(MpscQueueTest, PopsInPushOrder) {
+  MpscQueue<Element> queue;
+  EXPECT_EQ(queue.Pop(), nullptr);
+  Element first(0, 1);
+  Element second(0, 2);
+  Element third(0, 3);
+  queue.Push(&first);
+  queue.Push(&second);
+  EXPECT_EQ(queue.Pop(), &first);
+  queue.Push(&third);
+  EXPECT_EQ(queue.Pop(), &second);
+  EXPECT_EQ(queue.Pop(), &third);
+  EXPECT_EQ(queue.Pop(), nullptr);
+
+  // Elements can be pushed again once popped.
+  queue.Push(&first);
+  EXPECT_EQ(queue.Pop(), &first);
+  EXPECT_EQ(queue.Pop(), nullptr);
+}
+
+TEST(MpscQueueTest, AsksForOneWakeUpPerPrepareToPop) {
+  MpscQueue<Element> queue;
+  Element first(0, 1);
+  Element second(0, 2);
+  Element third(0, 3);
+  EXPECT_TRUE(queue.Push(&first));
+  EXPECT_FALSE(queue.Push(&second));
+  EXPECT_EQ(queue.Pop(), &first);
+  EXPECT_EQ(queue.Pop(), &second);
+  EXPECT_FALSE(queue.Push(&third));
+  queue.PrepareToPop();
+  EXPECT_EQ(queue.Pop(), &third);
+  EXPECT_TRUE(queue.Push(&first));
+  EXPECT_FALSE(queue.Push(&second));
+}
+
+struct ProducerContext {
+  MpscQueue<Element>* queue;
+  rtc::Event* wake_up;
+  int producer;
+  int count;
+  std::vector<std::unique_ptr<Element>> elements;
+};
+
+void Produce(void* context) {
+  ProducerContext* producer = static_cast<ProducerContext*>(context);
+  for (auto& element : producer->elements) {
+    if (producer->queue->Push(element.get()))
+      producer->wake_up->Set();
+  }
+}
+
+// Several producers push while the consumer pops, and sleeps only when it
+// has been told that it will be woken up. Checks that nothing is lost, that
+// each producer's elements keep their order, and that the consumer doesn't
+// sleep through an element.
+TEST(MpscQueueTest, ManyProducersOneConsumer) {
+  constexpr int kNumProducers = 4;
+  constexpr int kElementsPerProducer = 100000;
+  MpscQueue<Element> queue;
+  rtc::Event wake_up;
+  std::vector<ProducerContext> contexts(kNumProducers);
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < kNumProducers; ++i) {
+    contexts[i].queue = &queue;
+    contexts[i].wake_up = &wake_up;
+    for (int j = 0; j < kElementsPerProducer; ++j)
+      contexts[i].elements.push_back(std::make_unique<Element>(i, j));
+    threads.push_back(
+        std::make_unique<rtc::PlatformThread>(&Produce, &contexts[i], "P"));
+  }
+  for (auto& thread : threads)
+    thread->Start();
+
+  std::vector<int> next(kNumProducers, 0);
+  int remaining = kNumProducers * kElementsPerProducer;
+  int out_of_order = 0;
+  while (remaining > 0) {
+    Element* element = queue.Pop();
+    if (!element) {
+      queue.PrepareToPop();
+      element = queue.Pop();
+      if (!element) {
+        ASSERT_TRUE(wake_up.Wait(10000)) << remaining << " left";
+        continue;
+      }
+    }
+    if (element->sequence != next[element->producer]++)
+      ++out_of_order;
+    --remaining;
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  EXPECT_EQ(out_of_order, 0);
+  EXPECT_EQ(queue.Pop(), nullptr);
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -20,6 +20,8 @@
 
 #if defined(WEBRTC_ABSL_MUTEX)
 #include "rtc_base/synchronization/mutex_abseil.h"  // nogncheck
+#elif defined(WEBRTC_ADAPTIVE_MUTEX)
+#include "rtc_base/synchronization/mutex_adaptive.h"
 #elif defined(WEBRTC_WIN)
 #include "rtc_base/synchronization/mutex_critical_section.h"
 #elif defined(WEBRTC_POSIX)
@@ -30,6 +32,10 @@
 
 namespace webrtc {
 
+#if defined(WEBRTC_ADAPTIVE_MUTEX) && !defined(WEBRTC_ABSL_MUTEX)
+using MutexImpl = AdaptiveMutexImpl;
+#endif
+
 // The Mutex guarantees exclusive access and aims to follow Abseil semantics
 // (i.e. non-reentrant etc).
 class RTC_LOCKABLE Mutex final {
@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/synchronization/mutex_adaptive.h"
+
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+namespace webrtc {
+namespace {
+
+// Tells the core that this is a spin loop, which saves power and lets a
+// hyperthread sibling, possibly the mutex holder, run faster.
+inline void CpuRelax() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  _mm_pause();
+#elif defined(WEBRTC_ARCH_ARM_FAMILY)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+bool IsMultiCore() {
+  static const bool multi_core = sysconf(_SC_NPROCESSORS_ONLN) > 1;
+  return multi_core;
+}
+
+}  // namespace
+
+constexpr int AdaptiveMutexImpl::kSpinEstimateScale;
+constexpr int AdaptiveMutexImpl::kInitialSpinEstimate;
+constexpr int AdaptiveMutexImpl::kMaxSpinRounds;
+
+// static
+int AdaptiveMutexImpl::MaxSpinRounds(int estimate) {
+  // At most 1 + 2 + ... + 2^9 = 1023 pauses, a few microseconds, which is
+  // about what a system call and a context switch cost.
+  return std::min(kMaxSpinRounds, 2 * estimate / kSpinEstimateScale + 2);
+}
+
+// static
+int AdaptiveMutexImpl::UpdateSpinEstimate(int estimate, int rounds) {
+  return estimate + (rounds * kSpinEstimateScale - estimate) / 4;
+}
+
+void AdaptiveMutexImpl::LockSlow() {
+  if (IsMultiCore()) {
+    // Spin for up to twice as many rounds as it has taken lately, so that the
+    // spinning stops paying off for mutexes that are held for long.
+    const int estimate = spin_estimate_.load(std::memory_order_relaxed);
+    const int max_rounds = MaxSpinRounds(estimate);
+    int round = 0;
+    while (round < max_rounds) {
+      for (int i = 0; i < (1 << round); ++i)
+        CpuRelax();
+      ++round;
+      if (state_.load(std::memory_order_relaxed) == kUnlocked && TryLock()) {
+        spin_estimate_.store(UpdateSpinEstimate(estimate, round),
+                             std::memory_order_relaxed);
+        return;
+      }
+    }
+    spin_estimate_.store(UpdateSpinEstimate(estimate, round),
+                         std::memory_order_relaxed);
+  }
+
+  // Sleep until woken up by Unlock(). Since there is no telling whether other
+  // threads sleep, a thread that gets the mutex here marks it as having
+  // sleepers, and wakes up the next one when unlocking.
+  while (state_.exchange(kLockedWithSleepers, std::memory_order_acquire) !=
+         kUnlocked) {
+    syscall(SYS_futex, &state_, FUTEX_WAIT_PRIVATE, kLockedWithSleepers,
+            nullptr, nullptr, 0);
+  }
+}
+
+void AdaptiveMutexImpl::WakeUpSleeper() {
+  syscall(SYS_futex, &state_, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+}  // namespace webrtc
+
+#endif  // defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
@@ -0,0 +1,89 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_SYNCHRONIZATION_MUTEX_ADAPTIVE_H_
+#define RTC_BASE_SYNCHRONIZATION_MUTEX_ADAPTIVE_H_
+
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+
+#include <atomic>
+
+#include "absl/base/attributes.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// A mutex for short critical sections. When it is taken, Lock() spins for a
+// while, with exponentially growing pauses, before it sleeps on a futex.
+// How long it spins adapts to how long it has taken to get the mutex lately.
+// Spinning is skipped on single-core machines, where the thread holding the
+// mutex can't run while another one spins. The uncontended Lock() and
+// Unlock() are a single atomic operation each, with no system call.
+class RTC_LOCKABLE AdaptiveMutexImpl final {
+ public:
+  // The spin estimate is kept in fixed point, in 1/kSpinEstimateScale of a
+  // round, so that it can move by less than a round at a time.
+  static constexpr int kSpinEstimateScale = 16;
+  static constexpr int kInitialSpinEstimate = 2 * kSpinEstimateScale;
+  static constexpr int kMaxSpinRounds = 10;
+
+  AdaptiveMutexImpl() = default;
+  AdaptiveMutexImpl(const AdaptiveMutexImpl&) = delete;
+  AdaptiveMutexImpl& operator=(const AdaptiveMutexImpl&) = delete;
+
+  void Lock() RTC_EXCLUSIVE_LOCK_FUNCTION() {
+    int unlocked = kUnlocked;
+    if (!state_.compare_exchange_strong(unlocked, kLocked,
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+      LockSlow();
+    }
+  }
+  ABSL_MUST_USE_RESULT bool TryLock() RTC_EXCLUSIVE_TRYLOCK_FUNCTION(true) {
+    int unlocked = kUnlocked;
+    return state_.compare_exchange_strong(unlocked, kLocked,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed);
+  }
+  void Unlock() RTC_UNLOCK_FUNCTION() {
+    if (state_.exchange(kUnlocked, std::memory_order_release) ==
+        kLockedWithSleepers) {
+      WakeUpSleeper();
+    }
+  }
+
+  // The number of rounds that Lock() spins for with |estimate|, up to twice
+  // as many as it has taken lately.
+  static int MaxSpinRounds(int estimate);
+  // Returns |estimate| moved a quarter of the way towards |rounds|, the
+  // rounds that the last contended Lock() spun for.
+  static int UpdateSpinEstimate(int estimate, int rounds);
+
+  int SpinEstimateForTesting() const {
+    return spin_estimate_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  enum State : int { kUnlocked = 0, kLocked = 1, kLockedWithSleepers = 2 };
+
+  void LockSlow();
+  void WakeUpSleeper();
+
+  std::atomic<int> state_{kUnlocked};
+  // The number of spin rounds that it has recently taken to get the mutex, in
+  // 1/kSpinEstimateScale rounds. Updated without synchronization, since it's
+  // only an estimate.
+  std::atomic<int> spin_estimate_{kInitialSpinEstimate};
+};
+
+}  // namespace webrtc
+
+#endif  // defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+#endif  // RTC_BASE_SYNCHRONIZATION_MUTEX_ADAPTIVE_H_
@@ -0,0 +1,139 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/synchronization/mutex_adaptive.h"
+
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kNumThreads = 8;
+constexpr int kIncrementsPerThread = 100000;
+
+struct Counter {
+  AdaptiveMutexImpl mutex;
+  rtc::Event start{/*manual_reset=*/true, /*initially_signaled=*/false};
+  int value = 0;
+};
+
+void Increment(void* context) {
+  Counter* counter = static_cast<Counter*>(context);
+  counter->start.Wait(rtc::Event::kForever);
+  for (int i = 0; i < kIncrementsPerThread; ++i) {
+    counter->mutex.Lock();
+    // Not a single instruction, so that lost updates show.
+    int value = counter->value;
+    counter->value = value + 1;
+    counter->mutex.Unlock();
+  }
+}
+
+TEST(AdaptiveMutexTest, TryLockFailsWhileLocked) {
+  AdaptiveMutexImpl mutex;
+  EXPECT_TRUE(mutex.TryLock());
+  EXPECT_FALSE(mutex.TryLock());
+  mutex.Unlock();
+  mutex.Lock();
+  EXPECT_FALSE(mutex.TryLock());
+  mutex.Unlock();
+  EXPECT_TRUE(mutex.TryLock());
+  mutex.Unlock();
+}
+
+TEST(AdaptiveMutexTest, ProtectsAgainstConcurrentIncrements) {
+  Counter counter;
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(
+        std::make_unique<rtc::PlatformThread>(&Increment, &counter, "Inc"));
+    threads.back()->Start();
+  }
+  counter.start.Set();
+  for (auto& thread : threads)
+    thread->Stop();
+  counter.mutex.Lock();
+  EXPECT_EQ(counter.value, kNumThreads * kIncrementsPerThread);
+  counter.mutex.Unlock();
+}
+
+struct Sleeper {
+  AdaptiveMutexImpl* mutex;
+  rtc::Event started;
+  rtc::Event locked;
+};
+
+void LockAndSignal(void* context) {
+  Sleeper* sleeper = static_cast<Sleeper*>(context);
+  sleeper->started.Set();
+  sleeper->mutex->Lock();
+  sleeper->locked.Set();
+  sleeper->mutex->Unlock();
+}
+
+// A thread that waits for longer than it spins goes to sleep, and has to be
+// woken up by Unlock().
+TEST(AdaptiveMutexTest, WakesUpSleepingThreadOnUnlock) {
+  AdaptiveMutexImpl mutex;
+  Sleeper sleeper{&mutex};
+  mutex.Lock();
+  rtc::PlatformThread thread(&LockAndSignal, &sleeper, "Sleeper");
+  thread.Start();
+  ASSERT_TRUE(sleeper.started.Wait(10000));
+  EXPECT_FALSE(sleeper.locked.Wait(50));
+  mutex.Unlock();
+  EXPECT_TRUE(sleeper.locked.Wait(10000));
+  thread.Stop();
+}
+
+// A mutex that is held briefly, but for longer than Lock() spins, is taken
+// at the end of the spinning. The estimate then grows, and with it how long
+// Lock() spins, up to the limit.
+TEST(AdaptiveMutexTest, SpinEstimateGrowsWhileHeldBriefly) {
+  AdaptiveMutexImpl mutex;
+  int estimate = mutex.SpinEstimateForTesting();
+  EXPECT_GT(estimate, 0);
+  int max_rounds = AdaptiveMutexImpl::MaxSpinRounds(estimate);
+  for (int i = 0; i < 20; ++i) {
+    const int next_estimate =
+        AdaptiveMutexImpl::UpdateSpinEstimate(estimate, max_rounds);
+    if (max_rounds < AdaptiveMutexImpl::kMaxSpinRounds) {
+      EXPECT_GT(next_estimate, estimate);
+    }
+    const int next_max_rounds = AdaptiveMutexImpl::MaxSpinRounds(next_estimate);
+    EXPECT_GE(next_max_rounds, max_rounds);
+    estimate = next_estimate;
+    max_rounds = next_max_rounds;
+  }
+  EXPECT_EQ(max_rounds, AdaptiveMutexImpl::kMaxSpinRounds);
+}
+
+// A mutex that is taken after a round of spinning lets the estimate shrink
+// back to that.
+TEST(AdaptiveMutexTest, SpinEstimateShrinksWhenTakenQuickly) {
+  int estimate = AdaptiveMutexImpl::kMaxSpinRounds *
+                 AdaptiveMutexImpl::kSpinEstimateScale;
+  for (int i = 0; i < 40; ++i)
+    estimate = AdaptiveMutexImpl::UpdateSpinEstimate(estimate, 1);
+  EXPECT_LT(estimate, 2 * AdaptiveMutexImpl::kSpinEstimateScale);
+  EXPECT_EQ(AdaptiveMutexImpl::MaxSpinRounds(estimate), 4);
+}
+
+}  // namespace
+}  // namespace webrtc
+
+#endif  // defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
@@ -0,0 +1,123 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_SYNCHRONIZATION_SPSC_RECORD_BUFFER_H_
+#define RTC_BASE_SYNCHRONIZATION_SPSC_RECORD_BUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+// A ring buffer of variable-size records, without locks, for one thread that
+// writes records and one that reads them. A writer that finds the buffer full
+// drops its record instead of waiting for the reader. Records are aligned to
+// 8 bytes.
+class SpscRecordBuffer {
+ public:
+  // |capacity| is in bytes, and a power of two.
+  explicit SpscRecordBuffer(size_t capacity)
+      : capacity_(capacity), data_(new uint64_t[capacity / 8]()) {
+    RTC_DCHECK_GE(capacity, 16);
+    RTC_DCHECK_EQ(capacity & (capacity - 1), 0);
+  }
+  SpscRecordBuffer(const SpscRecordBuffer&) = delete;
+  SpscRecordBuffer& operator=(const SpscRecordBuffer&) = delete;
+
+  // Called by the writer. Returns space for a record of |size| bytes, or null
+  // if it doesn't fit. The record is readable after Commit().
+  uint8_t* Reserve(size_t size) {
+    const size_t record_size = sizeof(Header) + ((size + 7) & ~size_t{7});
+    uint64_t write = write_pos_.load(std::memory_order_relaxed);
+    const uint64_t read = read_pos_.load(std::memory_order_acquire);
+    size_t offset = write & (capacity_ - 1);
+    const size_t to_end = capacity_ - offset;
+    // A record that doesn't fit at the end starts over at the beginning.
+    const size_t needed =
+        record_size <= to_end ? record_size : to_end + record_size;
+    if (capacity_ - (write - read) < needed)
+      return nullptr;
+    if (record_size > to_end) {
+      *HeaderAt(offset) = {kSkip, static_cast<uint32_t>(to_end)};
+      write += to_end;
+      offset = 0;
+    }
+    *HeaderAt(offset) = {static_cast<uint32_t>(size),
+                         static_cast<uint32_t>(record_size)};
+    reserved_pos_ = write + record_size;
+    return Data() + offset + sizeof(Header);
+  }
+
+  // Called by the writer to make the record from the last Reserve()
+  // readable.
+  void Commit() {
+    write_pos_.store(reserved_pos_, std::memory_order_release);
+  }
+
+  // Called by the reader. Calls |handler| with each record committed since
+  // the last Release(), oldest first, as (const uint8_t* data, size_t size).
+  // The records stay valid until Release().
+  template <typename Handler>
+  void Peek(Handler handler) {
+    uint64_t pos = read_pos_.load(std::memory_order_relaxed);
+    const uint64_t end = write_pos_.load(std::memory_order_acquire);
+    while (pos < end) {
+      const Header* header = HeaderAt(pos & (capacity_ - 1));
+      if (header->size != kSkip)
+        handler(reinterpret_cast<const uint8_t*>(header + 1), header->size);
+      pos += header->next;
+    }
+    peeked_pos_ = end;
+  }
+
+  // Called by the reader to free the records passed to the handler by the
+  // last Peek().
+  void Release() {
+    read_pos_.store(peeked_pos_, std::memory_order_release);
+  }
+
+  // Called by the reader to free the records committed so far, unread.
+  void Clear() {
+    peeked_pos_ = write_pos_.load(std::memory_order_acquire);
+    Release();
+  }
+
+ private:
+  struct Header {
+    // The record's size, or kSkip for the unused end of the buffer.
+    uint32_t size;
+    // The distance to the next header.
+    uint32_t next;
+  };
+  static constexpr uint32_t kSkip = 0xFFFFFFFF;
+
+  uint8_t* Data() const { return reinterpret_cast<uint8_t*>(data_.get()); }
+  Header* HeaderAt(size_t offset) const {
+    return reinterpret_cast<Header*>(Data() + offset);
+  }
+
+  const size_t capacity_;
+  const std::unique_ptr<uint64_t[]> data_;
+  // Only accessed by the writer.
+  uint64_t reserved_pos_ = 0;
+  // Only accessed by the reader.
+  uint64_t peeked_pos_ = 0;
+  std::atomic<uint64_t> write_pos_{0};
+  std::atomic<uint64_t> read_pos_{0};
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_SYNCHRONIZATION_SPSC_RECORD_BUFFER_H_
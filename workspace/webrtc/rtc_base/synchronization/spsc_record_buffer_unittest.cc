@@ -0,0 +1,137 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/synchronization/spsc_record_buffer.h"
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/synchronization/yield.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+bool Write(SpscRecordBuffer& buffer, const std::string& record) {
+  uint8_t* data = buffer.Reserve(record.size());
+  if (!data)
+    return false;
+  memcpy(data, record.data(), record.size());
+  buffer.Commit();
+  return true;
+}
+
+std::vector<std::string> ReadAll(SpscRecordBuffer& buffer) {
+  std::vector<std::string> records;
+  buffer.Peek([&records](const uint8_t* data, size_t size) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % 8, 0u);
+    records.emplace_back(reinterpret_cast<const char*>(data), size);
+  });
+  buffer.Release();
+  return records;
+}
+
+TEST(SpscRecordBufferTest, ReadsRecordsInOrder) {
+  SpscRecordBuffer buffer(256);
+  EXPECT_TRUE(ReadAll(buffer).empty());
+  EXPECT_TRUE(Write(buffer, "first"));
+  EXPECT_TRUE(Write(buffer, ""));
+  EXPECT_TRUE(Write(buffer, "third record"));
+  EXPECT_EQ(ReadAll(buffer),
+            (std::vector<std::string>{"first", "", "third record"}));
+  EXPECT_TRUE(ReadAll(buffer).empty());
+}
+
+TEST(SpscRecordBufferTest, RecordsStayUntilReleased) {
+  SpscRecordBuffer buffer(256);
+  EXPECT_TRUE(Write(buffer, "record"));
+  int count = 0;
+  buffer.Peek([&count](const uint8_t*, size_t) { ++count; });
+  buffer.Peek([&count](const uint8_t*, size_t) { ++count; });
+  EXPECT_EQ(count, 2);
+  buffer.Release();
+  EXPECT_TRUE(ReadAll(buffer).empty());
+}
+
+TEST(SpscRecordBufferTest, DropsRecordsThatDontFit) {
+  // Each record takes 8 bytes for its header and 24 for its data.
+  SpscRecordBuffer buffer(64);
+  const std::string record(20, 'x');
+  EXPECT_TRUE(Write(buffer, record));
+  EXPECT_TRUE(Write(buffer, record));
+  EXPECT_FALSE(Write(buffer, record));
+  EXPECT_EQ(ReadAll(buffer).size(), 2u);
+  // Space is freed by reading, and records wrap around.
+  EXPECT_TRUE(Write(buffer, "a"));
+  EXPECT_TRUE(Write(buffer, record));
+  EXPECT_EQ(ReadAll(buffer), (std::vector<std::string>{"a", record}));
+  EXPECT_TRUE(Write(buffer, record));
+  buffer.Clear();
+  EXPECT_TRUE(ReadAll(buffer).empty());
+}
+
+struct WriterContext {
+  SpscRecordBuffer* buffer;
+  int count;
+  int written = 0;
+};
+
+void WriteNumbers(void* context) {
+  WriterContext* writer = static_cast<WriterContext*>(context);
+  for (int i = 0; i < writer->count;) {
+    // Records of 4 to 36 bytes.
+    const size_t size = sizeof(int) * (1 + i % 9);
+    uint8_t* data = writer->buffer->Reserve(size);
+    if (!data) {
+      YieldCurrentThread();
+      continue;
+    }
+    for (size_t j = 0; j < size; j += sizeof(int))
+      memcpy(data + j, &i, sizeof(int));
+    writer->buffer->Commit();
+    ++i;
+  }
+}
+
+// The writer retries dropped records, so that every number arrives.
+TEST(SpscRecordBufferTest, ConcurrentWriterAndReader) {
+  constexpr int kCount = 20000;
+  SpscRecordBuffer buffer(1024);
+  WriterContext writer = {&buffer, kCount};
+  rtc::PlatformThread thread(&WriteNumbers, &writer, "Writer");
+  thread.Start();
+  int expected = 0;
+  bool intact = true;
+  while (expected < kCount) {
+    const int before = expected;
+    buffer.Peek([&](const uint8_t* data, size_t size) {
+      intact &= size == sizeof(int) * (1 + expected % 9);
+      for (size_t j = 0; j < size; j += sizeof(int)) {
+        int value;
+        memcpy(&value, data + j, sizeof(int));
+        intact &= value == expected;
+      }
+      ++expected;
+    });
+    buffer.Release();
+    if (expected == before)
+      YieldCurrentThread();
+  }
+  thread.Stop();
+  EXPECT_TRUE(intact);
+  EXPECT_EQ(expected, kCount);
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -0,0 +1,164 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "api/task_queue/task_queue_factory.h"
+#include "benchmark/benchmark.h"
+#include "rtc_base/event.h"
+#include "rtc_base/system/unused.h"
+#include "rtc_base/task_queue_pooled.h"
+#include "rtc_base/task_queue_stdlib.h"
+#include "rtc_base/task_utils/to_queued_task.h"
+
+#if defined(WEBRTC_ENABLE_LIBEVENT)
+#include "rtc_base/task_queue_libevent.h"
+#endif
+
+namespace webrtc {
+namespace {
+
+using FactoryCreator = std::unique_ptr<TaskQueueFactory> (*)();
+using TaskQueuePtr = std::unique_ptr<TaskQueueBase, TaskQueueDeleter>;
+
+std::unique_ptr<TaskQueueFactory> CreatePooledFactory() {
+  return CreateTaskQueuePooledFactory();
+}
+
+std::vector<TaskQueuePtr> CreateQueues(const TaskQueueFactory& factory,
+                                       int num_queues) {
+  std::vector<TaskQueuePtr> queues;
+  for (int i = 0; i < num_queues; ++i) {
+    queues.push_back(
+        factory.CreateTaskQueue("Queue", TaskQueueFactory::Priority::NORMAL));
+  }
+  return queues;
+}
+
+// Posts a burst of tasks to each of state.range(0) queues, as the many
+// per-call queues of a busy server do, and waits for all of them to run.
+void BM_PostThroughput(benchmark::State& state, FactoryCreator create) {
+  constexpr int kTasksPerQueue = 100;
+  const int num_queues = state.range(0);
+  std::unique_ptr<TaskQueueFactory> factory = create();
+  std::vector<TaskQueuePtr> queues = CreateQueues(*factory, num_queues);
+  std::atomic<int> remaining(0);
+  rtc::Event done;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    remaining.store(num_queues * kTasksPerQueue);
+    for (int task = 0; task < kTasksPerQueue; ++task) {
+      for (TaskQueuePtr& queue : queues) {
+        queue->PostTask(ToQueuedTask([&remaining, &done] {
+          if (remaining.fetch_sub(1) == 1)
+            done.Set();
+        }));
+      }
+    }
+    done.Wait(rtc::Event::kForever);
+  }
+  state.SetItemsProcessed(state.iterations() * num_queues * kTasksPerQueue);
+}
+
+// Time for a task to go to another queue and back, that is, two wake-ups.
+void BM_PingPongLatency(benchmark::State& state, FactoryCreator create) {
+  std::unique_ptr<TaskQueueFactory> factory = create();
+  std::vector<TaskQueuePtr> queues = CreateQueues(*factory, 2);
+  TaskQueueBase* ping = queues[0].get();
+  TaskQueueBase* pong = queues[1].get();
+  rtc::Event done;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    ping->PostTask(ToQueuedTask([pong, &done] {
+      pong->PostTask(ToQueuedTask([&done] { done.Set(); }));
+    }));
+    done.Wait(rtc::Event::kForever);
+  }
+}
+
+// Creating and deleting a queue, as done for every call.
+void BM_CreateAndDelete(benchmark::State& state, FactoryCreator create) {
+  std::unique_ptr<TaskQueueFactory> factory = create();
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    benchmark::DoNotOptimize(factory->CreateTaskQueue(
+        "Queue", TaskQueueFactory::Priority::NORMAL));
+  }
+}
+
+BENCHMARK_CAPTURE(BM_PostThroughput, Stdlib, CreateTaskQueueStdlibFactory)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_PostThroughput, Pooled, CreatePooledFactory)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_PingPongLatency, Stdlib, CreateTaskQueueStdlibFactory)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_PingPongLatency, Pooled, CreatePooledFactory)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_CreateAndDelete, Stdlib, CreateTaskQueueStdlibFactory)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_CreateAndDelete, Pooled, CreatePooledFactory)
+    ->UseRealTime();
+
+#if defined(WEBRTC_ENABLE_LIBEVENT)
+BENCHMARK_CAPTURE(BM_PostThroughput, Libevent, CreateTaskQueueLibeventFactory)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_PingPongLatency,
+                  Libevent,
+                  CreateTaskQueueLibeventFactory)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_CreateAndDelete,
+                  Libevent,
+                  CreateTaskQueueLibeventFactory)
+    ->UseRealTime();
+#endif
+
+}  // namespace
+}  // namespace webrtc
+
+/*
+
+Results (Linux, a single x86-64 core, libevent 2.1, the pooled factory with
+one worker per core):
+
+-----------------------------------------------------------------------------
+Benchmark                                         Time   UserCounters...
+-----------------------------------------------------------------------------
+BM_PostThroughput/Stdlib/1/real_time         782902 ns   items_per_second=128k/s
+BM_PostThroughput/Stdlib/16/real_time      13211773 ns   items_per_second=121k/s
+BM_PostThroughput/Stdlib/256/real_time    348339753 ns   items_per_second=73k/s
+BM_PostThroughput/Libevent/1/real_time       531981 ns   items_per_second=188k/s
+BM_PostThroughput/Libevent/16/real_time     8335569 ns   items_per_second=192k/s
+BM_PostThroughput/Libevent/256/real_time  313456839 ns   items_per_second=82k/s
+BM_PostThroughput/Pooled/1/real_time         809580 ns   items_per_second=124k/s
+BM_PostThroughput/Pooled/16/real_time      13301390 ns   items_per_second=120k/s
+BM_PostThroughput/Pooled/256/real_time    213253558 ns   items_per_second=120k/s
+BM_PingPongLatency/Stdlib/real_time           11969 ns
+BM_PingPongLatency/Libevent/real_time          8727 ns
+BM_PingPongLatency/Pooled/real_time            8960 ns
+BM_CreateAndDelete/Stdlib/real_time           34384 ns
+BM_CreateAndDelete/Libevent/real_time         44459 ns
+BM_CreateAndDelete/Pooled/real_time             236 ns
+
+With a thread per queue, throughput drops once there are many more queues than
+cores, while the pool keeps it. A pooled queue is also two orders of magnitude
+cheaper to create, since it doesn't start a thread.
+
+*/
@@ -18,10 +18,11 @@
 #include <time.h>
 #include <unistd.h>
 
-#include <list>
+#include <algorithm>
 #include <memory>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/string_view.h"
@@ -36,6 +37,7 @@
 #include "rtc_base/synchronization/mutex.h"
 #include "rtc_base/thread_annotations.h"
 #include "rtc_base/time_utils.h"
+#include "rtc_base/timer_wheel.h"
 
 namespace webrtc {
 namespace {
@@ -116,13 +118,16 @@ class TaskQueueLibevent final : public TaskQueueBase {
 
  private:
   class SetTimerTask;
-  struct TimerEvent;
 
   ~TaskQueueLibevent() override = default;
 
   static void ThreadMain(void* context);
   static void OnWakeup(int socket, short flags, void* context);  // NOLINT
-  static void RunTimer(int fd, short flags, void* context);      // NOLINT
+  static void RunTimers(int fd, short flags, void* context);     // NOLINT
+
+  // Arms |timer_event_| for the next wake-up of |delayed_tasks_|, unless it is
+  // already armed for that time or earlier.
+  void ArmTimer();
 
   bool is_active_ = true;
   int wakeup_pipe_in_ = -1;
@@ -133,18 +138,11 @@ class TaskQueueLibevent final : public TaskQueueBase {
   Mutex pending_lock_;
   absl::InlinedVector<std::unique_ptr<QueuedTask>, 4> pending_
       RTC_GUARDED_BY(pending_lock_);
-  // Holds a list of events pending timers for cleanup when the loop exits.
-  std::list<TimerEvent*> pending_timers_;
-};
-
-struct TaskQueueLibevent::TimerEvent {
-  TimerEvent(TaskQueueLibevent* task_queue, std::unique_ptr<QueuedTask> task)
-      : task_queue(task_queue), task(std::move(task)) {}
-  ~TimerEvent() { event_del(&ev); }
-
-  event ev;
-  TaskQueueLibevent* task_queue;
-  std::unique_ptr<QueuedTask> task;
+  // The delayed tasks share a single timer event, rather than adding an event
+  // for each of them to libevent. Only accessed on the queue thread.
+  TimerWheel<std::unique_ptr<QueuedTask>> delayed_tasks_;
+  event timer_event_;
+  int64_t timer_armed_at_ms_ = TimerWheel<std::unique_ptr<QueuedTask>>::kNever;
 };
 
 class TaskQueueLibevent::SetTimerTask : public QueuedTask {
@@ -173,7 +171,8 @@ class TaskQueueLibevent::SetTimerTask : public QueuedTask {
 TaskQueueLibevent::TaskQueueLibevent(absl::string_view queue_name,
                                      rtc::ThreadPriority priority)
     : event_base_(event_base_new()),
-      thread_(&TaskQueueLibevent::ThreadMain, this, queue_name, priority) {
+      thread_(&TaskQueueLibevent::ThreadMain, this, queue_name, priority),
+      delayed_tasks_(rtc::TimeMillis()) {
   int fds[2];
   RTC_CHECK(pipe(fds) == 0);
   SetNonBlocking(fds[0]);
@@ -184,6 +183,8 @@ TaskQueueLibevent::TaskQueueLibevent(absl::string_view queue_name,
   EventAssign(&wakeup_event_, event_base_, wakeup_pipe_out_,
               EV_READ | EV_PERSIST, OnWakeup, this);
   event_add(&wakeup_event_, 0);
+  EventAssign(&timer_event_, event_base_, -1, 0, &TaskQueueLibevent::RunTimers,
+              this);
   thread_.Start();
 }
 
@@ -240,13 +241,8 @@ void TaskQueueLibevent::PostTask(std::unique_ptr<QueuedTask> task) {
 void TaskQueueLibevent::PostDelayedTask(std::unique_ptr<QueuedTask> task,
                                         uint32_t milliseconds) {
   if (IsCurrent()) {
-    TimerEvent* timer = new TimerEvent(this, std::move(task));
-    EventAssign(&timer->ev, event_base_, -1, 0, &TaskQueueLibevent::RunTimer,
-                timer);
-    pending_timers_.push_back(timer);
-    timeval tv = {rtc::dchecked_cast<int>(milliseconds / 1000),
-                  rtc::dchecked_cast<int>(milliseconds % 1000) * 1000};
-    event_add(&timer->ev, &tv);
+    delayed_tasks_.Schedule(rtc::TimeMillis() + milliseconds, std::move(task));
+    ArmTimer();
   } else {
     PostTask(std::make_unique<SetTimerTask>(std::move(task), milliseconds));
   }
@@ -262,8 +258,8 @@ void TaskQueueLibevent::ThreadMain(void* context) {
       event_base_loop(me->event_base_, 0);
   }
 
-  for (TimerEvent* timer : me->pending_timers_)
-    delete timer;
+  event_del(&me->timer_event_);
+  me->delayed_tasks_.Clear();
 }
 
 // static
@@ -303,14 +299,35 @@ void TaskQueueLibevent::OnWakeup(int socket,
 }
 
 // static
-void TaskQueueLibevent::RunTimer(int fd,
-                                 short flags,  // NOLINT
-                                 void* context) {
-  TimerEvent* timer = static_cast<TimerEvent*>(context);
-  if (!timer->task->Run())
-    timer->task.release();
-  timer->task_queue->pending_timers_.remove(timer);
-  delete timer;
+void TaskQueueLibevent::RunTimers(int fd,
+                                  short flags,  // NOLINT
+                                  void* context) {
+  TaskQueueLibevent* me = static_cast<TaskQueueLibevent*>(context);
+  me->timer_armed_at_ms_ = TimerWheel<std::unique_ptr<QueuedTask>>::kNever;
+  // The wake-up may be for timers that have only moved closer to the first
+  // level of the wheel, in which case there is nothing to run yet.
+  std::vector<std::unique_ptr<QueuedTask>> tasks;
+  me->delayed_tasks_.Advance(rtc::TimeMillis(), &tasks);
+  for (auto& task : tasks) {
+    if (task->Run()) {
+      task.reset();
+    } else {
+      // |false| means the task should *not* be deleted.
+      task.release();
+    }
+  }
+  me->ArmTimer();
+}
+
+void TaskQueueLibevent::ArmTimer() {
+  const int64_t wake_up_ms = delayed_tasks_.NextWakeUp();
+  if (wake_up_ms >= timer_armed_at_ms_)
+    return;
+  timer_armed_at_ms_ = wake_up_ms;
+  const int64_t delay_ms = std::max<int64_t>(wake_up_ms - rtc::TimeMillis(), 0);
+  timeval tv = {rtc::dchecked_cast<int>(delay_ms / 1000),
+                rtc::dchecked_cast<int>(delay_ms % 1000) * 1000};
+  event_add(&timer_event_, &tv);
 }
 
 class TaskQueueLibeventFactory final : public TaskQueueFactory {
@@ -0,0 +1,475 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/task_queue_pooled.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "api/scoped_refptr.h"
+#include "api/task_queue/queued_task.h"
+#include "api/task_queue/task_queue_base.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/ref_counter.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+#include "rtc_base/time_utils.h"
+#include "rtc_base/timer_wheel.h"
+#include "system_wrappers/include/cpu_info.h"
+
+namespace webrtc {
+namespace {
+
+// The number of tasks a worker runs from one queue before it puts the queue
+// back in line behind the other scheduled queues.
+constexpr int kMaxTasksPerSlice = 16;
+
+class TaskQueuePool;
+
+// A sequential task queue without a thread of its own. While it has pending
+// tasks it is scheduled, that is, in exactly one of the deques of the pool
+// workers or being run by one of them.
+class PooledTaskQueue final : public TaskQueueBase {
+ public:
+  PooledTaskQueue(TaskQueuePool* pool, bool high_priority);
+
+  void Delete() override;
+  void PostTask(std::unique_ptr<QueuedTask> task) override;
+  void PostDelayedTask(std::unique_ptr<QueuedTask> task,
+                       uint32_t milliseconds) override;
+
+  // The queue is referenced by its owner until Delete(), and by the pool while
+  // it is scheduled or has delayed tasks.
+  void AddRef() const { ref_count_.IncRef(); }
+  void Release() const {
+    if (ref_count_.DecRef() == rtc::RefCountReleaseStatus::kDroppedLastRef)
+      delete this;
+  }
+
+  // Runs up to kMaxTasksPerSlice tasks on the calling worker. Returns true if
+  // the queue has more tasks and must be scheduled again.
+  bool RunSlice();
+
+  bool high_priority() const { return high_priority_; }
+
+ private:
+  ~PooledTaskQueue() override = default;
+
+  TaskQueuePool* const pool_;
+  const bool high_priority_;
+  mutable webrtc_impl::RefCounter ref_count_{1};
+
+  // Signaled when a task that was running while the queue was deleted has
+  // returned.
+  rtc::Event done_running_;
+
+  Mutex mutex_;
+  std::queue<std::unique_ptr<QueuedTask>> pending_ RTC_GUARDED_BY(mutex_);
+  bool scheduled_ RTC_GUARDED_BY(mutex_) = false;
+  bool running_ RTC_GUARDED_BY(mutex_) = false;
+  bool deleted_ RTC_GUARDED_BY(mutex_) = false;
+};
+
+class TaskQueuePool {
+ public:
+  explicit TaskQueuePool(int num_workers);
+  ~TaskQueuePool();
+
+  void QueueCreated() { num_queues_.fetch_add(1, std::memory_order_relaxed); }
+  void QueueDeleted() { num_queues_.fetch_sub(1, std::memory_order_relaxed); }
+
+  // Puts |queue| in line to be run by a worker. Queues scheduled from a worker
+  // go to the deque of that worker, others are spread over all the workers.
+  void Schedule(PooledTaskQueue* queue);
+
+  // Posts |task| to |queue| in |milliseconds|.
+  void PostDelayed(PooledTaskQueue* queue,
+                   std::unique_ptr<QueuedTask> task,
+                   uint32_t milliseconds);
+
+ private:
+  struct Worker {
+    Worker(TaskQueuePool* pool, int index);
+
+    TaskQueuePool* const pool;
+    const int index;
+    rtc::PlatformThread thread;
+    // Written by the worker before the pool constructor returns.
+    rtc::PlatformThreadRef thread_ref;
+    rtc::Event started;
+    // Signaled to wake the worker up when it is idle, or to stop it.
+    rtc::Event wake_up;
+
+    Mutex mutex;
+    std::deque<rtc::scoped_refptr<PooledTaskQueue>> queues
+        RTC_GUARDED_BY(mutex);
+  };
+
+  struct DelayedTask {
+    rtc::scoped_refptr<PooledTaskQueue> queue;
+    std::unique_ptr<QueuedTask> task;
+  };
+
+  static void WorkerMain(void* context);
+  static void TimerMain(void* context);
+
+  void RunWorker(Worker* worker);
+  void RunTimer();
+
+  // Returns the next queue to run on |worker|: the oldest of its own, or else
+  // one stolen from another worker.
+  rtc::scoped_refptr<PooledTaskQueue> NextQueue(Worker* worker);
+  void Push(Worker* worker, rtc::scoped_refptr<PooledTaskQueue> queue);
+  Worker* CurrentWorker() const;
+  void RemoveIdleWorker(Worker* worker);
+  void WakeUpIdleWorker();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<uint32_t> next_worker_{0};
+  std::atomic<int> num_queues_{0};
+  std::atomic<bool> stopping_{false};
+
+  // Idle workers, waiting for |wake_up|. |num_idle_| is the size of
+  // |idle_workers_|, so that posting doesn't take |idle_mutex_| when all the
+  // workers are busy.
+  std::atomic<int> num_idle_{0};
+  Mutex idle_mutex_;
+  std::vector<Worker*> idle_workers_ RTC_GUARDED_BY(idle_mutex_);
+
+  rtc::PlatformThread timer_thread_;
+  rtc::Event timer_wake_up_;
+  Mutex timer_mutex_;
+  TimerWheel<DelayedTask> delayed_ RTC_GUARDED_BY(timer_mutex_);
+  // When the timer thread is next going to look at |delayed_|.
+  int64_t timer_wake_up_at_ms_ RTC_GUARDED_BY(timer_mutex_) =
+      TimerWheel<DelayedTask>::kNever;
+};
+
+PooledTaskQueue::PooledTaskQueue(TaskQueuePool* pool, bool high_priority)
+    : pool_(pool), high_priority_(high_priority) {
+  pool_->QueueCreated();
+}
+
+void PooledTaskQueue::Delete() {
+  RTC_DCHECK(!IsCurrent());
+
+  std::queue<std::unique_ptr<QueuedTask>> pending;
+  bool running;
+  {
+    MutexLock lock(&mutex_);
+    deleted_ = true;
+    running = running_;
+    pending.swap(pending_);
+  }
+  if (running)
+    done_running_.Wait(rtc::Event::kForever);
+
+  // Destroy the tasks that never ran outside of the lock, since they may post
+  // to this queue from their destructors.
+  while (!pending.empty())
+    pending.pop();
+
+  pool_->QueueDeleted();
+  Release();
+}
+
+void PooledTaskQueue::PostTask(std::unique_ptr<QueuedTask> task) {
+  {
+    MutexLock lock(&mutex_);
+    if (deleted_)
+      return;
+    pending_.push(std::move(task));
+    if (scheduled_)
+      return;
+    scheduled_ = true;
+  }
+  pool_->Schedule(this);
+}
+
+void PooledTaskQueue::PostDelayedTask(std::unique_ptr<QueuedTask> task,
+                                      uint32_t milliseconds) {
+  if (milliseconds == 0) {
+    PostTask(std::move(task));
+    return;
+  }
+  pool_->PostDelayed(this, std::move(task), milliseconds);
+}
+
+bool PooledTaskQueue::RunSlice() {
+  std::unique_ptr<QueuedTask> task;
+  {
+    MutexLock lock(&mutex_);
+    if (deleted_ || pending_.empty()) {
+      scheduled_ = false;
+      return false;
+    }
+    task = std::move(pending_.front());
+    pending_.pop();
+    running_ = true;
+  }
+
+  CurrentTaskQueueSetter set_current(this);
+  for (int i = 1;; ++i) {
+    QueuedTask* release_ptr = task.release();
+    if (release_ptr->Run())
+      delete release_ptr;
+
+    MutexLock lock(&mutex_);
+    running_ = false;
+    if (deleted_) {
+      scheduled_ = false;
+      done_running_.Set();
+      return false;
+    }
+    if (pending_.empty()) {
+      scheduled_ = false;
+      return false;
+    }
+    if (i == kMaxTasksPerSlice)
+      return true;
+    task = std::move(pending_.front());
+    pending_.pop();
+    running_ = true;
+  }
+}
+
+TaskQueuePool::Worker::Worker(TaskQueuePool* pool, int index)
+    : pool(pool),
+      index(index),
+      thread(&TaskQueuePool::WorkerMain,
+             this,
+             "TaskQueuePool" + std::to_string(index)) {}
+
+TaskQueuePool::TaskQueuePool(int num_workers)
+    : timer_thread_(&TaskQueuePool::TimerMain, this, "TaskQueuePoolTmr"),
+      delayed_(rtc::TimeMillis()) {
+  if (num_workers <= 0)
+    num_workers = std::max<int>(1, CpuInfo::DetectNumberOfCores());
+  for (int i = 0; i < num_workers; ++i)
+    workers_.push_back(std::make_unique<Worker>(this, i));
+  for (auto& worker : workers_) {
+    worker->thread.Start();
+    worker->started.Wait(rtc::Event::kForever);
+  }
+  timer_thread_.Start();
+}
+
+TaskQueuePool::~TaskQueuePool() {
+  RTC_DCHECK_EQ(num_queues_.load(), 0)
+      << "The task queues must be deleted before their factory.";
+  stopping_.store(true);
+  for (auto& worker : workers_) {
+    worker->wake_up.Set();
+    worker->thread.Stop();
+  }
+  timer_wake_up_.Set();
+  timer_thread_.Stop();
+
+  // Release the queues that were deleted with tasks still scheduled or
+  // delayed.
+  for (auto& worker : workers_) {
+    MutexLock lock(&worker->mutex);
+    worker->queues.clear();
+  }
+  std::vector<DelayedTask> delayed;
+  {
+    // Takes all the delayed tasks, to destroy them without holding the lock.
+    MutexLock lock(&timer_mutex_);
+    delayed_.Advance(TimerWheel<DelayedTask>::kNever - 1, &delayed);
+  }
+}
+
+void TaskQueuePool::Schedule(PooledTaskQueue* queue) {
+  Worker* worker = CurrentWorker();
+  if (!worker) {
+    worker = workers_[next_worker_.fetch_add(1, std::memory_order_relaxed) %
+                      workers_.size()]
+                 .get();
+  }
+  Push(worker, queue);
+  WakeUpIdleWorker();
+}
+
+void TaskQueuePool::PostDelayed(PooledTaskQueue* queue,
+                                std::unique_ptr<QueuedTask> task,
+                                uint32_t milliseconds) {
+  const int64_t fire_at = rtc::TimeMillis() + milliseconds;
+  bool earliest = false;
+  {
+    MutexLock lock(&timer_mutex_);
+    delayed_.Schedule(fire_at, DelayedTask{queue, std::move(task)});
+    if (fire_at < timer_wake_up_at_ms_) {
+      timer_wake_up_at_ms_ = fire_at;
+      earliest = true;
+    }
+  }
+  // The timer thread only needs to recompute its timeout if this task is due
+  // before it would wake up anyway.
+  if (earliest)
+    timer_wake_up_.Set();
+}
+
+// static
+void TaskQueuePool::WorkerMain(void* context) {
+  Worker* worker = static_cast<Worker*>(context);
+  worker->thread_ref = rtc::CurrentThreadRef();
+  worker->started.Set();
+  worker->pool->RunWorker(worker);
+}
+
+// static
+void TaskQueuePool::TimerMain(void* context) {
+  static_cast<TaskQueuePool*>(context)->RunTimer();
+}
+
+void TaskQueuePool::RunWorker(Worker* worker) {
+  while (!stopping_.load()) {
+    rtc::scoped_refptr<PooledTaskQueue> queue = NextQueue(worker);
+    if (!queue) {
+      // Register as idle before looking a last time. A queue scheduled before
+      // the registration is found here, and one scheduled after it wakes us
+      // up, since Schedule() checks |num_idle_| after pushing.
+      {
+        MutexLock lock(&idle_mutex_);
+        idle_workers_.push_back(worker);
+        num_idle_.fetch_add(1);
+      }
+      queue = NextQueue(worker);
+      if (!queue) {
+        worker->wake_up.Wait(rtc::Event::kForever);
+        // Normally whoever woke the worker up has unregistered it, but the
+        // wake up may be left over from an earlier registration.
+        RemoveIdleWorker(worker);
+        continue;
+      }
+      RemoveIdleWorker(worker);
+    }
+    if (queue->RunSlice())
+      Push(worker, std::move(queue));
+  }
+}
+
+void TaskQueuePool::RunTimer() {
+  while (!stopping_.load()) {
+    std::vector<DelayedTask> due;
+    int wait_ms = rtc::Event::kForever;
+    {
+      MutexLock lock(&timer_mutex_);
+      const int64_t now = rtc::TimeMillis();
+      delayed_.Advance(now, &due);
+      timer_wake_up_at_ms_ = delayed_.NextWakeUp();
+      if (!delayed_.empty()) {
+        wait_ms = static_cast<int>(std::min<int64_t>(
+            timer_wake_up_at_ms_ - now, std::numeric_limits<int>::max()));
+      }
+    }
+    // Queues that have been deleted destroy the tasks.
+    for (DelayedTask& delayed_task : due)
+      delayed_task.queue->PostTask(std::move(delayed_task.task));
+    if (due.empty())
+      timer_wake_up_.Wait(wait_ms);
+  }
+}
+
+rtc::scoped_refptr<PooledTaskQueue> TaskQueuePool::NextQueue(Worker* worker) {
+  const size_t num_workers = workers_.size();
+  for (size_t i = 0; i < num_workers; ++i) {
+    Worker* victim = workers_[(worker->index + i) % num_workers].get();
+    MutexLock lock(&victim->mutex);
+    if (!victim->queues.empty()) {
+      rtc::scoped_refptr<PooledTaskQueue> queue =
+          std::move(victim->queues.front());
+      victim->queues.pop_front();
+      return queue;
+    }
+  }
+  return nullptr;
+}
+
+void TaskQueuePool::Push(Worker* worker,
+                         rtc::scoped_refptr<PooledTaskQueue> queue) {
+  MutexLock lock(&worker->mutex);
+  if (queue->high_priority()) {
+    worker->queues.push_front(std::move(queue));
+  } else {
+    worker->queues.push_back(std::move(queue));
+  }
+}
+
+TaskQueuePool::Worker* TaskQueuePool::CurrentWorker() const {
+  const rtc::PlatformThreadRef current = rtc::CurrentThreadRef();
+  for (const auto& worker : workers_) {
+    if (rtc::IsThreadRefEqual(worker->thread_ref, current))
+      return worker.get();
+  }
+  return nullptr;
+}
+
+void TaskQueuePool::RemoveIdleWorker(Worker* worker) {
+  MutexLock lock(&idle_mutex_);
+  auto it = std::find(idle_workers_.begin(), idle_workers_.end(), worker);
+  // If the worker isn't registered any more, |wake_up| has been or is about
+  // to be set, and the next wait returns at once, which is harmless.
+  if (it != idle_workers_.end()) {
+    idle_workers_.erase(it);
+    num_idle_.fetch_sub(1);
+  }
+}
+
+void TaskQueuePool::WakeUpIdleWorker() {
+  if (num_idle_.load() == 0)
+    return;
+  Worker* worker;
+  {
+    MutexLock lock(&idle_mutex_);
+    if (idle_workers_.empty())
+      return;
+    worker = idle_workers_.back();
+    idle_workers_.pop_back();
+    num_idle_.fetch_sub(1);
+  }
+  worker->wake_up.Set();
+}
+
+class TaskQueuePooledFactory final : public TaskQueueFactory {
+ public:
+  explicit TaskQueuePooledFactory(int num_workers)
+      : pool_(std::make_unique<TaskQueuePool>(num_workers)) {}
+
+  std::unique_ptr<TaskQueueBase, TaskQueueDeleter> CreateTaskQueue(
+      absl::string_view name,
+      Priority priority) const override {
+    return std::unique_ptr<TaskQueueBase, TaskQueueDeleter>(
+        new PooledTaskQueue(pool_.get(), priority == Priority::HIGH));
+  }
+
+ private:
+  const std::unique_ptr<TaskQueuePool> pool_;
+};
+
+}  // namespace
+
+std::unique_ptr<TaskQueueFactory> CreateTaskQueuePooledFactory(
+    int num_workers) {
+  return std::make_unique<TaskQueuePooledFactory>(num_workers);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,40 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_TASK_QUEUE_POOLED_H_
+#define RTC_BASE_TASK_QUEUE_POOLED_H_
+
+#include <memory>
+
+#include "api/task_queue/task_queue_factory.h"
+
+namespace webrtc {
+
+// Creates a factory whose task queues share a fixed pool of |num_workers|
+// threads, instead of owning one thread each. Every task queue is still
+// sequential: its tasks run in FIFO order, one at a time, and
+// TaskQueueBase::Current() returns the queue while they run. A queue that has
+// pending tasks is scheduled on one worker, and idle workers steal scheduled
+// queues from the busy ones. A worker runs a bounded number of tasks of a
+// queue before it moves on to the next, so that a busy queue can't starve the
+// others. Delayed tasks are kept by a single timer thread and posted to their
+// queue when due.
+//
+// Queues created with Priority::HIGH are scheduled ahead of the others; the
+// workers themselves all run at normal priority.
+//
+// The factory must outlive the task queues it creates. If |num_workers| is
+// zero, one worker per CPU core is used.
+std::unique_ptr<TaskQueueFactory> CreateTaskQueuePooledFactory(
+    int num_workers = 0);
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_TASK_QUEUE_POOLED_H_
@@ -0,0 +1,159 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/task_queue_pooled.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "api/task_queue/task_queue_test.h"
+#include "rtc_base/event.h"
+#include "rtc_base/task_utils/to_queued_task.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+std::unique_ptr<TaskQueueFactory> CreateSingleWorkerFactory() {
+  return CreateTaskQueuePooledFactory(1);
+}
+
+std::unique_ptr<TaskQueueFactory> CreateFourWorkerFactory() {
+  return CreateTaskQueuePooledFactory(4);
+}
+
+INSTANTIATE_TEST_SUITE_P(PooledSingleWorker,
+                         TaskQueueTest,
+                         ::testing::Values(CreateSingleWorkerFactory));
+INSTANTIATE_TEST_SUITE_P(PooledFourWorkers,
+                         TaskQueueTest,
+                         ::testing::Values(CreateFourWorkerFactory));
+
+using TaskQueuePtr = std::unique_ptr<TaskQueueBase, TaskQueueDeleter>;
+
+TEST(TaskQueuePooledTest, ManyQueuesKeepFifoOrder) {
+  constexpr int kNumQueues = 1000;
+  constexpr int kTasksPerQueue = 50;
+  std::unique_ptr<TaskQueueFactory> factory = CreateTaskQueuePooledFactory(4);
+  std::vector<TaskQueuePtr> queues;
+  for (int i = 0; i < kNumQueues; ++i) {
+    queues.push_back(factory->CreateTaskQueue(
+        "Queue", TaskQueueFactory::Priority::NORMAL));
+  }
+
+  std::vector<int> next(kNumQueues, 0);
+  std::atomic<int> out_of_order(0);
+  std::atomic<int> remaining(kNumQueues * kTasksPerQueue);
+  rtc::Event done;
+  // Interleave the posts, so that the queues are scheduled and descheduled
+  // over and over while the workers steal them from each other.
+  for (int task = 0; task < kTasksPerQueue; ++task) {
+    for (int i = 0; i < kNumQueues; ++i) {
+      TaskQueueBase* queue = queues[i].get();
+      int* queue_next = &next[i];
+      queues[i]->PostTask(ToQueuedTask([&, queue, queue_next, task] {
+        if (!queue->IsCurrent() || (*queue_next)++ != task)
+          ++out_of_order;
+        if (--remaining == 0)
+          done.Set();
+      }));
+    }
+  }
+  EXPECT_TRUE(done.Wait(10000));
+  EXPECT_EQ(out_of_order, 0);
+}
+
+TEST(TaskQueuePooledTest, QueuesRunInParallel) {
+  std::unique_ptr<TaskQueueFactory> factory = CreateTaskQueuePooledFactory(2);
+  TaskQueuePtr first =
+      factory->CreateTaskQueue("First", TaskQueueFactory::Priority::NORMAL);
+  TaskQueuePtr second =
+      factory->CreateTaskQueue("Second", TaskQueueFactory::Priority::NORMAL);
+
+  // Each task waits for the other, which only works on two workers.
+  rtc::Event first_running;
+  rtc::Event second_running;
+  rtc::Event first_done;
+  rtc::Event second_done;
+  first->PostTask(ToQueuedTask([&] {
+    first_running.Set();
+    if (second_running.Wait(1000))
+      first_done.Set();
+  }));
+  second->PostTask(ToQueuedTask([&] {
+    second_running.Set();
+    if (first_running.Wait(1000))
+      second_done.Set();
+  }));
+  EXPECT_TRUE(first_done.Wait(2000));
+  EXPECT_TRUE(second_done.Wait(2000));
+}
+
+TEST(TaskQueuePooledTest, BusyQueueDoesNotStarveOthers) {
+  std::unique_ptr<TaskQueueFactory> factory = CreateTaskQueuePooledFactory(1);
+  TaskQueuePtr busy =
+      factory->CreateTaskQueue("Busy", TaskQueueFactory::Priority::NORMAL);
+  TaskQueuePtr other =
+      factory->CreateTaskQueue("Other", TaskQueueFactory::Priority::NORMAL);
+
+  // A task that reposts itself until told to stop.
+  std::atomic<bool> stop(false);
+  rtc::Event busy_stopped;
+  class RepostingTask : public QueuedTask {
+   public:
+    RepostingTask(std::atomic<bool>* stop, rtc::Event* stopped)
+        : stop_(stop), stopped_(stopped) {}
+
+   private:
+    bool Run() override {
+      if (stop_->load()) {
+        stopped_->Set();
+        return true;
+      }
+      TaskQueueBase::Current()->PostTask(absl::WrapUnique(this));
+      return false;
+    }
+
+    std::atomic<bool>* const stop_;
+    rtc::Event* const stopped_;
+  };
+  busy->PostTask(std::make_unique<RepostingTask>(&stop, &busy_stopped));
+
+  rtc::Event other_ran;
+  other->PostTask(ToQueuedTask([&] { other_ran.Set(); }));
+  EXPECT_TRUE(other_ran.Wait(1000));
+  stop.store(true);
+  EXPECT_TRUE(busy_stopped.Wait(1000));
+}
+
+TEST(TaskQueuePooledTest, DeleteWaitsForRunningTask) {
+  std::unique_ptr<TaskQueueFactory> factory = CreateTaskQueuePooledFactory(2);
+  TaskQueuePtr queue =
+      factory->CreateTaskQueue("Queue", TaskQueueFactory::Priority::NORMAL);
+
+  rtc::Event started;
+  std::atomic<bool> finished(false);
+  bool second_ran = false;
+  queue->PostTask(ToQueuedTask([&] {
+    started.Set();
+    rtc::Event().Wait(100);
+    finished.store(true);
+  }));
+  queue->PostTask(ToQueuedTask([&] { second_ran = true; }));
+  ASSERT_TRUE(started.Wait(1000));
+  queue = nullptr;
+  EXPECT_TRUE(finished.load());
+  EXPECT_FALSE(second_ran);
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -13,10 +13,10 @@
 #include <string.h>
 
 #include <algorithm>
-#include <map>
 #include <memory>
 #include <queue>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "api/task_queue/queued_task.h"
@@ -28,6 +28,7 @@
 #include "rtc_base/synchronization/mutex.h"
 #include "rtc_base/thread_annotations.h"
 #include "rtc_base/time_utils.h"
+#include "rtc_base/timer_wheel.h"
 
 namespace webrtc {
 namespace {
@@ -59,16 +60,7 @@ class TaskQueueStdlib final : public TaskQueueBase {
 
  private:
   using OrderId = uint64_t;
-
-  struct DelayedEntryTimeout {
-    int64_t next_fire_at_ms_{};
-    OrderId order_{};
-
-    bool operator<(const DelayedEntryTimeout& o) const {
-      return std::tie(next_fire_at_ms_, order_) <
-             std::tie(o.next_fire_at_ms_, o.order_);
-    }
-  };
+  using OrderedTask = std::pair<OrderId, std::unique_ptr<QueuedTask>>;
 
   struct NextTask {
     bool final_task_{false};
@@ -108,17 +100,19 @@ class TaskQueueStdlib final : public TaskQueueBase {
 
   // The list of all pending tasks that need to be processed in the
   // FIFO queue ordering on the worker thread.
-  std::queue<std::pair<OrderId, std::unique_ptr<QueuedTask>>> pending_queue_
-      RTC_GUARDED_BY(pending_lock_);
-
-  // The list of all pending tasks that need to be processed at a future
-  // time based upon a delay. On the off change the delayed task should
-  // happen at exactly the same time interval as another task then the
-  // task is processed based on FIFO ordering. std::priority_queue was
-  // considered but rejected due to its inability to extract the
-  // std::unique_ptr out of the queue without the presence of a hack.
-  std::map<DelayedEntryTimeout, std::unique_ptr<QueuedTask>> delayed_queue_
-      RTC_GUARDED_BY(pending_lock_);
+  std::queue<OrderedTask> pending_queue_ RTC_GUARDED_BY(pending_lock_);
+
+  // All pending tasks that need to be processed at a future time based upon
+  // a delay. Should a delayed task happen at exactly the same time as another
+  // task then the tasks are processed based on FIFO ordering.
+  TimerWheel<OrderedTask> delayed_queue_ RTC_GUARDED_BY(pending_lock_);
+
+  // The delayed tasks whose time has come, in the order they are due. They
+  // are interleaved with |pending_queue_| by order of posting.
+  std::queue<OrderedTask> due_queue_ RTC_GUARDED_BY(pending_lock_);
+
+  // Scratch space for moving tasks from |delayed_queue_| to |due_queue_|.
+  std::vector<OrderedTask> expired_tasks_ RTC_GUARDED_BY(pending_lock_);
 };
 
 TaskQueueStdlib::TaskQueueStdlib(absl::string_view queue_name,
@@ -126,7 +120,8 @@ TaskQueueStdlib::TaskQueueStdlib(absl::string_view queue_name,
     : started_(/*manual_reset=*/false, /*initially_signaled=*/false),
       stopped_(/*manual_reset=*/false, /*initially_signaled=*/false),
       flag_notify_(/*manual_reset=*/false, /*initially_signaled=*/false),
-      thread_(&TaskQueueStdlib::ThreadMain, this, queue_name, priority) {
+      thread_(&TaskQueueStdlib::ThreadMain, this, queue_name, priority),
+      delayed_queue_(rtc::TimeMillis()) {
   thread_.Start();
   started_.Wait(rtc::Event::kForever);
 }
@@ -151,8 +146,7 @@ void TaskQueueStdlib::PostTask(std::unique_ptr<QueuedTask> task) {
     MutexLock lock(&pending_lock_);
     OrderId order = thread_posting_order_++;
 
-    pending_queue_.push(std::pair<OrderId, std::unique_ptr<QueuedTask>>(
-        order, std::move(task)));
+    pending_queue_.push(OrderedTask(order, std::move(task)));
   }
 
   NotifyWake();
@@ -162,13 +156,10 @@ void TaskQueueStdlib::PostDelayedTask(std::unique_ptr<QueuedTask> task,
                                       uint32_t milliseconds) {
   auto fire_at = rtc::TimeMillis() + milliseconds;
 
-  DelayedEntryTimeout delay;
-  delay.next_fire_at_ms_ = fire_at;
-
   {
     MutexLock lock(&pending_lock_);
-    delay.order_ = ++thread_posting_order_;
-    delayed_queue_[delay] = std::move(task);
+    OrderId order = ++thread_posting_order_;
+    delayed_queue_.Schedule(fire_at, OrderedTask(order, std::move(task)));
   }
 
   NotifyWake();
@@ -186,28 +177,30 @@ TaskQueueStdlib::NextTask TaskQueueStdlib::GetNextTask() {
     return result;
   }
 
-  if (delayed_queue_.size() > 0) {
-    auto delayed_entry = delayed_queue_.begin();
-    const auto& delay_info = delayed_entry->first;
-    auto& delay_run = delayed_entry->second;
-    if (tick >= delay_info.next_fire_at_ms_) {
-      if (pending_queue_.size() > 0) {
-        auto& entry = pending_queue_.front();
-        auto& entry_order = entry.first;
-        auto& entry_run = entry.second;
-        if (entry_order < delay_info.order_) {
-          result.run_task_ = std::move(entry_run);
-          pending_queue_.pop();
-          return result;
-        }
+  delayed_queue_.Advance(tick, &expired_tasks_);
+  for (OrderedTask& entry : expired_tasks_)
+    due_queue_.push(std::move(entry));
+  expired_tasks_.clear();
+
+  if (due_queue_.size() > 0) {
+    auto& delayed_entry = due_queue_.front();
+    if (pending_queue_.size() > 0) {
+      auto& entry = pending_queue_.front();
+      if (entry.first < delayed_entry.first) {
+        result.run_task_ = std::move(entry.second);
+        pending_queue_.pop();
+        return result;
       }
-
-      result.run_task_ = std::move(delay_run);
-      delayed_queue_.erase(delayed_entry);
-      return result;
     }
 
-    result.sleep_time_ms_ = delay_info.next_fire_at_ms_ - tick;
+    result.run_task_ = std::move(delayed_entry.second);
+    due_queue_.pop();
+    return result;
+  }
+
+  if (!delayed_queue_.empty()) {
+    // Advance() has moved past |tick|, so the next wake-up is later.
+    result.sleep_time_ms_ = delayed_queue_.NextWakeUp() - tick;
   }
 
   if (pending_queue_.size() > 0) {
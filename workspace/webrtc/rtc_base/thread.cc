@@ -37,6 +37,7 @@
 #include "rtc_base/internal/default_socket_server.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/null_socket_server.h"
+#include "rtc_base/synchronization/yield.h"
 #include "rtc_base/task_utils/to_queued_task.h"
 #include "rtc_base/time_utils.h"
 #include "rtc_base/trace_event.h"
@@ -402,6 +403,7 @@ void Thread::DoDestroy() {
   // is going away.
   SignalQueueDestroyed();
   ThreadManager::Remove(this);
+  // Also deletes the messages that are left in |incoming_|.
   ClearInternal(nullptr, MQID_ANY, nullptr);
 
   if (ss_) {
@@ -472,6 +474,7 @@ bool Thread::Get(Message* pmsg, int cmsWait, bool process_io) {
         // triggered and calculate the next trigger time.
         if (first_pass) {
           first_pass = false;
+          TakeIncomingMessages();
           while (!delayed_messages_.empty()) {
             if (msCurrent < delayed_messages_.top().run_time_ms_) {
               cmsDelayNext =
@@ -483,6 +486,8 @@ bool Thread::Get(Message* pmsg, int cmsWait, bool process_io) {
           }
         }
         // Pull a message off the message queue, if available.
+        if (messages_.empty())
+          TakeIncomingMessages();
         if (messages_.empty()) {
           break;
         } else {
@@ -504,6 +509,16 @@ bool Thread::Get(Message* pmsg, int cmsWait, bool process_io) {
     if (IsQuitting())
       break;
 
+    // Ask to be woken up by the next Post(), and look for messages one last
+    // time, since a Post() before that didn't wake us up.
+    {
+      CritScope cs(&crit_);
+      incoming_.PrepareToPop();
+      TakeIncomingMessages();
+      if (!messages_.empty())
+        continue;
+    }
+
     // Which is shorter, the delay wait or the asked wait?
 
     int64_t cmsNext;
@@ -544,20 +559,16 @@ void Thread::Post(const Location& posted_from,
     return;
   }
 
-  // Keep thread safe
-  // Add the message to the end of the queue
-  // Signal for the multiplexer to return
-
-  {
-    CritScope cs(&crit_);
-    Message msg;
-    msg.posted_from = posted_from;
-    msg.phandler = phandler;
-    msg.message_id = id;
-    msg.pdata = pdata;
-    messages_.push_back(msg);
-  }
-  WakeUpSocketServer();
+  // Add the message to the end of the queue, which is safe from any thread
+  // without a lock. Signal for the multiplexer to return, unless that has
+  // already been done since it last waited.
+  IncomingMessage* incoming = new IncomingMessage;
+  incoming->msg.posted_from = posted_from;
+  incoming->msg.phandler = phandler;
+  incoming->msg.message_id = id;
+  incoming->msg.pdata = pdata;
+  if (incoming_.Push(incoming))
+    WakeUpSocketServer();
 }
 
 void Thread::PostDelayed(const Location& posted_from,
@@ -614,6 +625,7 @@ void Thread::DoDelayPost(const Location& posted_from,
 int Thread::GetDelay() {
   CritScope cs(&crit_);
 
+  TakeIncomingMessages();
   if (!messages_.empty())
     return 0;
 
@@ -641,8 +653,11 @@ void Thread::ClearInternal(MessageHandler* phandler,
     fPeekKeep_ = false;
   }
 
-  // Remove from ordered message queue
+  // Remove from ordered message queue, including the messages of Post()s
+  // that are still in progress, since a Post() that has returned on another
+  // thread may be queued behind one.
 
+  TakeIncomingMessages(/*wait_for_posts=*/true);
   for (auto it = messages_.begin(); it != messages_.end();) {
     if (it->Match(phandler, id)) {
       if (removed) {
@@ -675,6 +690,19 @@ void Thread::ClearInternal(MessageHandler* phandler,
   delayed_messages_.reheap();
 }
 
+void Thread::TakeIncomingMessages(bool wait_for_posts) const {
+  while (true) {
+    while (IncomingMessage* incoming = incoming_.Pop()) {
+      messages_.push_back(incoming->msg);
+      delete incoming;
+    }
+    if (!wait_for_posts || !incoming_.PushInProgress())
+      return;
+    // The posting thread is between two instructions; let it run.
+    webrtc::YieldCurrentThread();
+  }
+}
+
 void Thread::Dispatch(Message* pmsg) {
   TRACE_EVENT2("webrtc", "Thread::Dispatch", "src_file",
                pmsg->posted_from.file_name(), "src_func",
@@ -13,6 +13,7 @@
 
 #include <stdint.h>
 
+#include <deque>
 #include <list>
 #include <map>
 #include <memory>
@@ -34,6 +35,7 @@
 #include "rtc_base/message_handler.h"
 #include "rtc_base/platform_thread_types.h"
 #include "rtc_base/socket_server.h"
+#include "rtc_base/synchronization/mpsc_queue.h"
 #include "rtc_base/system/rtc_export.h"
 #include "rtc_base/thread_annotations.h"
 #include "rtc_base/thread_message.h"
@@ -263,6 +265,7 @@ class RTC_LOCKABLE RTC_EXPORT Thread : public webrtc::TaskQueueBase {
   bool empty() const { return size() == 0u; }
   size_t size() const {
     CritScope cs(&crit_);
+    TakeIncomingMessages(/*wait_for_posts=*/true);
     return messages_.size() + delayed_messages_.size() + (fPeekKeep_ ? 1u : 0u);
   }
 
@@ -515,6 +518,12 @@ class RTC_LOCKABLE RTC_EXPORT Thread : public webrtc::TaskQueueBase {
 
   void WakeUpSocketServer();
 
+  // Moves the messages posted since the last call from |incoming_| to
+  // |messages_|. With |wait_for_posts|, also waits for the Post()s in
+  // progress, so that every Post() that has returned is moved.
+  void TakeIncomingMessages(bool wait_for_posts = false) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(&crit_);
+
   // Same as WrapCurrent except that it never fails as it does not try to
   // acquire the synchronization access of the thread. The caller should never
   // call Stop() or Join() on this thread.
@@ -538,6 +547,11 @@ class RTC_LOCKABLE RTC_EXPORT Thread : public webrtc::TaskQueueBase {
     void OnMessage(Message* msg) override;
   };
 
+  // A message on its way from Post() to |messages_|.
+  struct IncomingMessage : public webrtc::MpscQueueNode {
+    Message msg;
+  };
+
   // Sets the per-thread allow-blocking-calls flag and returns the previous
   // value. Must be called on this thread.
   bool SetAllowBlockingCalls(bool allow);
@@ -574,7 +588,11 @@ class RTC_LOCKABLE RTC_EXPORT Thread : public webrtc::TaskQueueBase {
 
   bool fPeekKeep_;
   Message msgPeek_;
-  MessageList messages_ RTC_GUARDED_BY(crit_);
+  // Messages are posted to |incoming_| without taking |crit_|, and moved to
+  // |messages_| by the thread when it looks for messages to process. A Post()
+  // only wakes the thread up if it has gone to sleep since the last wake-up.
+  mutable webrtc::MpscQueue<IncomingMessage> incoming_;
+  mutable std::deque<Message> messages_ RTC_GUARDED_BY(crit_);
   PriorityQueue delayed_messages_ RTC_GUARDED_BY(crit_);
   uint32_t delayed_next_num_ RTC_GUARDED_BY(crit_);
 #if (!defined(NDEBUG) || defined(DCHECK_ALWAYS_ON))
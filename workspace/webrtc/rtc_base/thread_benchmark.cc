@@ -0,0 +1,139 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "rtc_base/event.h"
+#include "rtc_base/location.h"
+#include "rtc_base/message_handler.h"
+#include "rtc_base/physical_socket_server.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/system/unused.h"
+#include "rtc_base/thread.h"
+
+namespace rtc {
+namespace {
+
+constexpr int kMessagesPerProducer = 10000;
+
+class CountingHandler : public MessageHandler {
+ public:
+  explicit CountingHandler(int count) : remaining_(count) {}
+
+  void OnMessage(Message* msg) override {
+    if (--remaining_ == 0)
+      done_.Set();
+  }
+
+  void Wait() { done_.Wait(Event::kForever); }
+
+ private:
+  int remaining_;
+  Event done_;
+};
+
+// Counts how often the consumer is woken up.
+class CountingSocketServer : public PhysicalSocketServer {
+ public:
+  void WakeUp() override {
+    wake_ups_.fetch_add(1, std::memory_order_relaxed);
+    PhysicalSocketServer::WakeUp();
+  }
+
+  int64_t wake_ups() const { return wake_ups_.load(); }
+
+ private:
+  std::atomic<int64_t> wake_ups_{0};
+};
+
+struct Producer {
+  Thread* target;
+  MessageHandler* handler;
+  Event* start;
+};
+
+void RunProducer(void* context) {
+  Producer* producer = static_cast<Producer*>(context);
+  producer->start->Wait(Event::kForever);
+  for (int i = 0; i < kMessagesPerProducer; ++i)
+    producer->target->Post(RTC_FROM_HERE, producer->handler);
+}
+
+// Posts messages to one thread from state.range(0) threads at once, as the
+// audio and network threads do to the signaling and worker threads, and waits
+// for them to be handled.
+void BM_PostFromProducers(benchmark::State& state) {
+  const int num_producers = state.range(0);
+  CountingSocketServer socket_server;
+  auto consumer = std::make_unique<Thread>(&socket_server);
+  consumer->Start();
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    CountingHandler handler(num_producers * kMessagesPerProducer);
+    Event start(/*manual_reset=*/true, /*initially_signaled=*/false);
+    Producer producer = {consumer.get(), &handler, &start};
+    std::vector<std::unique_ptr<PlatformThread>> threads;
+    for (int i = 0; i < num_producers; ++i) {
+      threads.push_back(
+          std::make_unique<PlatformThread>(&RunProducer, &producer, "Producer"));
+      threads.back()->Start();
+    }
+    start.Set();
+    handler.Wait();
+    for (auto& thread : threads)
+      thread->Stop();
+  }
+  consumer->Stop();
+  const int64_t num_messages =
+      state.iterations() * num_producers * kMessagesPerProducer;
+  state.SetItemsProcessed(num_messages);
+  state.counters["wake_ups_per_message"] =
+      static_cast<double>(socket_server.wake_ups()) / num_messages;
+}
+
+BENCHMARK(BM_PostFromProducers)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
+}  // namespace
+}  // namespace rtc
+
+/*
+
+Results (Linux, a single x86-64 core):
+
+Posting under the lock, waking the thread up for every message:
+----------------------------------------------------------------------------
+Benchmark                                    Time   UserCounters...
+----------------------------------------------------------------------------
+BM_PostFromProducers/1/real_time       3840773 ns   items_per_second=2.60M/s
+                                                    wake_ups_per_message=1
+BM_PostFromProducers/4/real_time      16435592 ns   items_per_second=2.43M/s
+                                                    wake_ups_per_message=1
+BM_PostFromProducers/16/real_time     60728433 ns   items_per_second=2.63M/s
+                                                    wake_ups_per_message=1
+
+Posting to the lock-free queue, waking the thread up once per batch:
+----------------------------------------------------------------------------
+Benchmark                                    Time   UserCounters...
+----------------------------------------------------------------------------
+BM_PostFromProducers/1/real_time       2889732 ns   items_per_second=3.46M/s
+                                                    wake_ups_per_message=0.8u
+BM_PostFromProducers/4/real_time      12780655 ns   items_per_second=3.13M/s
+                                                    wake_ups_per_message=21u
+BM_PostFromProducers/16/real_time     49989891 ns   items_per_second=3.20M/s
+                                                    wake_ups_per_message=6.8u
+
+On a single core the producers rarely contend for the lock, so the gain there
+comes from not writing to the socket server's wake-up pipe for every message.
+With producers on other cores, Post() no longer serializes them either.
+
+*/
@@ -10,7 +10,9 @@
 
 #include "rtc_base/thread.h"
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include "api/task_queue/task_queue_factory.h"
 #include "api/task_queue/task_queue_test.h"
@@ -22,6 +24,7 @@
 #include "rtc_base/internal/default_socket_server.h"
 #include "rtc_base/null_socket_server.h"
 #include "rtc_base/physical_socket_server.h"
+#include "rtc_base/platform_thread.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/synchronization/mutex.h"
 #include "rtc_base/task_utils/to_queued_task.h"
@@ -697,6 +700,54 @@ TEST(ThreadManager, ClearReentrant) {
           new ScopedRefMessageData<RefCountedHandler>(inner_handler));
 }
 
+struct ClearPoster {
+  static constexpr int kNumPosts = 20000;
+
+  Thread* thread;
+  MessageHandler* handler;
+  // Counts the Post()s that have returned.
+  std::atomic<int>* posted;
+};
+
+void PostToClear(void* context) {
+  ClearPoster* poster = static_cast<ClearPoster*>(context);
+  for (int i = 0; i < ClearPoster::kNumPosts; ++i) {
+    poster->thread->Post(RTC_FROM_HERE, poster->handler, i);
+    poster->posted->fetch_add(1, std::memory_order_release);
+  }
+}
+
+// Clear() removes the message of every Post() that returned before it,
+// although other threads keep posting. Posts are linked to the queue without
+// a lock, so a Post() that has returned can be queued behind one that is
+// still in progress.
+TEST(ThreadTest, ClearRemovesMessagesOfConcurrentPosts) {
+  constexpr int kNumPosters = 4;
+  NullSocketServer nullss;
+  Thread thread(&nullss);
+  EmptyHandler handler;
+  std::atomic<int> posted{0};
+  ClearPoster poster{&thread, &handler, &posted};
+  std::vector<std::unique_ptr<PlatformThread>> posters;
+  for (int i = 0; i < kNumPosters; ++i) {
+    posters.push_back(
+        std::make_unique<PlatformThread>(&PostToClear, &poster, "Poster"));
+    posters.back()->Start();
+  }
+  int cleared = 0;
+  while (cleared < kNumPosters * ClearPoster::kNumPosts) {
+    const int posted_before = posted.load(std::memory_order_acquire);
+    MessageList removed;
+    thread.Clear(&handler, MQID_ANY, &removed);
+    cleared += removed.size();
+    ASSERT_GE(cleared, posted_before);
+  }
+  for (auto& poster_thread : posters)
+    poster_thread->Stop();
+  EXPECT_EQ(cleared, kNumPosters * ClearPoster::kNumPosts);
+  EXPECT_TRUE(thread.empty());
+}
+
 class AsyncInvokeTest : public ::testing::Test {
  public:
   void IntCallback(int value) {
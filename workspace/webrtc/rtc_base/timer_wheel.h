@@ -0,0 +1,327 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_TIMER_WHEEL_H_
+#define RTC_BASE_TIMER_WHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "absl/numeric/bits.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+// A hashed hierarchical timer wheel with millisecond resolution, for the
+// delayed tasks of a task queue. Scheduling and cancelling a timer are O(1),
+// and don't allocate once the wheel has grown to the number of pending timers.
+// Expiry is done in batches by Advance().
+//
+// The first level has a slot for each of the next 256 ms. The four levels above
+// it have 64 slots each, covering 64 times the range of the level below, so that
+// any uint32_t millisecond delay fits. When the first level wraps around, the
+// next slot of the second level is redistributed over the first, and so on up.
+//
+// Values are returned by Advance() in order of due time, and in the order they
+// were scheduled for the same due time, just as with an ordered map. T must be
+// default constructible and movable. The wheel is not thread safe.
+template <typename T>
+class TimerWheel {
+ public:
+  // Identifies a scheduled timer. Never 0.
+  using TimerId = uint64_t;
+
+  static constexpr int64_t kNever = std::numeric_limits<int64_t>::max();
+
+  explicit TimerWheel(int64_t now_ms) : current_ms_(now_ms) {
+    heads_.fill(kNil);
+  }
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Schedules |value| to be returned by the first Advance() to |fire_at_ms| or
+  // later. A time that has already passed is returned by the next Advance().
+  TimerId Schedule(int64_t fire_at_ms, T value) {
+    uint32_t index;
+    if (free_ != kNil) {
+      index = free_;
+      free_ = nodes_[index].next;
+    } else {
+      RTC_CHECK_LT(nodes_.size(), kNil);
+      index = static_cast<uint32_t>(nodes_.size());
+      nodes_.emplace_back();
+    }
+    Node& node = nodes_[index];
+    node.fire_at_ms = fire_at_ms;
+    node.order = next_order_++;
+    node.in_use = true;
+    node.value = std::move(value);
+    Link(index);
+    ++size_;
+    return (static_cast<uint64_t>(node.generation) << 32) | index;
+  }
+
+  // Destroys the value of a pending timer. Returns false if the timer has
+  // already expired or been cancelled.
+  bool Cancel(TimerId id) {
+    const uint32_t index = static_cast<uint32_t>(id);
+    if (index >= nodes_.size() || !nodes_[index].in_use ||
+        nodes_[index].generation != static_cast<uint32_t>(id >> 32)) {
+      return false;
+    }
+    Unlink(index);
+    Free(index);
+    return true;
+  }
+
+  // Moves the values that are due at |now_ms| to the end of |expired|. Empty
+  // stretches of time are skipped, so the cost is in the number of slots with
+  // timers that are passed, rather than in the time since the last call.
+  void Advance(int64_t now_ms, std::vector<T>* expired) {
+    due_.clear();
+    TakeSlot(kOverdueSlot, &due_);
+    while (current_ms_ <= now_ms) {
+      const int64_t next_ms = NextWakeUp();
+      if (next_ms > current_ms_) {
+        MoveTo(std::min(next_ms, now_ms + 1));
+        continue;
+      }
+      TakeSlot(SlotIndex(0, current_ms_), &due_);
+      MoveTo(current_ms_ + 1);
+    }
+    // Entries end up in the same slot in a different order when they have
+    // been cascaded, so sort the batch.
+    std::sort(due_.begin(), due_.end(), [this](uint32_t a, uint32_t b) {
+      return std::make_pair(nodes_[a].fire_at_ms, nodes_[a].order) <
+             std::make_pair(nodes_[b].fire_at_ms, nodes_[b].order);
+    });
+    for (uint32_t index : due_) {
+      expired->push_back(std::move(nodes_[index].value));
+      Free(index);
+    }
+  }
+
+  // Returns a time at which Advance() should be called next, kNever if there
+  // are no timers. It is never later than the earliest due time, but may be
+  // earlier when the earliest timers are still on an upper level.
+  int64_t NextWakeUp() const {
+    if (size_ == 0)
+      return kNever;
+    // Timers scheduled for before the time the wheel has been advanced to are
+    // due already.
+    if (heads_[kOverdueSlot] != kNil)
+      return current_ms_ - 1;
+    int64_t wake_up_ms = kNever;
+    // The first level holds the exact due times of the next 256 ms.
+    const int distance = NextSetBit<kLevel0Words>(
+        &occupied_[0], static_cast<int>(current_ms_ & SlotMask(0)));
+    if (distance >= 0)
+      wake_up_ms = current_ms_ + distance;
+    // The slots of the upper levels become due when the first level reaches
+    // their start. The current slot of a level holds timers one full turn of
+    // that level ahead, since its timers for this turn have been cascaded.
+    for (int level = 1; level < kNumLevels; ++level) {
+      const int64_t position = current_ms_ >> Shift(level);
+      const int d = NextSetBit<1>(&occupied_[OccupiedWord(level)],
+                                  static_cast<int>((position + 1) & 63));
+      if (d >= 0)
+        wake_up_ms = std::min(wake_up_ms, (position + 1 + d) << Shift(level));
+    }
+    return wake_up_ms;
+  }
+
+  // Destroys all pending values.
+  void Clear() {
+    for (uint32_t index = 0; index < nodes_.size(); ++index) {
+      if (nodes_[index].in_use) {
+        Unlink(index);
+        Free(index);
+      }
+    }
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  static constexpr uint32_t kNil = std::numeric_limits<uint32_t>::max();
+  static constexpr int kNumLevels = 5;
+  static constexpr int kLevel0Slots = 256;
+  static constexpr int kLevelSlots = 64;
+  static constexpr int kLevel0Words = kLevel0Slots / 64;
+  static constexpr int kNumWheelSlots =
+      kLevel0Slots + (kNumLevels - 1) * kLevelSlots;
+  // An extra slot, after those of the levels, for timers that are overdue.
+  static constexpr int kOverdueSlot = kNumWheelSlots;
+  // The furthest ahead the levels reach.
+  static constexpr int64_t kMaxDelayMs = (int64_t{1} << 32) - 1;
+
+  struct Node {
+    int64_t fire_at_ms = 0;
+    uint64_t order = 0;
+    uint32_t prev = kNil;
+    uint32_t next = kNil;
+    uint32_t generation = 1;
+    uint16_t slot = 0;
+    bool in_use = false;
+    T value{};
+  };
+
+  // Returns the distance from bit |start| to the first set bit at or after it,
+  // wrapping around, or -1 if no bit is set.
+  template <int kWords>
+  static int NextSetBit(const uint64_t* words, int start) {
+    const int first_word = start / 64;
+    const int bit = start % 64;
+    uint64_t word = words[first_word] >> bit;
+    if (word != 0)
+      return absl::countr_zero(word);
+    int distance = 64 - bit;
+    for (int i = 1; i <= kWords; ++i) {
+      word = words[(first_word + i) % kWords];
+      if (i == kWords) {
+        // Back at the first word, where only the bits below |start| are left.
+        word &= bit == 0 ? 0 : (uint64_t{1} << bit) - 1;
+      }
+      if (word != 0)
+        return distance + absl::countr_zero(word);
+      distance += 64;
+    }
+    return -1;
+  }
+
+  // The bits of a due time that select the slot on each level are
+  // (time >> Shift(level)) & SlotMask(level).
+  static int Shift(int level) { return level == 0 ? 0 : 2 + 6 * level; }
+  static int64_t SlotMask(int level) {
+    return level == 0 ? kLevel0Slots - 1 : kLevelSlots - 1;
+  }
+  static int LevelBase(int level) {
+    return level == 0 ? 0 : kLevel0Slots + (level - 1) * kLevelSlots;
+  }
+  static int OccupiedWord(int level) {
+    return LevelBase(level) / 64;
+  }
+  static int SlotIndex(int level, int64_t time_ms) {
+    return LevelBase(level) +
+           static_cast<int>((time_ms >> Shift(level)) & SlotMask(level));
+  }
+
+  // Puts the node in the slot for its due time, relative to |current_ms_|.
+  void Link(uint32_t index) {
+    Node& node = nodes_[index];
+    int slot = kOverdueSlot;
+    if (node.fire_at_ms >= current_ms_) {
+      // Timers further ahead than the wheel reaches are cascaded before they
+      // are due, and put in their real slot then.
+      const int64_t time_ms =
+          std::min(node.fire_at_ms, current_ms_ + kMaxDelayMs);
+      const int64_t delay_ms = time_ms - current_ms_;
+      int level = 0;
+      while (level + 1 < kNumLevels &&
+             delay_ms >= int64_t{1} << Shift(level + 1)) {
+        ++level;
+      }
+      slot = SlotIndex(level, time_ms);
+    }
+    node.slot = static_cast<uint16_t>(slot);
+    node.prev = kNil;
+    node.next = heads_[slot];
+    if (node.next != kNil)
+      nodes_[node.next].prev = index;
+    heads_[slot] = index;
+    occupied_[slot / 64] |= uint64_t{1} << (slot % 64);
+  }
+
+  void Unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.prev != kNil) {
+      nodes_[node.prev].next = node.next;
+    } else {
+      heads_[node.slot] = node.next;
+      if (node.next == kNil)
+        occupied_[node.slot / 64] &= ~(uint64_t{1} << (node.slot % 64));
+    }
+    if (node.next != kNil)
+      nodes_[node.next].prev = node.prev;
+  }
+
+  void Free(uint32_t index) {
+    Node& node = nodes_[index];
+    node.value = T();
+    node.in_use = false;
+    ++node.generation;
+    node.next = free_;
+    free_ = index;
+    --size_;
+  }
+
+  // Moves all the nodes of |slot| to |indices|.
+  void TakeSlot(int slot, std::vector<uint32_t>* indices) {
+    for (uint32_t index = heads_[slot]; index != kNil;
+         index = nodes_[index].next) {
+      indices->push_back(index);
+    }
+    heads_[slot] = kNil;
+    occupied_[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+  }
+
+  // Moves to |time_ms|, which must not be past the next wake-up.
+  // When the first level wraps around, the current slot of the second level is
+  // redistributed, and so on up for the levels that wrap around too. This is
+  // done right away, since NextWakeUp() takes the current slots of the upper
+  // levels to be a full turn ahead.
+  void MoveTo(int64_t time_ms) {
+    current_ms_ = time_ms;
+    if ((current_ms_ & SlotMask(0)) == 0)
+      Cascade();
+  }
+
+  void Cascade() {
+    for (int level = 1; level < kNumLevels; ++level) {
+      const int slot = SlotIndex(level, current_ms_);
+      cascaded_.clear();
+      TakeSlot(slot, &cascaded_);
+      for (uint32_t index : cascaded_)
+        Link(index);
+      if (((current_ms_ >> Shift(level)) & SlotMask(level)) != 0)
+        break;
+    }
+  }
+
+  // The next millisecond to expire.
+  int64_t current_ms_;
+  uint64_t next_order_ = 0;
+  size_t size_ = 0;
+  std::vector<Node> nodes_;
+  // Unused nodes, linked through |next|.
+  uint32_t free_ = kNil;
+  std::array<uint32_t, kNumWheelSlots + 1> heads_;
+  // A bit for each slot that has nodes.
+  std::array<uint64_t, kNumWheelSlots / 64 + 1> occupied_{};
+  // Scratch space, kept to avoid allocations.
+  std::vector<uint32_t> due_;
+  std::vector<uint32_t> cascaded_;
+};
+
+template <typename T>
+constexpr int64_t TimerWheel<T>::kNever;
+template <typename T>
+constexpr uint32_t TimerWheel<T>::kNil;
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_TIMER_WHEEL_H_
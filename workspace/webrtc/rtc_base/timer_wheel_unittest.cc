@@ -0,0 +1,190 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/timer_wheel.h"
+
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(TimerWheelTest, ExpiresInOrderOfDueTime) {
+  TimerWheel<int> wheel(0);
+  wheel.Schedule(30, 3);
+  wheel.Schedule(10, 1);
+  wheel.Schedule(20, 2);
+  wheel.Schedule(10, 4);
+  EXPECT_EQ(wheel.size(), 4u);
+
+  std::vector<int> expired;
+  wheel.Advance(9, &expired);
+  EXPECT_THAT(expired, IsEmpty());
+  wheel.Advance(20, &expired);
+  EXPECT_THAT(expired, ElementsAre(1, 4, 2));
+  wheel.Advance(1000, &expired);
+  EXPECT_THAT(expired, ElementsAre(1, 4, 2, 3));
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, OverdueTimersExpireOnNextAdvance) {
+  TimerWheel<int> wheel(1000);
+  std::vector<int> expired;
+  wheel.Advance(1000, &expired);
+  wheel.Schedule(500, 1);
+  wheel.Schedule(1000, 2);
+  EXPECT_LE(wheel.NextWakeUp(), 1000);
+  wheel.Advance(1000, &expired);
+  EXPECT_THAT(expired, ElementsAre(1, 2));
+}
+
+TEST(TimerWheelTest, CascadesThroughAllLevels) {
+  constexpr int64_t kStart = 123456789;
+  const std::vector<int64_t> delays = {
+      1, 255, 256, 257, 1000, 16383, 16384, 70000, 1 << 20, (1 << 20) + 1,
+      1 << 26, (1 << 26) + 12345, int64_t{1} << 31, (int64_t{1} << 32) - 1};
+  TimerWheel<int64_t> wheel(kStart);
+  for (int64_t delay : delays)
+    wheel.Schedule(kStart + delay, delay);
+
+  std::vector<int64_t> expired;
+  for (int64_t delay : delays) {
+    wheel.Advance(kStart + delay - 1, &expired);
+    EXPECT_EQ(expired.size(), 0u) << delay;
+    EXPECT_LE(wheel.NextWakeUp(), kStart + delay);
+    wheel.Advance(kStart + delay, &expired);
+    EXPECT_THAT(expired, ElementsAre(delay));
+    expired.clear();
+  }
+  EXPECT_EQ(wheel.NextWakeUp(), TimerWheel<int64_t>::kNever);
+}
+
+TEST(TimerWheelTest, HandlesDelaysBeyondTheLastLevel) {
+  TimerWheel<int> wheel(0);
+  constexpr int64_t kFarAway = int64_t{5} << 32;
+  wheel.Schedule(kFarAway, 1);
+  std::vector<int> expired;
+  wheel.Advance(kFarAway - 1, &expired);
+  EXPECT_THAT(expired, IsEmpty());
+  wheel.Advance(kFarAway, &expired);
+  EXPECT_THAT(expired, ElementsAre(1));
+}
+
+TEST(TimerWheelTest, CancelDestroysValue) {
+  TimerWheel<std::unique_ptr<int>> wheel(0);
+  auto first = wheel.Schedule(10, std::make_unique<int>(1));
+  auto second = wheel.Schedule(10, std::make_unique<int>(2));
+  EXPECT_TRUE(wheel.Cancel(first));
+  EXPECT_FALSE(wheel.Cancel(first));
+  EXPECT_EQ(wheel.size(), 1u);
+
+  std::vector<std::unique_ptr<int>> expired;
+  wheel.Advance(10, &expired);
+  ASSERT_EQ(expired.size(), 1u);
+  EXPECT_EQ(*expired[0], 2);
+  EXPECT_FALSE(wheel.Cancel(second));
+}
+
+TEST(TimerWheelTest, StaleIdDoesNotCancelReusedTimer) {
+  TimerWheel<int> wheel(0);
+  auto first = wheel.Schedule(10, 1);
+  EXPECT_TRUE(wheel.Cancel(first));
+  auto second = wheel.Schedule(10, 2);
+  EXPECT_NE(first, second);
+  EXPECT_FALSE(wheel.Cancel(first));
+  EXPECT_TRUE(wheel.Cancel(second));
+}
+
+TEST(TimerWheelTest, NextWakeUpIsNotLaterThanFirstDueTime) {
+  TimerWheel<int> wheel(0);
+  EXPECT_EQ(wheel.NextWakeUp(), TimerWheel<int>::kNever);
+  wheel.Schedule(100000, 1);
+  int64_t wake_up = wheel.NextWakeUp();
+  EXPECT_LE(wake_up, 100000);
+  // Following the wake-ups only ever moves closer to the due time.
+  std::vector<int> expired;
+  while (expired.empty()) {
+    wheel.Advance(wake_up, &expired);
+    int64_t next = wheel.NextWakeUp();
+    if (expired.empty()) {
+      EXPECT_GT(next, wake_up);
+      EXPECT_LE(next, 100000);
+    }
+    wake_up = next;
+  }
+  EXPECT_THAT(expired, ElementsAre(1));
+}
+
+TEST(TimerWheelTest, ClearDestroysAllValues) {
+  auto value = std::make_shared<int>(0);
+  TimerWheel<std::shared_ptr<int>> wheel(0);
+  wheel.Schedule(10, value);
+  wheel.Schedule(100000, value);
+  EXPECT_EQ(value.use_count(), 3);
+  wheel.Clear();
+  EXPECT_EQ(value.use_count(), 1);
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_EQ(wheel.NextWakeUp(), TimerWheel<std::shared_ptr<int>>::kNever);
+}
+
+// Compares the wheel with an ordered map of random timers, advanced in random
+// steps and with some timers cancelled on the way.
+TEST(TimerWheelTest, MatchesOrderedMap) {
+  std::mt19937 random(4711);
+  int64_t now = 1000;
+  TimerWheel<int> wheel(now);
+  std::map<std::pair<int64_t, int>, TimerWheel<int>::TimerId> reference;
+  int next_value = 0;
+
+  for (int round = 0; round < 2000; ++round) {
+    const int num_new = random() % 20;
+    for (int i = 0; i < num_new; ++i) {
+      // Mostly short delays, with some that are long enough for the upper
+      // levels.
+      const int64_t delay = random() % 4 == 0 ? random() % 3000000
+                                              : random() % 300;
+      const int value = next_value++;
+      reference[{now + delay, value}] = wheel.Schedule(now + delay, value);
+    }
+    if (!reference.empty() && random() % 3 == 0) {
+      auto it = reference.begin();
+      std::advance(it, random() % reference.size());
+      EXPECT_TRUE(wheel.Cancel(it->second));
+      reference.erase(it);
+    }
+
+    now += random() % 4 == 0 ? random() % 100000 : random() % 50;
+    std::vector<int> expected;
+    while (!reference.empty() && reference.begin()->first.first <= now) {
+      expected.push_back(reference.begin()->first.second);
+      reference.erase(reference.begin());
+    }
+    std::vector<int> expired;
+    wheel.Advance(now, &expired);
+    ASSERT_EQ(expired, expected) << "round " << round;
+    ASSERT_EQ(wheel.size(), reference.size());
+    if (!reference.empty()) {
+      ASSERT_LE(wheel.NextWakeUp(), reference.begin()->first.first);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
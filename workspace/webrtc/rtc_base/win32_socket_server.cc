@@ -565,6 +565,9 @@ int Win32Socket::TranslateOption(Option opt, int* slevel, int* sopt) {
     case OPT_DSCP:
       RTC_LOG(LS_WARNING) << "Socket::OPT_DSCP not supported.";
       return -1;
+    case OPT_UDP_GRO:
+      RTC_LOG(LS_WARNING) << "Socket::OPT_UDP_GRO not supported.";
+      return -1;
     default:
       RTC_NOTREACHED();
       return -1;
@@ -13,6 +13,8 @@
 
 #include <string>
 
+#include "absl/strings/string_view.h"
+
 // Field trials allow webrtc clients (such as Chrome) to turn on feature code
 // in binaries out in the field and gather information with that.
 //
@@ -66,15 +68,11 @@ std::string FindFullName(const std::string& name);
 // Convenience method, returns true iff FindFullName(name) return a string that
 // starts with "Enabled".
 // TODO(tommi): Make sure all implementations support this.
-inline bool IsEnabled(const char* name) {
-  return FindFullName(name).find("Enabled") == 0;
-}
+bool IsEnabled(const char* name);
 
 // Convenience method, returns true iff FindFullName(name) return a string that
 // starts with "Disabled".
-inline bool IsDisabled(const char* name) {
-  return FindFullName(name).find("Disabled") == 0;
-}
+bool IsDisabled(const char* name);
 
 // Optionally initialize field trial from a string.
 // This method can be called at most once before any other call into webrtc.
@@ -85,6 +83,11 @@ void InitFieldTrialsFromString(const char* trials_string);
 const char* GetFieldTrialString();
 
 #ifndef WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT
+// Like FindFullName, but returns a view of the group name in the string passed
+// to InitFieldTrialsFromString, which is looked up in an index built when the
+// field trials were initialized, so that nothing is parsed or copied.
+absl::string_view FindFullNameView(absl::string_view name);
+
 // Validates the given field trial string.
 bool FieldTrialsStringIsValid(const char* trials_string);
 
@@ -10,10 +10,15 @@
 #include "system_wrappers/include/field_trial.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 
+#include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -29,6 +34,53 @@ static const char* trials_init_string = NULL;
 #ifndef WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT
 namespace {
 constexpr char kPersistentStringSeparator = '/';
+
+// FNV-1a, since absl::string_view isn't hashable by std::hash in every build.
+struct StringViewHash {
+  size_t operator()(absl::string_view s) const {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : s)
+      hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    return static_cast<size_t>(hash);
+  }
+};
+
+// Maps the trial names to the group names, both pointing into
+// |trials_init_string|.
+using FieldTrialIndex =
+    std::unordered_map<absl::string_view, absl::string_view, StringViewHash>;
+
+// Built by InitFieldTrialsFromString, so that lookups don't parse the trials
+// string. Replaced, like |trials_init_string|, only when the field trials are
+// reinitialized, which tests do (see ScopedFieldTrials) while other threads
+// may be looking up trials. A replaced index is therefore never deleted.
+std::atomic<const FieldTrialIndex*> trials_index{nullptr};
+
+std::unique_ptr<FieldTrialIndex> IndexFieldTrials(
+    const absl::string_view trials) {
+  auto index = std::make_unique<FieldTrialIndex>();
+  size_t next_item = 0;
+  while (next_item < trials.length()) {
+    // Find next name/value pair in field trial configuration string.
+    size_t field_name_end = trials.find(kPersistentStringSeparator, next_item);
+    if (field_name_end == trials.npos || field_name_end == next_item)
+      break;
+    size_t field_value_end =
+        trials.find(kPersistentStringSeparator, field_name_end + 1);
+    if (field_value_end == trials.npos || field_value_end == field_name_end + 1)
+      break;
+    absl::string_view field_name =
+        trials.substr(next_item, field_name_end - next_item);
+    absl::string_view field_value = trials.substr(
+        field_name_end + 1, field_value_end - field_name_end - 1);
+    next_item = field_value_end + 1;
+
+    // The first group of a trial that is listed more than once is used.
+    index->emplace(field_name, field_value);
+  }
+  return index;
+}
+
 // Validates the given field trial string.
 //  E.g.:
 //    "WebRTC-experimentFoo/Enabled/WebRTC-experimentBar/Enabled100kbps/"
@@ -102,36 +154,18 @@ std::string MergeFieldTrialsStrings(const char* first, const char* second) {
   return merged;
 }
 
-std::string FindFullName(const std::string& name) {
-  if (trials_init_string == NULL)
-    return std::string();
-
-  std::string trials_string(trials_init_string);
-  if (trials_string.empty())
-    return std::string();
-
-  size_t next_item = 0;
-  while (next_item < trials_string.length()) {
-    // Find next name/value pair in field trial configuration string.
-    size_t field_name_end =
-        trials_string.find(kPersistentStringSeparator, next_item);
-    if (field_name_end == trials_string.npos || field_name_end == next_item)
-      break;
-    size_t field_value_end =
-        trials_string.find(kPersistentStringSeparator, field_name_end + 1);
-    if (field_value_end == trials_string.npos ||
-        field_value_end == field_name_end + 1)
-      break;
-    std::string field_name(trials_string, next_item,
-                           field_name_end - next_item);
-    std::string field_value(trials_string, field_name_end + 1,
-                            field_value_end - field_name_end - 1);
-    next_item = field_value_end + 1;
+absl::string_view FindFullNameView(absl::string_view name) {
+  const FieldTrialIndex* index = trials_index.load(std::memory_order_acquire);
+  if (index == nullptr)
+    return absl::string_view();
+  auto it = index->find(name);
+  if (it == index->end())
+    return absl::string_view();
+  return it->second;
+}
 
-    if (name == field_name)
-      return field_value;
-  }
-  return std::string();
+std::string FindFullName(const std::string& name) {
+  return std::string(FindFullNameView(name));
 }
 #endif  // WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT
 
@@ -143,10 +177,30 @@ void InitFieldTrialsFromString(const char* trials_string) {
     RTC_DCHECK(FieldTrialsStringIsValidInternal(trials_string))
         << "Invalid field trials string:" << trials_string;
   };
+  // The previous index is leaked, see |trials_index|.
+  trials_index.store(
+      trials_string ? IndexFieldTrials(trials_string).release() : nullptr,
+      std::memory_order_release);
 #endif  // WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT
   trials_init_string = trials_string;
 }
 
+bool IsEnabled(const char* name) {
+#ifndef WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT
+  return absl::StartsWith(FindFullNameView(name), "Enabled");
+#else
+  return FindFullName(name).find("Enabled") == 0;
+#endif  // WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT
+}
+
+bool IsDisabled(const char* name) {
+#ifndef WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT
+  return absl::StartsWith(FindFullNameView(name), "Disabled");
+#else
+  return FindFullName(name).find("Disabled") == 0;
+#endif  // WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT
+}
+
 const char* GetFieldTrialString() {
   return trials_init_string;
 }
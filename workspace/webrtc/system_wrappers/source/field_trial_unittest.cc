@@ -10,6 +10,7 @@
 #include "system_wrappers/include/field_trial.h"
 
 #include "rtc_base/checks.h"
+#include "rtc_base/platform_thread.h"
 #include "test/gtest.h"
 #include "test/testsupport/rtc_expect_death.h"
 
@@ -103,5 +104,74 @@ TEST(FieldTrialMergingTest, HandlesEmptyInput) {
 #endif  // GTEST_HAS_DEATH_TEST && RTC_DCHECK_IS_ON && !defined(WEBRTC_ANDROID)
         // && !defined(WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT)
 
+#if !defined(WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT)
+class FieldTrialLookupTest : public ::testing::Test {
+ protected:
+  FieldTrialLookupTest() : previous_trials_(GetFieldTrialString()) {}
+  ~FieldTrialLookupTest() override {
+    InitFieldTrialsFromString(previous_trials_);
+  }
+
+ private:
+  const char* const previous_trials_;
+};
+
+TEST_F(FieldTrialLookupTest, FindsGroups) {
+  InitFieldTrialsFromString("Audio/Enabled/Video/Disabled-100/");
+  EXPECT_EQ(FindFullName("Audio"), "Enabled");
+  EXPECT_EQ(FindFullName("Video"), "Disabled-100");
+  EXPECT_EQ(FindFullName("Data"), "");
+  EXPECT_EQ(FindFullName("Audi"), "");
+  EXPECT_EQ(FindFullNameView("Audio"), "Enabled");
+  EXPECT_EQ(FindFullNameView("Data"), "");
+  EXPECT_TRUE(IsEnabled("Audio"));
+  EXPECT_FALSE(IsDisabled("Audio"));
+  EXPECT_FALSE(IsEnabled("Video"));
+  EXPECT_TRUE(IsDisabled("Video"));
+  EXPECT_FALSE(IsEnabled("Data"));
+  EXPECT_FALSE(IsDisabled("Data"));
+}
+
+TEST_F(FieldTrialLookupTest, ViewsPointIntoTrialsString) {
+  static constexpr char kTrials[] = "Audio/Enabled/";
+  InitFieldTrialsFromString(kTrials);
+  EXPECT_EQ(FindFullNameView("Audio").data(), kTrials + 6);
+}
+
+TEST_F(FieldTrialLookupTest, FindsNothingWithoutTrials) {
+  InitFieldTrialsFromString(nullptr);
+  EXPECT_EQ(FindFullName("Audio"), "");
+  InitFieldTrialsFromString("");
+  EXPECT_EQ(FindFullName("Audio"), "");
+  EXPECT_FALSE(IsEnabled("Audio"));
+}
+
+TEST_F(FieldTrialLookupTest, ReindexesWhenReinitialized) {
+  InitFieldTrialsFromString("Audio/Enabled/");
+  EXPECT_TRUE(IsEnabled("Audio"));
+  InitFieldTrialsFromString("Audio/Disabled/Video/Enabled/");
+  EXPECT_TRUE(IsDisabled("Audio"));
+  EXPECT_TRUE(IsEnabled("Video"));
+}
+
+void LookUpAudio(void* /*unused*/) {
+  for (int i = 0; i < 100000; ++i) {
+    absl::string_view group = FindFullNameView("Audio");
+    EXPECT_TRUE(group == "Enabled" || group == "Disabled") << group;
+  }
+}
+
+// Tests reinitialize the field trials, as ScopedFieldTrials does, while
+// threads that they have started may still look them up.
+TEST_F(FieldTrialLookupTest, LooksUpWhileReinitialized) {
+  InitFieldTrialsFromString("Audio/Enabled/");
+  rtc::PlatformThread thread(&LookUpAudio, nullptr, "LookUp");
+  thread.Start();
+  for (int i = 0; i < 1000; ++i)
+    InitFieldTrialsFromString(i % 2 ? "Audio/Enabled/" : "Audio/Disabled/");
+  thread.Stop();
+}
+#endif  // !defined(WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT)
+
 }  // namespace field_trial
 }  // namespace webrtc
@@ -15,6 +15,17 @@
 #include "rtc_base/synchronization/mutex.h"
 #include "rtc_base/thread_annotations.h"
 
+#if defined(WEBRTC_SHARDED_METRICS)
+#include <unordered_map>
+
+#include "absl/base/attributes.h"
+#include "absl/base/config.h"
+#include "system_wrappers/source/sharded_histogram.h"
+#if !defined(ABSL_HAVE_THREAD_LOCAL) && defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
+#endif
+
 // Default implementation of histogram methods for WebRTC clients that do not
 // want to provide their own implementation.
 
@@ -23,6 +34,49 @@ namespace metrics {
 class Histogram;
 
 namespace {
+#if defined(WEBRTC_SHARDED_METRICS)
+using RtcHistogram = ShardedHistogram;
+
+// The histograms that the current thread has looked up, by name.
+using HistogramCache = std::unordered_map<std::string, Histogram*>;
+
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+
+HistogramCache& CurrentThreadCache() {
+  thread_local HistogramCache cache;
+  return cache;
+}
+
+#elif defined(WEBRTC_POSIX)
+
+// Allocated on the thread's first lookup, and deleted when it exits.
+ABSL_CONST_INIT pthread_key_t g_histogram_cache_tls = 0;
+
+void DeleteHistogramCache(void* cache) {
+  delete static_cast<HistogramCache*>(cache);
+}
+
+void InitializeTls() {
+  RTC_CHECK_EQ(
+      pthread_key_create(&g_histogram_cache_tls, &DeleteHistogramCache), 0);
+}
+
+HistogramCache& CurrentThreadCache() {
+  static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+  RTC_CHECK_EQ(pthread_once(&init_once, &InitializeTls), 0);
+  HistogramCache* cache =
+      static_cast<HistogramCache*>(pthread_getspecific(g_histogram_cache_tls));
+  if (!cache) {
+    cache = new HistogramCache();
+    pthread_setspecific(g_histogram_cache_tls, cache);
+  }
+  return *cache;
+}
+
+#else
+#error Unsupported platform
+#endif
+#else
 // Limit for the maximum number of sample values that can be stored.
 // TODO(asapersson): Consider using bucket count (and set up
 // linearly/exponentially spaced buckets) if samples are logged more frequently.
@@ -102,6 +156,7 @@ class RtcHistogram {
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtcHistogram);
 };
+#endif  // defined(WEBRTC_SHARDED_METRICS)
 
 class RtcHistogramMap {
  public:
@@ -111,24 +166,46 @@ class RtcHistogramMap {
   Histogram* GetCountsHistogram(const std::string& name,
                                 int min,
                                 int max,
-                                int bucket_count) {
+                                int bucket_count,
+                                bool exponential) {
+#if defined(WEBRTC_SHARDED_METRICS)
+    if (Histogram* cached = FindCached(name))
+      return cached;
+#endif
     MutexLock lock(&mutex_);
     const auto& it = map_.find(name);
     if (it != map_.end())
       return reinterpret_cast<Histogram*>(it->second.get());
 
+#if defined(WEBRTC_SHARDED_METRICS)
+    RtcHistogram* hist = new RtcHistogram(
+        name, min, max, bucket_count,
+        exponential ? ShardedHistogram::Buckets::kExponential
+                    : ShardedHistogram::Buckets::kLinear);
+#else
+    // Keeps each sample value, so it has no buckets.
     RtcHistogram* hist = new RtcHistogram(name, min, max, bucket_count);
+#endif
     map_[name].reset(hist);
     return reinterpret_cast<Histogram*>(hist);
   }
 
   Histogram* GetEnumerationHistogram(const std::string& name, int boundary) {
+#if defined(WEBRTC_SHARDED_METRICS)
+    if (Histogram* cached = FindCached(name))
+      return cached;
+#endif
     MutexLock lock(&mutex_);
     const auto& it = map_.find(name);
     if (it != map_.end())
       return reinterpret_cast<Histogram*>(it->second.get());
 
+#if defined(WEBRTC_SHARDED_METRICS)
+    RtcHistogram* hist = new RtcHistogram(name, 1, boundary, boundary + 1,
+                                          ShardedHistogram::Buckets::kLinear);
+#else
     RtcHistogram* hist = new RtcHistogram(name, 1, boundary, boundary + 1);
+#endif
     map_[name].reset(hist);
     return reinterpret_cast<Histogram*>(hist);
   }
@@ -175,6 +252,25 @@ class RtcHistogramMap {
   }
 
  private:
+#if defined(WEBRTC_SHARDED_METRICS)
+  // The histograms are never destroyed, so each thread keeps the ones that it
+  // looked up, and only takes the lock the first time. The slow histogram
+  // macros look up the histogram for every sample.
+  Histogram* FindCached(const std::string& name) {
+    HistogramCache& cache = CurrentThreadCache();
+    const auto it = cache.find(name);
+    if (it != cache.end())
+      return it->second;
+    MutexLock lock(&mutex_);
+    const auto& map_it = map_.find(name);
+    if (map_it == map_.end())
+      return nullptr;
+    Histogram* histogram = reinterpret_cast<Histogram*>(map_it->second.get());
+    cache.emplace(name, histogram);
+    return histogram;
+  }
+#endif
+
   mutable Mutex mutex_;
   std::map<std::string, std::unique_ptr<RtcHistogram>> map_
       RTC_GUARDED_BY(mutex_);
@@ -226,9 +322,12 @@ Histogram* HistogramFactoryGetCounts(const std::string& name,
                                      int min,
                                      int max,
                                      int bucket_count) {
-  // TODO(asapersson): Alternative implementation will be needed if this
-  // histogram type should be truly exponential.
-  return HistogramFactoryGetCountsLinear(name, min, max, bucket_count);
+  RtcHistogramMap* map = GetMap();
+  if (!map)
+    return nullptr;
+
+  return map->GetCountsHistogram(name, min, max, bucket_count,
+                                 /*exponential=*/true);
 }
 
 // Histogram with linearly spaced buckets.
@@ -243,7 +342,8 @@ Histogram* HistogramFactoryGetCountsLinear(const std::string& name,
   if (!map)
     return nullptr;
 
-  return map->GetCountsHistogram(name, min, max, bucket_count);
+  return map->GetCountsHistogram(name, min, max, bucket_count,
+                                 /*exponential=*/false);
 }
 
 // Histogram with linearly spaced buckets.
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "benchmark/benchmark.h"
+#include "rtc_base/system/unused.h"
+#include "system_wrappers/include/metrics.h"
+#include "system_wrappers/source/sharded_histogram.h"
+
+namespace webrtc {
+namespace metrics {
+namespace {
+
+void EnableMetrics() {
+  static const bool enabled = [] {
+    Enable();
+    return true;
+  }();
+  RTC_UNUSED(enabled);
+}
+
+// A cached histogram, as most metrics are.
+void BM_HistogramCounts(benchmark::State& state) {
+  EnableMetrics();
+  int i = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    RTC_HISTOGRAM_COUNTS_1000("WebRTC.Benchmark.Counts", ++i % 1000);
+  }
+}
+
+// A histogram that is looked up by name for every sample.
+void BM_HistogramEnumeration(benchmark::State& state) {
+  EnableMetrics();
+  int i = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    RTC_HISTOGRAM_ENUMERATION("WebRTC.Benchmark.Enumeration", ++i % 10, 10);
+  }
+}
+
+// The sharded histogram on its own, whichever backend the metrics use.
+void BM_ShardedHistogramAdd(benchmark::State& state) {
+  static ShardedHistogram* const histogram =
+      new ShardedHistogram("WebRTC.Benchmark.Sharded", 1, 1000, 50,
+                           ShardedHistogram::Buckets::kLinear);
+  int i = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    histogram->Add(++i % 1000);
+  }
+}
+
+BENCHMARK(BM_HistogramCounts)->Threads(1)->Threads(4)->Threads(16);
+BENCHMARK(BM_HistogramEnumeration)->Threads(1)->Threads(4)->Threads(16);
+BENCHMARK(BM_ShardedHistogramAdd)->Threads(1)->Threads(4)->Threads(16);
+
+}  // namespace
+}  // namespace metrics
+}  // namespace webrtc
+
+/*
+
+Results (Linux, a single x86-64 core):
+
+Default backend:
+-----------------------------------------------------------------------------
+Benchmark                                   Time             CPU   Iterations
+-----------------------------------------------------------------------------
+BM_HistogramCounts/threads:1             24.5 ns         23.8 ns     34756983
+BM_HistogramCounts/threads:4             24.7 ns         24.7 ns     24990576
+BM_HistogramCounts/threads:16            23.8 ns         24.9 ns     28242992
+BM_HistogramEnumeration/threads:1        63.2 ns         62.4 ns     10431149
+BM_HistogramEnumeration/threads:4        63.0 ns         63.1 ns     10922100
+BM_HistogramEnumeration/threads:16       62.5 ns         65.0 ns     10996576
+BM_ShardedHistogramAdd/threads:1         9.79 ns         9.69 ns     73278863
+BM_ShardedHistogramAdd/threads:4         9.93 ns         9.88 ns     71309304
+BM_ShardedHistogramAdd/threads:16        9.18 ns         9.63 ns     73068480
+
+rtc_use_sharded_metrics = true:
+-----------------------------------------------------------------------------
+Benchmark                                   Time             CPU   Iterations
+-----------------------------------------------------------------------------
+BM_HistogramCounts/threads:1             10.3 ns         9.99 ns     70452509
+BM_HistogramCounts/threads:4             10.9 ns         10.9 ns     70454376
+BM_HistogramCounts/threads:16            9.33 ns         9.77 ns     73425504
+BM_HistogramEnumeration/threads:1        32.7 ns         32.4 ns     21953926
+BM_HistogramEnumeration/threads:4        33.2 ns         33.4 ns     20817748
+BM_HistogramEnumeration/threads:16       31.6 ns         33.0 ns     21730592
+BM_ShardedHistogramAdd/threads:1         10.8 ns         10.3 ns     69107804
+BM_ShardedHistogramAdd/threads:4         9.95 ns         9.96 ns     65697696
+BM_ShardedHistogramAdd/threads:16        9.64 ns         10.1 ns     68291104
+
+The sharded backend adds a sample without taking a lock, and looks up
+histograms that are not cached at the call site in a per-thread cache before
+the map under the lock. With a single core the threads don't run in parallel,
+so this doesn't show the lock contention between cores that the sharding
+avoids.
+
+*/
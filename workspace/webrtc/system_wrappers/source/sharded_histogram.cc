@@ -0,0 +1,206 @@
+// Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+//
+
+#include "system_wrappers/source/sharded_histogram.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "absl/base/attributes.h"
+#include "absl/base/config.h"
+#include "rtc_base/checks.h"
+#if !defined(ABSL_HAVE_THREAD_LOCAL) && defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
+
+namespace webrtc {
+namespace metrics {
+namespace {
+
+// Threads are spread over the shards round robin, in the order they first
+// add a sample to any histogram.
+constexpr int kNumShards = 8;
+// Counters per cache line.
+constexpr int kCountersPerCacheLine = 64 / sizeof(std::atomic<int>);
+
+int NextShard() {
+  static std::atomic<int> next_shard{0};
+  return next_shard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+}
+
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+
+ABSL_CONST_INIT thread_local int current_shard = -1;
+
+int CurrentShard() {
+  if (current_shard < 0)
+    current_shard = NextShard();
+  return current_shard;
+}
+
+#elif defined(WEBRTC_POSIX)
+
+// Holds the shard plus one, so that a thread without a shard has null.
+ABSL_CONST_INIT pthread_key_t g_current_shard_tls = 0;
+
+void InitializeTls() {
+  RTC_CHECK_EQ(pthread_key_create(&g_current_shard_tls, nullptr), 0);
+}
+
+int CurrentShard() {
+  static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+  RTC_CHECK_EQ(pthread_once(&init_once, &InitializeTls), 0);
+  uintptr_t shard =
+      reinterpret_cast<uintptr_t>(pthread_getspecific(g_current_shard_tls));
+  if (shard == 0) {
+    shard = NextShard() + 1;
+    pthread_setspecific(g_current_shard_tls, reinterpret_cast<void*>(shard));
+  }
+  return static_cast<int>(shard - 1);
+}
+
+#else
+#error Unsupported platform
+#endif
+
+std::vector<int> LinearBucketMins(int min, int max, int width) {
+  std::vector<int> mins;
+  for (int64_t value = min; value <= max; value += width)
+    mins.push_back(static_cast<int>(value));
+  return mins;
+}
+
+// Like the exponential histograms of Chrome: each bucket is the remaining
+// range divided evenly on a log scale, but at least one value wide. The
+// logarithms are of the values offset to start at 1, so |min| may be 0.
+std::vector<int> ExponentialBucketMins(int min, int max, int bucket_count) {
+  std::vector<int> mins = {min};
+  const double log_max = std::log(static_cast<double>(max) - min + 1);
+  int64_t current = 1;
+  for (int remaining = bucket_count - 1; remaining > 0; --remaining) {
+    const double log_current = std::log(static_cast<double>(current));
+    const int64_t next = static_cast<int64_t>(std::llround(
+        std::exp(log_current + (log_max - log_current) / remaining)));
+    current = std::max(next, current + 1);
+    if (current > static_cast<int64_t>(max) - min + 1)
+      break;
+    mins.push_back(static_cast<int>(min + current - 1));
+  }
+  return mins;
+}
+
+}  // namespace
+
+ShardedHistogram::ShardedHistogram(const std::string& name,
+                                   int min,
+                                   int max,
+                                   int bucket_count,
+                                   Buckets buckets)
+    : name_(name),
+      min_(min),
+      max_(max),
+      bucket_count_(bucket_count),
+      bucket_width_(buckets == Buckets::kLinear
+                        ? std::max(1, (max - min + bucket_count) / bucket_count)
+                        : 0),
+      bucket_mins_(buckets == Buckets::kLinear
+                       ? LinearBucketMins(min, max, bucket_width_)
+                       : ExponentialBucketMins(min, max, bucket_count)),
+      num_buckets_(1 + static_cast<int>(bucket_mins_.size())),
+      shard_stride_((num_buckets_ + kCountersPerCacheLine - 1) /
+                    kCountersPerCacheLine * kCountersPerCacheLine),
+      counters_(new std::atomic<int>[kNumShards * shard_stride_]()) {
+  RTC_DCHECK_GT(bucket_count, 0);
+  RTC_DCHECK_LE(min, max);
+}
+
+void ShardedHistogram::Add(int sample) {
+  Counter(CurrentShard(), BucketIndex(sample))
+      .fetch_add(1, std::memory_order_relaxed);
+}
+
+std::unique_ptr<SampleInfo> ShardedHistogram::GetAndReset() {
+  std::unique_ptr<SampleInfo> info;
+  for (int index = 0; index < num_buckets_; ++index) {
+    int count = 0;
+    for (int shard = 0; shard < kNumShards; ++shard)
+      count += Counter(shard, index).exchange(0, std::memory_order_relaxed);
+    if (count == 0)
+      continue;
+    if (!info)
+      info.reset(new SampleInfo(name_, min_, max_, bucket_count_));
+    info->samples[BucketValue(index)] = count;
+  }
+  return info;
+}
+
+void ShardedHistogram::Reset() {
+  for (int i = 0; i < kNumShards * shard_stride_; ++i)
+    counters_[i].store(0, std::memory_order_relaxed);
+}
+
+int ShardedHistogram::NumEvents(int sample) const {
+  return BucketCount(BucketIndex(sample));
+}
+
+int ShardedHistogram::NumSamples() const {
+  int num_samples = 0;
+  for (int index = 0; index < num_buckets_; ++index)
+    num_samples += BucketCount(index);
+  return num_samples;
+}
+
+int ShardedHistogram::MinSample() const {
+  for (int index = 0; index < num_buckets_; ++index) {
+    if (BucketCount(index) > 0)
+      return BucketValue(index);
+  }
+  return -1;
+}
+
+std::map<int, int> ShardedHistogram::Samples() const {
+  std::map<int, int> samples;
+  for (int index = 0; index < num_buckets_; ++index) {
+    const int count = BucketCount(index);
+    if (count > 0)
+      samples[BucketValue(index)] = count;
+  }
+  return samples;
+}
+
+int ShardedHistogram::BucketIndex(int sample) const {
+  if (sample < min_)
+    return 0;
+  if (bucket_width_ > 0)
+    return 1 + (std::min(sample, max_) - min_) / bucket_width_;
+  // The number of buckets that start at or below the sample.
+  return static_cast<int>(
+      std::upper_bound(bucket_mins_.begin(), bucket_mins_.end(), sample) -
+      bucket_mins_.begin());
+}
+
+int ShardedHistogram::BucketValue(int index) const {
+  return index == 0 ? min_ - 1 : bucket_mins_[index - 1];
+}
+
+int ShardedHistogram::BucketCount(int index) const {
+  int count = 0;
+  for (int shard = 0; shard < kNumShards; ++shard)
+    count += Counter(shard, index).load(std::memory_order_relaxed);
+  return count;
+}
+
+std::atomic<int>& ShardedHistogram::Counter(int shard, int index) const {
+  return counters_[shard * shard_stride_ + index];
+}
+
+}  // namespace metrics
+}  // namespace webrtc
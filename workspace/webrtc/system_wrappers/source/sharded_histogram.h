@@ -0,0 +1,87 @@
+// Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+//
+
+#ifndef SYSTEM_WRAPPERS_SOURCE_SHARDED_HISTOGRAM_H_
+#define SYSTEM_WRAPPERS_SOURCE_SHARDED_HISTOGRAM_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "system_wrappers/include/metrics.h"
+
+namespace webrtc {
+namespace metrics {
+
+// A histogram that many threads can add samples to without contending on a
+// lock, for the metrics backend that rtc_use_sharded_metrics selects.
+//
+// Samples are counted in up to |bucket_count| buckets that cover [min, max],
+// and an underflow bucket for samples below |min|; samples above |max| are
+// counted in the last bucket. The buckets have equal widths, or widths that
+// grow exponentially from one value at |min|, as for the counts histograms.
+// A sample is reported as the smallest value of its bucket, and the underflow
+// bucket as min - 1, so enumerations, which have a bucket per value, are
+// reported exactly. Each thread adds to one of several shards of atomic
+// counters, and the shards are summed when the histogram is read.
+class ShardedHistogram {
+ public:
+  enum class Buckets { kLinear, kExponential };
+
+  ShardedHistogram(const std::string& name,
+                   int min,
+                   int max,
+                   int bucket_count,
+                   Buckets buckets);
+  ShardedHistogram(const ShardedHistogram&) = delete;
+  ShardedHistogram& operator=(const ShardedHistogram&) = delete;
+
+  void Add(int sample);
+
+  // Returns a copy (or nullptr if there are no samples) and clears samples.
+  std::unique_ptr<SampleInfo> GetAndReset();
+
+  const std::string& name() const { return name_; }
+
+  // Functions only for testing.
+  void Reset();
+  int NumEvents(int sample) const;
+  int NumSamples() const;
+  int MinSample() const;
+  std::map<int, int> Samples() const;
+
+ private:
+  int BucketIndex(int sample) const;
+  int BucketValue(int index) const;
+  // Summed over the shards.
+  int BucketCount(int index) const;
+  std::atomic<int>& Counter(int shard, int index) const;
+
+  const std::string name_;
+  const int min_;
+  const int max_;
+  const int bucket_count_;
+  // Zero for exponential buckets.
+  const int bucket_width_;
+  // The smallest value of each bucket but the underflow bucket, ascending.
+  const std::vector<int> bucket_mins_;
+  // Including the underflow bucket.
+  const int num_buckets_;
+  // The distance between shards, in counters, which keeps them on separate
+  // cache lines.
+  const int shard_stride_;
+  const std::unique_ptr<std::atomic<int>[]> counters_;
+};
+
+}  // namespace metrics
+}  // namespace webrtc
+
+#endif  // SYSTEM_WRAPPERS_SOURCE_SHARDED_HISTOGRAM_H_
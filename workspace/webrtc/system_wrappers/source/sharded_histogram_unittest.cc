@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "system_wrappers/source/sharded_histogram.h"
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "rtc_base/platform_thread.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+namespace webrtc {
+namespace metrics {
+namespace {
+
+TEST(ShardedHistogramTest, EnumerationSamplesAreExact) {
+  // As made for RTC_HISTOGRAM_ENUMERATION(name, sample, 5).
+  ShardedHistogram histogram("Enum", 1, 5, 6,
+                             ShardedHistogram::Buckets::kLinear);
+  histogram.Add(0);
+  histogram.Add(2);
+  histogram.Add(2);
+  histogram.Add(4);
+  histogram.Add(7);
+  EXPECT_THAT(histogram.Samples(),
+              ElementsAre(Pair(0, 1), Pair(2, 2), Pair(4, 1), Pair(5, 1)));
+  EXPECT_EQ(histogram.NumEvents(2), 2);
+  EXPECT_EQ(histogram.NumEvents(3), 0);
+  EXPECT_EQ(histogram.NumSamples(), 5);
+  EXPECT_EQ(histogram.MinSample(), 0);
+}
+
+TEST(ShardedHistogramTest, CountsSamplesInBuckets) {
+  // Buckets of 10: [1, 10], [11, 20], ..., [91, 100].
+  ShardedHistogram histogram("Counts", 1, 100, 10,
+                             ShardedHistogram::Buckets::kLinear);
+  histogram.Add(15);
+  histogram.Add(20);
+  histogram.Add(1000);
+  histogram.Add(-5);
+  EXPECT_THAT(histogram.Samples(),
+              ElementsAre(Pair(0, 1), Pair(11, 2), Pair(91, 1)));
+  EXPECT_EQ(histogram.NumEvents(11), 2);
+  EXPECT_EQ(histogram.NumEvents(19), 2);
+  EXPECT_EQ(histogram.NumEvents(100), 1);
+}
+
+TEST(ShardedHistogramTest, CountsSamplesInExponentialBuckets) {
+  // As made for RTC_HISTOGRAM_COUNTS(name, sample, 1, 100, 10), with buckets
+  // starting at 1, 2, 3, 5, 8, 13, 22, 36, 60 and 100.
+  ShardedHistogram histogram("Counts", 1, 100, 10,
+                             ShardedHistogram::Buckets::kExponential);
+  histogram.Add(1);
+  histogram.Add(4);
+  histogram.Add(21);
+  histogram.Add(40);
+  histogram.Add(1000);
+  histogram.Add(-5);
+  EXPECT_THAT(histogram.Samples(),
+              ElementsAre(Pair(0, 1), Pair(1, 1), Pair(3, 1), Pair(13, 1),
+                          Pair(36, 1), Pair(100, 1)));
+  EXPECT_EQ(histogram.NumEvents(59), 1);
+}
+
+// The value below which |fraction| of the samples are.
+int Percentile(const std::map<int, int>& samples, double fraction) {
+  int num_samples = 0;
+  for (const auto& sample : samples)
+    num_samples += sample.second;
+  int count = 0;
+  for (const auto& sample : samples) {
+    count += sample.second;
+    if (count >= fraction * num_samples)
+      return sample.first;
+  }
+  return -1;
+}
+
+// The default metrics backend keeps the samples, so its percentiles are
+// exact. Those of the sharded histogram are the smallest value of a bucket,
+// which is at most the ratio of adjacent buckets off.
+TEST(ShardedHistogramTest, CountsPercentilesAreCloseToTheDefaultBackend) {
+  // As made for RTC_HISTOGRAM_COUNTS_100000.
+  ShardedHistogram histogram("Counts", 1, 100000, 50,
+                             ShardedHistogram::Buckets::kExponential);
+  std::map<int, int> exact_samples;
+  // Spread over the range on a log scale, as delays and bitrates are.
+  for (int i = 0; i < 200; ++i) {
+    const int sample = static_cast<int>(std::pow(10.0, 1.0 + i / 50.0));
+    for (int j = 0; j <= i % 3; ++j) {
+      histogram.Add(sample);
+      ++exact_samples[sample];
+    }
+  }
+  for (double fraction : {0.1, 0.5, 0.9}) {
+    const int exact = Percentile(exact_samples, fraction);
+    const int bucketed = Percentile(histogram.Samples(), fraction);
+    EXPECT_LE(bucketed, exact) << fraction;
+    EXPECT_GE(bucketed * 1.3, exact) << fraction;
+  }
+}
+
+TEST(ShardedHistogramTest, GetAndResetClearsSamples) {
+  ShardedHistogram histogram("Name", 1, 100, 50,
+                             ShardedHistogram::Buckets::kLinear);
+  EXPECT_EQ(histogram.GetAndReset(), nullptr);
+  EXPECT_EQ(histogram.MinSample(), -1);
+  histogram.Add(50);
+  std::unique_ptr<SampleInfo> info = histogram.GetAndReset();
+  ASSERT_TRUE(info);
+  EXPECT_EQ(info->name, "Name");
+  EXPECT_EQ(info->min, 1);
+  EXPECT_EQ(info->max, 100);
+  EXPECT_EQ(info->bucket_count, 50u);
+  EXPECT_THAT(info->samples, ElementsAre(Pair(49, 1)));
+  EXPECT_EQ(histogram.NumSamples(), 0);
+
+  histogram.Add(50);
+  histogram.Reset();
+  EXPECT_EQ(histogram.GetAndReset(), nullptr);
+}
+
+constexpr int kSamplesPerThread = 10000;
+
+void AddSamples(void* histogram) {
+  for (int i = 0; i < kSamplesPerThread; ++i)
+    static_cast<ShardedHistogram*>(histogram)->Add(i % 10);
+}
+
+TEST(ShardedHistogramTest, MergesSamplesFromAllThreads) {
+  constexpr int kNumThreads = 12;
+  ShardedHistogram histogram("Threads", 0, 9, 10,
+                             ShardedHistogram::Buckets::kLinear);
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(std::make_unique<rtc::PlatformThread>(
+        &AddSamples, &histogram, "Adder"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  EXPECT_EQ(histogram.NumSamples(), kNumThreads * kSamplesPerThread);
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(histogram.NumEvents(i), kNumThreads * kSamplesPerThread / 10);
+}
+
+}  // namespace
+}  // namespace metrics
+}  // namespace webrtc